@@ -45,7 +45,7 @@ namespace kiwano
 		Complete(target);
 	}
 
-	void Action::UpdateStep(NodePtr target, Duration dt)
+	void Action::UpdateStep(NodePtr const& target, Duration dt)
 	{
 		elapsed_ += dt;
 
@@ -81,7 +81,7 @@ namespace kiwano
 		}
 	}
 
-	void Action::Complete(NodePtr target)
+	void Action::Complete(NodePtr const& target)
 	{
 		if (cb_loop_done_)
 			cb_loop_done_();
@@ -99,7 +99,7 @@ namespace kiwano
 		++loops_done_;
 	}
 
-	void Action::Restart(NodePtr target)
+	void Action::Restart(NodePtr const& target)
 	{
 		status_ = Status::NotStarted;
 		elapsed_ = 0;
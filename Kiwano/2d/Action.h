@@ -49,34 +49,34 @@ namespace kiwano
 
 		virtual ~Action();
 
-		// 
+		// 继续动作
 		inline void Resume()										{ running_ = true; }
 
-		// ͣ
+		// 暂停动作
 		inline void Pause()											{ running_ = false; }
 
-		// ֹͣ
+		// 停止动作
 		inline void Stop()											{ status_ = Status::Removeable; }
 
-		// öʱ
+		// 设置动作延时
 		inline void SetDelay(Duration delay)						{ delay_ = delay; }
 
-		// ѭ (-1 Ϊѭ)
+		// 设置循环次数 (-1 为永久循环)
 		inline void SetLoops(int loops)								{ loops_ = loops; }
 
-		// ʱƳĿڵ
+		// 动作结束时移除目标节点
 		inline void RemoveTargetWhenDone()							{ detach_target_ = true; }
 
-		// öʱĻص
+		// 设置动作结束时的回调函数
 		inline void SetDoneCallback(ActionCallback const& cb)		{ cb_done_ = cb; }
 
-		// öѭʱĻص
+		// 设置动作循环结束时的回调函数
 		inline void SetLoopDoneCallback(ActionCallback const& cb)	{ cb_loop_done_ = cb; }
 
-		// ȡĿ
+		// 获取动作的拷贝
 		virtual ActionPtr Clone() const = 0;
 
-		// ȡĵת
+		// 获取动作的倒转
 		virtual ActionPtr Reverse() const = 0;
 
 		inline void Done()											{ status_ = Status::Done; }
@@ -104,11 +104,11 @@ namespace kiwano
 
 		virtual void Update(NodePtr target, Duration dt);
 
-		void UpdateStep(NodePtr target, Duration dt);
+		void UpdateStep(NodePtr const& target, Duration dt);
 
-		void Complete(NodePtr target);
+		void Complete(NodePtr const& target);
 
-		void Restart(NodePtr target);
+		void Restart(NodePtr const& target);
 
 	protected:
 		Status			status_;
@@ -23,7 +23,7 @@
 
 namespace kiwano
 {
-	// 
+	// 动作组
 	class KGE_API ActionGroup
 		: public Action
 	{
@@ -34,35 +34,35 @@ namespace kiwano
 
 		explicit ActionGroup(
 			Array<ActionPtr> const& actions,
-			bool sequence = true				// ˳ִлͬʱִ
+			bool sequence = true				// 按顺序执行或同时执行
 		);
 
 		virtual ~ActionGroup();
 
-		// Ӷ
+		// 添加动作
 		void Add(
 			ActionPtr action
 		);
 
-		// Ӷ
+		// 添加多个动作
 		void Add(
 			Array<ActionPtr> const& actions
 		);
 
-		// ȡж
+		// 获取所有动作
 		inline ActionList const& GetActions() { return actions_; }
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override;
 
 	protected:
-		// ʼ
+		// 初始化动作
 		void Init(NodePtr target) override;
 
-		// ¶
+		// 更新动作
 		void Update(NodePtr target, Duration dt) override;
 
 	protected:
@@ -72,7 +72,7 @@ namespace kiwano
 	};
 
 
-	// ˳
+	// 顺序动作
 	class KGE_API ActionSequence
 		: public ActionGroup
 	{
@@ -87,7 +87,7 @@ namespace kiwano
 	};
 
 
-	// ͬ
+	// 同步动作
 	class KGE_API ActionSpawn
 		: public ActionGroup
 	{
@@ -27,25 +27,25 @@ namespace kiwano
 {
 	struct ActionHelper
 	{
-		// ѭ
+		// 设置循环次数
 		inline ActionHelper& SetLoops(int loops)							{ base->SetLoops(loops); return (*this); }
 
-		// öӳ
+		// 设置动作延迟
 		inline ActionHelper& SetDelay(Duration delay)						{ base->SetDelay(delay); return (*this); }
 
-		// öص
+		// 设置动作结束回调函数
 		inline ActionHelper& SetDoneCallback(ActionCallback const& cb)		{ base->SetDoneCallback(cb); return (*this); }
 
-		// öѭʱĻص
+		// 设置动作循环结束时的回调函数
 		inline ActionHelper& SetLoopDoneCallback(ActionCallback const& cb)	{ base->SetLoopDoneCallback(cb); return (*this); }
 
-		// ʱƳĿڵ
+		// 动作结束时移除目标节点
 		inline ActionHelper& RemoveTargetWhenDone()							{ base->RemoveTargetWhenDone(); return (*this); }
 
-		// 
+		// 设置名称
 		inline ActionHelper& SetName(String const& name)					{ base->SetName(name); return (*this); }
 
-		// ȡָ
+		// 获取指针
 		inline ActionPtr Get() const									{ return base; }
 
 		inline ActionHelper(ActionPtr base)							: base(base) {}
@@ -58,31 +58,31 @@ namespace kiwano
 
 	struct TweenHelper
 	{
-		// öʱ
+		// 设置动画持续时长
 		inline TweenHelper& SetDuration(Duration dur)						{ base->SetDuration(dur); return (*this); }
 
-		// ѭ
+		// 设置循环次数
 		inline TweenHelper& SetLoops(int loops)								{ base->SetLoops(loops); return (*this); }
 
-		// û
+		// 设置缓动函数
 		inline TweenHelper& SetEaseFunc(EaseFunc ease)						{ base->SetEaseFunc(ease); return (*this); }
 
-		// öӳ
+		// 设置动作延迟
 		inline TweenHelper& SetDelay(Duration delay)						{ base->SetDelay(delay); return (*this); }
 
-		// öص
+		// 设置动作结束回调函数
 		inline TweenHelper& SetDoneCallback(ActionCallback const& cb)		{ base->SetDoneCallback(cb); return (*this); }
 
-		// öѭʱĻص
+		// 设置动作循环结束时的回调函数
 		inline TweenHelper& SetLoopDoneCallback(ActionCallback const& cb)	{ base->SetLoopDoneCallback(cb); return (*this); }
 
-		// ʱƳĿڵ
+		// 动作结束时移除目标节点
 		inline TweenHelper& RemoveTargetWhenDone()							{ base->RemoveTargetWhenDone(); return (*this); }
 
-		// 
+		// 设置名称
 		inline TweenHelper& SetName(String const& name)						{ base->SetName(name); return (*this); }
 
-		// ȡָ
+		// 获取指针
 		inline ActionTweenPtr Get() const							{ return base; }
 		
 		inline TweenHelper(ActionTweenPtr base)						: base(base) {}
@@ -113,18 +113,18 @@ namespace kiwano
 
 		static inline TweenHelper
 		JumpBy(
-			Point const& pos,	/* Ŀ */
-			float height,		/* Ծ߶ */
-			int jumps = 1)		/* Ծ */
+			Point const& pos,	/* 目的坐标 */
+			float height,		/* 跳跃高度 */
+			int jumps = 1)		/* 跳跃次数 */
 		{
 			return TweenHelper(new kiwano::ActionJumpBy(0, pos, height, jumps));
 		}
 
 		static inline TweenHelper
 		JumpTo(
-			Point const& pos,	/* Ŀ */
-			float height,		/* Ծ߶ */
-			int jumps = 1)		/* Ծ */
+			Point const& pos,	/* 目的坐标 */
+			float height,		/* 跳跃高度 */
+			int jumps = 1)		/* 跳跃次数 */
 		{
 			return TweenHelper(new kiwano::ActionJumpTo(0, pos, height, jumps));
 		}
@@ -191,10 +191,10 @@ namespace kiwano
 
 		static inline TweenHelper
 		Path(
-			GeometryPtr geo,			/* ͼ */
-			bool rotating = false,		/* ·߷ת */
-			float start = 0.f,			/*  */
-			float end = 1.f)			/* յ */
+			GeometryPtr geo,			/* 几何图形 */
+			bool rotating = false,		/* 沿路径切线方向旋转 */
+			float start = 0.f,			/* 起点 */
+			float end = 1.f)			/* 终点 */
 		{
 			return TweenHelper(new kiwano::ActionPath(0, geo, rotating, start, end));
 		}
@@ -24,7 +24,7 @@
 
 namespace kiwano
 {
-	void ActionManager::UpdateActions(NodePtr target, Duration dt)
+	void ActionManager::UpdateActions(NodePtr const& target, Duration dt)
 	{
 		if (actions_.IsEmpty() || !target)
 			return;
@@ -55,11 +55,12 @@ namespace kiwano
 
 	ActionPtr ActionManager::GetAction(String const & name)
 	{
-		if (actions_.IsEmpty())
+		StringAtom atom;
+		if (actions_.IsEmpty() || !StringAtom::find(name, atom))
 			return nullptr;
 
 		for (auto action = actions_.First().Get(); action; action = action->NextItem().Get())
-			if (action->IsName(name))
+			if (action->IsName(atom))
 				return action;
 		return nullptr;
 	}
@@ -28,30 +28,30 @@ namespace kiwano
 		using Actions = IntrusiveList<ActionPtr>;
 
 	public:
-		// Ӷ
+		// 添加动作
 		ActionPtr AddAction(
 			ActionPtr action
 		);
 
-		// ȡ
+		// 获取动作
 		ActionPtr GetAction(
 			String const& name
 		);
 
-		// ͣ
+		// 继续所有暂停动作
 		void ResumeAllActions();
 
-		// ͣж
+		// 暂停所有动作
 		void PauseAllActions();
 
-		// ֹͣж
+		// 停止所有动作
 		void StopAllActions();
 
-		// ȡж
+		// 获取所有动作
 		Actions const& GetAllActions() const;
 
 	protected:
-		void UpdateActions(NodePtr target, Duration dt);
+		void UpdateActions(NodePtr const& target, Duration dt);
 
 	protected:
 		Actions actions_;
@@ -67,6 +67,13 @@ namespace kiwano
 	EaseFunc Ease::QuintOut = math::EaseQuintOut;
 	EaseFunc Ease::QuintInOut = math::EaseQuintInOut;
 
+	EaseFunc Ease::Tabulate(EaseFunc const& func, size_t resolution)
+	{
+		if (!func)
+			return nullptr;
+		return math::EaseTable(func, resolution);
+	}
+
 	//-------------------------------------------------------
 	// ActionTween
 	//-------------------------------------------------------
@@ -100,30 +107,31 @@ namespace kiwano
 
 	void ActionTween::Update(NodePtr target, Duration dt)
 	{
-		float percent;
+		float percent = ComputePercent(target);
+
+		if (ease_func_)
+			percent = ease_func_(percent);
+
+		UpdateTween(target, percent);
+	}
 
+	float ActionTween::ComputePercent(NodePtr const& target)
+	{
 		if (dur_.IsZero())
 		{
-			percent = 1.f;
 			Complete(target);
+			return 1.f;
 		}
-		else
-		{
-			Duration elapsed = elapsed_ - delay_;
-			float loops_done = elapsed / dur_;
 
-			while (loops_done_ < static_cast<int>(loops_done))
-			{
-				Complete(target);	// loops_done_++
-			}
+		Duration elapsed = elapsed_ - delay_;
+		float loops_done = elapsed / dur_;
 
-			percent = (status_ == Status::Done) ? 1.f : (loops_done - static_cast<float>(loops_done_));
+		while (loops_done_ < static_cast<int>(loops_done))
+		{
+			Complete(target);	// loops_done_++
 		}
 
-		if (ease_func_)
-			percent = ease_func_(percent);
-
-		UpdateTween(target, percent);
+		return (status_ == Status::Done) ? 1.f : (loops_done - static_cast<float>(loops_done_));
 	}
 
 	void ActionTween::SetDuration(Duration duration)
@@ -21,30 +21,31 @@
 #pragma once
 #include "Action.h"
 #include "Geometry.h"  // ActionPath
+#include "../math/EaseTable.h"
 #include "../base/logs.h"
 
 namespace kiwano
 {
-	// 
+	// 缓动函数
 	using EaseFunc = Closure<float(float)>;
 
-	// ö
+	// 缓动函数枚举
 	// See https://easings.net for more information
 	struct Ease
 	{
-		static KGE_API EaseFunc Linear;			// 
-		static KGE_API EaseFunc EaseIn;			// 
-		static KGE_API EaseFunc EaseOut;		// ɿ
-		static KGE_API EaseFunc EaseInOut;		// , ɿ
-		static KGE_API EaseFunc ExpoIn;			// 伫
-		static KGE_API EaseFunc ExpoOut;		// ɼ
-		static KGE_API EaseFunc ExpoInOut;		// , ɼ
-		static KGE_API EaseFunc ElasticIn;		// 㸳赯
-		static KGE_API EaseFunc ElasticOut;		// յ㸳赯
-		static KGE_API EaseFunc ElasticInOut;	// յ㸳赯
-		static KGE_API EaseFunc BounceIn;		// 㸳跴
-		static KGE_API EaseFunc BounceOut;		// յ㸳跴
-		static KGE_API EaseFunc BounceInOut;	// յ㸳跴
+		static KGE_API EaseFunc Linear;			// 线性
+		static KGE_API EaseFunc EaseIn;			// 由慢变快
+		static KGE_API EaseFunc EaseOut;		// 由快变慢
+		static KGE_API EaseFunc EaseInOut;		// 由慢变快, 再由快变慢
+		static KGE_API EaseFunc ExpoIn;			// 由慢变极快
+		static KGE_API EaseFunc ExpoOut;		// 由极快变慢
+		static KGE_API EaseFunc ExpoInOut;		// 由慢至极快, 再由极快边慢
+		static KGE_API EaseFunc ElasticIn;		// 自起点赋予弹性
+		static KGE_API EaseFunc ElasticOut;		// 自终点赋予弹性
+		static KGE_API EaseFunc ElasticInOut;	// 再起点和终点赋予弹性
+		static KGE_API EaseFunc BounceIn;		// 自起点赋予反弹力
+		static KGE_API EaseFunc BounceOut;		// 自终点赋予反弹力
+		static KGE_API EaseFunc BounceInOut;	// 在起点和终点赋予反弹力
 		static KGE_API EaseFunc BackIn;
 		static KGE_API EaseFunc BackOut;
 		static KGE_API EaseFunc BackInOut;
@@ -63,10 +64,16 @@ namespace kiwano
 		static KGE_API EaseFunc SineIn;
 		static KGE_API EaseFunc SineOut;
 		static KGE_API EaseFunc SineInOut;
+
+		// 使用查找表计算缓动函数, 以少量精度换取速度
+		static KGE_API EaseFunc Tabulate(
+			EaseFunc const& func,
+			size_t resolution = 256
+		);
 	};
 
 
-	// 䶯
+	// 补间动画
 	class KGE_API ActionTween
 		: public Action
 	{
@@ -78,8 +85,8 @@ namespace kiwano
 			EaseFunc func
 		);
 
-		// Զ建
-		void SetEaseFunc(
+		// 自定义缓动函数
+		virtual void SetEaseFunc(
 			EaseFunc const& func
 		);
 
@@ -94,27 +101,30 @@ namespace kiwano
 
 		virtual void UpdateTween(NodePtr target, float percent) = 0;
 
+		// 计算本帧的进度, 到达循环终点时结束本次循环
+		float ComputePercent(NodePtr const& target);
+
 	protected:
 		Duration dur_;
 		EaseFunc ease_func_;
 	};
 
 
-	// λƶ
+	// 相对位移动作
 	class KGE_API ActionMoveBy
 		: public ActionTween
 	{
 	public:
 		ActionMoveBy(
-			Duration duration,		/* ʱ */
-			Point const& vector,	/* ƶ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			Point const& vector,	/* 移动距离 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override;
 
 	protected:
@@ -129,21 +139,21 @@ namespace kiwano
 	};
 
 
-	// λƶ
+	// 位移动作
 	class KGE_API ActionMoveTo
 		: public ActionMoveBy
 	{
 	public:
 		ActionMoveTo(
-			Duration duration,		/* ʱ */
-			Point const& pos,		/* Ŀ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			Point const& pos,		/* 目的坐标 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual ActionPtr Reverse() const override
 		{
 			KGE_ERROR_LOG(L"Reverse() not supported in ActionMoveTo");
@@ -158,23 +168,23 @@ namespace kiwano
 	};
 
 
-	// Ծ
+	// 相对跳跃动作
 	class KGE_API ActionJumpBy
 		: public ActionTween
 	{
 	public:
 		ActionJumpBy(
-			Duration duration,		/* ʱ */
-			Point const& vec,		/* Ծ */
-			float height,			/* Ծ߶ */
-			int jumps = 1,			/* Ծ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			Point const& vec,		/* 跳跃距离 */
+			float height,			/* 跳跃高度 */
+			int jumps = 1,			/* 跳跃次数 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override;
 
 	protected:
@@ -191,23 +201,23 @@ namespace kiwano
 	};
 
 
-	// Ծ
+	// 跳跃动作
 	class KGE_API ActionJumpTo
 		: public ActionJumpBy
 	{
 	public:
 		ActionJumpTo(
-			Duration duration,		/* ʱ */
-			Point const& pos,		/* Ŀ */
-			float height,			/* Ծ߶ */
-			int jumps = 1,			/* Ծ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			Point const& pos,		/* 目的坐标 */
+			float height,			/* 跳跃高度 */
+			int jumps = 1,			/* 跳跃次数 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual ActionPtr Reverse() const override
 		{
 			KGE_ERROR_LOG(L"Reverse() not supported in ActionJumpTo");
@@ -222,28 +232,28 @@ namespace kiwano
 	};
 
 
-	// Ŷ
+	// 相对缩放动作
 	class KGE_API ActionScaleBy
 		: public ActionTween
 	{
 	public:
 		ActionScaleBy(
-			Duration duration,		/* ʱ */
-			float scale,			/* Ա仯ֵ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			float scale,			/* 相对变化值 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
 		ActionScaleBy(
-			Duration duration,		/* ʱ */
-			float scale_x,			/* Ա仯ֵ */
-			float scale_y,			/* Ա仯ֵ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			float scale_x,			/* 横向缩放相对变化值 */
+			float scale_y,			/* 纵向缩放相对变化值 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override;
 
 	protected:
@@ -259,28 +269,28 @@ namespace kiwano
 	};
 
 
-	// Ŷ
+	// 缩放动作
 	class KGE_API ActionScaleTo
 		: public ActionScaleBy
 	{
 	public:
 		ActionScaleTo(
-			Duration duration,		/* ʱ */
-			float scale,			/* Ŀֵ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			float scale,			/* 目标值 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
 		ActionScaleTo(
-			Duration duration,		/* ʱ */
-			float scale_x,			/* Ŀֵ */
-			float scale_y,			/* Ŀֵ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			float scale_x,			/* 横向缩放目标值 */
+			float scale_y,			/* 纵向缩放目标值 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual ActionPtr Reverse() const override
 		{
 			KGE_ERROR_LOG(L"Reverse() not supported in ActionScaleTo");
@@ -296,21 +306,21 @@ namespace kiwano
 	};
 
 
-	// ͸Խ䶯
+	// 透明度相对渐变动作
 	class KGE_API ActionOpacityBy
 		: public ActionTween
 	{
 	public:
 		ActionOpacityBy(
-			Duration duration,		/* ʱ */
-			float opacity,			/* Ա仯ֵ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			float opacity,			/* 相对变化值 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override;
 
 	protected:
@@ -324,21 +334,21 @@ namespace kiwano
 	};
 
 
-	// ͸Ƚ䶯
+	// 透明度渐变动作
 	class KGE_API ActionOpacityTo
 		: public ActionOpacityBy
 	{
 	public:
 		ActionOpacityTo(
-			Duration duration,		/* ʱ */
-			float opacity,			/* Ŀֵ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			float opacity,			/* 目标值 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual ActionPtr Reverse() const override
 		{
 			KGE_ERROR_LOG(L"Reverse() not supported in ActionOpacityTo");
@@ -353,47 +363,47 @@ namespace kiwano
 	};
 
 
-	// 붯
+	// 淡入动作
 	class KGE_API ActionFadeIn
 		: public ActionOpacityTo
 	{
 	public:
-		// 붯
+		// 创建淡入动作
 		explicit ActionFadeIn(
-			Duration duration,		/* ʱ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 	};
 
 
-	// 
+	// 淡出动作
 	class KGE_API ActionFadeOut
 		: public ActionOpacityTo
 	{
 	public:
-		// 
+		// 创建淡出动作
 		explicit ActionFadeOut(
-			Duration duration,		/* ʱ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 	};
 
 
-	// ת
+	// 相对旋转动作
 	class KGE_API ActionRotateBy
 		: public ActionTween
 	{
 	public:
 		ActionRotateBy(
-			Duration duration,		/* ʱ */
-			float rotation,			/* Ա仯ֵ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			float rotation,			/* 相对变化值 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override;
 
 	protected:
@@ -407,21 +417,21 @@ namespace kiwano
 	};
 
 
-	// ת
+	// 旋转动作
 	class KGE_API ActionRotateTo
 		: public ActionRotateBy
 	{
 	public:
 		ActionRotateTo(
-			Duration duration,		/* ʱ */
-			float rotation,			/* Ŀֵ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			float rotation,			/* 目标值 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		virtual ActionPtr Reverse() const override
 		{
 			KGE_ERROR_LOG(L"Reverse() not supported in ActionRotateTo");
@@ -436,24 +446,24 @@ namespace kiwano
 	};
 
 
-	// ·
+	// 路径动作
 	class KGE_API ActionPath
 		: public ActionTween
 	{
 	public:
 		ActionPath(
-			Duration duration,		/* ʱ */
-			GeometryPtr geo,		/* ͼ */
-			bool rotating = false,	/* ·߷ת */
-			float start = 0.f,		/*  */
-			float end = 1.f,		/* յ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			GeometryPtr geo,		/* 几何图形 */
+			bool rotating = false,	/* 沿路径切线方向旋转 */
+			float start = 0.f,		/* 起点 */
+			float end = 1.f,		/* 终点 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override;
 
 	protected:
@@ -470,7 +480,7 @@ namespace kiwano
 	};
 
 
-	// Զ嶯
+	// 自定义动作
 	class KGE_API ActionCustom
 		: public ActionTween
 	{
@@ -478,15 +488,15 @@ namespace kiwano
 		using TweenFunc = Closure<void(NodePtr, float)>;
 
 		ActionCustom(
-			Duration duration,		/* ʱ */
-			TweenFunc tween_func,	/* ̺ */
-			EaseFunc func = nullptr	/* ٶȱ仯 */
+			Duration duration,		/* 持续时长 */
+			TweenFunc tween_func,	/* 过程函数 */
+			EaseFunc func = nullptr	/* 速度变化 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override
 		{
 			KGE_ERROR_LOG(L"Reverse() not supported in ActionCustom");
@@ -503,19 +513,61 @@ namespace kiwano
 	};
 
 
-	// ʱ
+	// 缓动函数在编译期确定的补间动画, 缓动函数可被内联
+	// 例: new ActionEased<ActionMoveBy, math::EaseQuadInOut>(duration, vector)
+	// 拷贝和倒转得到的动作使用普通的缓动函数
+	// 调用 SetEaseFunc 重新设置缓动函数后, 按普通补间动画更新
+	template <typename _Tween, float(*_Ease)(float)>
+	class ActionEased
+		: public _Tween
+	{
+	public:
+		template <typename... _Args>
+		ActionEased(_Args&&... args)
+			: _Tween(std::forward<_Args>(args)...)
+			, inlined_(true)
+		{
+			_Tween::SetEaseFunc(_Ease);
+		}
+
+		void SetEaseFunc(EaseFunc const& func) override
+		{
+			inlined_ = false;
+			_Tween::SetEaseFunc(func);
+		}
+
+	protected:
+		void Update(NodePtr target, Duration dt) override
+		{
+			if (inlined_)
+			{
+				// 限定名调用, 不经过虚函数表
+				_Tween::UpdateTween(target, _Ease(this->ComputePercent(target)));
+			}
+			else
+			{
+				_Tween::Update(target, dt);
+			}
+		}
+
+	private:
+		bool inlined_;
+	};
+
+
+	// 延时动作
 	class KGE_API ActionDelay
 		: public Action
 	{
 	public:
 		ActionDelay(
-			Duration delay		/* ʱ */
+			Duration delay		/* 持续时长 */
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override;
 	};
 }
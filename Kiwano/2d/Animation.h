@@ -23,7 +23,7 @@
 
 namespace kiwano
 {
-	// ֡
+	// 帧动画
 	class KGE_API Animation
 		: public ActionTween
 	{
@@ -31,25 +31,25 @@ namespace kiwano
 		Animation();
 
 		Animation(
-			Duration duration,			/* ʱ */
-			FramesPtr frames,			/* ֡ */
-			EaseFunc func = nullptr		/* ٶȱ仯 */
+			Duration duration,			/* 动画时长 */
+			FramesPtr frames,			/* 序列帧 */
+			EaseFunc func = nullptr		/* 速度变化 */
 		);
 
 		virtual ~Animation();
 
-		// ȡ
+		// 获取动画
 		FramesPtr GetFrames() const;
 
-		// ö
+		// 设置动画
 		void SetFrames(
 			FramesPtr frames
 		);
 
-		// ȡöĿ
+		// 获取该动作的拷贝对象
 		ActionPtr Clone() const override;
 
-		// ȡöĵת
+		// 获取该动作的倒转
 		ActionPtr Reverse() const override;
 
 	protected:
@@ -53,7 +53,8 @@ namespace kiwano
 		ThrowIfFailed(
 			ITextRenderer::Create(
 				&text_renderer_,
-				render_target_.Get()
+				render_target_.Get(),
+				&Renderer::Instance().GetDeviceResources()->GetTextCache()
 			)
 		);
 
@@ -138,9 +139,6 @@ namespace kiwano
 			text_style_.outline_width,
 			Renderer::Instance().GetDeviceResources()->GetStrokeStyle(text_style_.outline_stroke)
 		);
-
-		// clear text format
-		text_format_ = nullptr;
 	}
 
 	Color Canvas::GetStrokeColor() const
@@ -258,7 +256,7 @@ namespace kiwano
 				D2D1::RectF(0, 0, image->GetWidth(), image->GetHeight()),
 				opacity,
 				D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
-				DX::ConvertToRectF(image->GetCropRect())
+				DX::ConvertToRectF(image->GetBitmapRect())
 			);
 			cache_expired_ = true;
 		}
@@ -269,25 +267,14 @@ namespace kiwano
 		if (text.empty())
 			return;
 
-		if (!text_format_)
-		{
-			ThrowIfFailed(
-				Renderer::Instance().GetDeviceResources()->CreateTextFormat(
-					text_format_,
-					text_font_,
-					text_style_
-				)
-			);
-		}
-
 		ComPtr<IDWriteTextLayout> text_layout;
 		Size layout_size;
 		ThrowIfFailed(
-			Renderer::Instance().GetDeviceResources()->CreateTextLayout(
+			Renderer::Instance().GetDeviceResources()->GetTextCache().GetTextLayout(
 				text_layout,
 				layout_size,
 				text,
-				text_format_,
+				text_font_,
 				text_style_
 			)
 		);
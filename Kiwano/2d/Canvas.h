@@ -28,7 +28,7 @@
 
 namespace kiwano
 {
-	// 
+	// 画布
 	class KGE_API Canvas
 		: public VisualNode
 	{
@@ -46,176 +46,176 @@ namespace kiwano
 
 		virtual ~Canvas();
 
-		// ʼͼ
+		// 开始绘图
 		void BeginDraw();
 
-		// ͼ
+		// 结束绘图
 		void EndDraw();
 
-		// ֱ
+		// 画直线
 		void DrawLine(
 			const Point& begin,
 			const Point& end
 		);
 
-		// Բα߿
+		// 画圆形边框
 		void DrawCircle(
 			const Point& center,
 			float radius
 		);
 
-		// Բα߿
+		// 画椭圆形边框
 		void DrawEllipse(
 			const Point& center,
 			float radius_x,
 			float radius_y
 		);
 
-		// α߿
+		// 画矩形边框
 		void DrawRect(
 			const Rect& rect
 		);
 
-		// ԲǾα߿
+		// 画圆角矩形边框
 		void DrawRoundedRect(
 			const Rect& rect,
 			float radius_x,
 			float radius_y
 		);
 
-		// ͼƬ
+		// 画图片
 		void DrawImage(
 			ImagePtr image,
 			float opacity = 1.f
 		);
 
-		// 
+		// 画文字
 		void DrawText(
-			String const& text,		/*  */
-			Point const& point		/* λ */
+			String const& text,		/* 文字 */
+			Point const& point		/* 文字位置 */
 		);
 
-		// ͼα߿
+		// 画几何图形边框
 		void DrawGeometry(
 			GeometryPtr geo
 		);
 
-		// Բ
+		// 填充圆形
 		void FillCircle(
 			const Point& center,
 			float radius
 		);
 
-		// Բ
+		// 填充椭圆形
 		void FillEllipse(
 			const Point& center,
 			float radius_x,
 			float radius_y
 		);
 
-		// 
+		// 填充矩形
 		void FillRect(
 			const Rect& rect
 		);
 
-		// ԲǾ
+		// 填充圆角矩形
 		void FillRoundedRect(
 			const Rect& rect,
 			float radius_x,
 			float radius_y
 		);
 
-		// 伸ͼ
+		// 填充几何图形
 		void FillGeometry(
 			GeometryPtr geo
 		);
 
-		// ʼ·
+		// 开始绘制路径
 		void BeginPath(
-			Point const& begin_pos	/* ·ʼ */
+			Point const& begin_pos	/* 路径起始点 */
 		);
 
-		// ·
+		// 结束路径
 		void EndPath(
-			bool closed = true		/* ·Ƿպ */
+			bool closed = true		/* 路径是否闭合 */
 		);
 
-		// һ߶
+		// 添加一条线段
 		void AddLine(
-			Point const& point		/* ˵ */
+			Point const& point		/* 端点 */
 		);
 
-		// Ӷ߶
+		// 添加多条线段
 		void AddLines(
 			Array<Point> const& points
 		);
 
-		// һη
+		// 添加一条三次方贝塞尔曲线
 		void AddBezier(
-			Point const& point1,	/* ߵĵһƵ */
-			Point const& point2,	/* ߵĵڶƵ */
-			Point const& point3		/* ߵյ */
+			Point const& point1,	/* 贝塞尔曲线的第一个控制点 */
+			Point const& point2,	/* 贝塞尔曲线的第二个控制点 */
+			Point const& point3		/* 贝塞尔曲线的终点 */
 		);
 
-		// ӻ
+		// 添加弧线
 		void AddArc(
-			Point const& point,		/* յ */
-			Point const& radius,	/* Բ뾶 */
-			float rotation,			/* ԲתǶ */
-			bool clockwise = true,	/* ˳ʱ or ʱ */
-			bool is_small = true	/* ǷȡС 180 Ļ */
+			Point const& point,		/* 终点 */
+			Point const& radius,	/* 椭圆半径 */
+			float rotation,			/* 椭圆旋转角度 */
+			bool clockwise = true,	/* 顺时针 or 逆时针 */
+			bool is_small = true	/* 是否取小于 180° 的弧 */
 		);
 
-		// ·
+		// 路径描边
 		void StrokePath();
 
-		// ·
+		// 路径填充
 		void FillPath();
 
-		// ջ
+		// 清空画布
 		void Clear();
 
-		// ɫ
+		// 设置填充颜色
 		void SetFillColor(
 			const Color& color
 		);
 
-		// ɫ
+		// 设置线条颜色
 		void SetStrokeColor(
 			const Color& color
 		);
 
-		// 
+		// 设置线条宽度
 		void SetStrokeWidth(
 			float width
 		);
 
-		// ཻʽ
+		// 设置线条相交样式
 		void SetOutlineJoinStyle(
 			StrokeStyle outline_join
 		);
 
-		// ֻˢʽ
+		// 设置文字画刷样式
 		void SetTextStyle(
 			Font const& font,
 			TextStyle const& text_style
 		);
 
-		// ȡɫ
+		// 获取填充颜色
 		Color GetFillColor() const;
 
-		// ȡɫ
+		// 获取线条颜色
 		Color GetStrokeColor() const;
 
-		// ȡ
+		// 获取线条宽度
 		float GetStrokeWidth() const;
 
-		// 任
+		// 变换画笔
 		void SetBrushTransform(
 			Matrix const& transform
 		);
 
-		// ΪͼƬ
+		// 导出为图片
 		ImagePtr ExportToImage() const;
 
 		void OnRender() override;
@@ -233,7 +233,6 @@ namespace kiwano
 		ComPtr<ID2D1StrokeStyle>		outline_join_style_;
 		ComPtr<ID2D1SolidColorBrush>	fill_brush_;
 		ComPtr<ID2D1SolidColorBrush>	stroke_brush_;
-		ComPtr<IDWriteTextFormat>		text_format_;
 		ComPtr<ITextRenderer>			text_renderer_;
 		ComPtr<ID2D1BitmapRenderTarget>	render_target_;
 
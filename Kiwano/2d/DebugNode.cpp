@@ -21,6 +21,7 @@
 #include "DebugNode.h"
 #include "Text.h"
 #include "../renderer/render.h"
+#include "../platform/Application.h"
 #include <sstream>
 #include <psapi.h>
 
@@ -51,12 +52,9 @@ namespace kiwano
 
 	void DebugNode::OnRender()
 	{
-		Renderer::Instance().SetTransform(Matrix{});
-		Renderer::Instance().GetSolidColorBrush()->SetColor(D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.5f));
-
-		Renderer::Instance().GetDeviceResources()->GetD2DDeviceContext()->FillRectangle(
-			D2D1_RECT_F{ 10, 10, 30 + debug_text_->GetLayoutSize().x, 30 + debug_text_->GetLayoutSize().y },
-			Renderer::Instance().GetSolidColorBrush()
+		Renderer::Instance().FillRectangle(
+			Rect{ 10, 10, 20 + debug_text_->GetLayoutSize().x, 20 + debug_text_->GetLayoutSize().y },
+			Color(0.0f, 0.0f, 0.0f, 0.5f)
 		);
 	}
 
@@ -81,6 +79,23 @@ namespace kiwano
 
 		ss << "Primitives / sec: " << Renderer::Instance().GetStatus().primitives * frame_time_.size() << std::endl;
 
+		ss << "Draw calls: " << Renderer::Instance().GetStatus().draw_calls << std::endl;
+
+		const auto& perform = Application::GetPerformStats();
+		ss << "Main thread tasks: " << perform.performed << " done, " << perform.queued << " queued" << std::endl;
+		ss << "Task drain: " << perform.drain_time.Milliseconds() << "ms, max wait: " << perform.max_latency.Milliseconds() << "ms" << std::endl;
+
+		if (auto device_resources = Renderer::Instance().GetDeviceResources())
+		{
+			const auto text_stats = device_resources->GetTextCache().GetStats();
+			ss << "Text cache: " << text_stats.layout_hits << "/" << text_stats.layout_misses << " layouts, "
+				<< text_stats.outline_hits << "/" << text_stats.outline_misses << " outlines (hit/miss)" << std::endl;
+
+			const auto bitmap_stats = device_resources->GetBitmapCache().GetStats();
+			ss << "Bitmap cache: " << bitmap_stats.count << " bitmaps (" << bitmap_stats.in_use << " in use), " << bitmap_stats.resident_bytes / 1024 << "kb, "
+				<< bitmap_stats.hits << "/" << bitmap_stats.misses << " (hit/miss), " << bitmap_stats.evictions << " evicted" << std::endl;
+		}
+
 		PROCESS_MEMORY_COUNTERS_EX pmc;
 		GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc));
 		ss << "Memory: " << pmc.PrivateUsage / 1024 << "kb";
@@ -23,7 +23,7 @@
 
 namespace kiwano
 {
-	// ϸֵ
+	// 字体粗细值
 	enum FontWeight : unsigned int
 	{
 		Thin = 100,
@@ -37,14 +37,14 @@ namespace kiwano
 		ExtraBlack = 950
 	};
 
-	// 
+	// 字体
 	class Font
 	{
 	public:
-		String			family;		// 
-		float			size;		// ֺ
-		unsigned int	weight;		// ϸֵ
-		bool			italic;		// Ƿб
+		String			family;		// 字体族
+		float			size;		// 字号
+		unsigned int	weight;		// 粗细值
+		bool			italic;		// 是否斜体
 
 	public:
 		Font(
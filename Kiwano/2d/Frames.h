@@ -23,7 +23,7 @@
 
 namespace kiwano
 {
-	// ֡
+	// 序列帧
 	class KGE_API Frames
 		: public virtual Object
 	{
@@ -31,28 +31,28 @@ namespace kiwano
 		Frames();
 
 		explicit Frames(
-			Array<ImagePtr> const& frames	/* ֡ */
+			Array<ImagePtr> const& frames	/* 序列帧 */
 		);
 
 		virtual ~Frames();
 
-		// ӹؼ֡
+		// 添加关键帧
 		void Add(
 			ImagePtr frame
 		);
 
-		// Ӷؼ֡
+		// 添加多个关键帧
 		void Add(
 			Array<ImagePtr> const& frames
 		);
 
-		// ȡؼ֡
+		// 获取关键帧
 		Array<ImagePtr> const& GetFrames() const;
 
-		// ȡ֡Ŀ
+		// 获取帧动画的拷贝对象
 		FramesPtr Clone() const;
 
-		// ȡ֡ĵת
+		// 获取帧动画的倒转
 		FramesPtr Reverse() const;
 
 	protected:
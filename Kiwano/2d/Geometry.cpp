@@ -24,6 +24,16 @@
 
 namespace kiwano
 {
+	namespace
+	{
+		// the renderer may not be set up yet
+		ID2D1Factory1* GetFactory()
+		{
+			auto device_resources = Renderer::Instance().GetDeviceResources();
+			return device_resources ? device_resources->GetD2DFactory() : nullptr;
+		}
+	}
+
 	//-------------------------------------------------------
 	// Geometry
 	//-------------------------------------------------------
@@ -128,7 +138,11 @@ namespace kiwano
 		ComPtr<ID2D1PathGeometry> path_geo;
 		ComPtr<ID2D1GeometrySink> path_sink;
 
-		HRESULT hr = Renderer::Instance().GetDeviceResources()->GetD2DFactory()->CreatePathGeometry(&path_geo);
+		auto factory = GetFactory();
+		if (!factory)
+			return;
+
+		HRESULT hr = factory->CreatePathGeometry(&path_geo);
 
 		if (SUCCEEDED(hr))
 		{
@@ -185,7 +199,9 @@ namespace kiwano
 	void RectangleGeometry::SetRect(Rect const & rect)
 	{
 		ComPtr<ID2D1RectangleGeometry> geo;
-		auto factory = Renderer::Instance().GetDeviceResources()->GetD2DFactory();
+		auto factory = GetFactory();
+		if (!factory)
+			return;
 
 		if (SUCCEEDED(factory->CreateRectangleGeometry(DX::ConvertToRectF(rect), &geo)))
 		{
@@ -226,7 +242,9 @@ namespace kiwano
 	void CircleGeometry::SetCircle(Point const & center, float radius)
 	{
 		ComPtr<ID2D1EllipseGeometry> geo;
-		auto factory = Renderer::Instance().GetDeviceResources()->GetD2DFactory();
+		auto factory = GetFactory();
+		if (!factory)
+			return;
 
 		if (SUCCEEDED(factory->CreateEllipseGeometry(
 			D2D1::Ellipse(
@@ -274,7 +292,9 @@ namespace kiwano
 	void EllipseGeometry::SetEllipse(Point const & center, float radius_x, float radius_y)
 	{
 		ComPtr<ID2D1EllipseGeometry> geo;
-		auto factory = Renderer::Instance().GetDeviceResources()->GetD2DFactory();
+		auto factory = GetFactory();
+		if (!factory)
+			return;
 
 		if (SUCCEEDED(factory->CreateEllipseGeometry(
 			D2D1::Ellipse(
@@ -306,7 +326,9 @@ namespace kiwano
 	{
 		current_geometry_ = nullptr;
 
-		auto factory = Renderer::Instance().GetDeviceResources()->GetD2DFactory();
+		auto factory = GetFactory();
+		if (!factory)
+			return;
 
 		ThrowIfFailed(
 			factory->CreatePathGeometry(&current_geometry_)
@@ -422,7 +444,9 @@ namespace kiwano
 	void RoundedRectGeometry::SetRoundedRect(Rect const & rect, float radius_x, float radius_y)
 	{
 		ComPtr<ID2D1RoundedRectangleGeometry> geo;
-		auto factory = Renderer::Instance().GetDeviceResources()->GetD2DFactory();
+		auto factory = GetFactory();
+		if (!factory)
+			return;
 
 		if (SUCCEEDED(factory->CreateRoundedRectangleGeometry(
 			D2D1::RoundedRect(
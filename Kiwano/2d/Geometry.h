@@ -24,7 +24,7 @@
 
 namespace kiwano
 {
-	// γ
+	// 几何抽象
 	class KGE_API Geometry
 		: public virtual Object
 	{
@@ -36,25 +36,25 @@ namespace kiwano
 
 		virtual ~Geometry();
 
-		// ȡаΧ
+		// 获取外切包围盒
 		Rect GetBoundingBox();
 
-		// жͼǷ
+		// 判断图形是否包含点
 		bool ContainsPoint(
 			Point const& point
 		);
 
-		// ȡͼչһֱߵĳ
+		// 获取图形展开成一条直线的长度
 		float GetLength();
 
-		// ͼ·ϵλú
+		// 计算图形路径上点的位置和切线向量
 		bool ComputePointAt(
 			float length,
 			Point* point,
 			Point* tangent
 		);
 
-		// 
+		// 计算面积
 		float ComputeArea();
 
 	protected:
@@ -62,7 +62,7 @@ namespace kiwano
 	};
 
 
-	// ֱ
+	// 直线
 	class KGE_API LineGeometry
 		: public Geometry
 	{
@@ -99,7 +99,7 @@ namespace kiwano
 	};
 
 
-	// ξ
+	// 几何矩形
 	class KGE_API RectangleGeometry
 		: public Geometry
 	{
@@ -126,7 +126,7 @@ namespace kiwano
 	};
 
 
-	// Բ
+	// 几何圆形
 	class KGE_API CircleGeometry
 		: public Geometry
 	{
@@ -163,7 +163,7 @@ namespace kiwano
 	};
 
 
-	// Բ
+	// 几何椭圆
 	class KGE_API EllipseGeometry
 		: public Geometry
 	{
@@ -206,7 +206,7 @@ namespace kiwano
 	};
 
 
-	// ·
+	// 几何路径
 	class KGE_API PathGeometry
 		: public Geometry
 	{
@@ -215,43 +215,43 @@ namespace kiwano
 
 		virtual ~PathGeometry();
 
-		// ʼ·
+		// 开始添加路径
 		void BeginPath(
-			Point const& begin_pos = Point{}	/* ʼ */
+			Point const& begin_pos = Point{}	/* 起始点 */
 		);
 
-		// ·
+		// 结束路径
 		void EndPath(
-			bool closed = true		/* ·Ƿպ */
+			bool closed = true		/* 路径是否闭合 */
 		);
 
-		// һ߶
+		// 添加一条线段
 		void AddLine(
-			Point const& point		/* ˵ */
+			Point const& point		/* 端点 */
 		);
 
-		// Ӷ߶
+		// 添加多条线段
 		void AddLines(
 			Array<Point> const& points
 		);
 
-		// һη
+		// 添加一条三次方贝塞尔曲线
 		void AddBezier(
-			Point const& point1,	/* ߵĵһƵ */
-			Point const& point2,	/* ߵĵڶƵ */
-			Point const& point3		/* ߵյ */
+			Point const& point1,	/* 贝塞尔曲线的第一个控制点 */
+			Point const& point2,	/* 贝塞尔曲线的第二个控制点 */
+			Point const& point3		/* 贝塞尔曲线的终点 */
 		);
 
-		// ӻ
+		// 添加弧线
 		void AddArc(
-			Point const& point,		/* յ */
-			Size const& radius,		/* Բ뾶 */
-			float rotation,			/* ԲתǶ */
-			bool clockwise = true,	/* ˳ʱ or ʱ */
-			bool is_small = true	/* ǷȡС 180 Ļ */
+			Point const& point,		/* 终点 */
+			Size const& radius,		/* 椭圆半径 */
+			float rotation,			/* 椭圆旋转角度 */
+			bool clockwise = true,	/* 顺时针 or 逆时针 */
+			bool is_small = true	/* 是否取小于 180° 的弧 */
 		);
 
-		// ·
+		// 清除路径
 		void ClearPath();
 
 	protected:
@@ -260,7 +260,7 @@ namespace kiwano
 	};
 
 
-	// ԲǾ
+	// 几何圆角矩形
 	class KGE_API RoundedRectGeometry
 		: public Geometry
 	{
@@ -24,7 +24,7 @@
 
 namespace kiwano
 {
-	// ͼ
+	// 几何图形
 	class KGE_API GeometryNode
 		: public VisualNode
 	{
@@ -37,44 +37,44 @@ namespace kiwano
 
 		virtual ~GeometryNode();
 
-		// ״
+		// 设置形状
 		void SetGeometry(
 			GeometryPtr geometry
 		);
 
-		// ɫ
+		// 设置填充颜色
 		void SetFillColor(
 			const Color& color
 		);
 
-		// ɫ
+		// 设置线条颜色
 		void SetStrokeColor(
 			const Color& color
 		);
 
-		// 
+		// 设置线条宽度
 		void SetStrokeWidth(
 			float width
 		);
 
-		// ཻʽ
+		// 设置线条相交样式
 		void SetOutlineJoinStyle(
 			StrokeStyle outline_join
 		);
 
-		// ȡ״
+		// 获取形状
 		GeometryPtr GetGeometry() const { return geometry_; }
 
-		// ȡɫ
+		// 获取填充颜色
 		Color GetFillColor() const { return fill_color_; }
 
-		// ȡɫ
+		// 获取线条颜色
 		Color GetStrokeColor() const { return stroke_color_; }
 
-		// ȡ
+		// 获取线条宽度
 		float GetStrokeWidth() const { return stroke_width_; }
 
-		// ȡཻʽ
+		// 获取线条相交样式
 		StrokeStyle SetOutlineJoinStyle() const { return outline_join_; }
 
 		void OnRender() override;
@@ -291,7 +291,7 @@ namespace kiwano
 
 			if (SUCCEEDED(hr))
 			{
-				// һǿӳ
+				// 插入一个强制延迟
 				if (frame_delay < 90)
 				{
 					frame_delay = 90;
@@ -317,7 +317,7 @@ namespace kiwano
 			}
 			else
 			{
-				// ȡ DisposalType ʧܣͼƬֻһ֡ͼƬ
+				// 获取 DisposalType 失败，可能图片是只有一帧的图片
 				disposal_type_ = DisposalType::Unknown;
 			}
 		}
@@ -336,7 +336,7 @@ namespace kiwano
 
 		ComPtr<IWICMetadataQueryReader> metadata_reader;
 
-		// ȡ֡
+		// 获取帧数量
 		HRESULT hr = decoder_->GetFrameCount(&frames_count_);
 
 		if (SUCCEEDED(hr))
@@ -347,18 +347,18 @@ namespace kiwano
 
 		if (SUCCEEDED(hr))
 		{
-			// ȡɫ
+			// 获取背景色
 			if (FAILED(GetBackgroundColor(metadata_reader.Get())))
 			{
-				// δܻɫĬΪ͸
+				// 如果未能获得颜色，则默认为透明
 				bg_color_ = D2D1::ColorF(0, 0.f);
 			}
 		}
 
-		// ȡȫ frame С
+		// 获取全局 frame 大小
 		if (SUCCEEDED(hr))
 		{
-			// ȡ
+			// 获取宽度
 			hr = metadata_reader->GetMetadataByName(
 				L"/logscrdesc/Width",
 				&prop_val);
@@ -376,7 +376,7 @@ namespace kiwano
 
 		if (SUCCEEDED(hr))
 		{
-			// ȡ߶
+			// 获取高度
 			hr = metadata_reader->GetMetadataByName(
 				L"/logscrdesc/Height",
 				&prop_val);
@@ -394,7 +394,7 @@ namespace kiwano
 
 		if (SUCCEEDED(hr))
 		{
-			// ݺ
+			// 获得像素纵横比
 			hr = metadata_reader->GetMetadataByName(
 				L"/logscrdesc/PixelAspectRatio",
 				&prop_val);
@@ -406,11 +406,11 @@ namespace kiwano
 				{
 					if (prop_val.bVal != 0)
 					{
-						// Ҫ
-						//  14 41Ϊ 1/64
+						// 需要计算比率
+						// 最高像素 1：4，最宽像素 4：1，增量为 1/64
 						float pixel_asp_ratio = (prop_val.bVal + 15.f) / 64.f;
 
-						// سȼеͼȺ͸߶ȣֻСͼ
+						// 根据像素长宽比计算像素中的图像宽度和高度，只缩小图像
 						if (pixel_asp_ratio > 1.f)
 						{
 							width_in_pixels_ = width;
@@ -424,7 +424,7 @@ namespace kiwano
 					}
 					else
 					{
-						// ֵΪ 0, رΪ 1
+						// 值为 0, 所以像素比为 1
 						width_in_pixels_ = width;
 						height_in_pixels_ = height;
 					}
@@ -445,7 +445,7 @@ namespace kiwano
 
 		if (frame_rt_)
 		{
-			// ҵӳٴ 0 ֡ (0 ӳ֡ǲɼм֡)
+			// 找到延迟大于 0 的帧 (0 延迟帧是不可见的中间帧)
 			do
 			{
 				hr = DisposeCurrentFrame();
@@ -470,11 +470,11 @@ namespace kiwano
 		case DisposalType::None:
 			break;
 		case DisposalType::Background:
-			// ñɫǰԭʼ֡ǵ
+			// 用背景颜色清除当前原始帧覆盖的区域
 			hr = ClearCurrentFrameArea();
 			break;
 		case DisposalType::Previous:
-			// ָǰͼ֡
+			// 恢复先前构图的帧
 			hr = RestoreSavedFrame();
 			break;
 		default:
@@ -500,7 +500,7 @@ namespace kiwano
 
 			if (next_index_ == 0)
 			{
-				// »Ʊ
+				// 重新绘制背景
 				frame_rt_->Clear(bg_color_);
 
 				loop_count_++;
@@ -645,7 +645,7 @@ namespace kiwano
 
 		if (SUCCEEDED(hr))
 		{
-			// ±
+			// 检查下标
 			hr = (bg_index >= colors_copied) ? E_FAIL : S_OK;
 		}
 
@@ -653,7 +653,7 @@ namespace kiwano
 		{
 			bgcolor = bgcolors[bg_index];
 
-			// תΪ ARGB ʽ
+			// 转换为 ARGB 格式
 			float alpha = (bgcolor >> 24) / 255.f;
 			bg_color_ = D2D1::ColorF(bgcolor, alpha);
 		}
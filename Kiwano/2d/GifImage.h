@@ -42,16 +42,16 @@ namespace kiwano
 			Resource const& res
 		);
 
-		//  GIF ѭ
+		// 设置 GIF 动画循环次数
 		inline void SetLoopCount(int loops)								{ total_loop_count_ = loops; }
 
-		//  GIF ÿѭص
+		// 设置 GIF 动画每次循环结束回调函数
 		inline void SetLoopDoneCallback(LoopDoneCallback const& cb)		{ loop_cb_ = cb; }
 
-		//  GIF ص
+		// 设置 GIF 动画结束回调函数
 		inline void SetDoneCallback(DoneCallback const& cb)				{ done_cb_ = cb; }
 
-		// ²Ŷ
+		// 重新播放动画
 		void Restart();
 
 		inline int GetFramesCount() const								{ return static_cast<int>(frames_count_); }
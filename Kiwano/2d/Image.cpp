@@ -27,7 +27,10 @@ namespace kiwano
 {
 	Image::Image()
 		: bitmap_(nullptr)
+		, region_()
 		, crop_rect_()
+		, cache_key_(0)
+		, cache_retained_(false)
 	{
 	}
 
@@ -50,8 +53,25 @@ namespace kiwano
 		SetBitmap(bitmap);
 	}
 
+	Image::Image(ComPtr<ID2D1Bitmap> const & bitmap, Rect const& region)
+		: Image()
+	{
+		SetBitmap(bitmap);
+
+		if (bitmap_)
+		{
+			auto bitmap_size = bitmap_->GetSize();
+			region_.origin.x = std::min(std::max(region.origin.x, 0.f), bitmap_size.width);
+			region_.origin.y = std::min(std::max(region.origin.y, 0.f), bitmap_size.height);
+			region_.size.x = std::min(std::max(region.size.x, 0.f), bitmap_size.width - region_.origin.x);
+			region_.size.y = std::min(std::max(region.size.y, 0.f), bitmap_size.height - region_.origin.y);
+			crop_rect_ = Rect{ Point{}, region_.size };
+		}
+	}
+
 	Image::~Image()
 	{
+		ReleaseCachedBitmap();
 	}
 
 	bool Image::Load(Resource const& res)
@@ -59,6 +79,13 @@ namespace kiwano
 		HRESULT hr = S_OK;
 		ComPtr<ID2D1Bitmap> bitmap;
 
+		auto device_resources = Renderer::Instance().GetDeviceResources();
+		if (!device_resources)
+		{
+			KGE_WARNING_LOG(L"Load image failed, the renderer is not set up");
+			return false;
+		}
+
 		if (res.IsFileType())
 		{
 			if (!modules::Shlwapi::Get().PathFileExistsW(res.GetFileName().c_str()))
@@ -66,11 +93,11 @@ namespace kiwano
 				KGE_WARNING_LOG(L"Image file '%s' not found!", res.GetFileName().c_str());
 				return false;
 			}
-			hr = Renderer::Instance().GetDeviceResources()->CreateBitmapFromFile(bitmap, res.GetFileName());
+			hr = device_resources->CreateBitmapFromFile(bitmap, res.GetFileName());
 		}
 		else
 		{
-			hr = Renderer::Instance().GetDeviceResources()->CreateBitmapFromResource(bitmap, res);
+			hr = device_resources->CreateBitmapFromResource(bitmap, res);
 		}
 
 		if (FAILED(hr))
@@ -79,7 +106,12 @@ namespace kiwano
 			return false;
 		}
 
+		ReleaseCachedBitmap();
 		SetBitmap(bitmap);
+
+		// keep the cache from evicting the bitmap while this image holds it
+		cache_key_ = res.GetHashCode();
+		cache_retained_ = device_resources->GetBitmapCache().Retain(cache_key_, bitmap.Get());
 		return true;
 	}
 
@@ -92,11 +124,12 @@ namespace kiwano
 	{
 		if (bitmap_)
 		{
-			auto bitmap_size = bitmap_->GetSize();
-			crop_rect_.origin.x = std::min(std::max(crop_rect.origin.x, 0.f), bitmap_size.width);
-			crop_rect_.origin.y = std::min(std::max(crop_rect.origin.y, 0.f), bitmap_size.height);
-			crop_rect_.size.x = std::min(std::max(crop_rect.size.x, 0.f), bitmap_size.width - crop_rect.origin.x);
-			crop_rect_.size.y = std::min(std::max(crop_rect.size.y, 0.f), bitmap_size.height - crop_rect.origin.y);
+			// the crop rect is relative to the region of the image
+			auto const& size = region_.size;
+			crop_rect_.origin.x = std::min(std::max(crop_rect.origin.x, 0.f), size.x);
+			crop_rect_.origin.y = std::min(std::max(crop_rect.origin.y, 0.f), size.y);
+			crop_rect_.size.x = std::min(std::max(crop_rect.size.x, 0.f), size.x - crop_rect.origin.x);
+			crop_rect_.size.y = std::min(std::max(crop_rect.size.y, 0.f), size.y - crop_rect.origin.y);
 		}
 	}
 
@@ -117,30 +150,17 @@ namespace kiwano
 
 	float Image::GetSourceWidth() const
 	{
-		if (bitmap_)
-		{
-			return bitmap_->GetSize().width;
-		}
-		return 0;
+		return region_.size.x;
 	}
 
 	float Image::GetSourceHeight() const
 	{
-		if (bitmap_)
-		{
-			return bitmap_->GetSize().height;
-		}
-		return 0;
+		return region_.size.y;
 	}
 
 	Size Image::GetSourceSize() const
 	{
-		if (bitmap_)
-		{
-			auto bitmap_size = bitmap_->GetSize();
-			return Size{ bitmap_size.width, bitmap_size.height };
-		}
-		return Size{};
+		return region_.size;
 	}
 
 	float Image::GetCropX() const
@@ -163,6 +183,11 @@ namespace kiwano
 		return crop_rect_;
 	}
 
+	Rect Image::GetBitmapRect() const
+	{
+		return Rect{ region_.origin + crop_rect_.origin, crop_rect_.size };
+	}
+
 	ComPtr<ID2D1Bitmap> const& Image::GetBitmap() const
 	{
 		return bitmap_;
@@ -172,10 +197,32 @@ namespace kiwano
 	{
 		if (bitmap)
 		{
+			if (bitmap != bitmap_)
+			{
+				// the cache entry belongs to the previous bitmap
+				ReleaseCachedBitmap();
+				cache_key_ = 0;
+			}
+
 			bitmap_ = bitmap;
 			crop_rect_.origin.x = crop_rect_.origin.y = 0;
 			crop_rect_.size.x = bitmap_->GetSize().width;
 			crop_rect_.size.y = bitmap_->GetSize().height;
+			region_ = crop_rect_;
+		}
+	}
+
+	void Image::ReleaseCachedBitmap()
+	{
+		if (cache_retained_)
+		{
+			cache_retained_ = false;
+
+			// the cache is gone with the renderer
+			if (auto device_resources = Renderer::Instance().GetDeviceResources())
+			{
+				device_resources->GetBitmapCache().Release(cache_key_, bitmap_.Get());
+			}
 		}
 	}
 
@@ -25,7 +25,7 @@
 
 namespace kiwano
 {
-	// ͼƬ
+	// 图片
 	class KGE_API Image
 		: public virtual Object
 	{
@@ -38,58 +38,67 @@ namespace kiwano
 
 		explicit Image(
 			Resource const& res,
-			Rect const& crop_rect	/* ü */
+			Rect const& crop_rect	/* 裁剪矩形 */
 		);
 
 		explicit Image(
 			ComPtr<ID2D1Bitmap> const& bitmap
 		);
 
+		// 使用位图的一部分作为图片, 如图集页面上的一个区域
+		explicit Image(
+			ComPtr<ID2D1Bitmap> const& bitmap,
+			Rect const& region		/* 图片在位图中的区域 */
+		);
+
 		virtual ~Image();
 
-		// ͼƬԴ
+		// 加载图片资源
 		bool Load(
 			Resource const& res
 		);
 
-		// ԴǷЧ
+		// 资源是否有效
 		bool IsValid() const;
 
-		// ͼƬüΪ
+		// 将图片裁剪为矩形
 		void Crop(
-			Rect const& crop_rect	/* ü */
+			Rect const& crop_rect	/* 裁剪矩形 */
 		);
 
-		// ȡ
+		// 获取宽度
 		float GetWidth() const;
 
-		// ȡ߶
+		// 获取高度
 		float GetHeight() const;
 
-		// ȡС
+		// 获取大小
 		Size GetSize() const;
 
-		// ȡԴͼƬ
+		// 获取源图片宽度
 		float GetSourceWidth() const;
 
-		// ȡԴͼƬ߶
+		// 获取源图片高度
 		float GetSourceHeight() const;
 
-		// ȡԴͼƬС
+		// 获取源图片大小
 		Size GetSourceSize() const;
 
-		// ȡüλ X 
+		// 获取裁剪位置 X 坐标
 		float GetCropX() const;
 
-		// ȡüλ Y 
+		// 获取裁剪位置 Y 坐标
 		float GetCropY() const;
 
-		// ȡüλ
+		// 获取裁剪位置
 		Point GetCropPos() const;
 
-		// ȡü
+		// 获取裁剪矩形
 		Rect GetCropRect() const;
 
+		// 获取裁剪矩形在位图中的位置
+		Rect GetBitmapRect() const;
+
 		ComPtr<ID2D1Bitmap> const& GetBitmap() const;
 
 	protected:
@@ -97,8 +106,14 @@ namespace kiwano
 			ComPtr<ID2D1Bitmap> const& bitmap
 		);
 
+		// 释放从位图缓存中取得的位图
+		void ReleaseCachedBitmap();
+
 	protected:
+		Rect region_;
 		Rect crop_rect_;
 		ComPtr<ID2D1Bitmap>	bitmap_;
+		size_t cache_key_;
+		bool cache_retained_;
 	};
 }
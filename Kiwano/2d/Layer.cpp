@@ -50,6 +50,9 @@ namespace kiwano
 		if (!IsVisible())
 			return;
 
+		if (!(subtree_mask_ & GetEventMask(evt.type)))
+			return;
+
 		if (!swallow_)
 		{
 			NodePtr prev;
@@ -40,9 +40,12 @@ namespace kiwano
 		virtual void OnKeyUp(int key) {}
 		virtual void OnChar(char c) {}
 
-		// ûϢ
+		// 吞没消息
 		inline void SetSwallowEvents(bool enabled) { swallow_ = enabled; }
 
+		// 是否吞没消息
+		inline bool IsSwallowEventsEnabled() const { return swallow_; }
+
 	public:
 		void Dispatch(Event& evt) override;
 
@@ -30,6 +30,9 @@ namespace kiwano
 	{
 		float default_anchor_x = 0.f;
 		float default_anchor_y = 0.f;
+
+		// all kinds of mouse events
+		const UINT mouse_event_mask = ((1u << Event::MouseLast) - 1) & ~((1u << (Event::MouseFirst + 1)) - 1);
 	}
 
 	void Node::SetDefaultAnchor(float anchor_x, float anchor_y)
@@ -41,6 +44,7 @@ namespace kiwano
 	Node::Node()
 		: visible_(true)
 		, update_pausing_(false)
+		, batch_reorder_(false)
 		, hover_(false)
 		, pressed_(false)
 		, responsible_(false)
@@ -48,11 +52,14 @@ namespace kiwano
 		, dirty_transform_inverse_(false)
 		, parent_(nullptr)
 		, scene_(nullptr)
-		, hash_name_(0)
 		, z_order_(0)
+		, subtree_mask_(0)
 		, opacity_(1.f)
 		, display_opacity_(1.f)
 		, anchor_(default_anchor_x, default_anchor_y)
+		, storage_(nullptr)
+		, storage_handle_(NodeStorage::InvalidHandle)
+		, spatial_index_(nullptr)
 	{
 	}
 
@@ -91,28 +98,37 @@ namespace kiwano
 		{
 			PrepareRender();
 			OnRender();
+			return;
 		}
-		else
+
+		if (batch_reorder_)
 		{
-			// render children those are less than 0 in Z-Order
-			Node* child = children_.First().Get();
-			while (child)
-			{
-				if (child->GetZOrder() >= 0)
-					break;
+			Renderer::Instance().GetCommandList().BeginReorder();
+		}
 
-				child->Render();
-				child = child->NextItem().Get();
-			}
+		// render children those are less than 0 in Z-Order
+		Node* child = children_.First().Get();
+		while (child)
+		{
+			if (child->GetZOrder() >= 0)
+				break;
 
-			PrepareRender();
-			OnRender();
+			child->Render();
+			child = child->NextItem().Get();
+		}
 
-			while (child)
-			{
-				child->Render();
-				child = child->NextItem().Get();
-			}
+		PrepareRender();
+		OnRender();
+
+		while (child)
+		{
+			child->Render();
+			child = child->NextItem().Get();
+		}
+
+		if (batch_reorder_)
+		{
+			Renderer::Instance().GetCommandList().EndReorder();
 		}
 	}
 
@@ -121,6 +137,10 @@ namespace kiwano
 		if (!visible_)
 			return;
 
+		// no one in this subtree is interested in the event
+		if (!(subtree_mask_ & GetEventMask(evt.type)))
+			return;
+
 		NodePtr prev;
 		for (auto child = children_.Last(); child; child = prev)
 		{
@@ -128,7 +148,8 @@ namespace kiwano
 			child->Dispatch(evt);
 		}
 
-		if (responsible_ && MouseEvent::Check(evt.type))
+		// hover and click are handled by the scene if it has a spatial index
+		if (responsible_ && !spatial_index_ && MouseEvent::Check(evt.type))
 		{
 			if (evt.type == Event::MouseMove)
 			{
@@ -179,12 +200,18 @@ namespace kiwano
 
 	Matrix const & Node::GetTransformMatrix()  const
 	{
+		if (storage_)
+			return storage_->GetTransformMatrix(storage_handle_);
+
 		UpdateTransform();
 		return transform_matrix_;
 	}
 
 	Matrix const & Node::GetTransformInverseMatrix()  const
 	{
+		if (storage_)
+			return storage_->GetTransformInverseMatrix(storage_handle_);
+
 		UpdateTransform();
 		if (dirty_transform_inverse_)
 		{
@@ -196,6 +223,13 @@ namespace kiwano
 
 	void Node::UpdateTransform() const
 	{
+		if (storage_)
+		{
+			// dirty nodes of the whole tree are updated in one pass
+			storage_->Update();
+			return;
+		}
+
 		if (!dirty_transform_)
 			return;
 
@@ -217,6 +251,12 @@ namespace kiwano
 
 	void Node::UpdateOpacity()
 	{
+		if (storage_)
+		{
+			storage_->SetOpacity(storage_handle_, opacity_);
+			return;
+		}
+
 		if (parent_)
 		{
 			display_opacity_ = opacity_ * parent_->display_opacity_;
@@ -227,6 +267,109 @@ namespace kiwano
 		}
 	}
 
+	float Node::GetDisplayOpacity() const
+	{
+		if (storage_)
+			return storage_->GetDisplayOpacity(storage_handle_);
+		return display_opacity_;
+	}
+
+	void Node::MarkTransformDirty()
+	{
+		dirty_transform_ = true;
+
+		if (storage_)
+			storage_->SetTransform(storage_handle_, transform_, anchor_, size_);
+
+		if (spatial_index_)
+			spatial_index_->MarkDirty(this);
+	}
+
+	void Node::AttachStorage(NodeStorage* storage)
+	{
+		if (storage_ == storage)
+			return;
+
+		DetachStorage();
+
+		if (!storage)
+			return;
+
+		storage_ = storage;
+		storage_handle_ = storage->Allocate(this);
+
+		if (parent_ && parent_->storage_ == storage)
+			storage->SetParent(storage_handle_, parent_->storage_handle_);
+
+		storage->SetTransform(storage_handle_, transform_, anchor_, size_);
+		storage->SetOpacity(storage_handle_, opacity_);
+
+		for (Node* child = children_.First().Get(); child; child = child->NextItem().Get())
+		{
+			child->AttachStorage(storage);
+		}
+	}
+
+	void Node::DetachStorage()
+	{
+		if (!storage_)
+			return;
+
+		for (Node* child = children_.First().Get(); child; child = child->NextItem().Get())
+		{
+			child->DetachStorage();
+		}
+
+		storage_->Free(storage_handle_);
+		storage_ = nullptr;
+		storage_handle_ = NodeStorage::InvalidHandle;
+
+		// fall back to lazy per-node updating
+		dirty_transform_ = true;
+		display_opacity_ = parent_ ? (opacity_ * parent_->GetDisplayOpacity()) : opacity_;
+	}
+
+	void Node::AttachSpatialIndex(SpatialIndex* index)
+	{
+		if (spatial_index_ == index)
+			return;
+
+		DetachSpatialIndex();
+
+		if (!index)
+			return;
+
+		spatial_index_ = index;
+
+		if (responsible_)
+			index->Insert(this);
+
+		for (Node* child = children_.First().Get(); child; child = child->NextItem().Get())
+		{
+			child->AttachSpatialIndex(index);
+		}
+		subtree_mask_ = ComputeSubtreeMask();
+	}
+
+	void Node::DetachSpatialIndex()
+	{
+		if (!spatial_index_)
+			return;
+
+		for (Node* child = children_.First().Get(); child; child = child->NextItem().Get())
+		{
+			child->DetachSpatialIndex();
+		}
+
+		spatial_index_->Remove(this);
+		spatial_index_ = nullptr;
+		subtree_mask_ = ComputeSubtreeMask();
+
+		// hover state was tracked by the index
+		hover_ = false;
+		pressed_ = false;
+	}
+
 	void Node::SetScene(Scene* scene)
 	{
 		if (scene && scene_ != scene)
@@ -306,7 +449,7 @@ namespace kiwano
 
 		anchor_.x = anchor_x;
 		anchor_.y = anchor_y;
-		dirty_transform_ = true;
+		MarkTransformDirty();
 	}
 
 	void Node::SetAnchor(Point const& anchor)
@@ -336,13 +479,13 @@ namespace kiwano
 
 		size_.x = width;
 		size_.y = height;
-		dirty_transform_ = true;
+		MarkTransformDirty();
 	}
 
 	void Node::SetTransform(Transform const& transform)
 	{
 		transform_ = transform;
-		dirty_transform_ = true;
+		MarkTransformDirty();
 	}
 
 	void Node::SetVisible(bool val)
@@ -350,15 +493,6 @@ namespace kiwano
 		visible_ = val;
 	}
 
-	void Node::SetName(String const& name)
-	{
-		if (!IsName(name))
-		{
-			Object::SetName(name);
-			hash_name_ = std::hash<String>{}(name);
-		}
-	}
-
 	void Node::SetPositionX(float x)
 	{
 		this->SetPosition(x, transform_.position.y);
@@ -381,7 +515,7 @@ namespace kiwano
 
 		transform_.position.x = x;
 		transform_.position.y = y;
-		dirty_transform_ = true;
+		MarkTransformDirty();
 	}
 
 	void Node::Move(float x, float y)
@@ -416,7 +550,7 @@ namespace kiwano
 
 		transform_.scale.x = scale_x;
 		transform_.scale.y = scale_y;
-		dirty_transform_ = true;
+		MarkTransformDirty();
 	}
 
 	void Node::SetScale(Point const& scale)
@@ -441,7 +575,7 @@ namespace kiwano
 
 		transform_.skew.x = skew_x;
 		transform_.skew.y = skew_y;
-		dirty_transform_ = true;
+		MarkTransformDirty();
 	}
 
 	void Node::SetSkew(Point const& skew)
@@ -455,7 +589,7 @@ namespace kiwano
 			return;
 
 		transform_.rotation = angle;
-		dirty_transform_ = true;
+		MarkTransformDirty();
 	}
 
 	void Node::AddChild(NodePtr child)
@@ -478,9 +612,13 @@ namespace kiwano
 			children_.PushBack(child);
 			child->parent_ = this;
 			child->SetScene(this->scene_);
+			child->AttachStorage(this->storage_);
+			child->AttachSpatialIndex(this->spatial_index_);
 			child->dirty_transform_ = true;
 			child->UpdateOpacity();
 			child->Reorder();
+
+			AddSubtreeMask(child->subtree_mask_);
 		}
 	}
 
@@ -505,11 +643,14 @@ namespace kiwano
 	Array<NodePtr> Node::GetChildren(String const& name) const
 	{
 		Array<NodePtr> children;
-		size_t hash_code = std::hash<String>{}(name);
+
+		StringAtom atom;
+		if (!StringAtom::find(name, atom) || atom.empty())
+			return children;
 
 		for (Node* child = children_.First().Get(); child; child = child->NextItem().Get())
 		{
-			if (child->hash_name_ == hash_code && child->IsName(name))
+			if (child->IsName(atom))
 			{
 				children.push_back(child);
 			}
@@ -519,11 +660,13 @@ namespace kiwano
 
 	NodePtr Node::GetChild(String const& name) const
 	{
-		size_t hash_code = std::hash<String>{}(name);
+		StringAtom atom;
+		if (!StringAtom::find(name, atom) || atom.empty())
+			return nullptr;
 
 		for (Node* child = children_.First().Get(); child; child = child->NextItem().Get())
 		{
-			if (child->hash_name_ == hash_code && child->IsName(name))
+			if (child->IsName(atom))
 			{
 				return child;
 			}
@@ -558,9 +701,17 @@ namespace kiwano
 
 		if (child)
 		{
+			// the list may hold the last reference, read the mask before removing
+			const bool has_listeners = child->subtree_mask_ != 0;
+
+			child->DetachStorage();
+			child->DetachSpatialIndex();
 			child->parent_ = nullptr;
 			if (child->scene_) child->SetScene(nullptr);
 			children_.Remove(NodePtr(child));
+
+			if (has_listeners)
+				UpdateSubtreeMask();
 		}
 	}
 
@@ -571,14 +722,16 @@ namespace kiwano
 			return;
 		}
 
-		size_t hash_code = std::hash<String>{}(child_name);
+		StringAtom atom;
+		if (!StringAtom::find(child_name, atom) || atom.empty())
+			return;
 
 		Node* next;
 		for (Node* child = children_.First().Get(); child; child = next)
 		{
 			next = child->NextItem().Get();
 
-			if (child->hash_name_ == hash_code && child->IsName(child_name))
+			if (child->IsName(atom))
 			{
 				RemoveChild(child);
 			}
@@ -587,12 +740,71 @@ namespace kiwano
 
 	void Node::RemoveAllChildren()
 	{
+		for (Node* child = children_.First().Get(); child; child = child->NextItem().Get())
+		{
+			child->DetachStorage();
+			child->DetachSpatialIndex();
+		}
 		children_.Clear();
+		UpdateSubtreeMask();
 	}
 
 	void Node::SetResponsible(bool enable)
 	{
-		responsible_ = enable;
+		if (responsible_ != enable)
+		{
+			responsible_ = enable;
+
+			if (spatial_index_)
+			{
+				if (responsible_)
+					spatial_index_->Insert(this);
+				else
+					spatial_index_->Remove(this);
+			}
+			UpdateSubtreeMask();
+		}
+	}
+
+	void Node::OnListenerMaskChanged()
+	{
+		UpdateSubtreeMask();
+	}
+
+	UINT Node::ComputeSubtreeMask() const
+	{
+		UINT mask = GetListenerMask();
+
+		// responsible nodes track mouse events to generate hover, out and click
+		if (responsible_ && !spatial_index_)
+			mask |= mouse_event_mask;
+
+		for (Node* child = children_.First().Get(); child; child = child->NextItem().Get())
+			mask |= child->subtree_mask_;
+		return mask;
+	}
+
+	void Node::UpdateSubtreeMask()
+	{
+		const UINT mask = ComputeSubtreeMask();
+		const UINT old_mask = subtree_mask_;
+		subtree_mask_ = mask;
+
+		if (parent_ && mask != old_mask)
+		{
+			if ((mask & old_mask) == old_mask)
+				parent_->AddSubtreeMask(mask);
+			else
+				parent_->UpdateSubtreeMask();
+		}
+	}
+
+	void Node::AddSubtreeMask(UINT mask)
+	{
+		for (Node* node = this; node && (node->subtree_mask_ | mask) != node->subtree_mask_; node = node->parent_)
+		{
+			node->subtree_mask_ |= mask;
+		}
 	}
 
 	bool Node::ContainsPoint(const Point& point) const
@@ -607,8 +819,8 @@ namespace kiwano
 
 	void VisualNode::PrepareRender()
 	{
-		Renderer::Instance().SetTransform(transform_matrix_);
-		Renderer::Instance().SetOpacity(display_opacity_);
+		Renderer::Instance().SetTransform(GetTransformMatrix());
+		Renderer::Instance().SetOpacity(GetDisplayOpacity());
 	}
 
 }
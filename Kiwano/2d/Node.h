@@ -21,6 +21,8 @@
 #pragma once
 #include "include-forwards.h"
 #include "Transform.hpp"
+#include "NodeStorage.h"
+#include "SpatialIndex.h"
 #include "ActionManager.h"
 #include "../base/TimerManager.h"
 #include "../base/EventDispatcher.h"
@@ -29,7 +31,7 @@ namespace kiwano
 {
 	class Application;
 
-	// ڵ
+	// 节点
 	class KGE_API Node
 		: public virtual Object
 		, public TimerManager
@@ -39,6 +41,7 @@ namespace kiwano
 	{
 		friend class Application;
 		friend class Transition;
+		friend class Scene;
 		friend class IntrusiveList<NodePtr>;
 
 		using Children = IntrusiveList<NodePtr>;
@@ -47,251 +50,249 @@ namespace kiwano
 	public:
 		Node();
 
-		// ½ڵ
+		// 更新节点
 		virtual void OnUpdate(Duration dt) { KGE_NOT_USED(dt); }
 
-		// Ⱦڵ
+		// 渲染节点
 		virtual void OnRender() {}
 
-		// ȡʾ״̬
+		// 获取显示状态
 		bool IsVisible()				const	{ return visible_; }
 
-		// ȡӦ״̬
+		// 获取响应状态
 		bool IsResponsible()			const	{ return responsible_; }
 
-		// ȡƵ Hash ֵ
-		size_t GetHashName()			const	{ return hash_name_; }
+		// 获取名称的 Hash 值
+		size_t GetHashName()			const	{ return GetNameAtom().hash(); }
 
-		// ȡ Z ˳
+		// 获取 Z 轴顺序
 		int GetZOrder()					const	{ return z_order_; }
 
-		// ȡ
+		// 获取坐标
 		Point GetPosition()				const	{ return transform_.position; }
 
-		// ȡ x 
+		// 获取 x 坐标
 		float GetPositionX()			const	{ return transform_.position.x; }
 
-		// ȡ y 
+		// 获取 y 坐标
 		float GetPositionY()			const	{ return transform_.position.y; }
 
-		// ȡű
+		// 获取横向缩放比例
 		Point GetScale()				const	{ return transform_.scale; }
 
-		// ȡű
+		// 获取横向缩放比例
 		float GetScaleX()				const	{ return transform_.scale.x; }
 
-		// ȡű
+		// 获取纵向缩放比例
 		float GetScaleY()				const	{ return transform_.scale.y; }
 
-		// ȡнǶ
+		// 获取错切角度
 		Point GetSkew()					const { return transform_.skew; }
 
-		// ȡнǶ
+		// 获取横向错切角度
 		float GetSkewX()				const	{ return transform_.skew.x; }
 
-		// ȡнǶ
+		// 获取纵向错切角度
 		float GetSkewY()				const	{ return transform_.skew.y; }
 
-		// ȡתǶ
+		// 获取旋转角度
 		float GetRotation()				const	{ return transform_.rotation; }
 
-		// ȡ
+		// 获取宽度
 		float GetWidth()				const	{ return size_.x; }
 
-		// ȡ߶
+		// 获取高度
 		float GetHeight()				const	{ return size_.y; }
 
-		// ȡС
+		// 获取大小
 		Size GetSize()					const	{ return size_; }
 
-		// ȡźĿ
+		// 获取缩放后的宽度
 		float GetScaledWidth()			const	{ return size_.x * transform_.scale.x; }
 
-		// ȡźĸ߶
+		// 获取缩放后的高度
 		float GetScaledHeight()			const	{ return size_.y * transform_.scale.y; }
 
-		// ȡźĴС
+		// 获取缩放后的大小
 		Size GetScaledSize()			const	{ return Size{ GetScaledWidth(), GetScaledHeight() }; }
 
-		// ȡê
+		// 获取锚点
 		Point GetAnchor()				const	{ return anchor_; }
 
-		// ȡ x ê
+		// 获取 x 方向锚点
 		float GetAnchorX()				const	{ return anchor_.x; }
 
-		// ȡ y ê
+		// 获取 y 方向锚点
 		float GetAnchorY()				const	{ return anchor_.y; }
 
-		// ȡ͸
+		// 获取透明度
 		float GetOpacity()				const	{ return opacity_; }
 
-		// ȡ任
+		// 获取显示透明度
+		float GetDisplayOpacity()		const;
+
+		// 获取变换
 		Transform GetTransform()		const	{ return transform_; }
 
-		// ȡ߿
+		// 获取边框
 		Rect GetBounds() const;
 
-		// ȡаΧ
+		// 获取外切包围盒
 		Rect GetBoundingBox() const;
 
-		// ȡά任
+		// 获取二维变换矩阵
 		Matrix const& GetTransformMatrix()  const;
 
-		// ȡά任
+		// 获取二维变换的逆矩阵
 		Matrix const& GetTransformInverseMatrix()  const;
 
-		// ȡڵ
+		// 获取父节点
 		inline Node* GetParent() const { return parent_; }
 
-		// ȡڳ
+		// 获取所在场景
 		inline Scene* GetScene() const { return scene_; }
 
-		// Ƿʾ
+		// 设置是否显示
 		void SetVisible(
 			bool val
 		);
 
-		// 
-		void SetName(
-			String const& name
-		);
-
-		// ú
+		// 设置横坐标
 		void SetPositionX(
 			float x
 		);
 
-		// 
+		// 设置纵坐标
 		void SetPositionY(
 			float y
 		);
 
-		// 
+		// 设置坐标
 		void SetPosition(
 			const Point & point
 		);
 
-		// 
+		// 设置坐标
 		void SetPosition(
 			float x,
 			float y
 		);
 
-		// ƶ
+		// 移动
 		void Move(
 			float x,
 			float y
 		);
 
-		// ƶ
+		// 移动
 		void Move(
 			const Point & vector
 		);
 
-		// úű
-		// ĬΪ 1.0
+		// 设置横向缩放比例
+		// 默认为 1.0
 		void SetScaleX(
 			float scale_x
 		);
 
-		// ű
-		// ĬΪ 1.0
+		// 设置纵向缩放比例
+		// 默认为 1.0
 		void SetScaleY(
 			float scale_y
 		);
 
-		// ű
-		// ĬΪ (1.0, 1.0)
+		// 设置缩放比例
+		// 默认为 (1.0, 1.0)
 		void SetScale(
 			float scale_x,
 			float scale_y
 		);
 
-		// ű
-		// ĬΪ (1.0, 1.0)
+		// 设置缩放比例
+		// 默认为 (1.0, 1.0)
 		void SetScale(
 			Point const& scale
 		);
 
-		// ű
-		// ĬΪ 1.0
+		// 设置缩放比例
+		// 默认为 1.0
 		void SetScale(
 			float scale
 		);
 
-		// úнǶ
-		// ĬΪ 0
+		// 设置横向错切角度
+		// 默认为 0
 		void SetSkewX(
 			float skew_x
 		);
 
-		// нǶ
-		// ĬΪ 0
+		// 设置纵向错切角度
+		// 默认为 0
 		void SetSkewY(
 			float skew_y
 		);
 
-		// ôнǶ
-		// ĬΪ (0, 0)
+		// 设置错切角度
+		// 默认为 (0, 0)
 		void SetSkew(
 			float skew_x,
 			float skew_y
 		);
 
-		// ôнǶ
-		// ĬΪ (0, 0)
+		// 设置错切角度
+		// 默认为 (0, 0)
 		void SetSkew(
 			Point const& skew
 		);
 
-		// תǶ
-		// ĬΪ 0
+		// 设置旋转角度
+		// 默认为 0
 		void SetRotation(
 			float rotation
 		);
 
-		// êĺλ
-		// ĬΪ 0, Χ [0, 1]
+		// 设置锚点的横向位置
+		// 默认为 0, 范围 [0, 1]
 		void SetAnchorX(
 			float anchor_x
 		);
 
-		// êλ
-		// ĬΪ 0, Χ [0, 1]
+		// 设置锚点的纵向位置
+		// 默认为 0, 范围 [0, 1]
 		void SetAnchorY(
 			float anchor_y
 		);
 
-		// êλ
-		// ĬΪ (0, 0), Χ [0, 1]
+		// 设置锚点位置
+		// 默认为 (0, 0), 范围 [0, 1]
 		void SetAnchor(
 			float anchor_x,
 			float anchor_y
 		);
 
-		// êλ
-		// ĬΪ (0, 0), Χ [0, 1]
+		// 设置锚点位置
+		// 默认为 (0, 0), 范围 [0, 1]
 		void SetAnchor(
 			Point const& anchor
 		);
 
-		// ޸Ŀ
+		// 修改宽度
 		void SetWidth(
 			float width
 		);
 
-		// ޸ĸ߶
+		// 修改高度
 		void SetHeight(
 			float height
 		);
 
-		// ޸ĴС
+		// 修改大小
 		void SetSize(
 			float width,
 			float height
 		);
 
-		// ޸ĴС
+		// 修改大小
 		void SetSize(
 			const Size & size
 		);
@@ -300,96 +301,103 @@ namespace kiwano
 			Transform const& transform
 		);
 
-		// ͸
-		// ĬΪ 1.0, Χ [0, 1]
+		// 设置透明度
+		// 默认为 1.0, 范围 [0, 1]
 		void SetOpacity(
 			float opacity
 		);
 
-		//  Z ˳
-		// ĬΪ 0
+		// 设置 Z 轴顺序
+		// 默认为 0
 		void SetZOrder(
 			int zorder
 		);
 
-		// ǷӦ ( Hover | Out | Click Ϣ)
-		// ĬΪ false
+		// 是否可响应 (鼠标 Hover | Out | Click 消息)
+		// 默认为 false
 		void SetResponsible(
 			bool enable
 		);
 
-		// жϵǷڽڵ
+		// 判断点是否在节点内
 		bool ContainsPoint(
 			const Point& point
 		)  const;
 
-		// ӽڵ
+		// 添加子节点
 		void AddChild(
 			NodePtr child
 		);
 
-		// Ӷӽڵ
+		// 添加多个子节点
 		void AddChildren(
 			Array<NodePtr> const& children
 		);
 
-		// ȡͬӽڵ
+		// 获取所有名称相同的子节点
 		Array<NodePtr> GetChildren(
 			String const& name
 		) const;
 
-		// ȡͬӽڵ
+		// 获取名称相同的子节点
 		NodePtr GetChild(
 			String const& name
 		) const;
 
-		// ȡȫӽڵ
+		// 获取全部子节点
 		Children const& GetChildren() const;
 
-		// Ƴӽڵ
+		// 移除子节点
 		void RemoveChild(
 			NodePtr child
 		);
 
-		// Ƴӽڵ
+		// 移除子节点
 		void RemoveChild(
 			Node* child
 		);
 
-		// Ƴͬӽڵ
+		// 移除所有名称相同的子节点
 		void RemoveChildren(
 			String const& child_name
 		);
 
-		// Ƴнڵ
+		// 移除所有节点
 		void RemoveAllChildren();
 
-		// ӸڵƳ
+		// 从父节点移除
 		void RemoveFromParent();
 
-		// ͣڵ
+		// 暂停节点更新
 		inline void PauseUpdating()									{ update_pausing_ = true; }
 
-		// ڵ
+		// 继续节点更新
 		inline void ResumeUpdating()								{ update_pausing_ = false; }
 
-		// ڵǷͣ
+		// 节点更新是否暂停
 		inline bool IsUpdatePausing() const							{ return update_pausing_; }
 
-		// øʱĻص
+		// 设置更新时的回调函数
 		inline void SetCallbackOnUpdate(UpdateCallback const& cb)	{ cb_update_ = cb; }
 
-		// ȡʱĻص
+		// 获取更新时的回调函数
 		inline UpdateCallback const& GetCallbackOnUpdate()			{ return cb_update_; }
 
-		// Ĭê
+		// 允许子节点中的精灵按图片重新排序以合并绘制
+		// 仅适用于互不重叠的精灵, 如瓦片地图和粒子, 默认为 false
+		inline void SetBatchReorderEnabled(bool enabled)			{ batch_reorder_ = enabled; }
+
+		// 是否允许子节点中的精灵重新排序
+		inline bool IsBatchReorderEnabled() const					{ return batch_reorder_; }
+
+		// 设置默认锚点
 		static void SetDefaultAnchor(
 			float anchor_x,
 			float anchor_y
 		);
 
 	public:
-		// ¼ַ
+		// 事件分发
 		void Dispatch(Event& evt) override;
 
 	protected:
@@ -407,16 +415,35 @@ namespace kiwano
 
 		void Reorder();
 
+		void MarkTransformDirty();
+
+		void AttachStorage(NodeStorage* storage);
+
+		void DetachStorage();
+
+		void AttachSpatialIndex(SpatialIndex* index);
+
+		void DetachSpatialIndex();
+
+		void OnListenerMaskChanged() override;
+
+		UINT ComputeSubtreeMask() const;
+
+		void UpdateSubtreeMask();
+
+		void AddSubtreeMask(UINT mask);
+
 	protected:
 		bool			visible_;
 		bool			hover_;
 		bool			pressed_;
 		bool			responsible_;
 		bool			update_pausing_;
+		bool			batch_reorder_;
 		int				z_order_;
+		UINT			subtree_mask_;
 		float			opacity_;
 		float			display_opacity_;
-		size_t			hash_name_;
 		Transform		transform_;
 		Point			anchor_;
 		Size			size_;
@@ -429,10 +456,14 @@ namespace kiwano
 		mutable bool	dirty_transform_inverse_;
 		mutable Matrix	transform_matrix_;
 		mutable Matrix	transform_matrix_inverse_;
+
+		NodeStorage*			storage_;
+		NodeStorage::Handle		storage_handle_;
+		SpatialIndex*			spatial_index_;
 	};
 
 
-	// ӻڵ
+	// 可视化节点
 	class KGE_API VisualNode
 		: public Node
 	{
@@ -0,0 +1,404 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "NodeStorage.h"
+#include "../math/MatrixBatch.h"
+
+namespace kiwano
+{
+	const NodeStorage::Handle NodeStorage::InvalidHandle;
+
+	NodeStorage::NodeStorage()
+		: node_count_(0)
+	{
+	}
+
+	NodeStorage::~NodeStorage()
+	{
+	}
+
+	NodeStorage::Handle NodeStorage::Allocate(Node* node)
+	{
+		Handle handle = InvalidHandle;
+
+		if (!free_handles_.empty())
+		{
+			handle = free_handles_.back();
+			free_handles_.pop_back();
+
+			transforms_[handle] = Transform{};
+			anchors_[handle] = Point{};
+			sizes_[handle] = Size{};
+			opacities_[handle] = 1.f;
+			display_opacities_[handle] = 1.f;
+			matrices_[handle] = Matrix{};
+			inverse_matrices_[handle] = Matrix{};
+			parents_[handle] = InvalidHandle;
+			first_children_[handle] = InvalidHandle;
+			next_siblings_[handle] = InvalidHandle;
+			prev_siblings_[handle] = InvalidHandle;
+			depths_[handle] = 0;
+			nodes_[handle] = node;
+		}
+		else
+		{
+			handle = static_cast<Handle>(flags_.size());
+
+			transforms_.push_back(Transform{});
+			anchors_.push_back(Point{});
+			sizes_.push_back(Size{});
+			opacities_.push_back(1.f);
+			display_opacities_.push_back(1.f);
+			matrices_.push_back(Matrix{});
+			inverse_matrices_.push_back(Matrix{});
+			parents_.push_back(InvalidHandle);
+			first_children_.push_back(InvalidHandle);
+			next_siblings_.push_back(InvalidHandle);
+			prev_siblings_.push_back(InvalidHandle);
+			depths_.push_back(0);
+			flags_.push_back(0);
+			nodes_.push_back(node);
+		}
+
+		flags_[handle] = (flags_[handle] & FlagQueued) | FlagAlive;
+		MarkDirty(handle, FlagDirtyTransform | FlagDirtyOpacity | FlagDirtyInverse);
+
+		++node_count_;
+		return handle;
+	}
+
+	void NodeStorage::Free(Handle handle)
+	{
+		KGE_ASSERT(flags_[handle] & FlagAlive && "NodeStorage::Free failed, invalid handle");
+
+		// children are normally freed first, any left over become roots
+		while (first_children_[handle] != InvalidHandle)
+			SetParent(first_children_[handle], InvalidHandle);
+
+		Unlink(handle);
+
+		// the handle may still be queued, Update skips it until it is alive again
+		flags_[handle] &= FlagQueued;
+		nodes_[handle] = nullptr;
+		free_handles_.push_back(handle);
+
+		--node_count_;
+	}
+
+	void NodeStorage::SetParent(Handle handle, Handle parent)
+	{
+		if (parents_[handle] == parent)
+			return;
+
+		Unlink(handle);
+		Link(handle, parent);
+
+		depths_[handle] = (parent != InvalidHandle) ? depths_[parent] + 1 : 0;
+		UpdateDepths(handle);
+
+		MarkDirty(handle, FlagDirtyTransform | FlagDirtyOpacity);
+	}
+
+	void NodeStorage::SetTransform(Handle handle, Transform const& transform, Point const& anchor, Size const& size)
+	{
+		transforms_[handle] = transform;
+		anchors_[handle] = anchor;
+		sizes_[handle] = size;
+		MarkDirty(handle, FlagDirtyTransform);
+	}
+
+	void NodeStorage::SetOpacity(Handle handle, float opacity)
+	{
+		opacities_[handle] = opacity;
+		MarkDirty(handle, FlagDirtyOpacity);
+	}
+
+	void NodeStorage::MarkDirty(Handle handle, unsigned short flags)
+	{
+		flags_[handle] |= flags;
+
+		if (!(flags_[handle] & FlagQueued))
+		{
+			flags_[handle] |= FlagQueued;
+			dirty_handles_.push_back(handle);
+		}
+	}
+
+	void NodeStorage::Link(Handle handle, Handle parent)
+	{
+		parents_[handle] = parent;
+
+		if (parent == InvalidHandle)
+			return;
+
+		const Handle next = first_children_[parent];
+		prev_siblings_[handle] = InvalidHandle;
+		next_siblings_[handle] = next;
+		if (next != InvalidHandle)
+			prev_siblings_[next] = handle;
+		first_children_[parent] = handle;
+	}
+
+	void NodeStorage::Unlink(Handle handle)
+	{
+		const Handle parent = parents_[handle];
+		if (parent == InvalidHandle)
+			return;
+
+		const Handle prev = prev_siblings_[handle];
+		const Handle next = next_siblings_[handle];
+
+		if (prev != InvalidHandle)
+			next_siblings_[prev] = next;
+		else
+			first_children_[parent] = next;
+
+		if (next != InvalidHandle)
+			prev_siblings_[next] = prev;
+
+		parents_[handle] = InvalidHandle;
+		prev_siblings_[handle] = InvalidHandle;
+		next_siblings_[handle] = InvalidHandle;
+	}
+
+	void NodeStorage::UpdateDepths(Handle root)
+	{
+		// walk the subtree through the sibling links, no stack needed
+		const Handle* parents = parents_.cbegin();
+		const Handle* first_children = first_children_.cbegin();
+		const Handle* next_siblings = next_siblings_.cbegin();
+		unsigned int* depths = depths_.begin();
+
+		Handle handle = first_children[root];
+		while (handle != InvalidHandle)
+		{
+			depths[handle] = depths[parents[handle]] + 1;
+
+			if (first_children[handle] != InvalidHandle)
+			{
+				handle = first_children[handle];
+				continue;
+			}
+
+			while (handle != root && next_siblings[handle] == InvalidHandle)
+				handle = parents[handle];
+
+			if (handle == root)
+				break;
+
+			handle = next_siblings[handle];
+		}
+	}
+
+	void NodeStorage::Update()
+	{
+		if (dirty_handles_.empty())
+			return;
+
+		const unsigned int* depths = depths_.cbegin();
+		const Handle* first_children = first_children_.cbegin();
+		const Handle* next_siblings = next_siblings_.cbegin();
+		unsigned short* flags = flags_.begin();
+
+		// each level only depends on the level above it, so the dirty nodes are
+		// visited level by level and every level is multiplied as a batch
+		std::sort(dirty_handles_.begin(), dirty_handles_.end(), [depths](Handle lhs, Handle rhs) { return depths[lhs] < depths[rhs]; });
+
+		auto visit = [&](Handle handle, Array<Handle>& level)
+		{
+			if (flags[handle] & FlagVisited)
+				return;
+
+			flags[handle] |= FlagVisited;
+			level.push_back(handle);
+			visited_handles_.push_back(handle);
+		};
+
+		level_handles_.resize(0);
+
+		size_t next_dirty = 0;
+		while (next_dirty < dirty_handles_.size() || !level_handles_.empty())
+		{
+			const unsigned int depth = level_handles_.empty() ? depths[dirty_handles_[next_dirty]] : depths[level_handles_[0]];
+
+			for (; next_dirty < dirty_handles_.size() && depths[dirty_handles_[next_dirty]] <= depth; ++next_dirty)
+			{
+				const Handle handle = dirty_handles_[next_dirty];
+				if (flags[handle] & FlagAlive)
+					visit(handle, level_handles_);
+			}
+
+			UpdateLevel(level_handles_.size());
+
+			// only the children of changed nodes are carried to the next level
+			next_level_handles_.resize(0);
+			for (const auto handle : level_handles_)
+			{
+				if (!(flags[handle] & (FlagTransformChanged | FlagOpacityChanged)))
+					continue;
+
+				for (Handle child = first_children[handle]; child != InvalidHandle; child = next_siblings[child])
+					visit(child, next_level_handles_);
+			}
+			std::swap(level_handles_, next_level_handles_);
+		}
+
+		for (const auto handle : visited_handles_)
+			flags[handle] &= ~(FlagVisited | FlagTransformChanged | FlagOpacityChanged);
+
+		for (const auto handle : dirty_handles_)
+			flags[handle] &= ~FlagQueued;
+
+		visited_handles_.resize(0);
+		dirty_handles_.resize(0);
+	}
+
+	void NodeStorage::UpdateLevel(size_t count)
+	{
+		if (batch_handles_.size() < count)
+		{
+			batch_handles_.resize(count);
+			batch_locals_.resize(count);
+			batch_parents_.resize(count);
+		}
+
+		const Transform* transforms = transforms_.cbegin();
+		const Point* anchors = anchors_.cbegin();
+		const Size* sizes = sizes_.cbegin();
+		const float* opacities = opacities_.cbegin();
+		const Handle* parents = parents_.cbegin();
+		const Handle* level_handles = level_handles_.cbegin();
+		float* display_opacities = display_opacities_.begin();
+		Matrix* matrices = matrices_.begin();
+		unsigned short* flags = flags_.begin();
+
+		Handle* batch_handles = batch_handles_.begin();
+		Matrix* batch_locals = batch_locals_.begin();
+		Matrix* batch_parents = batch_parents_.begin();
+		size_t batch_size = 0;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Handle handle = level_handles[i];
+			const Handle parent = parents[handle];
+			const unsigned short parent_flags = (parent != InvalidHandle) ? flags[parent] : 0;
+
+			unsigned short flag = flags[handle];
+
+			if ((flag & FlagDirtyTransform) || (parent_flags & FlagTransformChanged))
+			{
+				Matrix& local = batch_locals[batch_size];
+				local = transforms[handle].ToMatrix();
+				local.Translate(Point{ -sizes[handle].x * anchors[handle].x, -sizes[handle].y * anchors[handle].y });
+
+				batch_parents[batch_size] = (parent != InvalidHandle) ? matrices[parent] : Matrix{};
+				batch_handles[batch_size] = handle;
+				++batch_size;
+
+				flag &= ~FlagDirtyTransform;
+				flag |= FlagTransformChanged | FlagDirtyInverse;
+			}
+
+			if ((flag & FlagDirtyOpacity) || (parent_flags & FlagOpacityChanged))
+			{
+				if (parent != InvalidHandle)
+					display_opacities[handle] = opacities[handle] * display_opacities[parent];
+				else
+					display_opacities[handle] = opacities[handle];
+
+				flag &= ~FlagDirtyOpacity;
+				flag |= FlagOpacityChanged;
+			}
+
+			flags[handle] = flag;
+		}
+
+		if (batch_size == 0)
+			return;
+
+		math::MultiplyMatrices(batch_locals, batch_locals, batch_parents, batch_size);
+
+		for (size_t i = 0; i < batch_size; ++i)
+		{
+			matrices[batch_handles[i]] = batch_locals[i];
+		}
+
+		UpdateInverseMatrices(batch_handles, batch_size);
+	}
+
+	void NodeStorage::UpdateInverseMatrices(const Handle* handles, size_t count)
+	{
+		// only nodes that have been hit-tested before keep their inverse matrices up to date,
+		// the others are inverted lazily in GetTransformInverseMatrix
+		const Matrix* matrices = matrices_.cbegin();
+		unsigned short* flags = flags_.begin();
+		Matrix* batch_inputs = batch_parents_.begin();
+		Handle* batch_handles = batch_handles_.begin();
+
+		size_t batch_size = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Handle handle = handles[i];
+			if (flags[handle] & FlagHitTested)
+			{
+				batch_inputs[batch_size] = matrices[handle];
+				batch_handles[batch_size] = handle;
+				++batch_size;
+			}
+		}
+
+		if (batch_size == 0)
+			return;
+
+		Matrix* inverse_matrices = inverse_matrices_.begin();
+		Matrix* batch_outputs = batch_locals_.begin();
+		math::InvertMatrices(batch_outputs, batch_inputs, batch_size);
+
+		for (size_t i = 0; i < batch_size; ++i)
+		{
+			inverse_matrices[batch_handles[i]] = batch_outputs[i];
+			flags[batch_handles[i]] &= ~FlagDirtyInverse;
+		}
+	}
+
+	Matrix const& NodeStorage::GetTransformMatrix(Handle handle)
+	{
+		Update();
+		return matrices_[handle];
+	}
+
+	Matrix const& NodeStorage::GetTransformInverseMatrix(Handle handle)
+	{
+		Update();
+		if (flags_[handle] & FlagDirtyInverse)
+		{
+			inverse_matrices_[handle] = Matrix::Invert(matrices_[handle]);
+			flags_[handle] &= ~FlagDirtyInverse;
+		}
+		flags_[handle] |= FlagHitTested;
+		return inverse_matrices_[handle];
+	}
+
+	float NodeStorage::GetDisplayOpacity(Handle handle)
+	{
+		Update();
+		return display_opacities_[handle];
+	}
+}
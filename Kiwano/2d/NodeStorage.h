@@ -0,0 +1,166 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "include-forwards.h"
+#include "Transform.hpp"
+
+namespace kiwano
+{
+	// 节点数据存储
+	// 以 SoA 方式连续存放节点的变换、锚点、大小、透明度和脏标记,
+	// 通过稳定的节点句柄索引, 更新时只按层遍历脏节点及其子树
+	class KGE_API NodeStorage
+		: protected Noncopyable
+	{
+	public:
+		using Handle = unsigned int;
+
+		static const Handle InvalidHandle = static_cast<Handle>(-1);
+
+	public:
+		NodeStorage();
+
+		~NodeStorage();
+
+		// 分配节点句柄
+		Handle Allocate(
+			Node* node
+		);
+
+		// 释放节点句柄
+		void Free(
+			Handle handle
+		);
+
+		// 设置父节点
+		void SetParent(
+			Handle handle,
+			Handle parent
+		);
+
+		// 设置变换
+		void SetTransform(
+			Handle handle,
+			Transform const& transform,
+			Point const& anchor,
+			Size const& size
+		);
+
+		// 设置透明度
+		void SetOpacity(
+			Handle handle,
+			float opacity
+		);
+
+		// 更新脏节点及其子树的二维变换矩阵和显示透明度
+		void Update();
+
+		// 获取二维变换矩阵
+		Matrix const& GetTransformMatrix(
+			Handle handle
+		);
+
+		// 获取二维变换的逆矩阵
+		Matrix const& GetTransformInverseMatrix(
+			Handle handle
+		);
+
+		// 获取显示透明度
+		float GetDisplayOpacity(
+			Handle handle
+		);
+
+		// 获取句柄对应的节点
+		inline Node* GetNode(Handle handle) const	{ return nodes_[handle]; }
+
+		// 获取节点数量
+		inline size_t GetNodeCount() const			{ return node_count_; }
+
+	private:
+		void MarkDirty(
+			Handle handle,
+			unsigned short flags
+		);
+
+		void Link(
+			Handle handle,
+			Handle parent
+		);
+
+		void Unlink(
+			Handle handle
+		);
+
+		void UpdateDepths(
+			Handle handle
+		);
+
+		void UpdateLevel(
+			size_t count
+		);
+
+		void UpdateInverseMatrices(
+			const Handle* handles,
+			size_t count
+		);
+
+	private:
+		enum : unsigned short
+		{
+			FlagAlive				= 1 << 0,
+			FlagDirtyTransform		= 1 << 1,
+			FlagDirtyOpacity		= 1 << 2,
+			FlagDirtyInverse		= 1 << 3,
+			FlagTransformChanged	= 1 << 4,
+			FlagOpacityChanged		= 1 << 5,
+			FlagHitTested			= 1 << 6,
+			FlagQueued				= 1 << 7,
+			FlagVisited				= 1 << 8,
+		};
+
+		size_t					node_count_;
+
+		Array<Transform>		transforms_;
+		Array<Point>			anchors_;
+		Array<Size>				sizes_;
+		Array<float>			opacities_;
+		Array<float>			display_opacities_;
+		Array<Matrix>			matrices_;
+		Array<Matrix>			inverse_matrices_;
+		Array<Handle>			parents_;
+		Array<Handle>			first_children_;
+		Array<Handle>			next_siblings_;
+		Array<Handle>			prev_siblings_;
+		Array<unsigned int>		depths_;
+		Array<unsigned short>	flags_;
+		Array<Node*>			nodes_;
+
+		Array<Handle>			free_handles_;
+		Array<Handle>			dirty_handles_;
+		Array<Handle>			level_handles_;
+		Array<Handle>			next_level_handles_;
+		Array<Handle>			visited_handles_;
+
+		Array<Handle>			batch_handles_;
+		Array<Matrix>			batch_locals_;
+		Array<Matrix>			batch_parents_;
+	};
+}
@@ -27,6 +27,7 @@ namespace kiwano
 	Scene::Scene()
 		: mouse_cursor_(MouseCursor::Arrow)
 		, last_mouse_cursor(MouseCursor(-1))
+		, node_storage_(nullptr)
 	{
 		scene_ = this;
 
@@ -36,6 +37,8 @@ namespace kiwano
 
 	Scene::~Scene()
 	{
+		SetNodeStorageEnabled(false);
+		SetSpatialIndexEnabled(false);
 	}
 
 	void Scene::OnEnter()
@@ -77,4 +80,117 @@ namespace kiwano
 		mouse_cursor_ = cursor;
 	}
 
+	void Scene::SetNodeStorageEnabled(bool enabled)
+	{
+		if (enabled == IsNodeStorageEnabled())
+			return;
+
+		if (enabled)
+		{
+			node_storage_ = new NodeStorage;
+			AttachStorage(node_storage_);
+		}
+		else
+		{
+			DetachStorage();
+
+			delete node_storage_;
+			node_storage_ = nullptr;
+		}
+	}
+
+	void Scene::SetSpatialIndexEnabled(bool enabled)
+	{
+		if (enabled == IsSpatialIndexEnabled())
+			return;
+
+		if (enabled)
+		{
+			AttachSpatialIndex(new SpatialIndex);
+		}
+		else
+		{
+			SpatialIndex* index = spatial_index_;
+			DetachSpatialIndex();
+			delete index;
+		}
+	}
+
+	void Scene::Dispatch(Event& evt)
+	{
+		if (spatial_index_ && MouseEvent::Check(evt.type))
+		{
+			UpdateHoverNode(evt);
+		}
+		Node::Dispatch(evt);
+	}
+
+	void Scene::UpdateHoverNode(Event& evt)
+	{
+		// the index only keeps the hover node while it is indexed, so a node that
+		// has been removed from the scene is never dispatched to from here
+		if (evt.type == Event::MouseMove)
+		{
+			NodePtr hit = spatial_index_->FindTopmostNode(Point{ evt.mouse.x, evt.mouse.y });
+			NodePtr hover_node = spatial_index_->GetHoverNode();
+
+			if (hover_node != hit)
+			{
+				// set first, so that a listener removing nodes sees the new state
+				spatial_index_->SetHoverNode(hit.Get());
+
+				if (hover_node)
+				{
+					hover_node->hover_ = false;
+					hover_node->pressed_ = false;
+
+					Event out = evt;
+					out.target = hover_node.Get();
+					out.type = Event::MouseOut;
+					hover_node->EventDispatcher::Dispatch(out);
+				}
+
+				// the MouseOut listener may have removed the new hover node
+				if (hit && spatial_index_ && spatial_index_->GetHoverNode() == hit.Get())
+				{
+					hit->hover_ = true;
+
+					Event hover = evt;
+					hover.target = hit.Get();
+					hover.type = Event::MouseHover;
+					hit->EventDispatcher::Dispatch(hover);
+				}
+			}
+		}
+
+		if (!spatial_index_)
+			return;
+
+		Node* hover_node = spatial_index_->GetHoverNode();
+		if (!hover_node)
+			return;
+
+		if (evt.type == Event::MouseMove)
+		{
+			evt.target = hover_node;
+		}
+
+		if (evt.type == Event::MouseBtnDown)
+		{
+			hover_node->pressed_ = true;
+			evt.target = hover_node;
+		}
+
+		if (evt.type == Event::MouseBtnUp && hover_node->pressed_)
+		{
+			NodePtr guard = hover_node;
+			hover_node->pressed_ = false;
+			evt.target = hover_node;
+
+			Event click = evt;
+			click.type = Event::Click;
+			hover_node->EventDispatcher::Dispatch(click);
+		}
+	}
+
 }
@@ -23,7 +23,7 @@
 
 namespace kiwano
 {
-	// 
+	// 场景
 	class KGE_API Scene
 		: public Node
 	{
@@ -32,10 +32,10 @@ namespace kiwano
 
 		virtual ~Scene();
 
-		// 볡
+		// 进入场景
 		virtual void OnEnter();
 
-		// ˳
+		// 退出场景
 		virtual void OnExit();
 
 	public:
@@ -45,8 +45,40 @@ namespace kiwano
 			MouseCursor cursor
 		);
 
+		// 启用节点数据存储
+		// 启用后场景内所有节点的变换和透明度数据将连续存放, 并在每帧统一更新
+		void SetNodeStorageEnabled(
+			bool enabled
+		);
+
+		// 是否启用了节点数据存储
+		inline bool IsNodeStorageEnabled() const { return node_storage_ != nullptr; }
+
+		// 获取节点数据存储
+		inline NodeStorage* GetNodeStorage() const { return node_storage_; }
+
+		// 启用空间索引
+		// 启用后将通过网格索引查找鼠标位置下的可响应节点, 适用于含有大量可响应节点的场景
+		void SetSpatialIndexEnabled(
+			bool enabled
+		);
+
+		// 是否启用了空间索引
+		inline bool IsSpatialIndexEnabled() const { return spatial_index_ != nullptr; }
+
+		// 获取空间索引
+		inline SpatialIndex* GetSpatialIndex() const { return spatial_index_; }
+
+	public:
+		// 事件分发
+		void Dispatch(Event& evt) override;
+
+	protected:
+		void UpdateHoverNode(Event& evt);
+
 	protected:
 		MouseCursor mouse_cursor_;
 		MouseCursor last_mouse_cursor;
+		NodeStorage* node_storage_;
 	};
 }
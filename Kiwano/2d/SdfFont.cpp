@@ -0,0 +1,186 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "SdfFont.h"
+#include "../base/logs.h"
+#include "../renderer/render.h"
+#include <cstdio>
+#include <cmath>
+
+namespace kiwano
+{
+	namespace
+	{
+		template <typename _Ty>
+		void AppendKey(std::string& key, _Ty const& value)
+		{
+			key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		void AppendKey(std::string& key, Color const& color)
+		{
+			AppendKey(key, color.r);
+			AppendKey(key, color.g);
+			AppendKey(key, color.b);
+			AppendKey(key, color.a);
+		}
+
+		bool ReadFile(String const& file_path, Array<BYTE>& data)
+		{
+			std::FILE* file = nullptr;
+			if (0 != _wfopen_s(&file, file_path.c_str(), L"rb") || !file)
+				return false;
+
+			bool ok = 0 == std::fseek(file, 0, SEEK_END);
+
+			const long size = ok ? std::ftell(file) : -1;
+			ok = size > 0 && 0 == std::fseek(file, 0, SEEK_SET);
+
+			if (ok)
+			{
+				data.resize(static_cast<size_t>(size));
+				ok = 1 == std::fread(data.data(), data.size(), 1, file);
+			}
+			std::fclose(file);
+			return ok;
+		}
+
+		// feature level 9.1 devices only guarantee textures of this size
+		const int max_bitmap_size = 2048;
+	}
+
+	SdfFont::SdfFont(float base_size, int spread, int page_size)
+		: atlas_(base_size, spread, page_size)
+		, pages_(32 * 1024 * 1024)
+	{
+		UpdatePageLimit();
+	}
+
+	SdfFont::~SdfFont()
+	{
+	}
+
+	bool SdfFont::Load(Resource const& res)
+	{
+		pages_.Clear();
+
+		bool loaded = false;
+		if (res.IsFileType())
+		{
+			Array<BYTE> data;
+			if (ReadFile(res.GetFileName(), data))
+			{
+				loaded = atlas_.Load(data.data(), data.size());
+			}
+		}
+		else
+		{
+			LPVOID buffer = nullptr;
+			DWORD buffer_size = 0;
+			if (res.Load(buffer, buffer_size))
+			{
+				loaded = atlas_.Load(buffer, buffer_size);
+			}
+		}
+
+		if (!loaded)
+		{
+			KGE_WARNING_LOG(L"Load font file failed");
+		}
+		return loaded;
+	}
+
+	ComPtr<ID2D1Bitmap> SdfFont::GetPageBitmap(int page, SdfGlyphAtlas::Style const& style, float scale)
+	{
+		auto device_resources = Renderer::Instance().GetDeviceResources();
+		if (!device_resources || page < 0 || page >= atlas_.GetPageCount())
+			return nullptr;
+
+		// sizes above the limit share the clamped page, so the key uses page pixels
+		const float page_scale = atlas_.GetPageScale(scale);
+		const float page_ratio = page_scale / scale;
+
+		std::string key;
+		AppendKey(key, page);
+		AppendKey(key, page_scale);
+		AppendKey(key, style.color);
+		AppendKey(key, style.outline_color);
+		AppendKey(key, style.outline_width * page_ratio);
+		AppendKey(key, style.shadow_color);
+		AppendKey(key, style.shadow_offset.x * page_ratio);
+		AppendKey(key, style.shadow_offset.y * page_ratio);
+
+		const auto size = static_cast<UINT32>(atlas_.GetScaledPageSize(scale));
+		const size_t bytes = static_cast<size_t>(size) * size * 4;
+
+		StyledPage styled = { nullptr, 0 };
+		if (auto cached = pages_.Get(key))
+		{
+			styled = *cached;
+		}
+		else
+		{
+			// pages start transparent, only the glyph regions are uploaded
+			Array<BYTE> blank(bytes, 0);
+
+			HRESULT hr = device_resources->CreateBitmap(
+				styled.bitmap,
+				D2D1::SizeU(size, size),
+				blank.data(),
+				size * 4
+			);
+
+			if (FAILED(hr))
+			{
+				KGE_ERROR_LOG(L"Create bitmap failed with HRESULT of %08X", hr);
+				return nullptr;
+			}
+		}
+
+		const UINT32 version = atlas_.GetPageVersion(page);
+		if (styled.version != version)
+		{
+			RectPacker::Box region;
+			if (atlas_.ShadePage(page, style, scale, styled.version, pixels_, region))
+			{
+				const auto dest_rect = D2D1::RectU(region.x, region.y, region.x + region.width, region.y + region.height);
+				styled.bitmap->CopyFromMemory(&dest_rect, pixels_.data(), region.width * 4);
+			}
+
+			styled.version = version;
+			pages_.Put(key, styled, bytes);
+		}
+		return styled.bitmap;
+	}
+
+	void SdfFont::SetCacheLimit(size_t bytes)
+	{
+		pages_.SetCapacity(bytes);
+		UpdatePageLimit();
+	}
+
+	void SdfFont::UpdatePageLimit()
+	{
+		// a styled page takes at most a quarter of the cache, otherwise a few sizes
+		// evict each other and pages are shaded again every frame
+		const auto budget_size = static_cast<int>(std::sqrt(static_cast<double>(pages_.GetCapacity()) / 16));
+		atlas_.SetMaxScaledPageSize(std::min(budget_size, max_bitmap_size));
+	}
+}
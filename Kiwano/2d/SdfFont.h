@@ -0,0 +1,81 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "include-forwards.h"
+#include "../base/Resource.h"
+#include "../common/LruCache.hpp"
+#include "../utils/SdfGlyphAtlas.h"
+#include <d2d1.h>
+
+namespace kiwano
+{
+	// 距离场字体
+	// 字形只光栅化一次, 按样式和字号着色后的页面位图会被缓存,
+	// 文字绘制为页面上的矩形区域, 使用同一页面的文字可以合并绘制
+	class KGE_API SdfFont
+		: public virtual Object
+	{
+	public:
+		SdfFont(
+			float base_size = 32.f,	// 生成距离场的基准字号
+			int spread = 6,			// 距离场扩展边距, 限制描边线宽和阴影偏移
+			int page_size = 512		// 页面边长
+		);
+
+		virtual ~SdfFont();
+
+		// 加载 TrueType 字体文件或资源
+		bool Load(
+			Resource const& res
+		);
+
+		// 获取字形图集
+		inline SdfGlyphAtlas& GetGlyphAtlas()		{ return atlas_; }
+
+		// 获取着色后的页面位图
+		// 页面加入新字形后只更新变化的区域, 没有渲染设备时返回空
+		ComPtr<ID2D1Bitmap> GetPageBitmap(
+			int page,
+			SdfGlyphAtlas::Style const& style,
+			float scale
+		);
+
+		// 设置着色页面的显存上限 (字节), 默认为 32 MB
+		// 同时限制单个页面的大小, 需要在排版前设置
+		void SetCacheLimit(
+			size_t bytes
+		);
+
+	private:
+		void UpdatePageLimit();
+
+	private:
+		struct StyledPage
+		{
+			ComPtr<ID2D1Bitmap> bitmap;
+			UINT32 version;
+		};
+
+		SdfGlyphAtlas						atlas_;
+		LruCache<std::string, StyledPage>	pages_;
+		Array<UINT32>						pixels_;
+	};
+}
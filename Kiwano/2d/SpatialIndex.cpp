@@ -0,0 +1,289 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "SpatialIndex.h"
+#include "Node.h"
+#include "Layer.h"
+#include <cmath>
+
+namespace kiwano
+{
+	namespace
+	{
+		// nodes covering more cells than this are tested on every query
+		const int max_cells_per_node = 64;
+	}
+
+	SpatialIndex::SpatialIndex(float cell_size)
+		: cell_size_(cell_size > 0.f ? cell_size : 64.f)
+		, hover_node_(nullptr)
+	{
+	}
+
+	SpatialIndex::~SpatialIndex()
+	{
+		Clear();
+	}
+
+	void SpatialIndex::Insert(Node* node)
+	{
+		KGE_ASSERT(node && "SpatialIndex::Insert failed, NULL pointer exception");
+
+		if (entries_.find(node) == entries_.end())
+		{
+			// empty cell range, it will be placed in the next update
+			entries_.insert(std::make_pair(node, Entry{ Rect{}, 1, 1, 0, 0, false }));
+		}
+		dirty_nodes_.insert(node);
+	}
+
+	void SpatialIndex::Remove(Node* node)
+	{
+		// a removed node must never receive MouseOut from the scene later
+		if (hover_node_ == node)
+			hover_node_ = nullptr;
+
+		dirty_nodes_.erase(node);
+
+		auto iter = entries_.find(node);
+		if (iter != entries_.end())
+		{
+			RemoveFromCells(node, iter->second);
+			entries_.erase(iter);
+		}
+	}
+
+	void SpatialIndex::MarkDirty(Node* node)
+	{
+		dirty_nodes_.insert(node);
+	}
+
+	Node* SpatialIndex::FindTopmostNode(Point const& point)
+	{
+		Update();
+
+		Node* result = nullptr;
+		auto hit_test = [&](CellItem const& item)
+		{
+			Node* node = item.node;
+			if (node == result || !item.bounds.ContainsPoint(point))
+				return;
+
+			if (!node->ContainsPoint(point) || !IsReachable(node))
+				return;
+
+			if (!result || IsDispatchedBefore(node, result))
+				result = node;
+		};
+
+		const int x = static_cast<int>(std::floor(point.x / cell_size_));
+		const int y = static_cast<int>(std::floor(point.y / cell_size_));
+
+		auto iter = cells_.find(MakeCellKey(x, y));
+		if (iter != cells_.end())
+		{
+			for (const auto& item : iter->second)
+				hit_test(item);
+		}
+
+		for (const auto& item : oversized_)
+			hit_test(item);
+
+		return result;
+	}
+
+	void SpatialIndex::Clear()
+	{
+		entries_.clear();
+		cells_.clear();
+		oversized_.clear();
+		dirty_nodes_.clear();
+		hover_node_ = nullptr;
+	}
+
+	void SpatialIndex::Update()
+	{
+		if (dirty_nodes_.empty())
+			return;
+
+		for (auto node : dirty_nodes_)
+		{
+			UpdateSubtree(node);
+		}
+		dirty_nodes_.clear();
+	}
+
+	void SpatialIndex::UpdateSubtree(Node* node)
+	{
+		auto iter = entries_.find(node);
+		if (iter != entries_.end())
+		{
+			UpdateEntry(node, iter->second);
+		}
+
+		for (Node* child = node->GetChildren().First().Get(); child; child = child->NextItem().Get())
+		{
+			UpdateSubtree(child);
+		}
+	}
+
+	void SpatialIndex::UpdateEntry(Node* node, Entry& entry)
+	{
+		RemoveFromCells(node, entry);
+
+		const Rect bounds = node->GetBoundingBox();
+		if (bounds.size.x <= 0.f || bounds.size.y <= 0.f)
+		{
+			entry = Entry{ Rect{}, 1, 1, 0, 0, false };
+			return;
+		}
+
+		entry.bounds = bounds;
+		entry.min_x = static_cast<int>(std::floor(bounds.origin.x / cell_size_));
+		entry.min_y = static_cast<int>(std::floor(bounds.origin.y / cell_size_));
+		entry.max_x = static_cast<int>(std::floor((bounds.origin.x + bounds.size.x) / cell_size_));
+		entry.max_y = static_cast<int>(std::floor((bounds.origin.y + bounds.size.y) / cell_size_));
+
+		const long long cell_count = static_cast<long long>(entry.max_x - entry.min_x + 1) * (entry.max_y - entry.min_y + 1);
+		entry.oversized = cell_count > max_cells_per_node;
+
+		AddToCells(node, entry);
+	}
+
+	void SpatialIndex::AddToCells(Node* node, Entry const& entry)
+	{
+		const CellItem item = { node, entry.bounds };
+
+		if (entry.oversized)
+		{
+			oversized_.push_back(item);
+			return;
+		}
+
+		for (int y = entry.min_y; y <= entry.max_y; ++y)
+		{
+			for (int x = entry.min_x; x <= entry.max_x; ++x)
+			{
+				cells_[MakeCellKey(x, y)].push_back(item);
+			}
+		}
+	}
+
+	void SpatialIndex::RemoveFromCells(Node* node, Entry const& entry)
+	{
+		auto remove_from = [node](Cell& items)
+		{
+			auto iter = std::find_if(items.begin(), items.end(), [node](CellItem const& item) { return item.node == node; });
+			if (iter != items.end())
+				items.erase(iter);
+		};
+
+		if (entry.oversized)
+		{
+			remove_from(oversized_);
+			return;
+		}
+
+		for (int y = entry.min_y; y <= entry.max_y; ++y)
+		{
+			for (int x = entry.min_x; x <= entry.max_x; ++x)
+			{
+				auto cell = cells_.find(MakeCellKey(x, y));
+				if (cell == cells_.end())
+					continue;
+
+				remove_from(cell->second);
+
+				if (cell->second.empty())
+					cells_.erase(cell);
+			}
+		}
+	}
+
+	bool SpatialIndex::IsReachable(Node* node) const
+	{
+		// the same rules as Node::Dispatch and Layer::Dispatch
+		for (Node* parent = node; parent; parent = parent->GetParent())
+		{
+			if (!parent->IsVisible())
+				return false;
+
+			if (parent != node)
+			{
+				Layer* layer = dynamic_cast<Layer*>(parent);
+				if (layer && layer->IsSwallowEventsEnabled())
+					return false;
+			}
+		}
+		return true;
+	}
+
+	bool SpatialIndex::IsDispatchedBefore(Node* lhs, Node* rhs)
+	{
+		lhs_path_.clear();
+		rhs_path_.clear();
+
+		for (Node* node = lhs; node; node = node->GetParent())
+			lhs_path_.push_back(node);
+
+		for (Node* node = rhs; node; node = node->GetParent())
+			rhs_path_.push_back(node);
+
+		size_t i = lhs_path_.size();
+		size_t j = rhs_path_.size();
+		while (i > 0 && j > 0 && lhs_path_[i - 1] == rhs_path_[j - 1])
+		{
+			--i;
+			--j;
+		}
+
+		// children are dispatched before their parent
+		if (i == 0)
+			return false;
+
+		if (j == 0)
+			return true;
+
+		// siblings are dispatched from the last one,
+		// search in both directions as overlapping siblings are usually close to each other
+		Node* lhs_sibling = lhs_path_[i - 1];
+		Node* rhs_sibling = rhs_path_[j - 1];
+		Node* next = lhs_sibling->NextItem().Get();
+		Node* prev = lhs_sibling->PrevItem().Get();
+		while (next || prev)
+		{
+			if (next)
+			{
+				if (next == rhs_sibling)
+					return false;
+				next = next->NextItem().Get();
+			}
+
+			if (prev)
+			{
+				if (prev == rhs_sibling)
+					return true;
+				prev = prev->PrevItem().Get();
+			}
+		}
+		return true;
+	}
+
+}
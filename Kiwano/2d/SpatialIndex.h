@@ -0,0 +1,138 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "include-forwards.h"
+
+namespace kiwano
+{
+	// 空间索引
+	// 以均匀网格存放场景内可响应节点的外切包围盒, 用于快速查找鼠标位置下的节点.
+	// 节点变换改变时只标记脏的子树, 在下一次查询时增量更新
+	class KGE_API SpatialIndex
+		: protected Noncopyable
+	{
+	public:
+		SpatialIndex(
+			float cell_size = 64.f
+		);
+
+		~SpatialIndex();
+
+		// 添加节点
+		void Insert(
+			Node* node
+		);
+
+		// 移除节点
+		void Remove(
+			Node* node
+		);
+
+		// 标记节点及其子节点的变换已改变
+		void MarkDirty(
+			Node* node
+		);
+
+		// 查找坐标处最上层的可响应节点
+		Node* FindTopmostNode(
+			Point const& point
+		);
+
+		// 清空索引
+		void Clear();
+
+		// 设置鼠标悬停的节点
+		// 不持有节点的引用, 节点从索引中移除时自动清空
+		inline void SetHoverNode(Node* node)	{ hover_node_ = node; }
+
+		// 获取鼠标悬停的节点
+		inline Node* GetHoverNode() const		{ return hover_node_; }
+
+		// 获取网格大小
+		inline float GetCellSize() const		{ return cell_size_; }
+
+		// 获取已索引的节点数量
+		inline size_t GetNodeCount() const		{ return entries_.size(); }
+
+	private:
+		struct Entry
+		{
+			Rect bounds;
+			int min_x;
+			int min_y;
+			int max_x;
+			int max_y;
+			bool oversized;
+		};
+
+		struct CellItem
+		{
+			Node* node;
+			Rect bounds;
+		};
+
+		using Cell = Array<CellItem>;
+
+		using CellKey = unsigned long long;
+
+		void Update();
+
+		void UpdateSubtree(
+			Node* node
+		);
+
+		void UpdateEntry(
+			Node* node,
+			Entry& entry
+		);
+
+		void AddToCells(
+			Node* node,
+			Entry const& entry
+		);
+
+		void RemoveFromCells(
+			Node* node,
+			Entry const& entry
+		);
+
+		bool IsReachable(
+			Node* node
+		) const;
+
+		bool IsDispatchedBefore(
+			Node* lhs,
+			Node* rhs
+		);
+
+		static inline CellKey MakeCellKey(int x, int y)	{ return (static_cast<CellKey>(static_cast<unsigned int>(x)) << 32) | static_cast<unsigned int>(y); }
+
+	private:
+		float								cell_size_;
+		Node*								hover_node_;
+		UnorderedMap<Node*, Entry>			entries_;
+		UnorderedMap<CellKey, Cell>			cells_;
+		Cell								oversized_;
+		UnorderedSet<Node*>					dirty_nodes_;
+		Array<Node*>						lhs_path_;
+		Array<Node*>						rhs_path_;
+	};
+}
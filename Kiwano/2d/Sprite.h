@@ -24,7 +24,7 @@
 
 namespace kiwano
 {
-	// 
+	// 精灵
 	class KGE_API Sprite
 		: public VisualNode
 	{
@@ -41,30 +41,30 @@ namespace kiwano
 
 		explicit Sprite(
 			Resource const& res,
-			const Rect& crop_rect	/* ü */
+			const Rect& crop_rect	/* 裁剪矩形 */
 		);
 
 		virtual ~Sprite();
 
-		// ͼƬļ
+		// 加载图片文件
 		bool Load(
 			Resource const& res
 		);
 
-		// ͼƬ
+		// 加载图片
 		bool Load(
 			ImagePtr image
 		);
 
-		// ͼƬüΪ
+		// 将图片裁剪为矩形
 		void Crop(
-			const Rect& crop_rect	/* ü */
+			const Rect& crop_rect	/* 裁剪矩形 */
 		);
 
-		// ȡ Image 
+		// 获取 Image 对象
 		ImagePtr GetImage() const;
 
-		// Ⱦ
+		// 渲染精灵
 		void OnRender() override;
 
 	protected:
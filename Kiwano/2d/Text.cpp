@@ -127,6 +127,19 @@ namespace kiwano
 	int Text::GetLineCount()
 	{
 		UpdateLayout();
+		if (sdf_font_)
+		{
+			if (text_.empty())
+				return 0;
+
+			int line_count = 1;
+			for (size_t i = 0; i < text_.length(); ++i)
+			{
+				if (text_[i] == L'\n')
+					++line_count;
+			}
+			return line_count;
+		}
 		if (text_layout_)
 		{
 			DWRITE_TEXT_METRICS metrics;
@@ -297,11 +310,34 @@ namespace kiwano
 		style_.outline_stroke = outline_stroke;
 	}
 
+	void Text::SetShadowColor(Color const& shadow_color)
+	{
+		style_.shadow_color = shadow_color;
+	}
+
+	void Text::SetShadowOffset(Point const& shadow_offset)
+	{
+		style_.shadow_offset = shadow_offset;
+	}
+
+	void Text::SetSdfFont(SdfFontPtr sdf_font)
+	{
+		if (sdf_font_ != sdf_font)
+		{
+			sdf_font_ = sdf_font;
+			layout_dirty_ = true;
+		}
+	}
+
 	void Text::OnRender()
 	{
 		UpdateLayout();
 
-		if (text_layout_)
+		if (sdf_font_)
+		{
+			RenderSdfText();
+		}
+		else if (text_layout_)
 		{
 			Renderer::Instance().SetTextStyle(
 				style_.color,
@@ -320,28 +356,61 @@ namespace kiwano
 			return;
 
 		layout_dirty_ = false;
-		text_format_ = nullptr;
 		text_layout_ = nullptr;
 
-		if (text_.empty())
+		if (sdf_font_)
+		{
+			layout_size_ = sdf_font_->GetGlyphAtlas().Layout(
+				text_,
+				font_.size,
+				style_.line_spacing,
+				style_.alignment,
+				sdf_quads_
+			);
 			return;
+		}
 
-		ThrowIfFailed(
-			Renderer::Instance().GetDeviceResources()->CreateTextFormat(
-				text_format_,
-				font_,
-				style_
-			)
-		);
+		auto device_resources = Renderer::Instance().GetDeviceResources();
+		if (text_.empty() || !device_resources)
+			return;
 
+		// texts with the same font, style and string share one layout
 		ThrowIfFailed(
-			Renderer::Instance().GetDeviceResources()->CreateTextLayout(
+			device_resources->GetTextCache().GetTextLayout(
 				text_layout_,
 				layout_size_,
 				text_,
-				text_format_,
+				font_,
 				style_
 			)
 		);
 	}
-}
+
+	void Text::RenderSdfText()
+	{
+		SdfGlyphAtlas::Style sdf_style;
+		sdf_style.color = style_.color;
+		sdf_style.outline_color = style_.outline_color;
+		sdf_style.outline_width = style_.outline ? style_.outline_width : 0.f;
+		sdf_style.shadow_color = style_.shadow_color;
+		sdf_style.shadow_offset = style_.shadow_offset;
+
+		const float scale = font_.size / sdf_font_->GetGlyphAtlas().GetBaseSize();
+
+		// quads on the same page share one bitmap and are merged into a sprite batch
+		int page = -1;
+		ComPtr<ID2D1Bitmap> bitmap;
+		for (const auto& quad : sdf_quads_)
+		{
+			if (quad.page != page)
+			{
+				page = quad.page;
+				bitmap = sdf_font_->GetPageBitmap(page, sdf_style, scale);
+
+				// styled pages may be evicted before the frame is submitted
+				Renderer::Instance().Retain(bitmap.Get());
+			}
+			Renderer::Instance().DrawBitmap(bitmap, quad.src_rect, quad.dest_rect);
+		}
+	}
+}
\ No newline at end of file
@@ -22,11 +22,12 @@
 #include "Node.h"
 #include "Font.hpp"
 #include "TextStyle.hpp"
+#include "SdfFont.h"
 #include <dwrite.h>
 
 namespace kiwano
 {
-	// ı
+	// 文本
 	class KGE_API Text
 		: public VisualNode
 	{
@@ -34,171 +35,192 @@ namespace kiwano
 		Text();
 
 		explicit Text(
-			String const& text		/*  */
+			String const& text		/* 文字内容 */
 		);
 
 		explicit Text(
-			String const& text,		/*  */
-			const Font& font		/*  */
+			String const& text,		/* 文字内容 */
+			const Font& font		/* 字体 */
 		);
 
 		explicit Text(
-			String const& text,		/*  */
-			const TextStyle& style	/* ıʽ */
+			String const& text,		/* 文字内容 */
+			const TextStyle& style	/* 文本样式 */
 		);
 
 		explicit Text(
-			String const& text,		/*  */
-			const Font& font,		/*  */
-			const TextStyle& style	/* ıʽ */
+			String const& text,		/* 文字内容 */
+			const Font& font,		/* 字体 */
+			const TextStyle& style	/* 文本样式 */
 		);
 
 		virtual ~Text();
 
-		// ȡı
+		// 获取文本
 		String const& GetText() const;
 
-		// ȡ
+		// 获取字体
 		const Font& GetFont() const;
 
-		// ȡıʽ
+		// 获取文本样式
 		const TextStyle& GetStyle() const;
 
-		// ȡ
+		// 获取字体族
 		String const& GetFontFamily() const;
 
-		// ȡǰֺ
+		// 获取当前字号
 		float GetFontSize() const;
 
-		// ȡǰϸֵ
+		// 获取当前字体粗细值
 		unsigned int GetFontWeight() const;
 
-		// ȡɫ
+		// 获取文字颜色
 		const Color& GetColor() const;
 
-		// ȡɫ
+		// 获取描边颜色
 		const Color& GetOutlineColor() const;
 
-		// ȡ߿
+		// 获取描边线宽
 		float GetOutlineWidth() const;
 
-		// ȡཻʽ
+		// 获取描边线相交样式
 		StrokeStyle GetOutlineStroke() const;
 
-		// ȡıʾ
+		// 获取文本显示行数
 		int GetLineCount();
 
-		// ȡֲִС
+		// 获取文字布局大小
 		Size const& GetLayoutSize() const;
 
-		// Ƿб
+		// 是否是斜体
 		bool IsItalic() const;
 
-		// Ƿʾɾ
+		// 是否显示删除线
 		bool HasStrikethrough() const;
 
-		// Ƿʾ»
+		// 是否显示下划线
 		bool HasUnderline() const;
 
-		// Ƿʾ
+		// 是否显示描边
 		bool HasOutline() const;
 
-		// ı
+		// 设置文本
 		void SetText(
 			String const& text
 		);
 
-		// ıʽ
+		// 设置文本样式
 		void SetStyle(
 			const TextStyle& style
 		);
 
-		// 
+		// 设置字体
 		void SetFont(
 			const Font& font
 		);
 
-		// 
+		// 设置字体族
 		void SetFontFamily(
 			String const& family
 		);
 
-		// ֺţĬֵΪ 18
+		// 设置字号（默认值为 18）
 		void SetFontSize(
 			float size
 		);
 
-		// ϸֵĬֵΪ FontWeight::Normal
+		// 设置字体粗细值（默认值为 FontWeight::Normal）
 		void SetFontWeight(
 			unsigned int weight
 		);
 
-		// ɫĬֵΪ Color::White
+		// 设置文字颜色（默认值为 Color::White）
 		void SetColor(
 			Color const& color
 		);
 
-		// б壨ĬֵΪ false
+		// 设置文字斜体（默认值为 false）
 		void SetItalic(
 			bool val
 		);
 
-		// 򿪻رıԶУĬΪرգ
+		// 打开或关闭文本自动换行（默认为关闭）
 		void SetWrapEnabled(
 			bool wrap
 		);
 
-		// ıԶеĿȣĬΪ 0
+		// 设置文本自动换行的宽度（默认为 0）
 		void SetWrapWidth(
 			float wrap_width
 		);
 
-		// мࣨĬΪ 0
+		// 设置行间距（默认为 0）
 		void SetLineacingPtr(
 			float line_spacing
 		);
 
-		// ö뷽ʽĬΪ TextAlign::Left
+		// 设置对齐方式（默认为 TextAlign::Left）
 		void SetAlignment(
 			TextAlign align
 		);
 
-		// »ߣĬֵΪ false
+		// 设置下划线（默认值为 false）
 		void SetUnderline(
 			bool underline
 		);
 
-		// ɾߣĬֵΪ false
+		// 设置删除线（默认值为 false）
 		void SetStrikethrough(
 			bool strikethrough
 		);
 
-		// Ƿʾ
+		// 设置是否显示描边
 		void SetOutline(
 			bool outline
 		);
 
-		// ɫ
+		// 设置描边颜色
 		void SetOutlineColor(
 			Color const& outline_color
 		);
 
-		// ߿
+		// 设置描边线宽
 		void SetOutlineWidth(
 			float outline_width
 		);
 
-		// ཻʽ
+		// 设置描边线相交样式
 		void SetOutlineStroke(
 			StrokeStyle outline_stroke
 		);
 
-		// Ĭ
+		// 设置阴影颜色 (仅距离场文字, 默认透明)
+		void SetShadowColor(
+			Color const& shadow_color
+		);
+
+		// 设置阴影偏移 (仅距离场文字, 默认为 (2, 2))
+		void SetShadowOffset(
+			Point const& shadow_offset
+		);
+
+		// 设置距离场字体
+		// 设置后文字由距离场字体排版, 绘制为字形图集上的矩形, 大量文字可以合并绘制
+		// 字号、颜色、描边、阴影、行间距和对齐方式有效, 不支持自动换行、下划线和删除线
+		// 传入空指针时恢复使用 DirectWrite
+		void SetSdfFont(
+			SdfFontPtr sdf_font
+		);
+
+		// 获取距离场字体
+		inline SdfFontPtr GetSdfFont() const	{ return sdf_font_; }
+
+		// 设置默认字体
 		static void SetDefaultFont(
 			Font const& font
 		);
 
-		// Ĭʽ
+		// 设置默认文字样式
 		static void SetDefaultStyle(
 			TextStyle const& style
 		);
@@ -208,6 +230,8 @@ namespace kiwano
 	protected:
 		void UpdateLayout() const;
 
+		void RenderSdfText();
+
 	protected:
 		String		text_;
 		Font		font_;
@@ -215,7 +239,9 @@ namespace kiwano
 
 		mutable bool layout_dirty_;
 		mutable Size layout_size_;
-		mutable ComPtr<IDWriteTextFormat>	text_format_;
 		mutable ComPtr<IDWriteTextLayout>	text_layout_;
+
+		SdfFontPtr sdf_font_;
+		mutable Array<SdfGlyphAtlas::Quad>	sdf_quads_;
 	};
 }
\ No newline at end of file
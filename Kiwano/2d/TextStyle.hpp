@@ -20,32 +20,27 @@
 
 #pragma once
 #include "include-forwards.h"
+#include "TextAlign.hpp"
 
 namespace kiwano
 {
-	// ı뷽ʽ
-	enum class TextAlign
-	{
-		Left,		/*  */
-		Right,		/* Ҷ */
-		Center		/* ж */
-	};
-
-	// ıʽ
+	// 文本样式
 	class KGE_API TextStyle
 	{
 	public:
-		Color		color;				// ɫ
-		TextAlign	alignment;			// 뷽ʽ
-		bool		wrap;				// Զ
-		float		wrap_width;			// Զп
-		float		line_spacing;		// м
-		bool		underline;			// »
-		bool		strikethrough;		// ɾ
-		bool		outline;			// ʾ
-		Color		outline_color;		// ɫ
-		float		outline_width;		// ߿
-		StrokeStyle	outline_stroke;		// ཻʽ
+		Color		color;				// 颜色
+		TextAlign	alignment;			// 对齐方式
+		bool		wrap;				// 打开自动换行
+		float		wrap_width;			// 自动换行宽度
+		float		line_spacing;		// 行间距
+		bool		underline;			// 下划线
+		bool		strikethrough;		// 删除线
+		bool		outline;			// 显示描边
+		Color		outline_color;		// 描边颜色
+		float		outline_width;		// 描边线宽
+		StrokeStyle	outline_stroke;		// 描边线相交样式
+		Color		shadow_color;		// 阴影颜色 (仅距离场文字)
+		Point		shadow_offset;		// 阴影偏移 (仅距离场文字)
 
 	public:
 		TextStyle()
@@ -60,6 +55,8 @@ namespace kiwano
 			, outline_color(Color(Color::Black, 0.5))
 			, outline_width(1.f)
 			, outline_stroke(StrokeStyle::Round)
+			, shadow_color(Color(Color::Black, 0.f))
+			, shadow_offset(2.f, 2.f)
 		{}
 
 		TextStyle(
@@ -86,6 +83,8 @@ namespace kiwano
 			, outline_color(outline_color)
 			, outline_width(outline_width)
 			, outline_stroke(outline_stroke)
+			, shadow_color(Color(Color::Black, 0.f))
+			, shadow_offset(2.f, 2.f)
 		{}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,227 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "TextureAtlas.h"
+#include "Image.h"
+#include "../base/logs.h"
+#include "../renderer/render.h"
+
+namespace kiwano
+{
+	TextureAtlas::TextureAtlas(int page_width, int page_height, int padding)
+		: padding_(std::max(padding, 0))
+		, packer_(page_width, page_height, 0)
+	{
+	}
+
+	TextureAtlas::~TextureAtlas()
+	{
+	}
+
+	ImagePtr TextureAtlas::Add(Resource const& res)
+	{
+		auto device_resources = Renderer::Instance().GetDeviceResources();
+		if (!device_resources)
+		{
+			KGE_WARNING_LOG(L"Add image to atlas failed, the renderer is not set up");
+			return nullptr;
+		}
+
+		ComPtr<IWICBitmapSource> source;
+		HRESULT hr = device_resources->CreateBitmapSource(source, res);
+		if (FAILED(hr))
+		{
+			KGE_ERROR_LOG(L"Load image file failed with HRESULT of %08X", hr);
+			return nullptr;
+		}
+
+		UINT width = 0, height = 0;
+		source->GetSize(&width, &height);
+
+		// the packer only sees the extruded size, the padding belongs to the image
+		RectPacker::Box box;
+		packer_.Insert(static_cast<int>(width) + padding_ * 2, static_cast<int>(height) + padding_ * 2, box);
+		return CreateImage(res, source.Get(), box);
+	}
+
+	Array<ImagePtr> TextureAtlas::Add(Array<Resource> const& res_arr)
+	{
+		Array<ImagePtr> images;
+
+		auto device_resources = Renderer::Instance().GetDeviceResources();
+		if (!device_resources)
+		{
+			KGE_WARNING_LOG(L"Add image to atlas failed, the renderer is not set up");
+			return images;
+		}
+
+		// decode everything first so that the packer sees all sizes at once
+		Array<ComPtr<IWICBitmapSource>> sources;
+		Array<RectPacker::Box> boxes;
+		sources.reserve(res_arr.size());
+		boxes.reserve(res_arr.size());
+
+		for (const auto& res : res_arr)
+		{
+			ComPtr<IWICBitmapSource> source;
+			HRESULT hr = device_resources->CreateBitmapSource(source, res);
+
+			UINT width = 0, height = 0;
+			if (SUCCEEDED(hr))
+			{
+				source->GetSize(&width, &height);
+			}
+			else
+			{
+				KGE_ERROR_LOG(L"Load image file failed with HRESULT of %08X", hr);
+				source = nullptr;
+			}
+
+			sources.push_back(source);
+			boxes.push_back(RectPacker::Box{ -1, 0, 0, static_cast<int>(width) + padding_ * 2, static_cast<int>(height) + padding_ * 2 });
+		}
+
+		packer_.Insert(boxes);
+
+		// keep an empty slot for failed images so indices match res_arr
+		images.reserve(res_arr.size());
+		for (size_t i = 0; i < res_arr.size(); ++i)
+		{
+			ImagePtr image;
+			if (sources[i])
+				image = CreateImage(res_arr[i], sources[i].Get(), boxes[i]);
+			images.push_back(image);
+		}
+		return images;
+	}
+
+	ImagePtr TextureAtlas::CreateImage(Resource const& res, IWICBitmapSource* source, RectPacker::Box const& box)
+	{
+		auto device_resources = Renderer::Instance().GetDeviceResources();
+
+		HRESULT hr = S_OK;
+		if (box.page < 0)
+		{
+			// larger than a page, use a bitmap of its own
+			ComPtr<ID2D1Bitmap> bitmap;
+			hr = device_resources->CreateBitmapFromSource(bitmap, source);
+
+			if (FAILED(hr))
+			{
+				KGE_ERROR_LOG(L"Create bitmap failed with HRESULT of %08X", hr);
+				return nullptr;
+			}
+			return new (std::nothrow) Image(bitmap);
+		}
+
+		const auto page_width = static_cast<UINT32>(packer_.GetPageWidth());
+		const auto page_height = static_cast<UINT32>(packer_.GetPageHeight());
+
+		while (SUCCEEDED(hr) && static_cast<int>(pages_.size()) <= box.page)
+		{
+			// pages start transparent, the padding between images stays that way
+			Array<BYTE> blank(page_width * page_height * 4, 0);
+
+			ComPtr<ID2D1Bitmap> page;
+			hr = device_resources->CreateBitmap(
+				page,
+				D2D1::SizeU(page_width, page_height),
+				blank.data(),
+				page_width * 4
+			);
+
+			if (SUCCEEDED(hr))
+			{
+				pages_.push_back(page);
+			}
+		}
+
+		// box covers the image plus the extruded border on every side
+		const auto pad = static_cast<UINT32>(padding_);
+		const auto box_width = static_cast<UINT32>(box.width);
+		const auto box_height = static_cast<UINT32>(box.height);
+		const auto width = box_width - pad * 2;
+		const auto height = box_height - pad * 2;
+		const UINT32 stride = box_width * 4;
+
+		if (SUCCEEDED(hr))
+		{
+			pixels_.resize(stride * box_height);
+			hr = source->CopyPixels(nullptr, stride, static_cast<UINT>(pixels_.size() - stride * pad - pad * 4), pixels_.data() + stride * pad + pad * 4);
+		}
+
+		if (SUCCEEDED(hr) && pad)
+		{
+			ExtrudeEdges(pixels_.data(), box_width, box_height, pad);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			const auto x = static_cast<UINT32>(box.x);
+			const auto y = static_cast<UINT32>(box.y);
+			const auto dest_rect = D2D1::RectU(x, y, x + box_width, y + box_height);
+			hr = pages_[box.page]->CopyFromMemory(&dest_rect, pixels_.data(), stride);
+		}
+
+		if (FAILED(hr))
+		{
+			KGE_ERROR_LOG(L"Add image to atlas failed with HRESULT of %08X", hr);
+			return nullptr;
+		}
+
+		return new (std::nothrow) Image(
+			pages_[box.page],
+			Rect{ static_cast<float>(box.x + padding_), static_cast<float>(box.y + padding_), static_cast<float>(width), static_cast<float>(height) }
+		);
+	}
+
+	void TextureAtlas::ExtrudeEdges(BYTE* pixels, UINT32 width, UINT32 height, UINT32 pad)
+	{
+		const UINT32 stride = width * 4;
+
+		// repeat the first and last column of every image row into the side padding
+		for (UINT32 y = pad; y < height - pad; ++y)
+		{
+			UINT32* row = reinterpret_cast<UINT32*>(pixels + stride * y);
+			const UINT32 left = row[pad];
+			const UINT32 right = row[width - pad - 1];
+			for (UINT32 x = 0; x < pad; ++x)
+			{
+				row[x] = left;
+				row[width - x - 1] = right;
+			}
+		}
+
+		// then repeat the first and last full row into the top and bottom padding
+		const BYTE* top = pixels + stride * pad;
+		const BYTE* bottom = pixels + stride * (height - pad - 1);
+		for (UINT32 y = 0; y < pad; ++y)
+		{
+			::memcpy(pixels + stride * y, top, stride);
+			::memcpy(pixels + stride * (height - y - 1), bottom, stride);
+		}
+	}
+
+	void TextureAtlas::Clear()
+	{
+		packer_.Reset();
+		pages_.clear();
+	}
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "include-forwards.h"
+#include "../base/Resource.h"
+#include "../utils/RectPacker.h"
+#include <d2d1.h>
+
+namespace kiwano
+{
+	// 纹理图集
+	// 把多张小图片打包进共享的页面位图, 图片成为页面上的一个区域,
+	// 使用同一页面的精灵可以合并绘制, 也减少了逐张位图的显存浪费
+	// 图片四周会用边缘像素向外扩展, 缩放或小数坐标下采样时不会混入相邻图片
+	class KGE_API TextureAtlas
+		: public virtual Object
+	{
+	public:
+		TextureAtlas(
+			int page_width = 1024,	// 页面宽度
+			int page_height = 1024,	// 页面高度
+			int padding = 1			// 图片四周扩展的边缘像素宽度
+		);
+
+		virtual ~TextureAtlas();
+
+		// 添加图片
+		// 图片大于页面时单独创建位图
+		ImagePtr Add(
+			Resource const& res
+		);
+
+		// 添加多张图片
+		// 先解码全部图片, 按尺寸排序后装箱, 密度比逐张添加更高
+		// 返回的数组与 res_arr 一一对应, 加载失败的位置为空
+		Array<ImagePtr> Add(
+			Array<Resource> const& res_arr
+		);
+
+		// 清空所有页面, 已创建的图片仍然可用
+		void Clear();
+
+		// 获取页面数量
+		inline int GetPageCount() const			{ return packer_.GetPageCount(); }
+
+		// 获取页面填充率
+		inline float GetOccupancy() const		{ return packer_.GetOccupancy(); }
+
+		// 获取页面位图
+		inline ComPtr<ID2D1Bitmap> const& GetPage(int index) const	{ return pages_[index]; }
+
+	private:
+		ImagePtr CreateImage(
+			Resource const& res,
+			IWICBitmapSource* source,
+			RectPacker::Box const& box
+		);
+
+		static void ExtrudeEdges(
+			BYTE* pixels,
+			UINT32 width,
+			UINT32 height,
+			UINT32 pad
+		);
+
+	private:
+		int							padding_;
+		RectPacker					packer_;
+		Array<ComPtr<ID2D1Bitmap>>	pages_;
+		Array<BYTE>					pixels_;
+	};
+}
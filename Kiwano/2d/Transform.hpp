@@ -26,10 +26,10 @@ namespace kiwano
 	class Transform
 	{
 	public:
-		float rotation;		// ת
-		Point position;		// 
-		Point scale;		// 
-		Point skew;			// нǶ
+		float rotation;		// 旋转
+		Point position;		// 坐标
+		Point scale;		// 缩放
+		Point skew;			// 错切角度
 
 	public:
 		Transform()
@@ -26,7 +26,7 @@ namespace kiwano
 {
 	class Scene;
 
-	// 
+	// 场景过渡
 	class KGE_API Transition
 		: public virtual Object
 	{
@@ -70,17 +70,17 @@ namespace kiwano
 	};
 
 
-	// 뵭
+	// 淡入淡出过渡
 	class FadeTransition
 		: public Transition
 	{
 	public:
 		explicit FadeTransition(
-			Duration duration	/* ʱ */
+			Duration duration	/* 动画持续时长 */
 		);
 
 	protected:
-		// ¶
+		// 更新动画
 		void Update(Duration dt) override;
 
 		virtual void Init(
@@ -90,13 +90,13 @@ namespace kiwano
 	};
 
 
-	// 
+	// 渐变过渡
 	class EmergeTransition
 		: public Transition
 	{
 	public:
 		explicit EmergeTransition(
-			Duration duration	/* ʱ */
+			Duration duration	/* 动画持续时长 */
 		);
 
 	protected:
@@ -109,13 +109,13 @@ namespace kiwano
 	};
 
 
-	// ״
+	// 盒状过渡
 	class BoxTransition
 		: public Transition
 	{
 	public:
 		explicit BoxTransition(
-			Duration duration	/* ʱ */
+			Duration duration	/* 动画持续时长 */
 		);
 
 	protected:
@@ -128,14 +128,14 @@ namespace kiwano
 	};
 
 
-	// λƹ
+	// 位移过渡
 	class MoveTransition
 		: public Transition
 	{
 	public:
 		explicit MoveTransition(
-			Duration moveDuration,	/* ʱ */
-			Direction direction				/* ƶ */
+			Duration moveDuration,	/* 动画持续时长 */
+			Direction direction				/* 移动方向 */
 		);
 
 	protected:
@@ -155,14 +155,14 @@ namespace kiwano
 	};
 
 
-	// ת
+	// 旋转过渡
 	class RotationTransition
 		: public Transition
 	{
 	public:
 		explicit RotationTransition(
-			Duration moveDuration,	/* ʱ */
-			float rotation = 360			/* ת */
+			Duration moveDuration,	/* 动画持续时长 */
+			float rotation = 360			/* 旋转度数 */
 		);
 
 	protected:
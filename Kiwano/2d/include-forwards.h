@@ -22,7 +22,7 @@
 #include "Color.h"
 #include "../common/helper.h"
 #include "../common/ComPtr.hpp"
-#include "../common/Closure.hpp"
+#include "../common/closure.hpp"
 #include "../common/Singleton.hpp"
 #include "../common/IntrusiveList.hpp"
 #include "../base/time.h"
@@ -35,6 +35,7 @@ namespace kiwano
 {
 	KGE_DECLARE_SMART_PTR(Image);
 	KGE_DECLARE_SMART_PTR(Frames);
+	KGE_DECLARE_SMART_PTR(TextureAtlas);
 
 	KGE_DECLARE_SMART_PTR(Geometry);
 	KGE_DECLARE_SMART_PTR(LineGeometry);
@@ -49,6 +50,7 @@ namespace kiwano
 	KGE_DECLARE_SMART_PTR(Layer);
 	KGE_DECLARE_SMART_PTR(Sprite);
 	KGE_DECLARE_SMART_PTR(Text);
+	KGE_DECLARE_SMART_PTR(SdfFont);
 	KGE_DECLARE_SMART_PTR(Canvas);
 	KGE_DECLARE_SMART_PTR(GeometryNode);
 
@@ -84,29 +86,29 @@ namespace kiwano
 
 namespace kiwano
 {
-	// ʽ
+	// 画笔样式
 	enum class StrokeStyle : int
 	{
-		Miter = 0,	/* б */
-		Bevel = 1,	/* б */
-		Round = 2	/* Բ */
+		Miter = 0,	/* 斜切 */
+		Bevel = 1,	/* 斜角 */
+		Round = 2	/* 圆角 */
 	};
 
-	// 
+	// 方向
 	enum class Direction : int
 	{
-		Up,		/*  */
-		Down,	/*  */
-		Left,	/*  */
-		Right	/*  */
+		Up,		/* 上 */
+		Down,	/* 下 */
+		Left,	/* 左 */
+		Right	/* 右 */
 	};
 
-	// ָ
+	// 鼠标指针
 	enum class MouseCursor : int
 	{
-		Arrow,		/* ָ */
-		TextInput,	/* ı */
-		Hand,		/* ָ */
+		Arrow,		/* 指针 */
+		TextInput,	/* 输入文本 */
+		Hand,		/* 手指 */
 		SizeAll,
 		SizeNESW,
 		SizeNS,
@@ -114,16 +116,16 @@ namespace kiwano
 		SizeWE,
 	};
 
-	// ֿ
+	// 文字抗锯齿属性
 	enum class TextAntialias
 	{
-		Default,	// ϵͳĬ
-		ClearType,	// ClearType 
-		GrayScale,	// Ҷȿ
-		None		// ÿ
+		Default,	// 系统默认
+		ClearType,	// ClearType 抗锯齿
+		GrayScale,	// 灰度抗锯齿
+		None		// 不启用抗锯齿
 	};
 
-	// ͼ
+	// 图层属性
 	struct LayerProperties
 	{
 		Rect area;
@@ -0,0 +1,49 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#pragma once
+#include "VoicePool.h"
+
+namespace kiwano
+{
+	// 音频解码器
+	// 按顺序逐段输出 PCM 数据, 供流式播放使用
+	class KGE_API AudioDecoder
+		: protected Noncopyable
+	{
+	public:
+		virtual ~AudioDecoder() {}
+
+		// 获取输出的音频格式
+		virtual AudioFormat const& GetFormat() const = 0;
+
+		// 获取时长, 未知时为 0
+		virtual Duration GetDuration() const = 0;
+
+		// 读取 PCM 数据
+		// 返回实际读取的字节数, 小于 size 时表示已读到末尾
+		virtual std::uint32_t Read(
+			std::uint8_t* data,
+			std::uint32_t size
+		) = 0;
+
+		// 回到开头重新解码
+		virtual bool Rewind() = 0;
+	};
+}
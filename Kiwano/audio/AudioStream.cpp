@@ -0,0 +1,294 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include "AudioStream.h"
+#include "../base/logs.h"
+#include <chrono>
+
+namespace kiwano
+{
+	AudioStream::AudioStream(AudioDevice* device, AudioDecoder* decoder, size_t buffer_count, Duration buffer_duration)
+		: device_(device)
+		, decoder_(decoder)
+		, voice_(nullptr)
+		, buffer_count_(std::max(buffer_count, size_t(2)))
+		, buffer_size_(0)
+		, volume_(1.f)
+		, submitted_(0)
+		, generation_(0)
+		, loops_left_(0)
+		, active_(false)
+		, paused_(false)
+		, restart_(false)
+		, end_of_stream_(false)
+		, quit_(false)
+	{
+		KGE_ASSERT(device_ && decoder_ && "AudioStream needs an audio device and a decoder");
+
+		AudioFormat const& format = decoder_->GetFormat();
+		const std::uint32_t block_align = format.GetBlockAlign();
+		const std::uint64_t bytes_per_sec = static_cast<std::uint64_t>(block_align) * format.sample_rate;
+
+		if (block_align)
+		{
+			// buffers hold whole sample frames
+			std::uint64_t frames = bytes_per_sec * buffer_duration.Milliseconds() / 1000 / block_align;
+			buffer_size_ = static_cast<std::uint32_t>(std::max(frames, std::uint64_t(1)) * block_align);
+			buffer_duration_.SetNanoseconds(static_cast<long long>(buffer_size_ * 1000000000ULL / bytes_per_sec));
+
+			ring_.resize(buffer_count_ * buffer_size_);
+		}
+	}
+
+	AudioStream::~AudioStream()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			quit_ = true;
+		}
+		cond_.notify_one();
+
+		if (worker_.joinable())
+		{
+			worker_.join();
+		}
+
+		if (voice_)
+		{
+			voice_->Flush();
+			delete voice_;
+			voice_ = nullptr;
+		}
+
+		delete decoder_;
+		decoder_ = nullptr;
+	}
+
+	bool AudioStream::Play(int loop_count)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			if (ring_.empty())
+				return false;
+
+			if (!voice_)
+			{
+				voice_ = device_->CreateVoice(decoder_->GetFormat());
+				if (!voice_)
+				{
+					KGE_ERROR_LOG(L"Create voice for audio stream failed");
+					return false;
+				}
+				voice_->SetVolume(volume_);
+			}
+
+			// the worker rewinds the decoder and refills the ring once the
+			// flushed buffers are released by the device
+			voice_->Flush();
+
+			++generation_;
+			loops_left_ = loop_count;
+			active_ = true;
+			paused_ = false;
+			restart_ = true;
+			end_of_stream_ = false;
+
+			voice_->Start();
+
+			// buffers are decoded on the worker thread only
+			if (!worker_.joinable())
+			{
+				worker_ = std::thread(&AudioStream::Run, this);
+			}
+		}
+		cond_.notify_one();
+		return true;
+	}
+
+	void AudioStream::Pause()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (active_ && voice_)
+		{
+			paused_ = true;
+			voice_->Pause();
+		}
+	}
+
+	void AudioStream::Resume()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			if (!active_ || !paused_ || !voice_)
+				return;
+
+			paused_ = false;
+			voice_->Start();
+		}
+		cond_.notify_one();
+	}
+
+	void AudioStream::Stop()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		++generation_;
+		active_ = false;
+		paused_ = false;
+
+		if (voice_)
+		{
+			voice_->Flush();
+		}
+	}
+
+	bool AudioStream::IsPlaying() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (!active_ || paused_)
+			return false;
+
+		return !(end_of_stream_ && voice_->IsFinished());
+	}
+
+	bool AudioStream::IsPaused() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return active_ && paused_;
+	}
+
+	void AudioStream::SetVolume(float volume)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		volume_ = volume;
+		if (voice_)
+		{
+			voice_->SetVolume(volume);
+		}
+	}
+
+	AudioFormat const& AudioStream::GetFormat() const
+	{
+		return decoder_->GetFormat();
+	}
+
+	Duration AudioStream::GetDuration() const
+	{
+		return decoder_->GetDuration();
+	}
+
+	void AudioStream::Run()
+	{
+		// check the voice a few times per buffer so that it never runs dry
+		const auto interval = std::chrono::microseconds(std::max(buffer_duration_.Microseconds() / 4, 1000LL));
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		while (!quit_)
+		{
+			Fill(lock);
+			cond_.wait_for(lock, interval);
+		}
+	}
+
+	void AudioStream::Fill(std::unique_lock<std::mutex>& lock)
+	{
+		if (restart_ && active_)
+		{
+			// flushing is asynchronous, the ring may still be read until nothing is queued
+			if (voice_->GetQueuedCount() != 0)
+				return;
+
+			const std::uint64_t generation = generation_;
+			restart_ = false;
+
+			lock.unlock();
+			const bool rewound = decoder_->Rewind();
+			lock.lock();
+
+			if (generation != generation_)
+				return;
+
+			if (!rewound)
+			{
+				active_ = false;
+				return;
+			}
+			submitted_ = 0;
+		}
+
+		// buffers are consumed in order, so the slot after the queued ones is always free
+		while (active_ && !restart_ && !end_of_stream_ && !quit_ && voice_->GetQueuedCount() < buffer_count_)
+		{
+			std::uint8_t* buffer = &ring_[static_cast<size_t>(submitted_ % buffer_count_) * buffer_size_];
+			const std::uint64_t generation = generation_;
+			int loops_left = loops_left_;
+			bool end_of_stream = false;
+			std::uint32_t size = 0;
+			bool rewound = false;
+
+			// only this thread touches the decoder and the free slot, decode without the lock
+			lock.unlock();
+			while (true)
+			{
+				std::uint32_t read = decoder_->Read(buffer + size, buffer_size_ - size);
+				size += read;
+
+				if (size == buffer_size_)
+					break;
+
+				if (read)
+					rewound = false;
+
+				// reached the end, an empty pass after rewinding means there is no data at all
+				if (loops_left == 0 || rewound || !decoder_->Rewind())
+				{
+					end_of_stream = true;
+					break;
+				}
+
+				if (loops_left > 0)
+					--loops_left;
+				rewound = true;
+			}
+			lock.lock();
+
+			// stopped or restarted while decoding, the data is stale
+			if (generation != generation_)
+				break;
+
+			loops_left_ = loops_left;
+			end_of_stream_ = end_of_stream;
+
+			if (size)
+			{
+				if (!voice_->Queue(buffer, size, end_of_stream_))
+				{
+					active_ = false;
+					break;
+				}
+				++submitted_;
+			}
+		}
+	}
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#pragma once
+#include "AudioDecoder.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace kiwano
+{
+	KGE_DECLARE_SMART_PTR(AudioStream);
+
+	// 音频流
+	// 只保留少量解码后的缓冲区, 后台线程在缓冲区播放完毕后继续解码并提交,
+	// 适用于较长的背景音乐
+	class KGE_API AudioStream
+		: public Object
+	{
+	public:
+		AudioStream(
+			AudioDevice* device,			/* 音频设备 */
+			AudioDecoder* decoder,			/* 解码器, 由音频流负责释放 */
+			size_t buffer_count = 3,		/* 缓冲区数量 */
+			Duration buffer_duration = 250	/* 每个缓冲区的时长 */
+		);
+
+		virtual ~AudioStream();
+
+		// 播放
+		bool Play(
+			int loop_count = 0				/* 播放循环次数 (-1 为循环播放) */
+		);
+
+		// 暂停
+		void Pause();
+
+		// 继续
+		void Resume();
+
+		// 停止
+		void Stop();
+
+		// 是否正在播放
+		bool IsPlaying() const;
+
+		// 是否已暂停
+		bool IsPaused() const;
+
+		// 设置音量
+		void SetVolume(
+			float volume
+		);
+
+		// 获取音频格式
+		AudioFormat const& GetFormat() const;
+
+		// 获取时长
+		Duration GetDuration() const;
+
+		// 获取缓冲区占用的内存大小
+		inline size_t GetBufferSize() const	{ return ring_.size(); }
+
+	private:
+		// 后台解码线程
+		void Run();
+
+		// 填充空闲的缓冲区, 解码时释放锁
+		void Fill(
+			std::unique_lock<std::mutex>& lock
+		);
+
+	private:
+		AudioDevice*			device_;
+		AudioDecoder*			decoder_;
+		AudioVoice*				voice_;
+		Array<std::uint8_t>		ring_;
+		size_t					buffer_count_;
+		std::uint32_t			buffer_size_;
+		Duration				buffer_duration_;
+		float					volume_;
+		std::uint64_t			submitted_;		// 只在后台线程中访问
+		std::uint64_t			generation_;	// 每次播放或停止时递增, 丢弃过期的解码结果
+		int						loops_left_;
+		bool					active_;
+		bool					paused_;
+		bool					restart_;		// 等待设备放开旧数据后从头解码
+		bool					end_of_stream_;
+		bool					quit_;
+		std::thread				worker_;
+		mutable std::mutex		mutex_;
+		std::condition_variable	cond_;
+	};
+}
@@ -23,72 +23,134 @@
 
 namespace kiwano
 {
+	namespace
+	{
+		KGE_DECLARE_SMART_PTR(PreloadData);
+
+		// shared between the worker thread and the callback, touched by one side at a time
+		class PreloadData
+			: public Object
+		{
+		public:
+			Array<Resource>			resources;
+			Array<SoundBufferPtr>	buffers;
+		};
+	}
+
 	Player::Player()
 		: volume_(1.f)
+		, cache_budget_(64 * 1024 * 1024)
+		, cache_stats_()
 	{
 	}
 
 	Player::~Player()
 	{
+		// the callbacks of cancelled tasks are not called
+		for (const auto& task : preload_tasks_)
+		{
+			task->Cancel();
+		}
+
 		ClearCache();
 	}
 
 	bool Player::Load(Resource const& res)
 	{
-		size_t hash_code = res.GetHashCode();
-		if (sound_cache_.end() != sound_cache_.find(hash_code))
-			return true;
+		return Get(res) != nullptr;
+	}
 
-		SoundPtr sound = new (std::nothrow) Sound();
+	void Player::Preload(Array<Resource> const& res_list, Closure<void()> const& callback)
+	{
+		PreloadDataPtr data = new (std::nothrow) PreloadData;
+		if (!data)
+			return;
+
+		for (const auto& res : res_list)
+		{
+			if (sound_cache_.find(res.GetHashCode()) == sound_cache_.end())
+				data->resources.push_back(res);
+		}
 
-		if (sound)
+		PreloadData* shared = data.Get();
+		AsyncTaskPtr task = new AsyncTask([shared]()
 		{
-			if (sound->Load(res))
+			HRESULT hr = ::CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+			shared->buffers.reserve(shared->resources.size());
+			for (const auto& res : shared->resources)
 			{
-				sound->SetVolume(volume_);
-				sound_cache_.insert(std::make_pair(hash_code, sound));
-				return true;
+				shared->buffers.push_back(Sound::LoadBuffer(res));
 			}
-		}
-		return false;
+
+			if (SUCCEEDED(hr))
+				::CoUninitialize();
+		});
+
+		AsyncTask* current = task.Get();
+		task->SetCallback([this, data, current, callback]()
+		{
+			for (size_t i = 0; i < data->buffers.size(); i++)
+			{
+				size_t hash_code = data->resources[i].GetHashCode();
+				if (!data->buffers[i] || sound_cache_.find(hash_code) != sound_cache_.end())
+					continue;
+
+				SoundPtr sound = new (std::nothrow) Sound(data->buffers[i]);
+				if (sound)
+				{
+					sound->SetVolume(volume_);
+					Insert(hash_code, sound);
+				}
+			}
+			Trim();
+
+			auto iter = std::find(preload_tasks_.begin(), preload_tasks_.end(), current);
+			if (iter != preload_tasks_.end())
+				preload_tasks_.erase(iter);
+
+			if (callback)
+				callback();
+		});
+
+		preload_tasks_.push_back(task);
+		task->Start();
 	}
 
 	void Player::Play(Resource const& res, int loop_count)
 	{
-		if (Load(res))
-		{
-			size_t hash_code = res.GetHashCode();
-			if (sound_cache_.end() != sound_cache_.find(hash_code))
-				sound_cache_[hash_code]->Play(loop_count);
-		}
+		if (Sound* sound = Get(res))
+			sound->Play(loop_count);
 	}
 
 	void Player::Pause(Resource const& res)
 	{
-		size_t hash_code = res.GetHashCode();
-		if (sound_cache_.end() != sound_cache_.find(hash_code))
-			sound_cache_[hash_code]->Pause();
+		if (Sound* sound = Find(res))
+			sound->Pause();
 	}
 
 	void Player::Resume(Resource const& res)
 	{
-		size_t hash_code = res.GetHashCode();
-		if (sound_cache_.end() != sound_cache_.find(hash_code))
-			sound_cache_[hash_code]->Resume();
+		if (Sound* sound = Find(res))
+			sound->Resume();
 	}
 
 	void Player::Stop(Resource const& res)
 	{
-		size_t hash_code = res.GetHashCode();
-		if (sound_cache_.end() != sound_cache_.find(hash_code))
-			sound_cache_[hash_code]->Stop();
+		if (Sound* sound = Find(res))
+			sound->Stop();
+	}
+
+	void Player::SetMaxVoices(Resource const& res, size_t max_voices)
+	{
+		if (Sound* sound = Get(res))
+			sound->SetMaxVoices(max_voices);
 	}
 
 	bool Player::IsPlaying(Resource const& res)
 	{
-		size_t hash_code = res.GetHashCode();
-		if (sound_cache_.end() != sound_cache_.find(hash_code))
-			return sound_cache_[hash_code]->IsPlaying();
+		if (Sound* sound = Find(res))
+			return sound->IsPlaying();
 		return false;
 	}
 
@@ -102,7 +164,7 @@ namespace kiwano
 		volume_ = std::min(std::max(volume, -224.f), 224.f);
 		for (const auto& pair : sound_cache_)
 		{
-			pair.second->SetVolume(volume_);
+			pair.second.sound->SetVolume(volume_);
 		}
 	}
 
@@ -110,7 +172,7 @@ namespace kiwano
 	{
 		for (const auto& pair : sound_cache_)
 		{
-			pair.second->Pause();
+			pair.second.sound->Pause();
 		}
 	}
 
@@ -118,7 +180,7 @@ namespace kiwano
 	{
 		for (const auto& pair : sound_cache_)
 		{
-			pair.second->Resume();
+			pair.second.sound->Resume();
 		}
 	}
 
@@ -126,12 +188,90 @@ namespace kiwano
 	{
 		for (const auto& pair : sound_cache_)
 		{
-			pair.second->Stop();
+			pair.second.sound->Stop();
 		}
 	}
 
 	void Player::ClearCache()
 	{
 		sound_cache_.clear();
+		cache_order_.clear();
+		cache_stats_.bytes = 0;
+		cache_stats_.count = 0;
+	}
+
+	void Player::SetCacheBudget(size_t bytes)
+	{
+		cache_budget_ = bytes;
+		Trim();
+	}
+
+	Sound* Player::Find(Resource const& res)
+	{
+		auto iter = sound_cache_.find(res.GetHashCode());
+		if (iter == sound_cache_.end())
+			return nullptr;
+
+		CacheEntry& entry = iter->second;
+		cache_order_.splice(cache_order_.begin(), cache_order_, entry.order);
+		return entry.sound.Get();
+	}
+
+	Sound* Player::Get(Resource const& res)
+	{
+		if (Sound* sound = Find(res))
+		{
+			++cache_stats_.hits;
+			return sound;
+		}
+
+		++cache_stats_.misses;
+
+		SoundPtr sound = new (std::nothrow) Sound();
+		if (!sound || !sound->Load(res))
+			return nullptr;
+
+		sound->SetVolume(volume_);
+
+		Sound* inserted = Insert(res.GetHashCode(), sound);
+		Trim();
+		return inserted;
+	}
+
+	Sound* Player::Insert(size_t hash_code, SoundPtr sound)
+	{
+		cache_order_.push_front(hash_code);
+
+		CacheEntry& entry = sound_cache_[hash_code];
+		entry.sound = sound;
+		entry.bytes = sound->GetMemoryUsage();
+		entry.order = cache_order_.begin();
+
+		cache_stats_.bytes += entry.bytes;
+		cache_stats_.count = sound_cache_.size();
+		return entry.sound.Get();
+	}
+
+	void Player::Trim()
+	{
+		if (!cache_budget_ || cache_order_.empty())
+			return;
+
+		// the most recently used sound always stays, active sounds are pinned
+		auto iter = cache_order_.end();
+		auto first = cache_order_.begin();
+		while (cache_stats_.bytes > cache_budget_ && --iter != first)
+		{
+			auto found = sound_cache_.find(*iter);
+			if (found->second.sound->IsActive())
+				continue;
+
+			cache_stats_.bytes -= found->second.bytes;
+			++cache_stats_.evictions;
+
+			sound_cache_.erase(found);
+			iter = cache_order_.erase(iter);
+		}
+		cache_stats_.count = sound_cache_.size();
 	}
-}
\ No newline at end of file
+}
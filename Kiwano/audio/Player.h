@@ -24,70 +24,139 @@ namespace kiwano
 {
 	KGE_DECLARE_SMART_PTR(Player);
 
-	// ֲ
+	// 音乐播放器
+	// 已加载的音乐按使用顺序缓存, 超出内存预算时释放最久未使用的音乐,
+	// 正在播放或暂停的音乐不会被释放
 	class KGE_API Player
 		: protected Object
 	{
-		using MusicMap = Map<size_t, SoundPtr>;
+	public:
+		// 缓存统计
+		struct CacheStats
+		{
+			size_t hits;		// 命中次数
+			size_t misses;		// 未命中次数
+			size_t evictions;	// 释放次数
+			size_t bytes;		// 占用的内存大小
+			size_t count;		// 缓存的音乐数量
+		};
 
 	public:
 		Player();
 
 		~Player();
 
-		// ԤԴ
+		// 预加载音乐资源
 		bool Load(
-			Resource const& res			/* Դ */
+			Resource const& res			/* 音乐资源 */
+		);
+
+		// 在后台线程中预加载音乐资源
+		// 全部加载后在主线程中执行回调
+		void Preload(
+			Array<Resource> const& res_list,		/* 音乐资源列表 */
+			Closure<void()> const& callback = nullptr	/* 回调函数 */
 		);
 
-		// 
+		// 播放音乐
 		void Play(
-			Resource const& res,	/* Դ */
-			int loop_count = 0		/* ѭ (-1 Ϊѭ) */
+			Resource const& res,	/* 音乐资源 */
+			int loop_count = 0		/* 播放循环次数 (-1 为循环播放) */
 		);
 
-		// ͣ
+		// 暂停音乐
 		void Pause(
-			Resource const& res		/* Դ */
+			Resource const& res		/* 音乐资源 */
 		);
 
-		// 
+		// 继续播放音乐
 		void Resume(
-			Resource const& res		/* Դ */
+			Resource const& res		/* 音乐资源 */
 		);
 
-		// ֹͣ
+		// 停止音乐
 		void Stop(
-			Resource const& res		/* Դ */
+			Resource const& res		/* 音乐资源 */
+		);
+
+		// 设置音乐最多同时播放的次数
+		void SetMaxVoices(
+			Resource const& res,	/* 音乐资源 */
+			size_t max_voices		/* 最多同时播放的次数 */
 		);
 
-		// ȡֲ״̬
+		// 获取音乐播放状态
 		bool IsPlaying(
-			Resource const& res		/* Դ */
+			Resource const& res		/* 音乐资源 */
 		);
 
-		// ȡ
+		// 获取音量
 		float GetVolume() const;
 
-		// 
+		// 设置音量
 		void SetVolume(
-			float volume			/* 1.0 Ϊԭʼ */
+			float volume			/* 1.0 为原始音量 */
 		);
 
-		// ͣ
+		// 暂停所有音乐
 		void PauseAll();
 
-		// 
+		// 继续播放所有音乐
 		void ResumeAll();
 
-		// ֹͣ
+		// 停止所有音乐
 		void StopAll();
 
-		// 
+		// 清除缓存
 		void ClearCache();
 
+		// 设置缓存的内存预算 (字节)
+		// 默认为 64 MB, 0 表示不限制
+		void SetCacheBudget(
+			size_t bytes
+		);
+
+		// 获取缓存的内存预算
+		inline size_t GetCacheBudget() const			{ return cache_budget_; }
+
+		// 获取缓存统计
+		inline CacheStats const& GetCacheStats() const	{ return cache_stats_; }
+
+	protected:
+		struct CacheEntry
+		{
+			SoundPtr					sound;
+			size_t						bytes;
+			List<size_t>::iterator		order;
+		};
+
+		using MusicMap = UnorderedMap<size_t, CacheEntry>;
+
+		// 查找已缓存的音乐并标记为最近使用
+		Sound* Find(
+			Resource const& res
+		);
+
+		// 查找已缓存的音乐, 未缓存时加载音乐
+		Sound* Get(
+			Resource const& res
+		);
+
+		// 加入缓存
+		Sound* Insert(
+			size_t hash_code,
+			SoundPtr sound
+		);
+
+		// 释放最久未使用的音乐直到满足内存预算
+		void Trim();
+
 	protected:
-		float		volume_;
-		MusicMap	sound_cache_;
+		float				volume_;
+		size_t				cache_budget_;
+		CacheStats			cache_stats_;
+		List<size_t>		cache_order_;
+		MusicMap			sound_cache_;
+		Array<AsyncTaskPtr>	preload_tasks_;
 	};
 }
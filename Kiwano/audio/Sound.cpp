@@ -24,19 +24,100 @@
 
 namespace kiwano
 {
+	namespace
+	{
+		inline VoicePool* GetVoicePool()
+		{
+			VoicePool* pool = Audio::Instance().GetVoicePool();
+			KGE_ASSERT(pool != nullptr && "Audio component must be set up first");
+			return pool;
+		}
+
+		// plain PCM wave data is read directly, anything else goes through Media Foundation
+		AudioDecoder* CreateStreamDecoder(Resource const& res)
+		{
+			HRESULT hr = S_OK;
+
+			if (res.IsFileType())
+			{
+				String file_path = res.GetFileName();
+				if (!modules::Shlwapi::Get().PathFileExistsW(file_path.c_str()))
+				{
+					KGE_WARNING_LOG(L"Media file '%s' not found", file_path.c_str());
+					return nullptr;
+				}
+
+				// the wave decoder takes over the file, even when it is not a wave file
+				std::FILE* file = nullptr;
+				if (::_wfopen_s(&file, file_path.c_str(), L"rb") == 0 && file)
+				{
+					WaveDecoder* wave = new (std::nothrow) WaveDecoder;
+					if (!wave)
+					{
+						std::fclose(file);
+						return nullptr;
+					}
+
+					if (wave->Open(file))
+						return wave;
+					delete wave;
+				}
+
+				Transcoder* transcoder = new (std::nothrow) Transcoder;
+				if (!transcoder)
+					return nullptr;
+
+				hr = transcoder->OpenMediaFile(file_path);
+				if (SUCCEEDED(hr))
+					return transcoder;
+				delete transcoder;
+			}
+			else
+			{
+				LPVOID buffer;
+				DWORD buffer_size;
+				if (!res.Load(buffer, buffer_size))
+					return nullptr;
+
+				// resource data stays valid as long as the module is loaded
+				WaveDecoder* wave = new (std::nothrow) WaveDecoder;
+				if (wave && wave->Open(buffer, buffer_size))
+					return wave;
+				delete wave;
+
+				Transcoder* transcoder = new (std::nothrow) Transcoder;
+				if (!transcoder)
+					return nullptr;
+
+				hr = transcoder->OpenMediaResource(res);
+				if (SUCCEEDED(hr))
+					return transcoder;
+				delete transcoder;
+			}
+
+			KGE_ERROR_LOG(L"Open media stream failed with HRESULT of %08X", hr);
+			return nullptr;
+		}
+	}
+
 	Sound::Sound()
 		: opened_(false)
-		, playing_(false)
-		, size_(0)
-		, wave_data_(nullptr)
-		, voice_(nullptr)
+		, priority_(0)
+		, max_voices_(1)
+		, volume_(1.f)
 	{
 	}
 
-	Sound::Sound(Resource const& res)
+	Sound::Sound(Resource const& res, bool streaming)
 		: Sound()
 	{
-		Load(res);
+		Load(res, streaming);
+	}
+
+	Sound::Sound(SoundBufferPtr buffer)
+		: Sound()
+	{
+		Load(buffer);
 	}
 
 	Sound::~Sound()
@@ -44,48 +125,87 @@ namespace kiwano
 		Close();
 	}
 
-	bool Sound::Load(Resource const& res)
+	bool Sound::Load(Resource const& res, bool streaming)
 	{
 		if (opened_)
 		{
 			Close();
 		}
 
+		if (streaming)
+		{
+			return LoadStream(res);
+		}
+		return Load(LoadBuffer(res));
+	}
+
+	SoundBufferPtr Sound::LoadBuffer(Resource const& res)
+	{
 		HRESULT hr = S_OK;
 		Transcoder transcoder;
+		BYTE* wave_data = nullptr;
+		UINT32 size = 0;
 
 		if (res.IsFileType())
 		{
 			if (!modules::Shlwapi::Get().PathFileExistsW(res.GetFileName().c_str()))
 			{
 				KGE_WARNING_LOG(L"Media file '%s' not found", res.GetFileName().c_str());
-				return false;
+				return nullptr;
 			}
-			hr = transcoder.LoadMediaFile(res.GetFileName(), &wave_data_, &size_);
+			hr = transcoder.LoadMediaFile(res.GetFileName(), &wave_data, &size);
 		}
 		else
 		{
-			hr = transcoder.LoadMediaResource(res, &wave_data_, &size_);
+			hr = transcoder.LoadMediaResource(res, &wave_data, &size);
 		}
 
 		if (FAILED(hr))
 		{
 			KGE_ERROR_LOG(L"Load media file failed with HRESULT of %08X", hr);
-			return false;
+			return nullptr;
 		}
 
-		hr = Audio::Instance().CreateVoice(&voice_, transcoder.GetWaveFormatEx());
-		if (FAILED(hr))
+		const WAVEFORMATEX* wfx = transcoder.GetWaveFormatEx();
+		AudioFormat format(wfx->nChannels, wfx->nSamplesPerSec, wfx->wBitsPerSample);
+
+		SoundBufferPtr buffer = new (std::nothrow) SoundBuffer(format, wave_data, size);
+		if (!buffer)
 		{
-			if (wave_data_)
-			{
-				delete[] wave_data_;
-				wave_data_ = nullptr;
-			}
-			KGE_ERROR_LOG(L"Create source voice failed with HRESULT of %08X", hr);
+			delete[] wave_data;
+		}
+		return buffer;
+	}
+
+	bool Sound::Load(SoundBufferPtr buffer)
+	{
+		if (opened_)
+		{
+			Close();
+		}
+
+		if (!buffer)
+			return false;
+
+		buffer_ = buffer;
+		opened_ = true;
+		return true;
+	}
+
+	bool Sound::LoadStream(Resource const& res)
+	{
+		AudioDecoder* decoder = CreateStreamDecoder(res);
+		if (!decoder)
+			return false;
+
+		stream_ = new (std::nothrow) AudioStream(&Audio::Instance(), decoder);
+		if (!stream_)
+		{
+			delete decoder;
 			return false;
 		}
 
+		stream_->SetVolume(volume_);
 		opened_ = true;
 		return true;
 	}
@@ -98,120 +218,114 @@ namespace kiwano
 			return;
 		}
 
-		KGE_ASSERT(voice_ != nullptr && "IXAudio2SourceVoice* is NULL");
-
-		// if sound stream is not empty, stop() will clear it
-		XAUDIO2_VOICE_STATE state;
-		voice_->GetState(&state);
-		if (state.BuffersQueued)
-			Stop();
-
-		// clamp loop count
-		loop_count = (loop_count < 0) ? XAUDIO2_LOOP_INFINITE : std::min(loop_count, XAUDIO2_LOOP_INFINITE - 1);
-
-		XAUDIO2_BUFFER buffer = { 0 };
-		buffer.pAudioData = wave_data_;
-		buffer.Flags = XAUDIO2_END_OF_STREAM;
-		buffer.AudioBytes = size_;
-		buffer.LoopCount = static_cast<UINT32>(loop_count);
-
-		HRESULT hr = voice_->SubmitSourceBuffer(&buffer);
-		if (SUCCEEDED(hr))
-		{
-			hr = voice_->Start();
-		}
-
-		if (FAILED(hr))
+		if (stream_)
 		{
-			KGE_ERROR_LOG(L"Submitting source buffer failed with HRESULT of %08X", hr);
+			stream_->Play(loop_count);
+			return;
 		}
 
-		playing_ = SUCCEEDED(hr);
+		GetVoicePool()->Play(this, buffer_.Get(), loop_count, priority_, max_voices_, volume_);
 	}
 
 	void Sound::Pause()
 	{
-		KGE_ASSERT(voice_ != nullptr && "IXAudio2SourceVoice* is NULL");
+		if (!opened_)
+			return;
 
-		if (SUCCEEDED(voice_->Stop()))
-			playing_ = false;
+		if (stream_)
+			stream_->Pause();
+		else if (VoicePool* pool = Audio::Instance().GetVoicePool())
+			pool->Pause(this);
 	}
 
 	void Sound::Resume()
 	{
-		KGE_ASSERT(voice_ != nullptr && "IXAudio2SourceVoice* is NULL");
+		if (!opened_)
+			return;
 
-		if (SUCCEEDED(voice_->Start()))
-			playing_ = true;
+		if (stream_)
+			stream_->Resume();
+		else if (VoicePool* pool = Audio::Instance().GetVoicePool())
+			pool->Resume(this);
 	}
 
 	void Sound::Stop()
 	{
-		KGE_ASSERT(voice_ != nullptr && "IXAudio2SourceVoice* is NULL");
-
-		HRESULT hr = voice_->Stop();
-
-		if (SUCCEEDED(hr))
-			hr = voice_->ExitLoop();
-
-		if (SUCCEEDED(hr))
-			hr = voice_->FlushSourceBuffers();
+		if (!opened_)
+			return;
 
-		if (SUCCEEDED(hr))
-			playing_ = false;
+		if (stream_)
+			stream_->Stop();
+		else if (VoicePool* pool = Audio::Instance().GetVoicePool())
+			pool->Stop(this);
 	}
 
 	void Sound::Close()
 	{
-		if (voice_)
+		if (opened_)
 		{
-			voice_->Stop();
-			voice_->FlushSourceBuffers();
-			voice_->DestroyVoice();
-			voice_ = nullptr;
-		}
+			if (VoicePool* pool = Audio::Instance().GetVoicePool())
+				pool->Stop(this);
 
-		if (wave_data_)
-		{
-			delete[] wave_data_;
-			wave_data_ = nullptr;
+			buffer_ = nullptr;
+			stream_ = nullptr;
 		}
 
 		opened_ = false;
-		playing_ = false;
 	}
 
 	bool Sound::IsPlaying() const
 	{
 		if (opened_)
 		{
-			if (!voice_)
-				return false;
-
-			XAUDIO2_VOICE_STATE state;
-			voice_->GetState(&state);
-			UINT32 buffers_queued = state.BuffersQueued;
+			if (stream_)
+				return stream_->IsPlaying();
+			return GetVoicePool()->IsPlaying(this);
+		}
+		return false;
+	}
 
-			if (buffers_queued && playing_)
-				return true;
+	bool Sound::IsActive() const
+	{
+		if (opened_)
+		{
+			if (stream_)
+				return stream_->IsPlaying() || stream_->IsPaused();
+			return GetVoicePool()->GetPlayingCount(this) != 0;
 		}
 		return false;
 	}
 
-	float Sound::GetVolume() const
+	size_t Sound::GetMemoryUsage() const
 	{
-		KGE_ASSERT(voice_ != nullptr && "IXAudio2SourceVoice* is NULL");
+		if (stream_)
+			return stream_->GetBufferSize();
+		if (buffer_)
+			return buffer_->GetSize();
+		return 0;
+	}
 
-		float volume = 0.0f;
-		voice_->GetVolume(&volume);
-		return volume;
+	float Sound::GetVolume() const
+	{
+		return volume_;
 	}
 
 	void Sound::SetVolume(float volume)
 	{
-		KGE_ASSERT(voice_ != nullptr && "IXAudio2SourceVoice* is NULL");
+		volume_ = std::min(std::max(volume, -224.f), 224.f);
+
+		if (stream_)
+		{
+			stream_->SetVolume(volume_);
+		}
+		else if (opened_)
+		{
+			GetVoicePool()->SetVolume(this, volume_);
+		}
+	}
 
-		volume = std::min(std::max(volume, -224.f), 224.f);
-		voice_->SetVolume(volume);
+	void Sound::SetMaxVoices(size_t max_voices)
+	{
+		max_voices_ = std::max(max_voices, size_t(1));
 	}
-}
\ No newline at end of file
+}
@@ -19,13 +19,14 @@
 // THE SOFTWARE.
 
 #pragma once
-#include <xaudio2.h>
 
 namespace kiwano
 {
 	KGE_DECLARE_SMART_PTR(Sound);
 
-	// ֶ
+	// 音乐对象
+	// 音频数据可被多个音乐对象共享, 播放时从音频的声部池中取得声部;
+	// 流式打开时边播放边解码, 只占用少量缓冲区
 	class KGE_API Sound
 		: public virtual Object
 	{
@@ -33,49 +34,101 @@ namespace kiwano
 		Sound();
 
 		Sound(
-			Resource const& res		/* Դ */
+			Resource const& res,		/* 音乐资源 */
+			bool streaming = false		/* 是否流式播放 */
+		);
+
+		Sound(
+			SoundBufferPtr buffer	/* 音频数据 */
 		);
 
 		virtual ~Sound();
 
-		// Դ
+		// 打开音乐资源
+		bool Load(
+			Resource const& res,		/* 音乐资源 */
+			bool streaming = false		/* 是否流式播放 */
+		);
+
+		// 使用音频数据
 		bool Load(
-			Resource const& res		/* Դ */
+			SoundBufferPtr buffer	/* 音频数据 */
 		);
 
-		// 
+		// 播放
 		void Play(
-			int loop_count = 0		/* ѭ (-1 Ϊѭ) */
+			int loop_count = 0		/* 播放循环次数 (-1 为循环播放) */
 		);
 
-		// ͣ
+		// 暂停
 		void Pause();
 
-		// 
+		// 继续
 		void Resume();
 
-		// ֹͣ
+		// 停止
 		void Stop();
 
-		// رղԴ
+		// 关闭并回收资源
 		void Close();
 
-		// Ƿڲ
+		// 是否正在播放
 		bool IsPlaying() const;
 
-		// ȡ
+		// 是否正在播放或已暂停
+		bool IsActive() const;
+
+		// 获取音量
 		float GetVolume() const;
 
-		// 
+		// 设置音量
 		void SetVolume(
-			float volume	/* 1 Ϊԭʼ,  1 ΪŴ, 0 ΪС */
+			float volume	/* 1 为原始音量, 大于 1 为放大音量, 0 为最小音量 */
+		);
+
+		// 设置最多同时播放的次数
+		// 默认为 1, 即正在播放时再次播放会从头开始
+		void SetMaxVoices(
+			size_t max_voices
+		);
+
+		// 获取最多同时播放的次数
+		inline size_t GetMaxVoices() const			{ return max_voices_; }
+
+		// 设置优先级
+		// 声部用尽时只能抢占优先级不高于自己的声部, 默认为 0
+		inline void SetPriority(int priority)		{ priority_ = priority; }
+
+		// 获取优先级
+		inline int GetPriority() const				{ return priority_; }
+
+		// 获取音频数据, 流式播放时为空
+		inline SoundBufferPtr GetBuffer() const	{ return buffer_; }
+
+		// 是否流式播放
+		inline bool IsStreaming() const			{ return !!stream_; }
+
+		// 获取音频数据或流缓冲区占用的内存大小
+		size_t GetMemoryUsage() const;
+
+		// 解码音乐资源
+		// 不使用音频设备, 可以在后台线程中调用
+		static SoundBufferPtr LoadBuffer(
+			Resource const& res		/* 音乐资源 */
+		);
+
+	protected:
+		// 创建音频流
+		bool LoadStream(
+			Resource const& res
 		);
 
 	protected:
-		bool	opened_;
-		bool	playing_;
-		UINT32	size_;
-		BYTE*	wave_data_;
-		IXAudio2SourceVoice* voice_;
+		bool			opened_;
+		int				priority_;
+		size_t			max_voices_;
+		float			volume_;
+		SoundBufferPtr	buffer_;
+		AudioStreamPtr	stream_;
 	};
 }
@@ -28,13 +28,48 @@
 
 namespace kiwano
 {
+	namespace
+	{
+		// media foundation needs COM on every thread that reads samples, streams decode
+		// on their own worker thread, which is uninitialized when the thread exits
+		class ComScope
+		{
+		public:
+			ComScope() : hr_(::CoInitializeEx(nullptr, COINIT_MULTITHREADED)) {}
+
+			~ComScope()
+			{
+				if (SUCCEEDED(hr_))
+				{
+					::CoUninitialize();
+				}
+			}
+
+		private:
+			HRESULT hr_;
+		};
+
+		inline void EnsureComInitialized()
+		{
+			static thread_local ComScope scope;
+			KGE_NOT_USED(scope);
+		}
+	}
+
 	Transcoder::Transcoder()
 		: wave_format_(nullptr)
+		, buffer_data_(nullptr)
+		, buffer_length_(0)
+		, buffer_offset_(0)
+		, end_of_stream_(false)
+		, last_error_(S_OK)
 	{
 	}
 	
 	Transcoder::~Transcoder()
 	{
+		ReleaseSample();
+
 		if (wave_format_)
 		{
 			::CoTaskMemFree(wave_format_);
@@ -68,16 +103,61 @@ namespace kiwano
 	}
 
 	HRESULT Transcoder::LoadMediaResource(Resource const& res, BYTE** wave_data, UINT32* wave_data_size)
+	{
+		ComPtr<IMFSourceReader> reader;
+
+		HRESULT hr = CreateResourceReader(res, &reader);
+
+		if (SUCCEEDED(hr))
+		{
+			hr = ReadSource(reader.Get(), wave_data, wave_data_size);
+		}
+
+		return hr;
+	}
+
+	HRESULT Transcoder::OpenMediaFile(String const& file_path)
+	{
+		ComPtr<IMFSourceReader> reader;
+
+		HRESULT hr = modules::MediaFoundation::Get().MFCreateSourceReaderFromURL(
+			file_path.c_str(),
+			nullptr,
+			&reader
+		);
+
+		if (SUCCEEDED(hr))
+		{
+			hr = OpenSource(reader.Get());
+		}
+
+		return hr;
+	}
+
+	HRESULT Transcoder::OpenMediaResource(Resource const& res)
+	{
+		ComPtr<IMFSourceReader> reader;
+
+		HRESULT hr = CreateResourceReader(res, &reader);
+
+		if (SUCCEEDED(hr))
+		{
+			hr = OpenSource(reader.Get());
+		}
+
+		return hr;
+	}
+
+	HRESULT Transcoder::CreateResourceReader(Resource const& res, IMFSourceReader** reader)
 	{
 		HRESULT	hr = S_OK;
 
 		ComPtr<IStream> stream;
 		ComPtr<IMFByteStream> byte_stream;
-		ComPtr<IMFSourceReader> reader;
 
 		LPVOID buffer;
 		DWORD buffer_size;
-		if (!res.Load(buffer, buffer_size)) { return false; }
+		if (!res.Load(buffer, buffer_size)) { return E_FAIL; }
 
 		stream = modules::Shlwapi::Get().SHCreateMemStream(
 			static_cast<const BYTE*>(buffer),
@@ -100,22 +180,80 @@ namespace kiwano
 			hr = modules::MediaFoundation::Get().MFCreateSourceReaderFromByteStream(
 				byte_stream.Get(),
 				nullptr,
-				&reader
+				reader
 			);
 		}
 
+		return hr;
+	}
+
+	HRESULT Transcoder::ReadSource(IMFSourceReader* reader, BYTE** wave_data, UINT32* wave_data_size)
+	{
+		HRESULT hr = OpenSource(reader);
+
+		// 读取音频数据
 		if (SUCCEEDED(hr))
 		{
-			hr = ReadSource(reader.Get(), wave_data, wave_data_size);
+			// the duration is only an estimate, the buffer grows if it is too short
+			UINT64 capacity = static_cast<UINT64>(duration_.Nanoseconds()) * wave_format_->nAvgBytesPerSec / 1000000000ULL + 1;
+			UINT32 position = 0;
+			BYTE* data = new (std::nothrow) BYTE[static_cast<size_t>(capacity)];
+
+			while (data)
+			{
+				UINT32 read = Read(data + position, static_cast<UINT32>(capacity - position));
+				position += read;
+
+				if (position < capacity || FAILED(last_error_))
+					break;
+
+				UINT64 new_capacity = capacity + capacity / 2 + 1;
+				BYTE* new_data = new (std::nothrow) BYTE[static_cast<size_t>(new_capacity)];
+				if (new_data)
+				{
+					::memcpy(new_data, data, position);
+				}
+				delete[] data;
+				data = new_data;
+				capacity = new_capacity;
+			}
+
+			if (data == nullptr)
+			{
+				KGE_ERROR_LOG(L"Low memory");
+				hr = E_OUTOFMEMORY;
+			}
+			else if (FAILED(last_error_))
+			{
+				delete[] data;
+				hr = last_error_;
+			}
+			else
+			{
+				*wave_data = data;
+				*wave_data_size = position;
+			}
 		}
 
+		ReleaseSample();
+		reader_ = nullptr;
 		return hr;
 	}
 
-	HRESULT Transcoder::ReadSource(IMFSourceReader* reader, BYTE** wave_data, UINT32* wave_data_size)
+	HRESULT Transcoder::OpenSource(IMFSourceReader* reader)
 	{
 		HRESULT hr = S_OK;
-		DWORD max_stream_size = 0;
+
+		ReleaseSample();
+		reader_ = nullptr;
+		end_of_stream_ = false;
+		last_error_ = S_OK;
+
+		if (wave_format_)
+		{
+			::CoTaskMemFree(wave_format_);
+			wave_format_ = nullptr;
+		}
 
 		ComPtr<IMFMediaType> partial_type;
 		ComPtr<IMFMediaType> uncompressed_type;
@@ -132,7 +270,7 @@ namespace kiwano
 			hr = partial_type->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_PCM);
 		}
 
-		//  source reader ýͣʹúʵĽȥƵ
+		// 设置 source reader 的媒体类型，它将使用合适的解码器去解码这个音频
 		if (SUCCEEDED(hr))
 		{
 			hr = reader->SetCurrentMediaType(
@@ -142,7 +280,7 @@ namespace kiwano
 			);
 		}
 
-		//  IMFMediaType лȡ WAVEFORMAT ṹ
+		// 从 IMFMediaType 中获取 WAVEFORMAT 结构
 		if (SUCCEEDED(hr))
 		{
 			hr = reader->GetCurrentMediaType(
@@ -151,7 +289,7 @@ namespace kiwano
 			);
 		}
 
-		// ָƵ
+		// 指定音频流
 		if (SUCCEEDED(hr))
 		{
 			hr = reader->SetStreamSelection(
@@ -160,7 +298,7 @@ namespace kiwano
 			);
 		}
 
-		// ȡ WAVEFORMAT 
+		// 获取 WAVEFORMAT 数据
 		if (SUCCEEDED(hr))
 		{
 			UINT32 size = 0;
@@ -172,7 +310,7 @@ namespace kiwano
 			);
 		}
 
-		// ƵС
+		// 获取音频时长
 		if (SUCCEEDED(hr))
 		{
 			PROPVARIANT prop;
@@ -184,84 +322,154 @@ namespace kiwano
 				&prop
 			);
 
-			LONGLONG duration = prop.uhVal.QuadPart;
-			max_stream_size = static_cast<DWORD>(
-				(duration * wave_format_->nAvgBytesPerSec) / 10000000 + 1
-			);
+			// MF_PD_DURATION is in 100-nanosecond units
+			duration_.SetNanoseconds(SUCCEEDED(hr) ? static_cast<long long>(prop.uhVal.QuadPart) * 100 : 0);
 			PropVariantClear(&prop);
 		}
 
-		// ȡƵ
 		if (SUCCEEDED(hr))
 		{
-			DWORD flags = 0;
-			DWORD position = 0;
-			BYTE* data = new (std::nothrow) BYTE[max_stream_size];
+			format_ = AudioFormat(wave_format_->nChannels, wave_format_->nSamplesPerSec, wave_format_->wBitsPerSample);
+			reader_ = reader;
+		}
+
+		return hr;
+	}
+
+	AudioFormat const& Transcoder::GetFormat() const
+	{
+		return format_;
+	}
+
+	Duration Transcoder::GetDuration() const
+	{
+		return duration_;
+	}
+
+	UINT32 Transcoder::Read(BYTE* data, UINT32 size)
+	{
+		EnsureComInitialized();
+
+		UINT32 position = 0;
+
+		while (position < size)
+		{
+			if (buffer_offset_ == buffer_length_)
+			{
+				if (end_of_stream_ || FAILED(ReadSample()))
+					break;
+				continue;
+			}
+
+			const UINT32 length = std::min(size - position, static_cast<UINT32>(buffer_length_ - buffer_offset_));
+			::memcpy(data + position, buffer_data_ + buffer_offset_, length);
+
+			position += length;
+			buffer_offset_ += length;
+		}
+		return position;
+	}
+
+	bool Transcoder::Rewind()
+	{
+		if (!reader_)
+			return false;
+
+		EnsureComInitialized();
+
+		ReleaseSample();
+
+		PROPVARIANT position;
+		PropVariantInit(&position);
+		position.vt = VT_I8;
+		position.hVal.QuadPart = 0;
+
+		HRESULT hr = reader_->SetCurrentPosition(GUID_NULL, position);
+		PropVariantClear(&position);
+
+		end_of_stream_ = FAILED(hr);
+		last_error_ = hr;
+
+		if (FAILED(hr))
+		{
+			KGE_ERROR_LOG(L"Rewinding media source failed with HRESULT of %08X", hr);
+		}
+		return SUCCEEDED(hr);
+	}
+
+	HRESULT Transcoder::ReadSample()
+	{
+		HRESULT hr = S_OK;
 
+		ReleaseSample();
+
+		if (!reader_)
+		{
+			end_of_stream_ = true;
+			return E_UNEXPECTED;
+		}
+
+		while (true)
+		{
+			DWORD flags = 0;
 			ComPtr<IMFSample> sample;
-			ComPtr<IMFMediaBuffer> buffer;
 
-			if (data == nullptr)
+			hr = reader_->ReadSample(
+				(DWORD)MF_SOURCE_READER_FIRST_AUDIO_STREAM,
+				0,
+				nullptr,
+				&flags,
+				nullptr,
+				&sample
+			);
+
+			if (FAILED(hr) || (flags & MF_SOURCE_READERF_ENDOFSTREAM))
 			{
-				KGE_ERROR_LOG(L"Low memory");
-				hr = E_OUTOFMEMORY;
+				end_of_stream_ = true;
+				break;
 			}
-			else
+
+			if (sample == nullptr) { continue; }
+
+			hr = sample->ConvertToContiguousBuffer(&buffer_);
+
+			if (SUCCEEDED(hr))
 			{
-				while (true)
-				{
-					hr = reader->ReadSample(
-						(DWORD)MF_SOURCE_READER_FIRST_AUDIO_STREAM,
-						0,
-						nullptr,
-						&flags,
-						nullptr,
-						&sample
-					);
-
-					if (flags & MF_SOURCE_READERF_ENDOFSTREAM) { break; }
-
-					if (sample == nullptr) { continue; }
-
-					if (SUCCEEDED(hr))
-					{
-						hr = sample->ConvertToContiguousBuffer(&buffer);
-
-						if (SUCCEEDED(hr))
-						{
-							BYTE *audio_data = nullptr;
-							DWORD sample_buffer_length = 0;
-
-							hr = buffer->Lock(
-								&audio_data,
-								nullptr,
-								&sample_buffer_length
-							);
-
-							if (SUCCEEDED(hr))
-							{
-								for (DWORD i = 0; i < sample_buffer_length; i++)
-								{
-									data[position++] = audio_data[i];
-								}
-								hr = buffer->Unlock();
-							}
-						}
-						buffer = nullptr;
-					}
-					sample = nullptr;
-
-					if (FAILED(hr)) { break; }
-				}
+				hr = buffer_->Lock(
+					&buffer_data_,
+					nullptr,
+					&buffer_length_
+				);
+			}
 
-				if (SUCCEEDED(hr))
-				{
-					*wave_data = data;
-					*wave_data_size = position;
-				}
+			if (FAILED(hr))
+			{
+				buffer_ = nullptr;
+				buffer_data_ = nullptr;
+				buffer_length_ = 0;
+				end_of_stream_ = true;
 			}
+			break;
 		}
 
-		return hr;
+		if (FAILED(hr))
+		{
+			last_error_ = hr;
+			KGE_ERROR_LOG(L"Reading media sample failed with HRESULT of %08X", hr);
+		}
+		return SUCCEEDED(hr) && !end_of_stream_ ? S_OK : E_FAIL;
+	}
+
+	void Transcoder::ReleaseSample()
+	{
+		if (buffer_ && buffer_data_)
+		{
+			buffer_->Unlock();
+		}
+
+		buffer_ = nullptr;
+		buffer_data_ = nullptr;
+		buffer_length_ = 0;
+		buffer_offset_ = 0;
 	}
-}
\ No newline at end of file
+}
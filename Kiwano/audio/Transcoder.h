@@ -25,17 +25,28 @@
 
 namespace kiwano
 {
+	// 音频转码器
+	// 使用 Media Foundation 将音频解码为 PCM 数据, 可一次性解码或逐段解码
 	class KGE_API Transcoder
+		: public AudioDecoder
 	{
-		WAVEFORMATEX* wave_format_;
-
 	public:
 		Transcoder();
 
-		~Transcoder();
+		virtual ~Transcoder();
 
 		const WAVEFORMATEX* GetWaveFormatEx() const;
 
+		// 打开音频文件, 之后可以使用 Read 逐段解码
+		HRESULT OpenMediaFile(
+			String const& file_path
+		);
+
+		// 打开音频资源, 之后可以使用 Read 逐段解码
+		HRESULT OpenMediaResource(
+			Resource const& res
+		);
+
 		HRESULT LoadMediaFile(
 			String const& file_path,
 			BYTE** wave_data,
@@ -53,5 +64,45 @@ namespace kiwano
 			BYTE** wave_data,
 			UINT32* wave_data_size
 		);
+
+		AudioFormat const& GetFormat() const override;
+
+		Duration GetDuration() const override;
+
+		UINT32 Read(
+			BYTE* data,
+			UINT32 size
+		) override;
+
+		bool Rewind() override;
+
+	private:
+		HRESULT CreateResourceReader(
+			Resource const& res,
+			IMFSourceReader** reader
+		);
+
+		// 设置输出格式并获取音频信息
+		HRESULT OpenSource(
+			IMFSourceReader* reader
+		);
+
+		// 读取下一个采样并锁定其缓冲区
+		HRESULT ReadSample();
+
+		// 解锁并释放当前采样的缓冲区
+		void ReleaseSample();
+
+	private:
+		WAVEFORMATEX*			wave_format_;
+		AudioFormat				format_;
+		Duration				duration_;
+		ComPtr<IMFSourceReader>	reader_;
+		ComPtr<IMFMediaBuffer>	buffer_;
+		BYTE*					buffer_data_;
+		DWORD					buffer_length_;
+		DWORD					buffer_offset_;
+		bool					end_of_stream_;
+		HRESULT					last_error_;
 	};
 }
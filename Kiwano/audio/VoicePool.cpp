@@ -0,0 +1,498 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "VoicePool.h"
+#include "../base/logs.h"
+#include <mutex>
+#include <algorithm>
+
+namespace kiwano
+{
+	//-------------------------------------------------------
+	// AudioFormat
+	//-------------------------------------------------------
+
+	AudioFormat::AudioFormat()
+		: channels(0)
+		, sample_rate(0)
+		, bits_per_sample(0)
+	{
+	}
+
+	AudioFormat::AudioFormat(std::uint16_t channels, std::uint32_t sample_rate, std::uint16_t bits_per_sample)
+		: channels(channels)
+		, sample_rate(sample_rate)
+		, bits_per_sample(bits_per_sample)
+	{
+	}
+
+	bool AudioFormat::operator==(AudioFormat const& other) const
+	{
+		return channels == other.channels && sample_rate == other.sample_rate && bits_per_sample == other.bits_per_sample;
+	}
+
+	bool AudioFormat::operator!=(AudioFormat const& other) const
+	{
+		return !(*this == other);
+	}
+
+
+	//-------------------------------------------------------
+	// SoundBuffer
+	//-------------------------------------------------------
+
+	SoundBuffer::SoundBuffer(AudioFormat const& format, std::uint8_t* data, std::uint32_t size)
+		: format_(format)
+		, data_(data)
+		, size_(size)
+	{
+	}
+
+	SoundBuffer::~SoundBuffer()
+	{
+		if (data_)
+		{
+			delete[] data_;
+			data_ = nullptr;
+		}
+	}
+
+	Duration SoundBuffer::GetDuration() const
+	{
+		Duration duration;
+
+		const std::uint64_t bytes_per_sec = static_cast<std::uint64_t>(format_.GetBlockAlign()) * format_.sample_rate;
+		if (bytes_per_sec)
+		{
+			duration.SetNanoseconds(static_cast<long long>(size_ * 1000000000ULL / bytes_per_sec));
+		}
+		return duration;
+	}
+
+
+	//-------------------------------------------------------
+	// NullAudioDevice
+	//-------------------------------------------------------
+
+	class NullAudioDevice::NullVoice
+		: public AudioVoice
+	{
+	public:
+		NullVoice(NullAudioDevice* device, AudioFormat const& format)
+			: device_(device)
+			, format_(format)
+			, playing_(false)
+			, infinite_(false)
+		{
+		}
+
+		virtual ~NullVoice()
+		{
+			if (device_)
+			{
+				auto& voices = device_->voices_;
+				voices.erase(std::find(voices.begin(), voices.end(), this));
+			}
+		}
+
+		bool Submit(SoundBuffer* buffer, int loop_count) override
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			Duration duration = buffer->GetDuration();
+			duration.SetNanoseconds(duration.Nanoseconds() * (loop_count < 0 ? 1 : (loop_count + 1)));
+
+			infinite_ = loop_count < 0;
+			queue_.clear();
+			queue_.push_back(duration);
+			playing_ = true;
+			return true;
+		}
+
+		bool Queue(const std::uint8_t* data, std::uint32_t size, bool end_of_stream) override
+		{
+			KGE_NOT_USED(data);
+			KGE_NOT_USED(end_of_stream);
+
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			const std::uint64_t bytes_per_sec = static_cast<std::uint64_t>(format_.GetBlockAlign()) * format_.sample_rate;
+
+			Duration duration;
+			duration.SetNanoseconds(static_cast<long long>(size * 1000000000ULL / bytes_per_sec));
+			queue_.push_back(duration);
+			return true;
+		}
+
+		std::uint32_t GetQueuedCount() const override
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return static_cast<std::uint32_t>(queue_.size());
+		}
+
+		void Start() override
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			playing_ = true;
+		}
+
+		void Pause() override
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			playing_ = false;
+		}
+
+		void Flush() override
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			playing_ = false;
+			infinite_ = false;
+			queue_.clear();
+		}
+
+		bool IsFinished() const override
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return queue_.empty();
+		}
+
+		void SetVolume(float) override	{}
+
+		void Advance(Duration dt)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			if (!playing_ || infinite_)
+				return;
+
+			while (!queue_.empty())
+			{
+				Duration& front = queue_.front();
+				if (front > dt)
+				{
+					front -= dt;
+					break;
+				}
+				dt -= front;
+				queue_.erase(queue_.begin());
+			}
+		}
+
+	private:
+		friend class NullAudioDevice;
+
+		NullAudioDevice*	device_;
+		AudioFormat			format_;
+		bool				playing_;
+		bool				infinite_;
+		Array<Duration>		queue_;
+		mutable std::mutex	mutex_;
+	};
+
+	NullAudioDevice::NullAudioDevice()
+	{
+	}
+
+	NullAudioDevice::~NullAudioDevice()
+	{
+		for (auto voice : voices_)
+		{
+			voice->device_ = nullptr;
+		}
+	}
+
+	AudioVoice* NullAudioDevice::CreateVoice(AudioFormat const& format)
+	{
+		if (!format.GetBlockAlign() || !format.sample_rate)
+			return nullptr;
+
+		NullVoice* voice = new (std::nothrow) NullVoice(this, format);
+		if (voice)
+		{
+			voices_.push_back(voice);
+		}
+		return voice;
+	}
+
+	void NullAudioDevice::Advance(Duration dt)
+	{
+		for (auto voice : voices_)
+		{
+			voice->Advance(dt);
+		}
+	}
+
+
+	//-------------------------------------------------------
+	// VoicePool
+	//-------------------------------------------------------
+
+	VoicePool::VoicePool(AudioDevice* device, size_t max_voices)
+		: device_(device)
+		, max_voices_(std::max(max_voices, size_t(1)))
+		, serial_(0)
+	{
+		KGE_ASSERT(device_ && "VoicePool needs an audio device");
+	}
+
+	VoicePool::~VoicePool()
+	{
+		for (auto& slot : slots_)
+		{
+			slot.voice->Flush();
+			delete slot.voice;
+		}
+	}
+
+	bool VoicePool::Play(const void* owner, SoundBuffer* buffer, int loop_count, int priority, size_t max_voices, float volume)
+	{
+		if (!buffer)
+			return false;
+
+		Reclaim();
+
+		Slot* slot = Acquire(owner, buffer->GetFormat(), priority, max_voices);
+		if (!slot)
+		{
+			KGE_WARNING_LOG(L"No voice is available for the sound");
+			return false;
+		}
+
+		slot->voice->SetVolume(volume);
+		if (!slot->voice->Submit(buffer, loop_count))
+		{
+			Release(*slot);
+			return false;
+		}
+
+		slot->owner = owner;
+		slot->buffer = buffer;
+		slot->priority = priority;
+		slot->serial = ++serial_;
+		slot->paused = false;
+		return true;
+	}
+
+	void VoicePool::Pause(const void* owner)
+	{
+		for (auto& slot : slots_)
+		{
+			if (slot.owner == owner && !slot.paused)
+			{
+				slot.voice->Pause();
+				slot.paused = true;
+			}
+		}
+	}
+
+	void VoicePool::Resume(const void* owner)
+	{
+		for (auto& slot : slots_)
+		{
+			if (slot.owner == owner && slot.paused)
+			{
+				slot.voice->Start();
+				slot.paused = false;
+			}
+		}
+	}
+
+	void VoicePool::Stop(const void* owner)
+	{
+		for (auto& slot : slots_)
+		{
+			if (slot.owner == owner)
+			{
+				Release(slot);
+			}
+		}
+	}
+
+	void VoicePool::SetVolume(const void* owner, float volume)
+	{
+		for (auto& slot : slots_)
+		{
+			if (slot.owner == owner)
+			{
+				slot.voice->SetVolume(volume);
+			}
+		}
+	}
+
+	bool VoicePool::IsPlaying(const void* owner) const
+	{
+		for (const auto& slot : slots_)
+		{
+			if (slot.owner == owner && !slot.paused && !slot.voice->IsFinished())
+				return true;
+		}
+		return false;
+	}
+
+	size_t VoicePool::GetPlayingCount(const void* owner) const
+	{
+		size_t count = 0;
+		for (const auto& slot : slots_)
+		{
+			if (slot.owner == owner && (slot.paused || !slot.voice->IsFinished()))
+				++count;
+		}
+		return count;
+	}
+
+	void VoicePool::StopAll()
+	{
+		for (auto& slot : slots_)
+		{
+			if (slot.owner)
+			{
+				Release(slot);
+			}
+		}
+	}
+
+	void VoicePool::Reclaim()
+	{
+		for (auto& slot : slots_)
+		{
+			if (slot.owner && !slot.paused && slot.voice->IsFinished())
+			{
+				Release(slot);
+			}
+			else if (!slot.owner && slot.buffer && slot.voice->IsFinished())
+			{
+				// the device has let go of the flushed data
+				slot.buffer = nullptr;
+			}
+		}
+	}
+
+	void VoicePool::Release(Slot& slot)
+	{
+		slot.voice->Flush();
+		slot.owner = nullptr;
+		slot.paused = false;
+
+		// flushing is asynchronous, the device may still read the data until the
+		// voice has no buffers queued, so keep the sound buffer until then
+		if (slot.voice->IsFinished())
+			slot.buffer = nullptr;
+	}
+
+	VoicePool::Slot* VoicePool::Acquire(const void* owner, AudioFormat const& format, int priority, size_t max_voices)
+	{
+		// prefers the lower priority, then the older one
+		auto is_weaker = [](Slot const& lhs, Slot const* rhs)
+		{
+			return !rhs || lhs.priority < rhs->priority || (lhs.priority == rhs->priority && lhs.serial < rhs->serial);
+		};
+
+		Slot* victim = nullptr;
+
+		// the owner has used up its voices, so it replaces one of its own
+		if (max_voices)
+		{
+			size_t count = 0;
+			for (auto& slot : slots_)
+			{
+				if (slot.owner == owner)
+				{
+					++count;
+					if (is_weaker(slot, victim))
+						victim = &slot;
+				}
+			}
+
+			if (count < max_voices)
+				victim = nullptr;
+		}
+
+		if (!victim)
+		{
+			// prefers an idle voice of the same format that has drained
+			Slot* idle = nullptr;
+			for (auto& slot : slots_)
+			{
+				if (!slot.owner)
+				{
+					if (slot.format == format && !slot.buffer)
+					{
+						victim = &slot;
+						break;
+					}
+
+					if (!idle || (idle->buffer && !slot.buffer))
+						idle = &slot;
+				}
+			}
+
+			if (!victim && slots_.size() < max_voices_)
+			{
+				AudioVoice* voice = device_->CreateVoice(format);
+				if (!voice)
+					return nullptr;
+
+				Slot slot = { voice, format, nullptr, nullptr, 0, 0, false };
+				slots_.push_back(slot);
+				return &slots_.back();
+			}
+
+			if (!victim)
+				victim = idle;
+		}
+
+		// all voices are busy, steal the weakest one that is not more important
+		if (!victim)
+		{
+			for (auto& slot : slots_)
+			{
+				if (slot.priority <= priority && is_weaker(slot, victim))
+					victim = &slot;
+			}
+
+			if (!victim)
+				return nullptr;
+		}
+
+		if (victim->owner)
+		{
+			Release(*victim);
+		}
+
+		// a voice still reading flushed data is destroyed instead of reused,
+		// destroying waits until the device no longer uses its buffers
+		if (victim->format != format || victim->buffer)
+		{
+			delete victim->voice;
+
+			victim->buffer = nullptr;
+			victim->format = format;
+			victim->voice = device_->CreateVoice(format);
+
+			if (!victim->voice)
+			{
+				*victim = slots_.back();
+				slots_.pop_back();
+				return nullptr;
+			}
+		}
+		return victim;
+	}
+}
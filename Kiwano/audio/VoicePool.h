@@ -0,0 +1,274 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/defines.h"
+#include "../base/Object.h"
+#include "../base/time.h"
+#include "../common/Array.h"
+#include "../common/noncopyable.hpp"
+#include <cstdint>
+
+namespace kiwano
+{
+	// 音频格式 (PCM)
+	struct AudioFormat
+	{
+		std::uint16_t	channels;
+		std::uint32_t	sample_rate;
+		std::uint16_t	bits_per_sample;
+
+		AudioFormat();
+
+		AudioFormat(
+			std::uint16_t channels,
+			std::uint32_t sample_rate,
+			std::uint16_t bits_per_sample
+		);
+
+		// 每个采样帧的字节数
+		inline std::uint32_t GetBlockAlign() const	{ return channels * bits_per_sample / 8; }
+
+		bool operator== (AudioFormat const& other) const;
+		bool operator!= (AudioFormat const& other) const;
+	};
+
+
+	KGE_DECLARE_SMART_PTR(SoundBuffer);
+
+	// 音频数据
+	// 解码后的 PCM 数据创建后不再修改, 可被多个声音同时播放
+	class KGE_API SoundBuffer
+		: public Object
+	{
+	public:
+		SoundBuffer(
+			AudioFormat const& format,	/* 音频格式 */
+			std::uint8_t* data,			/* 由 new[] 分配的 PCM 数据, 由音频数据负责释放 */
+			std::uint32_t size			/* 数据字节数 */
+		);
+
+		virtual ~SoundBuffer();
+
+		// 获取音频格式
+		inline AudioFormat const& GetFormat() const	{ return format_; }
+
+		// 获取 PCM 数据
+		inline const std::uint8_t* GetData() const	{ return data_; }
+
+		// 获取数据字节数
+		inline std::uint32_t GetSize() const		{ return size_; }
+
+		// 获取时长
+		Duration GetDuration() const;
+
+	protected:
+		AudioFormat		format_;
+		std::uint8_t*	data_;
+		std::uint32_t	size_;
+	};
+
+
+	// 音频设备中的声部
+	class KGE_API AudioVoice
+	{
+	public:
+		virtual ~AudioVoice() {}
+
+		// 提交音频数据并开始播放
+		virtual bool Submit(
+			SoundBuffer* buffer,
+			int loop_count			/* 播放循环次数 (-1 为循环播放) */
+		) = 0;
+
+		// 追加一段音频数据, 用于流式播放
+		// 数据在播放完毕前必须保持有效
+		virtual bool Queue(
+			const std::uint8_t* data,
+			std::uint32_t size,
+			bool end_of_stream		/* 是否是最后一段数据 */
+		) = 0;
+
+		// 获取尚未播放完毕的数据段数量 (包括正在播放的一段)
+		virtual std::uint32_t GetQueuedCount() const = 0;
+
+		// 开始播放
+		virtual void Start() = 0;
+
+		// 暂停播放
+		virtual void Pause() = 0;
+
+		// 停止播放并丢弃已提交的数据
+		virtual void Flush() = 0;
+
+		// 已提交的数据是否播放完毕
+		virtual bool IsFinished() const = 0;
+
+		// 设置音量
+		virtual void SetVolume(
+			float volume
+		) = 0;
+	};
+
+
+	// 音频设备
+	class KGE_API AudioDevice
+	{
+	public:
+		virtual ~AudioDevice() {}
+
+		// 创建声部, 失败时返回空
+		virtual AudioVoice* CreateVoice(
+			AudioFormat const& format
+		) = 0;
+	};
+
+
+	// 空音频设备
+	// 不输出声音, 按 Advance 推进的时长模拟播放进度, 用于没有音频硬件的环境
+	class KGE_API NullAudioDevice
+		: public AudioDevice
+	{
+	public:
+		NullAudioDevice();
+
+		virtual ~NullAudioDevice();
+
+		AudioVoice* CreateVoice(
+			AudioFormat const& format
+		) override;
+
+		// 推进所有正在播放的声部
+		void Advance(
+			Duration dt
+		);
+
+		// 获取创建的声部数量
+		inline size_t GetVoiceCount() const	{ return voices_.size(); }
+
+	private:
+		class NullVoice;
+
+		friend class NullVoice;
+
+		Array<NullVoice*> voices_;
+	};
+
+
+	// 声部池
+	// 同一音频数据可以在多个声部中同时播放, 声部空闲后被复用;
+	// 声部用尽时抢占优先级最低、播放最久的声部
+	class KGE_API VoicePool
+		: protected Noncopyable
+	{
+	public:
+		VoicePool(
+			AudioDevice* device,		/* 音频设备 */
+			size_t max_voices = 32		/* 最大声部数量 */
+		);
+
+		~VoicePool();
+
+		// 播放音频数据
+		// 同一 owner 的声部数量达到 max_voices 时抢占其中最早的声部
+		bool Play(
+			const void* owner,			/* 声部所属对象 */
+			SoundBuffer* buffer,		/* 音频数据 */
+			int loop_count,				/* 播放循环次数 (-1 为循环播放) */
+			int priority,				/* 优先级, 只能抢占不高于该优先级的声部 */
+			size_t max_voices,			/* owner 最多同时占用的声部数量 */
+			float volume				/* 音量 */
+		);
+
+		// 暂停 owner 的所有声部
+		void Pause(
+			const void* owner
+		);
+
+		// 继续 owner 的所有声部
+		void Resume(
+			const void* owner
+		);
+
+		// 停止 owner 的所有声部
+		void Stop(
+			const void* owner
+		);
+
+		// 设置 owner 所有声部的音量
+		void SetVolume(
+			const void* owner,
+			float volume
+		);
+
+		// owner 是否有正在播放的声部
+		bool IsPlaying(
+			const void* owner
+		) const;
+
+		// 获取 owner 正在使用的声部数量
+		size_t GetPlayingCount(
+			const void* owner
+		) const;
+
+		// 停止所有声部
+		void StopAll();
+
+		// 获取已创建的声部数量
+		inline size_t GetVoiceCount() const	{ return slots_.size(); }
+
+		// 获取最大声部数量
+		inline size_t GetMaxVoices() const	{ return max_voices_; }
+
+	private:
+		struct Slot
+		{
+			AudioVoice*		voice;
+			AudioFormat		format;
+			const void*		owner;
+			SoundBufferPtr	buffer;		// 停止后保留到声部不再读取数据为止
+			int				priority;
+			std::uint64_t	serial;
+			bool			paused;
+		};
+
+		// 回收播放完毕的声部
+		void Reclaim();
+
+		// 释放声部, 声部可被再次使用
+		void Release(
+			Slot& slot
+		);
+
+		// 选择可供播放的声部, 没有时返回空
+		Slot* Acquire(
+			const void* owner,
+			AudioFormat const& format,
+			int priority,
+			size_t max_voices
+		);
+
+	private:
+		AudioDevice*	device_;
+		size_t			max_voices_;
+		std::uint64_t	serial_;
+		Array<Slot>		slots_;
+	};
+}
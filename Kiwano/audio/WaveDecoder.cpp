@@ -0,0 +1,240 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include "WaveDecoder.h"
+#include "../base/logs.h"
+#include <cstring>
+
+namespace kiwano
+{
+	namespace
+	{
+		const std::uint16_t WAVE_FORMAT_PCM_TAG		= 0x0001;
+		const std::uint16_t WAVE_FORMAT_EXTENSIBLE_TAG	= 0xFFFE;
+
+		// RIFF data is always little-endian
+		inline std::uint16_t ReadUInt16(const std::uint8_t* p)
+		{
+			return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+		}
+
+		inline std::uint32_t ReadUInt32(const std::uint8_t* p)
+		{
+			return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8)
+				| (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+		}
+	}
+
+	WaveDecoder::WaveDecoder()
+		: file_(nullptr)
+		, memory_(nullptr)
+		, memory_size_(0)
+		, data_offset_(0)
+		, data_size_(0)
+		, position_(0)
+	{
+	}
+
+	WaveDecoder::~WaveDecoder()
+	{
+		Close();
+	}
+
+	bool WaveDecoder::Open(std::FILE* file)
+	{
+		Close();
+
+		if (!file)
+			return false;
+
+		file_ = file;
+
+		if (!ParseHeader())
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	bool WaveDecoder::Open(const void* data, size_t size)
+	{
+		Close();
+
+		memory_ = static_cast<const std::uint8_t*>(data);
+		memory_size_ = size;
+
+		if (!ParseHeader())
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void WaveDecoder::Close()
+	{
+		if (file_)
+		{
+			std::fclose(file_);
+			file_ = nullptr;
+		}
+
+		memory_ = nullptr;
+		memory_size_ = 0;
+		data_offset_ = 0;
+		data_size_ = 0;
+		position_ = 0;
+		format_ = AudioFormat();
+	}
+
+	AudioFormat const& WaveDecoder::GetFormat() const
+	{
+		return format_;
+	}
+
+	Duration WaveDecoder::GetDuration() const
+	{
+		Duration duration;
+
+		const std::uint64_t bytes_per_sec = static_cast<std::uint64_t>(format_.GetBlockAlign()) * format_.sample_rate;
+		if (bytes_per_sec)
+		{
+			duration.SetNanoseconds(static_cast<long long>(data_size_ * 1000000000ULL / bytes_per_sec));
+		}
+		return duration;
+	}
+
+	std::uint32_t WaveDecoder::Read(std::uint8_t* data, std::uint32_t size)
+	{
+		size_t remaining = data_size_ - position_;
+		size_t bytes = std::min(static_cast<size_t>(size), remaining);
+
+		// only whole sample frames are handed out
+		if (std::uint32_t block_align = format_.GetBlockAlign())
+		{
+			bytes -= bytes % block_align;
+		}
+
+		bytes = ReadAt(data_offset_ + position_, data, bytes);
+		position_ += bytes;
+		return static_cast<std::uint32_t>(bytes);
+	}
+
+	bool WaveDecoder::Rewind()
+	{
+		position_ = 0;
+		return (file_ || memory_);
+	}
+
+	bool WaveDecoder::IsWave(const void* data, size_t size)
+	{
+		const std::uint8_t* header = static_cast<const std::uint8_t*>(data);
+		return size >= 12
+			&& std::memcmp(header, "RIFF", 4) == 0
+			&& std::memcmp(header + 8, "WAVE", 4) == 0;
+	}
+
+	bool WaveDecoder::ParseHeader()
+	{
+		std::uint8_t header[12];
+		if (ReadAt(0, header, sizeof(header)) != sizeof(header) || !IsWave(header, sizeof(header)))
+			return false;
+
+		bool has_format = false;
+		size_t offset = sizeof(header);
+
+		while (true)
+		{
+			std::uint8_t chunk[8];
+			if (ReadAt(offset, chunk, sizeof(chunk)) != sizeof(chunk))
+				break;
+
+			const size_t chunk_size = ReadUInt32(chunk + 4);
+			offset += sizeof(chunk);
+
+			if (std::memcmp(chunk, "fmt ", 4) == 0)
+			{
+				std::uint8_t fmt[40] = { 0 };
+				const size_t fmt_size = std::min(chunk_size, sizeof(fmt));
+				if (fmt_size < 16 || ReadAt(offset, fmt, fmt_size) != fmt_size)
+					return false;
+
+				std::uint16_t tag = ReadUInt16(fmt);
+				if (tag == WAVE_FORMAT_EXTENSIBLE_TAG && fmt_size >= 26)
+				{
+					// the first two bytes of the sub-format GUID hold the actual tag
+					tag = ReadUInt16(fmt + 24);
+				}
+
+				if (tag != WAVE_FORMAT_PCM_TAG)
+				{
+					KGE_WARNING_LOG(L"Only PCM wave data can be decoded without Media Foundation");
+					return false;
+				}
+
+				format_ = AudioFormat(ReadUInt16(fmt + 2), ReadUInt32(fmt + 4), ReadUInt16(fmt + 14));
+				has_format = format_.GetBlockAlign() != 0 && format_.sample_rate != 0;
+			}
+			else if (std::memcmp(chunk, "data", 4) == 0)
+			{
+				if (!has_format)
+					return false;
+
+				data_offset_ = offset;
+				data_size_ = chunk_size;
+
+				// tolerate truncated files
+				if (memory_)
+				{
+					data_size_ = std::min(data_size_, memory_size_ - std::min(offset, memory_size_));
+				}
+				data_size_ -= data_size_ % format_.GetBlockAlign();
+				position_ = 0;
+				return true;
+			}
+
+			// chunks are word aligned
+			offset += chunk_size + (chunk_size & 1);
+		}
+		return false;
+	}
+
+	size_t WaveDecoder::ReadAt(size_t offset, void* buffer, size_t size)
+	{
+		if (memory_)
+		{
+			if (offset >= memory_size_)
+				return 0;
+
+			size = std::min(size, memory_size_ - offset);
+			std::memcpy(buffer, memory_ + offset, size);
+			return size;
+		}
+
+		if (file_)
+		{
+			if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0)
+				return 0;
+
+			return std::fread(buffer, 1, size, file_);
+		}
+		return 0;
+	}
+}
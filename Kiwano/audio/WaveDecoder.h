@@ -0,0 +1,88 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#pragma once
+#include "AudioDecoder.h"
+#include <cstdio>
+
+namespace kiwano
+{
+	// WAV 解码器
+	// 直接读取 RIFF/WAVE 中的 PCM 数据, 不依赖 Media Foundation
+	class KGE_API WaveDecoder
+		: public AudioDecoder
+	{
+	public:
+		WaveDecoder();
+
+		virtual ~WaveDecoder();
+
+		// 打开 WAV 文件, 文件由解码器负责关闭, 打开失败时也会关闭
+		bool Open(
+			std::FILE* file
+		);
+
+		// 打开内存中的 WAV 数据
+		// 数据在解码器关闭前必须保持有效
+		bool Open(
+			const void* data,
+			size_t size
+		);
+
+		// 关闭
+		void Close();
+
+		AudioFormat const& GetFormat() const override;
+
+		Duration GetDuration() const override;
+
+		std::uint32_t Read(
+			std::uint8_t* data,
+			std::uint32_t size
+		) override;
+
+		bool Rewind() override;
+
+		// 判断数据是否为 WAV 格式
+		static bool IsWave(
+			const void* data,
+			size_t size
+		);
+
+	private:
+		// 解析文件头, 定位 PCM 数据
+		bool ParseHeader();
+
+		// 从 offset 处读取原始数据
+		size_t ReadAt(
+			size_t offset,
+			void* buffer,
+			size_t size
+		);
+
+	private:
+		AudioFormat		format_;
+		std::FILE*		file_;
+		const std::uint8_t*		memory_;
+		size_t			memory_size_;
+		size_t			data_offset_;
+		size_t			data_size_;
+		size_t			position_;
+	};
+}
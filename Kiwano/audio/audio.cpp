@@ -24,9 +24,106 @@
 
 namespace kiwano
 {
+	namespace
+	{
+		class XAudio2Voice
+			: public AudioVoice
+		{
+		public:
+			XAudio2Voice(IXAudio2SourceVoice* voice)
+				: voice_(voice)
+			{
+			}
+
+			virtual ~XAudio2Voice()
+			{
+				voice_->DestroyVoice();
+			}
+
+			bool Submit(SoundBuffer* buffer, int loop_count) override
+			{
+				// clamp loop count
+				loop_count = (loop_count < 0) ? XAUDIO2_LOOP_INFINITE : std::min(loop_count, XAUDIO2_LOOP_INFINITE - 1);
+
+				XAUDIO2_BUFFER xbuffer = { 0 };
+				xbuffer.pAudioData = buffer->GetData();
+				xbuffer.Flags = XAUDIO2_END_OF_STREAM;
+				xbuffer.AudioBytes = buffer->GetSize();
+				xbuffer.LoopCount = static_cast<UINT32>(loop_count);
+
+				HRESULT hr = voice_->SubmitSourceBuffer(&xbuffer);
+				if (SUCCEEDED(hr))
+				{
+					hr = voice_->Start();
+				}
+
+				if (FAILED(hr))
+				{
+					KGE_ERROR_LOG(L"Submitting source buffer failed with HRESULT of %08X", hr);
+				}
+				return SUCCEEDED(hr);
+			}
+
+			bool Queue(const BYTE* data, UINT32 size, bool end_of_stream) override
+			{
+				XAUDIO2_BUFFER xbuffer = { 0 };
+				xbuffer.pAudioData = data;
+				xbuffer.Flags = end_of_stream ? XAUDIO2_END_OF_STREAM : 0;
+				xbuffer.AudioBytes = size;
+
+				HRESULT hr = voice_->SubmitSourceBuffer(&xbuffer);
+				if (FAILED(hr))
+				{
+					KGE_ERROR_LOG(L"Submitting source buffer failed with HRESULT of %08X", hr);
+				}
+				return SUCCEEDED(hr);
+			}
+
+			UINT32 GetQueuedCount() const override
+			{
+				XAUDIO2_VOICE_STATE state;
+				voice_->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+				return state.BuffersQueued;
+			}
+
+			void Start() override
+			{
+				voice_->Start();
+			}
+
+			void Pause() override
+			{
+				voice_->Stop();
+			}
+
+			void Flush() override
+			{
+				voice_->Stop();
+				voice_->ExitLoop();
+				voice_->FlushSourceBuffers();
+			}
+
+			bool IsFinished() const override
+			{
+				XAUDIO2_VOICE_STATE state;
+				voice_->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+				return state.BuffersQueued == 0;
+			}
+
+			void SetVolume(float volume) override
+			{
+				voice_->SetVolume(volume);
+			}
+
+		private:
+			IXAudio2SourceVoice* voice_;
+		};
+	}
+
 	Audio::Audio()
 		: x_audio2_(nullptr)
 		, mastering_voice_(nullptr)
+		, voice_pool_(nullptr)
 	{
 	}
 
@@ -51,12 +148,20 @@ namespace kiwano
 		}
 
 		ThrowIfFailed(hr);
+
+		voice_pool_ = new VoicePool(this);
 	}
 
 	void Audio::DestroyComponent()
 	{
 		KGE_LOG(L"Destroying audio resources");
 
+		if (voice_pool_)
+		{
+			delete voice_pool_;
+			voice_pool_ = nullptr;
+		}
+
 		if (mastering_voice_)
 		{
 			mastering_voice_->DestroyVoice();
@@ -83,6 +188,32 @@ namespace kiwano
 		return hr;
 	}
 
+	AudioVoice* Audio::CreateVoice(AudioFormat const& format)
+	{
+		WAVEFORMATEX wfx = { 0 };
+		wfx.wFormatTag = WAVE_FORMAT_PCM;
+		wfx.nChannels = format.channels;
+		wfx.nSamplesPerSec = format.sample_rate;
+		wfx.wBitsPerSample = format.bits_per_sample;
+		wfx.nBlockAlign = static_cast<WORD>(format.GetBlockAlign());
+		wfx.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nBlockAlign;
+
+		IXAudio2SourceVoice* voice = nullptr;
+		HRESULT hr = CreateVoice(&voice, &wfx);
+		if (FAILED(hr))
+		{
+			KGE_ERROR_LOG(L"Create source voice failed with HRESULT of %08X", hr);
+			return nullptr;
+		}
+
+		AudioVoice* audio_voice = new (std::nothrow) XAudio2Voice(voice);
+		if (!audio_voice)
+		{
+			voice->DestroyVoice();
+		}
+		return audio_voice;
+	}
+
 	void Audio::Open()
 	{
 		x_audio2_->StartEngine();
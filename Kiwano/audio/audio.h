@@ -25,6 +25,7 @@ namespace kiwano
 	class KGE_API Audio
 		: public Singleton<Audio>
 		, public Component
+		, public AudioDevice
 	{
 		KGE_DECLARE_SINGLETON(Audio);
 
@@ -33,10 +34,10 @@ namespace kiwano
 
 		void DestroyComponent() override;
 
-		// 豸
+		// 开启设备
 		void Open();
 
-		// ر豸
+		// 关闭设备
 		void Close();
 
 		HRESULT CreateVoice(
@@ -44,6 +45,13 @@ namespace kiwano
 			const WAVEFORMATEX* wfx
 		);
 
+		AudioVoice* CreateVoice(
+			AudioFormat const& format
+		) override;
+
+		// 获取声部池
+		inline VoicePool* GetVoicePool() const	{ return voice_pool_; }
+
 	protected:
 		Audio();
 
@@ -52,5 +60,6 @@ namespace kiwano
 	protected:
 		IXAudio2* x_audio2_;
 		IXAudio2MasteringVoice*	mastering_voice_;
+		VoicePool*	voice_pool_;
 	};
 }
@@ -19,33 +19,71 @@
 // THE SOFTWARE.
 
 #include "AsyncTask.h"
-#include "../platform/Application.h"
-#include <thread>
 
 namespace kiwano
 {
 
 	AsyncTask::AsyncTask()
+		: priority_(TaskPriority::Normal)
 	{
 	}
 
 	AsyncTask::AsyncTask(AsyncTaskFunc func)
+		: AsyncTask()
 	{
 		Then(func);
 	}
 
 	void AsyncTask::Start()
 	{
-		std::thread thread(MakeClosure(this, &AsyncTask::TaskThread));
-		thread.detach();
+		KGE_ASSERT(tasks_.empty() && "AsyncTask::Start failed, the task is already started");
+
+		if (!tasks_.empty())
+			return;
+
+		auto& pool = ThreadPool::Instance();
+
+		// chain the functions so that they run one after another
+		TaskPtr prev;
+		while (!thread_func_queue_.empty())
+		{
+			TaskPtr task = pool.Create(std::move(thread_func_queue_.front()), priority_);
+			thread_func_queue_.pop();
+
+			if (prev)
+				task->AddDependency(prev);
+
+			tasks_.push_back(task);
+			prev = task;
+		}
+
+		if (!prev)
+		{
+			prev = pool.Create(AsyncTaskFunc(), priority_);
+			tasks_.push_back(prev);
+		}
+
+		prev->SetCallback(MakeClosure(this, &AsyncTask::Complete));
 
 		// retain this object until finished
 		Retain();
+
+		for (const auto& task : tasks_)
+		{
+			pool.Submit(task);
+		}
+	}
+
+	void AsyncTask::Cancel()
+	{
+		for (const auto& task : tasks_)
+		{
+			task->Cancel();
+		}
 	}
 
 	AsyncTask& AsyncTask::Then(AsyncTaskFunc func)
 	{
-		std::lock_guard<std::mutex> lock(func_mutex_);
 		thread_func_queue_.push(func);
 		return (*this);
 	}
@@ -56,27 +94,18 @@ namespace kiwano
 		return (*this);
 	}
 
-	void AsyncTask::TaskThread()
+	AsyncTask& AsyncTask::SetPriority(TaskPriority priority)
 	{
-		while (!thread_func_queue_.empty())
-		{
-			auto& func = thread_func_queue_.front();
-			if (func)
-			{
-				func();
-			}
-
-			func_mutex_.lock();
-			thread_func_queue_.pop();
-			func_mutex_.unlock();
-		}
-
-		Application::PreformInMainThread(MakeClosure(this, &AsyncTask::Complete));
+		priority_ = priority;
+		return (*this);
 	}
 
 	void AsyncTask::Complete()
 	{
-		if (thread_cb_)
+		bool cancelled = !tasks_.empty() && tasks_.back()->IsCancelled();
+		tasks_.clear();
+
+		if (thread_cb_ && !cancelled)
 		{
 			thread_cb_();
 		}
@@ -20,9 +20,9 @@
 
 #pragma once
 #include "Object.h"
+#include "ThreadPool.h"
 #include "../common/closure.hpp"
 #include <functional>
-#include <mutex>
 
 namespace kiwano
 {
@@ -31,6 +31,8 @@ namespace kiwano
 	typedef Closure<void()> AsyncTaskFunc;
 	typedef Closure<void()> AsyncTaskCallback;
 
+	// 异步任务
+	// 函数按添加顺序在线程池中依次执行, 全部结束后在主线程中执行回调
 	class AsyncTask
 		: public Object
 	{
@@ -49,16 +51,24 @@ namespace kiwano
 			AsyncTaskCallback callback
 		);
 
+		// 设置优先级
+		AsyncTask& SetPriority(
+			TaskPriority priority
+		);
+
 		void Start();
 
-	protected:
-		void TaskThread();
+		// 取消任务
+		// 未执行的函数不再执行, 回调也不会被调用
+		void Cancel();
 
+	protected:
 		void Complete();
 
 	protected:
+		TaskPriority priority_;
 		Queue<AsyncTaskFunc> thread_func_queue_;
 		AsyncTaskCallback thread_cb_;
-		std::mutex func_mutex_;
+		Array<TaskPtr> tasks_;
 	};
 }
@@ -20,17 +20,18 @@
 
 #pragma once
 #include "keys.hpp"
+#include <cstdint>
 
 namespace kiwano
 {
 
-	// ¼
+	// 鼠标事件
 	struct MouseEvent
 	{
 		float x;
 		float y;
-		bool left_btn_down;		// Ƿ
-		bool right_btn_down;	// ҼǷ
+		bool left_btn_down;		// 左键是否按下
+		bool right_btn_down;	// 右键是否按下
 
 		union
 		{
@@ -45,10 +46,10 @@ namespace kiwano
 			};
 		};
 
-		static bool Check(UINT type);
+		static bool Check(std::uint32_t type);
 	};
 
-	// ¼
+	// 键盘事件
 	struct KeyboardEvent
 	{
 		int count;
@@ -65,10 +66,10 @@ namespace kiwano
 			};
 		};
 
-		static bool Check(UINT type);
+		static bool Check(std::uint32_t type);
 	};
 
-	// ¼
+	// 窗口事件
 	struct WindowEvent
 	{
 		union
@@ -96,10 +97,10 @@ namespace kiwano
 			};
 		};
 
-		static bool Check(UINT type);
+		static bool Check(std::uint32_t type);
 	};
 
-	// Զ¼
+	// 自定义事件
 	struct CustomEvent
 	{
 		void* data;
@@ -107,44 +108,44 @@ namespace kiwano
 
 	class Node;
 
-	// ¼
+	// 事件
 	struct KGE_API Event
 	{
-		enum Type : UINT
+		enum Type : std::uint32_t
 		{
 			First,
 
-			// ¼
+			// 鼠标事件
 			MouseFirst,
-			MouseMove,			// ƶ
-			MouseBtnDown,		// 갴
-			MouseBtnUp,			// ̧
-			MouseWheel,			// ֹ
-			MouseHover,			// 
-			MouseOut,			// Ƴ
-			Click,				// 
+			MouseMove,			// 移动
+			MouseBtnDown,		// 鼠标按下
+			MouseBtnUp,			// 鼠标抬起
+			MouseWheel,			// 滚轮滚动
+			MouseHover,			// 鼠标移入
+			MouseOut,			// 鼠标移出
+			Click,				// 鼠标点击
 			MouseLast,
 
-			// ¼
+			// 按键事件
 			KeyFirst,
-			KeyDown,			// 
-			KeyUp,				// ̧
-			Char,				// ַ
+			KeyDown,			// 按键按下
+			KeyUp,				// 按键抬起
+			Char,				// 输出字符
 			KeyLast,
 
-			// Ϣ
+			// 窗口消息
 			WindowFirst,
-			WindowMoved,		// ƶ
-			WindowResized,		// ڴС仯
-			WindowFocusChanged,	// ûʧȥ
-			WindowTitleChanged,	// 仯
-			WindowClosed,		// ڱر
+			WindowMoved,		// 窗口移动
+			WindowResized,		// 窗口大小变化
+			WindowFocusChanged,	// 获得或失去焦点
+			WindowTitleChanged,	// 标题变化
+			WindowClosed,		// 窗口被关闭
 			WindowLast,
 
 			Last
 		};
 
-		UINT type;
+		std::uint32_t type;
 		Node* target;
 
 		union
@@ -155,23 +156,23 @@ namespace kiwano
 			CustomEvent custom;
 		};
 
-		Event(UINT type = Type::First) : type(type), target(nullptr) {}
+		Event(std::uint32_t type = Type::First) : type(type), target(nullptr) {}
 	};
 
 
 	// Check-functions
 
-	inline bool MouseEvent::Check(UINT type)
+	inline bool MouseEvent::Check(std::uint32_t type)
 	{
 		return type > Event::MouseFirst && type < Event::MouseLast;
 	}
 
-	inline bool KeyboardEvent::Check(UINT type)
+	inline bool KeyboardEvent::Check(std::uint32_t type)
 	{
 		return type > Event::KeyFirst && type < Event::KeyLast;
 	}
 
-	inline bool WindowEvent::Check(UINT type)
+	inline bool WindowEvent::Check(std::uint32_t type)
 	{
 		return type > Event::WindowFirst && type < Event::WindowLast;
 	}
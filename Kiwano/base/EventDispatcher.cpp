@@ -23,17 +23,26 @@
 
 namespace kiwano
 {
+	EventDispatcher::EventDispatcher()
+		: listener_mask_(0)
+	{
+	}
+
 	void EventDispatcher::Dispatch(Event& evt)
 	{
-		if (listeners_.IsEmpty())
+		if (!(listener_mask_ & GetEventMask(evt.type)))
+			return;
+
+		auto iter = listeners_.find(evt.type);
+		if (iter == listeners_.end())
 			return;
 
 		EventListenerPtr next;
-		for (auto listener = listeners_.First(); listener; listener = next)
+		for (auto listener = iter->second.First(); listener; listener = next)
 		{
 			next = listener->NextItem();
 
-			if (listener->type_ == evt.type)
+			if (listener->IsRunning())
 			{
 				listener->callback_(evt);
 			}
@@ -46,89 +55,128 @@ namespace kiwano
 
 		if (listener)
 		{
-			listeners_.PushBack(listener);
+			listeners_[listener->type_].PushBack(listener);
+			UpdateListenerMask();
 		}
 		return listener;
 	}
 
-	void EventDispatcher::AddListener(UINT type, EventCallback callback, String const& name)
+	void EventDispatcher::AddListener(std::uint32_t type, EventCallback callback, String const& name)
 	{
 		EventListenerPtr listener = new EventListener(type, callback, name);
 		if (listener)
 		{
-			listeners_.PushBack(listener);
+			listeners_[type].PushBack(listener);
+			UpdateListenerMask();
 		}
 	}
 
 	void EventDispatcher::StartListeners(String const & listener_name)
 	{
-		for (auto listener = listeners_.First(); listener; listener = listener->NextItem())
+		StringAtom atom;
+		if (!StringAtom::find(listener_name, atom))
+			return;
+
+		for (auto& bucket : listeners_)
 		{
-			if (listener->IsName(listener_name))
+			for (auto listener = bucket.second.First(); listener; listener = listener->NextItem())
 			{
-				listener->Start();
+				if (listener->IsName(atom))
+				{
+					listener->Start();
+				}
 			}
 		}
 	}
 
 	void EventDispatcher::StopListeners(String const & listener_name)
 	{
-		for (auto listener = listeners_.First(); listener; listener = listener->NextItem())
+		StringAtom atom;
+		if (!StringAtom::find(listener_name, atom))
+			return;
+
+		for (auto& bucket : listeners_)
 		{
-			if (listener->IsName(listener_name))
+			for (auto listener = bucket.second.First(); listener; listener = listener->NextItem())
 			{
-				listener->Stop();
+				if (listener->IsName(atom))
+				{
+					listener->Stop();
+				}
 			}
 		}
 	}
 
 	void EventDispatcher::RemoveListeners(String const & listener_name)
 	{
+		StringAtom atom;
+		if (!StringAtom::find(listener_name, atom))
+			return;
+
 		EventListenerPtr next;
-		for (auto listener = listeners_.First(); listener; listener = next)
+		for (auto& bucket : listeners_)
 		{
-			next = listener->NextItem();
-
-			if (listener->IsName(listener_name))
+			for (auto listener = bucket.second.First(); listener; listener = next)
 			{
-				listeners_.Remove(listener);
+				next = listener->NextItem();
+
+				if (listener->IsName(atom))
+				{
+					bucket.second.Remove(listener);
+				}
 			}
 		}
+		UpdateListenerMask();
 	}
 
-	void EventDispatcher::StartListeners(UINT type)
+	void EventDispatcher::StartListeners(std::uint32_t type)
 	{
-		for (auto listener = listeners_.First(); listener; listener = listener->NextItem())
+		auto iter = listeners_.find(type);
+		if (iter == listeners_.end())
+			return;
+
+		for (auto listener = iter->second.First(); listener; listener = listener->NextItem())
 		{
-			if (listener->type_ == type)
-			{
-				listener->Start();
-			}
+			listener->Start();
 		}
 	}
 
-	void EventDispatcher::StopListeners(UINT type)
+	void EventDispatcher::StopListeners(std::uint32_t type)
 	{
-		for (auto listener = listeners_.First(); listener; listener = listener->NextItem())
+		auto iter = listeners_.find(type);
+		if (iter == listeners_.end())
+			return;
+
+		for (auto listener = iter->second.First(); listener; listener = listener->NextItem())
 		{
-			if (listener->type_ == type)
-			{
-				listener->Stop();
-			}
+			listener->Stop();
 		}
 	}
 
-	void EventDispatcher::RemoveListeners(UINT type)
+	void EventDispatcher::RemoveListeners(std::uint32_t type)
 	{
-		EventListenerPtr next;
-		for (auto listener = listeners_.First(); listener; listener = next)
+		auto iter = listeners_.find(type);
+		if (iter == listeners_.end())
+			return;
+
+		// buckets are never erased, a callback may be iterating over it
+		iter->second.Clear();
+		UpdateListenerMask();
+	}
+
+	void EventDispatcher::UpdateListenerMask()
+	{
+		std::uint32_t mask = 0;
+		for (const auto& bucket : listeners_)
 		{
-			next = listener->NextItem();
+			if (!bucket.second.IsEmpty())
+				mask |= GetEventMask(bucket.first);
+		}
 
-			if (listener->type_ == type)
-			{
-				listeners_.Remove(listener);
-			}
+		if (mask != listener_mask_)
+		{
+			listener_mask_ = mask;
+			OnListenerMaskChanged();
 		}
 	}
 
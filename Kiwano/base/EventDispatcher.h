@@ -26,53 +26,69 @@ namespace kiwano
 	class KGE_API EventDispatcher
 	{
 		using Listeners = IntrusiveList<EventListenerPtr>;
+		using ListenerBuckets = UnorderedMap<std::uint32_t, Listeners>;
 
 	public:
-		// Ӽ
+		EventDispatcher();
+
+		// 添加监听器
 		EventListenerPtr AddListener(
 			EventListenerPtr listener
 		);
 
-		// Ӽ
+		// 添加监听器
 		void AddListener(
-			UINT type,
+			std::uint32_t type,
 			EventCallback callback,
 			String const& name = L""
 		);
 
-		// 
+		// 启动监听器
 		void StartListeners(
 			String const& listener_name
 		);
 
-		// ֹͣ
+		// 停止监听器
 		void StopListeners(
 			String const& listener_name
 		);
 
-		// Ƴ
+		// 移除监听器
 		void RemoveListeners(
 			String const& listener_name
 		);
 
-		// 
+		// 启动监听器
 		void StartListeners(
-			UINT type
+			std::uint32_t type
 		);
 
-		// ֹͣ
+		// 停止监听器
 		void StopListeners(
-			UINT type
+			std::uint32_t type
 		);
 
-		// Ƴ
+		// 移除监听器
 		void RemoveListeners(
-			UINT type
+			std::uint32_t type
 		);
 
 		virtual void Dispatch(Event& evt);
 
+		// 获取已监听的事件类型掩码
+		inline std::uint32_t GetListenerMask() const		{ return listener_mask_; }
+
+		// 获取事件类型对应的掩码位
+		static inline std::uint32_t GetEventMask(std::uint32_t type)	{ return type < 31 ? (1u << type) : (1u << 31); }
+
+	protected:
+		// 监听的事件类型发生变化
+		virtual void OnListenerMaskChanged() {}
+
+		void UpdateListenerMask();
+
 	protected:
-		Listeners listeners_;
+		std::uint32_t	listener_mask_;
+		ListenerBuckets	listeners_;
 	};
 }
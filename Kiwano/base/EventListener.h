@@ -21,7 +21,7 @@
 #pragma once
 #include "../base/SmartPtr.hpp"
 #include "../common/helper.h"
-#include "../common/Closure.hpp"
+#include "../common/closure.hpp"
 #include "../common/IntrusiveList.hpp"
 #include "Object.h"
 #include "Event.hpp"
@@ -35,7 +35,7 @@ namespace kiwano
 
 	KGE_DECLARE_SMART_PTR(EventListener);
 
-	// ¼
+	// 事件监听器
 	class KGE_API EventListener
 		: public virtual Object
 		, protected IntrusiveListItem<EventListenerPtr>
@@ -45,7 +45,7 @@ namespace kiwano
 
 	public:
 		EventListener(
-			UINT type,
+			std::uint32_t type,
 			EventCallback const& callback,
 			String const& name = L""
 		);
@@ -54,13 +54,13 @@ namespace kiwano
 
 		inline void Start()				{ running_ = true; }
 
-		inline void Stop()				{ running_ = true; }
+		inline void Stop()				{ running_ = false; }
 
 		inline bool IsRunning() const	{ return running_; }
 
 	protected:
 		bool			running_;
-		UINT			type_;
+		std::uint32_t	type_;
 		EventCallback	callback_;
 	};
 }
@@ -0,0 +1,106 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "FrameStepper.h"
+#include "PerformQueue.h"
+
+namespace kiwano
+{
+	FrameStepper::FrameStepper()
+		: time_scale_(1.f)
+		, max_fixed_steps_(8)
+		, interpolation_alpha_(0.f)
+		, frame_timings_()
+	{
+	}
+
+	int FrameStepper::Update(Duration dt, Closure<void(Duration)> const& update)
+	{
+		const auto start = Time::Now();
+
+		PerformQueue::Instance().Perform(perform_budget_);
+
+		dt = dt * time_scale_;
+
+		int steps = 0;
+		if (fixed_step_.IsZero())
+		{
+			update(dt);
+			steps = 1;
+		}
+		else
+		{
+			accumulator_ += dt;
+
+			while (accumulator_ >= fixed_step_ && steps < max_fixed_steps_)
+			{
+				update(fixed_step_);
+				accumulator_ -= fixed_step_;
+				++steps;
+			}
+
+			// drop the time we can't catch up with
+			if (accumulator_ >= fixed_step_)
+				accumulator_ = Duration{};
+
+			interpolation_alpha_ = accumulator_ / fixed_step_;
+		}
+
+		// events are dispatched between two updates
+		frame_timings_.dispatch = dispatch_time_;
+		dispatch_time_ = Duration{};
+
+		frame_timings_.update = Time::Now() - start;
+		return steps;
+	}
+
+	void FrameStepper::Dispatch(Closure<void()> const& dispatch)
+	{
+		const auto start = Time::Now();
+
+		dispatch();
+
+		dispatch_time_ += Time::Now() - start;
+	}
+
+	void FrameStepper::Render(Closure<void()> const& render)
+	{
+		const auto start = Time::Now();
+
+		render();
+
+		frame_timings_.render = Time::Now() - start;
+	}
+
+	void FrameStepper::SetTimeScale(float scale_factor)
+	{
+		time_scale_ = scale_factor;
+	}
+
+	void FrameStepper::SetFixedTimeStep(Duration step, int max_steps_per_frame)
+	{
+		KGE_ASSERT(step >= Duration{} && max_steps_per_frame > 0);
+
+		fixed_step_ = step;
+		max_fixed_steps_ = (max_steps_per_frame > 0) ? max_steps_per_frame : 1;
+		accumulator_ = Duration{};
+		interpolation_alpha_ = 0.f;
+	}
+}
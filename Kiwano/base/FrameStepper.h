@@ -0,0 +1,102 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/defines.h"
+#include "../common/closure.hpp"
+#include "time.h"
+
+namespace kiwano
+{
+	// 每帧各阶段耗时
+	struct FrameTimings
+	{
+		Duration update;			// 更新
+		Duration dispatch;			// 事件分发
+		Duration render;			// 渲染提交
+	};
+
+
+	// 帧步进
+	// 按时间缩放和固定步长将帧间隔拆分为若干次更新, 并统计每帧各阶段耗时
+	class KGE_API FrameStepper
+	{
+	public:
+		FrameStepper();
+
+		// 更新一帧
+		// 先执行主线程函数, 再以缩放后的时间间隔调用 update, 返回调用次数
+		int Update(
+			Duration dt,
+			Closure<void(Duration)> const& update
+		);
+
+		// 分发事件
+		// 耗时计入下一次更新时统计的事件分发耗时
+		void Dispatch(
+			Closure<void()> const& dispatch
+		);
+
+		// 渲染一帧
+		void Render(
+			Closure<void()> const& render
+		);
+
+		// 设置时间缩放因子
+		void SetTimeScale(
+			float scale_factor
+		);
+
+		inline float GetTimeScale() const				{ return time_scale_; }
+
+		// 设置固定时间步长
+		// 步长不为零时, 每帧按固定步长更新若干次, 剩余时间留到下一帧
+		// 默认为 0, 即每帧更新一次
+		void SetFixedTimeStep(
+			Duration step,
+			int max_steps_per_frame = 8	/* 每帧最多更新次数 */
+		);
+
+		inline Duration GetFixedTimeStep() const		{ return fixed_step_; }
+
+		// 获取插值系数
+		// 固定步长模式下为剩余时间与步长之比, 范围 [0, 1)
+		inline float GetInterpolationAlpha() const		{ return interpolation_alpha_; }
+
+		// 设置每帧执行主线程函数的时间上限, 为 0 时不限时
+		inline void SetPerformTimeBudget(Duration budget)	{ perform_budget_ = budget; }
+
+		inline Duration GetPerformTimeBudget() const	{ return perform_budget_; }
+
+		// 获取上一帧各阶段耗时
+		// 事件分发耗时为两次更新之间分发的所有事件的总耗时
+		inline FrameTimings const& GetFrameTimings() const	{ return frame_timings_; }
+
+	private:
+		float			time_scale_;
+		int				max_fixed_steps_;
+		float			interpolation_alpha_;
+		Duration		fixed_step_;
+		Duration		accumulator_;
+		Duration		perform_budget_;
+		Duration		dispatch_time_;
+		FrameTimings	frame_timings_;
+	};
+}
@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "input.h"
+#include "Input.h"
 #include "logs.h"
 #include <cstring>
 
@@ -29,9 +29,9 @@ namespace kiwano
 		, mouse_pos_x_(0.f)
 		, mouse_pos_y_(0.f)
 	{
-		ZeroMemory(keys_, sizeof(keys_));
-		ZeroMemory(keys_pressed_, sizeof(keys_pressed_));
-		ZeroMemory(keys_released_, sizeof(keys_released_));
+		std::memset(keys_, 0, sizeof(keys_));
+		std::memset(keys_pressed_, 0, sizeof(keys_pressed_));
+		std::memset(keys_released_, 0, sizeof(keys_released_));
 	}
 
 	Input::~Input()
@@ -44,8 +44,8 @@ namespace kiwano
 		{
 			want_update_ = false;
 
-			ZeroMemory(keys_pressed_, sizeof(keys_pressed_));
-			ZeroMemory(keys_released_, sizeof(keys_released_));
+			std::memset(keys_pressed_, 0, sizeof(keys_pressed_));
+			std::memset(keys_released_, 0, sizeof(keys_released_));
 		}
 	}
 
@@ -67,6 +67,26 @@ namespace kiwano
 		mouse_pos_y_ = y;
 	}
 
+	void Input::HandleEvent(Event const& evt)
+	{
+		switch (evt.type)
+		{
+		case Event::KeyDown:
+		case Event::KeyUp:
+			UpdateKey(evt.key.code, evt.type == Event::KeyDown);
+			break;
+		case Event::MouseBtnDown:
+		case Event::MouseBtnUp:
+			UpdateKey(evt.mouse.button, evt.type == Event::MouseBtnDown);
+			break;
+		case Event::MouseMove:
+			UpdateMousePos(evt.mouse.x, evt.mouse.y);
+			break;
+		default:
+			break;
+		}
+	}
+
 	bool Input::IsDown(int key_or_btn)
 	{
 		KGE_ASSERT(key_or_btn >= 0 && key_or_btn < KEY_NUM);
@@ -19,10 +19,11 @@
 // THE SOFTWARE.
 
 #pragma once
-#include "../macros.h"
+#include "../common/defines.h"
 #include "../common/Singleton.hpp"
 #include "../math/helper.h"
 #include "keys.hpp"
+#include "Event.hpp"
 #include "Component.h"
 
 namespace kiwano
@@ -34,28 +35,28 @@ namespace kiwano
 		KGE_DECLARE_SINGLETON(Input);
 
 	public:
-		// ̻갴Ƿ
+		// 检测键盘或鼠标按键是否正被按下
 		bool IsDown(
 			int key_or_btn
 		);
 
-		// ̻갴Ƿձ
+		// 检测键盘或鼠标按键是否刚被点击
 		bool WasPressed(
 			int key_or_btn
 		);
 
-		// ̻갴Ƿ̧
+		// 检测键盘或鼠标按键是否刚抬起
 		bool WasReleased(
 			int key_or_btn
 		);
 
-		//  x 
+		// 获得鼠标 x 坐标
 		float GetMouseX();
 
-		//  y 
+		// 获得鼠标 y 坐标
 		float GetMouseY();
 
-		// 
+		// 获得鼠标坐标
 		Point GetMousePos();
 
 	public:
@@ -69,6 +70,9 @@ namespace kiwano
 
 		void UpdateMousePos(float, float);
 
+		// 根据按键和鼠标事件更新输入状态
+		void HandleEvent(Event const& evt);
+
 	protected:
 		Input();
 
@@ -35,7 +35,6 @@ namespace kiwano
 	Object::Object()
 		: tracing_leak_(false)
 		, user_data_(nullptr)
-		, name_(nullptr)
 		, id_(++last_object_id)
 	{
 #ifdef KGE_DEBUG
@@ -47,9 +46,6 @@ namespace kiwano
 
 	Object::~Object()
 	{
-		if (name_)
-			delete name_;
-
 #ifdef KGE_DEBUG
 
 		Object::__RemoveObjectFromTracingList(this);
@@ -72,20 +68,12 @@ namespace kiwano
 		if (IsName(name))
 			return;
 
-		if (name.empty())
-		{
-			if (name_)
-				name_->clear();
-			return;
-		}
-
-		if (!name_)
-		{
-			name_ = new (std::nothrow) String(name);
-			return;
-		}
+		name_ = StringAtom(name);
+	}
 
-		*name_ = name;
+	void Object::SetName(StringAtom const & name)
+	{
+		name_ = name;
 	}
 
 	String Object::DumpObject()
@@ -19,7 +19,7 @@
 // THE SOFTWARE.
 
 #pragma once
-#include "../macros.h"
+#include "../common/defines.h"
 #include "../common/helper.h"
 #include "RefCounter.hpp"
 #include "SmartPtr.hpp"
@@ -42,9 +42,15 @@ namespace kiwano
 
 		void SetName(String const& name);
 
-		inline String GetName() const					{ if (name_) return *name_; return String(); }
+		void SetName(StringAtom const& name);
 
-		inline bool IsName(String const& name) const	{ return name_ ? (*name_ == name) : name.empty(); }
+		inline String const& GetName() const				{ return name_.str(); }
+
+		inline StringAtom const& GetNameAtom() const		{ return name_; }
+
+		inline bool IsName(String const& name) const		{ return name_.str() == name; }
+
+		inline bool IsName(StringAtom const& name) const	{ return name_ == name; }
 
 		inline unsigned int GetObjectID() const			{ return id_; }
 
@@ -67,7 +73,7 @@ namespace kiwano
 	private:
 		bool tracing_leak_;
 		void* user_data_;
-		String* name_;
+		StringAtom name_;
 
 		const unsigned int id_;
 		static unsigned int last_object_id;
@@ -0,0 +1,86 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "PerformQueue.h"
+#include <algorithm>
+
+namespace kiwano
+{
+	PerformQueue::PerformQueue()
+		: stats_()
+	{
+		for (auto& queued : queued_)
+			queued = 0;
+	}
+
+	void PerformQueue::Push(Closure<void()> function, PerformPriority priority)
+	{
+		const int lane = static_cast<int>(priority);
+
+		lanes_[lane].Push(Item{ std::move(function), Time::Now() });
+		++queued_[lane];
+	}
+
+	void PerformQueue::Perform(Duration budget)
+	{
+		const auto start = Time::Now();
+
+		PerformStats stats = {};
+		bool out_of_time = false;
+
+		for (int lane = 0; lane < lane_count && !out_of_time; ++lane)
+		{
+			// functions posted while performing wait for the next frame
+			size_t count = queued_[lane].load();
+
+			for (; count > 0; --count)
+			{
+				const auto now = Time::Now();
+				if (!budget.IsZero() && stats.performed > 0 && now - start >= budget)
+				{
+					out_of_time = true;
+					break;
+				}
+
+				Item item;
+				if (!lanes_[lane].Pop(item))
+					break;
+
+				--queued_[lane];
+
+				stats.max_latency = std::max(stats.max_latency, now - item.post_time);
+				++stats.performed;
+
+				if (item.function)
+				{
+					item.function();
+				}
+			}
+		}
+
+		for (int lane = 0; lane < lane_count; ++lane)
+		{
+			stats.queued += queued_[lane].load();
+		}
+
+		stats.drain_time = Time::Now() - start;
+		stats_ = stats;
+	}
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/defines.h"
+#include "../common/closure.hpp"
+#include "../common/Singleton.hpp"
+#include "../common/MpscQueue.hpp"
+#include "time.h"
+
+namespace kiwano
+{
+	// 主线程函数的优先级
+	enum class PerformPriority
+	{
+		High,
+		Normal,
+		Low
+	};
+
+
+	// 主线程函数的执行情况
+	struct PerformStats
+	{
+		size_t		queued;			// 等待执行的函数数量
+		size_t		performed;		// 上一帧执行的函数数量
+		Duration	drain_time;		// 上一帧执行函数的耗时
+		Duration	max_latency;	// 上一帧执行的函数从提交到执行的最长等待时间
+	};
+
+
+	// 主线程函数队列
+	// 任意线程可以提交函数, 由主线程在每帧更新前按优先级执行
+	class KGE_API PerformQueue
+		: public Singleton<PerformQueue>
+	{
+		KGE_DECLARE_SINGLETON(PerformQueue);
+
+	public:
+		// 提交函数, 可在任意线程调用
+		void Push(
+			Closure<void()> function,
+			PerformPriority priority = PerformPriority::Normal
+		);
+
+		// 执行已提交的函数, 只能在主线程调用
+		// 执行中提交的函数留到下一次执行
+		// 超出时间上限时剩余的函数也留到下一次执行, 至少执行一个函数, 上限为 0 时不限时
+		void Perform(
+			Duration budget = Duration()
+		);
+
+		// 获取上一次执行的情况
+		inline PerformStats const& GetStats() const { return stats_; }
+
+	private:
+		PerformQueue();
+
+		struct Item
+		{
+			Closure<void()>	function;
+			Time			post_time;
+		};
+
+		enum : int
+		{
+			lane_count = 3
+		};
+
+	private:
+		// one lane per priority, worker threads post without taking a lock
+		MpscQueue<Item>		lanes_[lane_count];
+		std::atomic<size_t>	queued_[lane_count];
+		PerformStats		stats_;
+	};
+}
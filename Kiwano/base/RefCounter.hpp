@@ -19,7 +19,7 @@
 // THE SOFTWARE.
 
 #pragma once
-#include "../macros.h"
+#include "../common/defines.h"
 #include "../common/noncopyable.hpp"
 
 namespace kiwano
@@ -28,17 +28,17 @@ namespace kiwano
 		: protected Noncopyable
 	{
 	public:
-		// ü
+		// 增加引用计数
 		inline void Retain() { ++ref_count_; }
 
-		// ü
+		// 减少引用计数
 		inline void Release()
 		{
 			if (--ref_count_ <= 0)
 				delete this;
 		}
 
-		// ȡü
+		// 获取引用计数
 		inline long GetRefCount() const { return ref_count_; }
 
 	protected:
@@ -47,6 +47,8 @@ namespace kiwano
 	}
 
 	Resource::Resource(Resource const & rhs)
+		: type_(Type::File)
+		, file_name_(nullptr)
 	{
 		operator=(rhs);
 	}
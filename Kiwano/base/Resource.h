@@ -24,13 +24,13 @@
 
 namespace kiwano
 {
-	// Դ
+	// 资源
 	// 
-	// ԴļͣҲǱ exe еĶԴ
-	// , һƵԴΪ L"WAVE", ƱʶΪ IDR_WAVE_1,
-	// ôָԴ: Resource res(MAKEINTRESOURCE(IDR_WAVE_1), L"WAVE");
+	// 资源可以是文件类型，也可以是保存在 exe 中的二进制资源
+	// 例如, 一份音频资源的类型为 L"WAVE", 名称标识符为 IDR_WAVE_1,
+	// 那么可以这样指定该资源: Resource res(MAKEINTRESOURCE(IDR_WAVE_1), L"WAVE");
 	// 
-	// ˽ԴĸϢ: https://docs.microsoft.com/en-us/windows/desktop/menurc/resources
+	// 了解资源的更多信息: https://docs.microsoft.com/en-us/windows/desktop/menurc/resources
 	//
 	class KGE_API Resource
 	{
@@ -38,16 +38,16 @@ namespace kiwano
 
 	public:
 		Resource(
-			LPCWSTR file_name		/* ļ· */
+			LPCWSTR file_name		/* 文件路径 */
 		);
 
 		Resource(
-			String const& file_name	/* ļ· */
+			String const& file_name	/* 文件路径 */
 		);
 
 		Resource(
-			LPCWSTR name,			/* Դ */
-			LPCWSTR type			/* Դ */
+			LPCWSTR name,			/* 资源名称 */
+			LPCWSTR type			/* 资源类型 */
 		);
 
 		Resource(
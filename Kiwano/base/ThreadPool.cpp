@@ -0,0 +1,370 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "ThreadPool.h"
+#include "PerformQueue.h"
+#include <deque>
+
+namespace kiwano
+{
+	namespace
+	{
+		// index of the worker running on this thread, -1 for other threads
+		thread_local int worker_index = -1;
+
+		const int priority_count = 3;
+	}
+
+	//-------------------------------------------------------
+	// Task
+	//-------------------------------------------------------
+
+	void TaskPtrManager::AddRef(Task* ptr)
+	{
+		if (ptr)
+			++ptr->ref_count_;
+	}
+
+	void TaskPtrManager::Release(Task* ptr)
+	{
+		if (ptr && --ptr->ref_count_ == 0)
+			delete ptr;
+	}
+
+	Task::Task(Func func, TaskPriority priority)
+		: ref_count_(0)
+		, pending_(1)
+		, state_(StateIdle)
+		, priority_(priority)
+		, func_(std::move(func))
+	{
+	}
+
+	void Task::AddDependency(TaskPtr const& task)
+	{
+		KGE_ASSERT(task && task.Get() != this);
+
+		if (!task)
+			return;
+
+		std::lock_guard<std::mutex> lock(task->mutex_);
+		if (task->state_ & StateDone)
+			return;
+
+		++pending_;
+		TaskPtrManager::AddRef(this);
+		task->successors_.push_back(this);
+	}
+
+	void Task::SetCallback(Func const& callback)
+	{
+		callback_ = callback;
+	}
+
+	void Task::Cancel()
+	{
+		state_ |= StateCancelled;
+	}
+
+	bool Task::IsCancelled() const
+	{
+		return (state_ & StateCancelled) != 0;
+	}
+
+	bool Task::IsDone() const
+	{
+		return (state_ & StateDone) != 0;
+	}
+
+	void Task::Wait()
+	{
+		while (!IsDone())
+		{
+			if (!ThreadPool::Instance().RunPendingTask())
+				std::this_thread::yield();
+		}
+	}
+
+	//-------------------------------------------------------
+	// ThreadPool
+	//-------------------------------------------------------
+
+	struct ThreadPool::WorkQueue
+	{
+		std::mutex			mutex;
+		std::deque<Task*>	lanes[priority_count];
+	};
+
+	ThreadPool::ThreadPool()
+		: started_(false)
+		, stopped_(false)
+		, thread_count_(0)
+		, queued_(0)
+		, sleeping_(0)
+		, next_queue_(0)
+	{
+		thread_count_ = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+		if (thread_count_ < 1)
+			thread_count_ = 1;
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		Stop();
+	}
+
+	TaskPtr ThreadPool::Create(Func func, TaskPriority priority)
+	{
+		// take over the closure, it will be released on a worker thread
+		return TaskPtr(new Task(std::move(func), priority));
+	}
+
+	void ThreadPool::Submit(TaskPtr const& task)
+	{
+		KGE_ASSERT(task && "ThreadPool::Submit failed, NULL pointer exception");
+
+		if (!task)
+			return;
+
+		Start();
+
+		// the reference is held by the pool until the task finishes
+		TaskPtrManager::AddRef(task.Get());
+
+		if (--task->pending_ == 0)
+			Enqueue(task.Get());
+	}
+
+	TaskPtr ThreadPool::Run(Func func, TaskPriority priority)
+	{
+		TaskPtr task = Create(std::move(func), priority);
+		Submit(task);
+		return task;
+	}
+
+	bool ThreadPool::RunPendingTask()
+	{
+		if (!started_.load(std::memory_order_acquire))
+			return false;
+
+		Task* task = Dequeue(worker_index);
+		if (!task)
+			return false;
+
+		Execute(task);
+		return true;
+	}
+
+	void ThreadPool::SetThreadCount(int count)
+	{
+		KGE_ASSERT(!started_.load(std::memory_order_acquire) && "ThreadPool::SetThreadCount must be called before any task is submitted");
+
+		thread_count_ = (count > 0) ? count : 1;
+	}
+
+	int ThreadPool::GetThreadCount() const
+	{
+		return thread_count_;
+	}
+
+	void ThreadPool::DestroyComponent()
+	{
+		Stop();
+	}
+
+	void ThreadPool::Start()
+	{
+		// pairs with the release store below, so queues_ and threads_ are visible once started_ is
+		if (started_.load(std::memory_order_acquire))
+			return;
+
+		std::lock_guard<std::mutex> lock(start_mutex_);
+		if (started_.load(std::memory_order_relaxed))
+			return;
+
+		for (int i = 0; i < thread_count_; ++i)
+		{
+			queues_.push_back(new WorkQueue);
+		}
+
+		for (int i = 0; i < thread_count_; ++i)
+		{
+			threads_.push_back(new std::thread(&ThreadPool::WorkerThread, this, i));
+		}
+
+		started_.store(true, std::memory_order_release);
+	}
+
+	void ThreadPool::Stop()
+	{
+		std::lock_guard<std::mutex> lock(start_mutex_);
+		if (!started_.load(std::memory_order_relaxed))
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex_);
+			stopped_ = true;
+		}
+		sleep_cond_.notify_all();
+
+		for (auto thread : threads_)
+		{
+			thread->join();
+			delete thread;
+		}
+		threads_.clear();
+
+		// cancel the tasks left in queues, their dependents are released too
+		while (Task* task = Dequeue(-1))
+		{
+			task->Cancel();
+			Finish(task);
+		}
+
+		for (auto queue : queues_)
+		{
+			delete queue;
+		}
+		queues_.clear();
+
+		// stays set while workers drain, tasks they submit must not wait on start_mutex_
+		started_.store(false, std::memory_order_release);
+		stopped_ = false;
+	}
+
+	void ThreadPool::Enqueue(Task* task)
+	{
+		int index = worker_index;
+		if (index < 0)
+			index = static_cast<int>(next_queue_++ % queues_.size());
+
+		WorkQueue* queue = queues_[index];
+		{
+			std::lock_guard<std::mutex> lock(queue->mutex);
+			queue->lanes[static_cast<int>(task->priority_)].push_back(task);
+		}
+
+		++queued_;
+
+		if (sleeping_ > 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(sleep_mutex_);
+			}
+			sleep_cond_.notify_one();
+		}
+	}
+
+	Task* ThreadPool::Dequeue(int index)
+	{
+		if (queued_ <= 0)
+			return nullptr;
+
+		const int count = static_cast<int>(queues_.size());
+		const int first = (index < 0) ? 0 : index;
+
+		// own queue first, then steal from the others
+		for (int lane = priority_count - 1; lane >= 0; --lane)
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				WorkQueue* queue = queues_[(first + i) % count];
+
+				std::lock_guard<std::mutex> lock(queue->mutex);
+				auto& tasks = queue->lanes[lane];
+				if (!tasks.empty())
+				{
+					Task* task = tasks.front();
+					tasks.pop_front();
+
+					--queued_;
+					return task;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	void ThreadPool::Execute(Task* task)
+	{
+		if (!task->IsCancelled() && task->func_)
+		{
+			task->func_();
+		}
+
+		Finish(task);
+	}
+
+	void ThreadPool::Finish(Task* task)
+	{
+		Array<Task*> successors;
+		{
+			std::lock_guard<std::mutex> lock(task->mutex_);
+			successors = std::move(task->successors_);
+			task->state_ |= Task::StateDone;
+		}
+
+		const bool cancelled = task->IsCancelled();
+		for (auto next : successors)
+		{
+			if (cancelled)
+				next->Cancel();
+
+			if (--next->pending_ == 0)
+				Enqueue(next);
+
+			// reference taken in AddDependency
+			TaskPtrManager::Release(next);
+		}
+
+		if (task->callback_)
+		{
+			TaskPtr ptr(task);
+			PerformQueue::Instance().Push([ptr]() { ptr->callback_(); });
+		}
+
+		TaskPtrManager::Release(task);
+	}
+
+	void ThreadPool::WorkerThread(int index)
+	{
+		worker_index = index;
+
+		while (true)
+		{
+			if (Task* task = Dequeue(index))
+			{
+				Execute(task);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleep_mutex_);
+
+			++sleeping_;
+			sleep_cond_.wait(lock, [this]() { return stopped_ || queued_ > 0; });
+			--sleeping_;
+
+			if (stopped_)
+				break;
+		}
+
+		worker_index = -1;
+	}
+}
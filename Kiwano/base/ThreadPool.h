@@ -0,0 +1,212 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/defines.h"
+#include "../common/helper.h"
+#include "../common/closure.hpp"
+#include "../common/Singleton.hpp"
+#include "../common/noncopyable.hpp"
+#include "../common/IntrusivePtr.hpp"
+#include "Component.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace kiwano
+{
+	class Task;
+	class ThreadPool;
+
+	struct TaskPtrManager
+	{
+		static void AddRef(Task* ptr);
+
+		static void Release(Task* ptr);
+	};
+
+	using TaskPtr = IntrusivePtr<Task, TaskPtrManager>;
+
+	// 任务优先级
+	enum class TaskPriority : int
+	{
+		Low = 0,
+		Normal,
+		High,
+	};
+
+	// 线程池任务
+	// 任务的所有前置任务结束后才会被调度, 一个任务可以有多个前置任务和后续任务
+	class KGE_API Task
+		: protected Noncopyable
+	{
+		friend class ThreadPool;
+		friend struct TaskPtrManager;
+
+	public:
+		using Func = Closure<void()>;
+
+		// 添加前置任务
+		// 需在提交任务之前调用, 前置任务已结束时无效
+		void AddDependency(
+			TaskPtr const& task
+		);
+
+		// 设置任务结束后在主线程中执行的回调
+		// 任务被取消时回调仍会执行
+		void SetCallback(
+			Func const& callback
+		);
+
+		// 取消任务
+		// 未开始执行的任务及其后续任务都不再执行
+		void Cancel();
+
+		// 是否已取消
+		bool IsCancelled() const;
+
+		// 是否已结束
+		bool IsDone() const;
+
+		// 等待任务结束
+		// 等待期间当前线程会帮助执行其他任务
+		void Wait();
+
+		// 获取优先级
+		inline TaskPriority GetPriority() const	{ return priority_; }
+
+	private:
+		Task(
+			Func func,
+			TaskPriority priority
+		);
+
+		enum : int
+		{
+			StateIdle = 0,
+			StateCancelled = 1,
+			StateDone = 2,
+		};
+
+	private:
+		std::atomic<long>	ref_count_;
+		std::atomic<int>	pending_;
+		std::atomic<int>	state_;
+		TaskPriority		priority_;
+		Func				func_;
+		Func				callback_;
+		std::mutex			mutex_;
+		Array<Task*>		successors_;
+	};
+
+
+	// 线程池
+	// 每个工作线程有各自的任务队列, 空闲时从其他线程的队列中窃取任务
+	class KGE_API ThreadPool
+		: public Singleton<ThreadPool>
+		, public Component
+	{
+		KGE_DECLARE_SINGLETON(ThreadPool);
+
+		using Func = Task::Func;
+
+	public:
+		// 创建任务
+		// 任务需要提交后才会执行
+		TaskPtr Create(
+			Func func,
+			TaskPriority priority = TaskPriority::Normal
+		);
+
+		// 提交任务
+		void Submit(
+			TaskPtr const& task
+		);
+
+		// 创建并提交任务
+		TaskPtr Run(
+			Func func,
+			TaskPriority priority = TaskPriority::Normal
+		);
+
+		// 在当前线程执行一个待执行的任务
+		// 没有待执行的任务时返回 false
+		bool RunPendingTask();
+
+		// 设置工作线程数量
+		// 需在第一次提交任务之前调用, 默认为 CPU 核心数减一
+		void SetThreadCount(
+			int count
+		);
+
+		// 获取工作线程数量
+		int GetThreadCount() const;
+
+	public:
+		void SetupComponent(Application*) override {}
+
+		void DestroyComponent() override;
+
+	private:
+		ThreadPool();
+
+		~ThreadPool();
+
+		struct WorkQueue;
+
+		void Start();
+
+		void Stop();
+
+		void Enqueue(
+			Task* task
+		);
+
+		Task* Dequeue(
+			int index
+		);
+
+		void Execute(
+			Task* task
+		);
+
+		void Finish(
+			Task* task
+		);
+
+		void WorkerThread(
+			int index
+		);
+
+	private:
+		std::atomic<bool>		started_;
+		bool					stopped_;
+		int						thread_count_;
+		std::atomic<int>		queued_;
+		std::atomic<int>		sleeping_;
+		std::atomic<unsigned>	next_queue_;
+		std::mutex				start_mutex_;
+		std::mutex				sleep_mutex_;
+		std::condition_variable	sleep_cond_;
+		Array<WorkQueue*>		queues_;
+		Array<std::thread*>		threads_;
+	};
+}
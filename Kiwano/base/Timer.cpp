@@ -19,6 +19,7 @@
 // THE SOFTWARE.
 
 #include "Timer.h"
+#include "TimerManager.h"
 
 namespace kiwano
 {
@@ -33,38 +34,43 @@ namespace kiwano
 		, total_times_(times)
 		, delay_(delay)
 		, callback_(func)
-		, delta_()
+		, manager_(nullptr)
+		, deadline_(0)
+		, remaining_(0)
+		, wheel_level_(-1)
+		, wheel_slot_(-1)
+		, wheel_prev_(nullptr)
+		, wheel_next_(nullptr)
 	{
 		SetName(name);
 	}
 
 	void Timer::Start()
 	{
+		if (running_)
+			return;
+
 		running_ = true;
+
+		if (manager_)
+			manager_->ResumeTimer(this);
 	}
 
 	void Timer::Stop()
 	{
+		if (!running_)
+			return;
+
 		running_ = false;
+
+		if (manager_)
+			manager_->PauseTimer(this);
 	}
 
-	void Timer::Update(Duration dt, bool& remove_after_update)
+	bool Timer::Invoke()
 	{
-		if (!running_)
-			return;
-
 		if (total_times_ == 0)
-		{
-			remove_after_update = true;
-			return;
-		}
-
-		if (!delay_.IsZero())
-		{
-			delta_ += dt;
-			if (delta_ < delay_)
-				return;
-		}
+			return true;
 
 		++run_times_;
 
@@ -73,17 +79,13 @@ namespace kiwano
 			callback_();
 		}
 
-		if (run_times_ == total_times_)
-		{
-			remove_after_update = true;
-			return;
-		}
+		return run_times_ == total_times_;
 	}
 
 	void Timer::Reset()
 	{
-		delta_ = Duration{};
 		run_times_ = 0;
+		remaining_ = delay_.Milliseconds();
 	}
 
 	bool Timer::IsRunning() const
@@ -20,7 +20,7 @@
 
 #pragma once
 #include "../common/helper.h"
-#include "../common/Closure.hpp"
+#include "../common/closure.hpp"
 #include "../common/IntrusiveList.hpp"
 #include "Object.h"
 #include "time.h"
@@ -32,49 +32,61 @@ namespace kiwano
 
 	KGE_DECLARE_SMART_PTR(Timer);
 
-    // ʱ
+    // 定时任务
 	class KGE_API Timer
 		: public virtual Object
 		, protected IntrusiveListItem<TimerPtr>
 	{
 		friend class TimerManager;
+		friend class TimerWheel;
 		friend class IntrusiveList<TimerPtr>;
 
 		using Callback = Closure<void()>;
 
 	public:
 		explicit Timer(
-			Callback const& func,		/* ִк */
-			String const& name = L""	/*  */
+			Callback const& func,		/* 执行函数 */
+			String const& name = L""	/* 任务名称 */
 		);
 
 		explicit Timer(
-			Callback const& func,		/* ִк */
-			Duration delay,				/* ʱ룩 */
-			int times = -1,				/* ִд -1 ΪִУ */
-			String const& name = L""	/*  */
+			Callback const& func,		/* 执行函数 */
+			Duration delay,				/* 时间间隔（秒） */
+			int times = -1,				/* 执行次数（设 -1 为永久执行） */
+			String const& name = L""	/* 任务名称 */
 		);
 
-		// 
+		// 启动任务
 		void Start();
 
-		// ֹͣ
+		// 停止任务
 		void Stop();
 
-		// Ƿִ
+		// 任务是否正在执行
 		bool IsRunning() const;
 
 	protected:
-		void Update(Duration dt, bool& remove_after_update);
+		// 执行任务, 返回任务是否已完成
+		bool Invoke();
 
 		void Reset();
 
+		// 是否已加入时间轮
+		inline bool IsScheduled() const { return wheel_level_ >= 0; }
+
 	protected:
-		bool		running_;
-		int			run_times_;
-		int			total_times_;
-		Duration	delay_;
-		Duration	delta_;
-		Callback	callback_;
+		bool			running_;
+		int				run_times_;
+		int				total_times_;
+		Duration		delay_;
+		Callback		callback_;
+
+		TimerManager*	manager_;
+		long long		deadline_;
+		long long		remaining_;
+		int				wheel_level_;
+		int				wheel_slot_;
+		Timer*			wheel_prev_;
+		Timer*			wheel_next_;
 	};
 }
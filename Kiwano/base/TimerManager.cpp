@@ -19,47 +19,114 @@
 // THE SOFTWARE.
 
 #include "TimerManager.h"
-#include "../base/logs.h"
+#include <algorithm>
 
 namespace kiwano
 {
+	TimerManager::TimerManager()
+		: elapsed_()
+		, wheel_(nullptr)
+	{
+	}
+
+	TimerManager::~TimerManager()
+	{
+		RemoveAllTimers();
+
+		if (wheel_)
+		{
+			delete wheel_;
+			wheel_ = nullptr;
+		}
+	}
+
 	void TimerManager::UpdateTimers(Duration dt)
 	{
 		if (timers_.IsEmpty())
 			return;
 
-		TimerPtr next;
-		for (auto timer = timers_.First(); timer; timer = next)
+		// the wheel ticks in milliseconds, keep the sub-millisecond part in elapsed_
+		elapsed_ += dt;
+
+		const long long now = elapsed_.Milliseconds();
+		wheel_->Advance(now, expired_);
+
+		if (expired_.empty())
+			return;
+
+		for (const auto& timer : expired_)
 		{
-			next = timer->NextItem();
+			// removed, stopped or rescheduled by an earlier callback
+			if (timer->manager_ != this || !timer->running_ || timer->IsScheduled())
+				continue;
+
+			long long delay = timer->delay_.Milliseconds();
+			long long deadline = timer->deadline_ + delay;
+			timer->deadline_ = (deadline > now) ? deadline : (now + delay);
+
+			if (timer->Invoke())
+			{
+				if (timer->manager_ == this)
+					RemoveTimer(timer);
+			}
+			else if (timer->manager_ == this && timer->running_ && !timer->IsScheduled())
+			{
+				wheel_->Insert(timer.Get());
+			}
+		}
+		expired_.clear();
+	}
 
-			bool remove_after_update = false;
-			timer->Update(dt, remove_after_update);
+	void TimerManager::PauseTimer(Timer* timer)
+	{
+		timer->remaining_ = std::max(timer->deadline_ - elapsed_.Milliseconds(), 0LL);
+		wheel_->Remove(timer);
+	}
 
-			if (remove_after_update)
-				timers_.Remove(timer);
+	void TimerManager::ResumeTimer(Timer* timer)
+	{
+		if (!timer->IsScheduled())
+		{
+			timer->deadline_ = elapsed_.Milliseconds() + timer->remaining_;
+			wheel_->Insert(timer);
 		}
 	}
 
+	void TimerManager::RemoveTimer(TimerPtr timer)
+	{
+		wheel_->Remove(timer.Get());
+		timer->manager_ = nullptr;
+		timers_.Remove(timer);
+	}
+
 	void TimerManager::AddTimer(TimerPtr timer)
 	{
 		KGE_ASSERT(timer && "AddTimer failed, NULL pointer exception");
+		KGE_ASSERT(!timer->manager_ && "AddTimer failed, the timer is already added");
 
-		if (timer)
+		if (timer && !timer->manager_)
 		{
+			if (!wheel_)
+				wheel_ = new TimerWheel;
+
 			timer->Reset();
+			timer->manager_ = this;
 			timers_.PushBack(timer);
+
+			if (timer->running_)
+				ResumeTimer(timer.Get());
 		}
 	}
 
 	void TimerManager::StopTimers(String const& name)
 	{
-		if (timers_.IsEmpty())
+		StringAtom atom;
+		if (timers_.IsEmpty() || !StringAtom::find(name, atom))
 			return;
 
 		for (auto timer = timers_.First().Get(); timer; timer = timer->NextItem().Get())
 		{
-			if (timer->IsName(name))
+			if (timer->IsName(atom))
 			{
 				timer->Stop();
 			}
@@ -68,12 +135,13 @@ namespace kiwano
 
 	void TimerManager::StartTimers(String const& name)
 	{
-		if (timers_.IsEmpty())
+		StringAtom atom;
+		if (timers_.IsEmpty() || !StringAtom::find(name, atom))
 			return;
-		
+
 		for (auto timer = timers_.First().Get(); timer; timer = timer->NextItem().Get())
 		{
-			if (timer->IsName(name))
+			if (timer->IsName(atom))
 			{
 				timer->Start();
 			}
@@ -82,16 +150,17 @@ namespace kiwano
 
 	void TimerManager::RemoveTimers(String const& name)
 	{
-		if (timers_.IsEmpty())
+		StringAtom atom;
+		if (timers_.IsEmpty() || !StringAtom::find(name, atom))
 			return;
 
 		TimerPtr next;
 		for (auto timer = timers_.First(); timer; timer = next)
 		{
 			next = timer->NextItem();
-			if (timer->IsName(name))
+			if (timer->IsName(atom))
 			{
-				timers_.Remove(timer);
+				RemoveTimer(timer);
 			}
 		}
 	}
@@ -120,6 +189,15 @@ namespace kiwano
 
 	void TimerManager::RemoveAllTimers()
 	{
+		if (timers_.IsEmpty())
+			return;
+
+		for (auto timer = timers_.First().Get(); timer; timer = timer->NextItem().Get())
+		{
+			timer->manager_ = nullptr;
+		}
+
+		wheel_->Clear();
 		timers_.Clear();
 	}
 
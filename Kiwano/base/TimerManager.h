@@ -20,50 +20,68 @@
 
 #pragma once
 #include "Timer.h"
+#include "TimerWheel.h"
 
 namespace kiwano
 {
+	// 定时任务管理器
+	// 任务按到期时间存放在时间轮中, 每帧只处理到期的任务
 	class KGE_API TimerManager
 	{
+		friend class Timer;
+
 		using Timers = IntrusiveList<TimerPtr>;
 
 	public:
-		// 
+		TimerManager();
+
+		~TimerManager();
+
+		// 添加任务
 		void AddTimer(
 			TimerPtr timer
 		);
 
-		// 
+		// 启动任务
 		void StartTimers(
 			String const& timer_name
 		);
 
-		// ֹͣ
+		// 停止任务
 		void StopTimers(
 			String const& timer_name
 		);
 
-		// Ƴ
+		// 移除任务
 		void RemoveTimers(
 			String const& timer_name
 		);
 
-		// 
+		// 启动所有任务
 		void StartAllTimers();
 
-		// ֹͣ
+		// 停止所有任务
 		void StopAllTimers();
 
-		// Ƴ
+		// 移除所有任务
 		void RemoveAllTimers();
 
-		// ȡ
+		// 获取所有任务
 		const Timers& GetAllTimers() const;
 
 	protected:
 		void UpdateTimers(Duration dt);
 
+		void PauseTimer(Timer* timer);
+
+		void ResumeTimer(Timer* timer);
+
+		void RemoveTimer(TimerPtr timer);
+
 	protected:
-		Timers timers_;
+		Duration		elapsed_;
+		TimerWheel*		wheel_;
+		Array<TimerPtr>	expired_;
+		Timers			timers_;
 	};
 }
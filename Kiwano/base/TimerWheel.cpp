@@ -0,0 +1,203 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "TimerWheel.h"
+#include "Timer.h"
+#include <algorithm>
+
+namespace kiwano
+{
+	TimerWheel::TimerWheel()
+		: current_(0)
+		, size_(0)
+		, level_size_{}
+		, slots_{}
+		, pending_(nullptr)
+	{
+	}
+
+	TimerWheel::~TimerWheel()
+	{
+		Clear();
+	}
+
+	void TimerWheel::Insert(Timer* timer)
+	{
+		KGE_ASSERT(timer && timer->wheel_level_ < 0);
+
+		if (timer->deadline_ <= current_)
+		{
+			// already due, run it at the next advance
+			Link(timer, level_count, 0);
+		}
+		else
+		{
+			Place(timer, timer->deadline_);
+		}
+	}
+
+	void TimerWheel::Remove(Timer* timer)
+	{
+		if (timer && timer->wheel_level_ >= 0)
+		{
+			Unlink(timer);
+		}
+	}
+
+	void TimerWheel::Advance(long long now, Array<TimerPtr>& expired)
+	{
+		TakeAll(pending_, expired);
+
+		if (size_ == 0)
+		{
+			current_ = std::max(current_, now);
+			return;
+		}
+
+		while (current_ < now)
+		{
+			if (level_size_[0] == 0)
+			{
+				// nothing in the lowest level, jump to the next cascade point
+				long long next = (current_ | slot_mask) + 1;
+				if (next > now)
+				{
+					current_ = now;
+					break;
+				}
+				current_ = next - 1;
+			}
+
+			++current_;
+
+			int top = 0;
+			while (top + 1 < level_count && (current_ & ((1LL << (slot_bits * (top + 1))) - 1)) == 0)
+				++top;
+
+			for (int level = top; level > 0; --level)
+				Cascade(level);
+
+			TakeAll(slots_[0][current_ & slot_mask], expired);
+		}
+	}
+
+	void TimerWheel::Clear()
+	{
+		for (int level = 0; level < level_count; ++level)
+		{
+			for (int slot = 0; slot < slot_count; ++slot)
+			{
+				while (slots_[level][slot])
+					Unlink(slots_[level][slot]);
+			}
+		}
+
+		while (pending_)
+			Unlink(pending_);
+	}
+
+	void TimerWheel::Place(Timer* timer, long long deadline)
+	{
+		long long delta = deadline - current_;
+
+		int level = 0;
+		while (level + 1 < level_count && delta >= (1LL << (slot_bits * (level + 1))))
+			++level;
+
+		// too far away, park it in the last slot and place it again when cascading
+		const long long max_delta = (1LL << (slot_bits * level_count)) - 1;
+		if (delta > max_delta)
+			deadline = current_ + max_delta;
+
+		Link(timer, level, static_cast<int>(deadline >> (slot_bits * level)) & slot_mask);
+	}
+
+	void TimerWheel::Link(Timer* timer, int level, int slot)
+	{
+		Timer*& head = GetSlot(level, slot);
+
+		timer->wheel_level_ = level;
+		timer->wheel_slot_ = slot;
+		timer->wheel_prev_ = nullptr;
+		timer->wheel_next_ = head;
+		if (head)
+			head->wheel_prev_ = timer;
+		head = timer;
+
+		++level_size_[level];
+		++size_;
+	}
+
+	void TimerWheel::Unlink(Timer* timer)
+	{
+		if (timer->wheel_prev_)
+			timer->wheel_prev_->wheel_next_ = timer->wheel_next_;
+		else
+			GetSlot(timer->wheel_level_, timer->wheel_slot_) = timer->wheel_next_;
+
+		if (timer->wheel_next_)
+			timer->wheel_next_->wheel_prev_ = timer->wheel_prev_;
+
+		--level_size_[timer->wheel_level_];
+		--size_;
+
+		timer->wheel_level_ = -1;
+		timer->wheel_slot_ = -1;
+		timer->wheel_prev_ = nullptr;
+		timer->wheel_next_ = nullptr;
+	}
+
+	Timer*& TimerWheel::GetSlot(int level, int slot)
+	{
+		if (level == level_count)
+			return pending_;
+		return slots_[level][slot];
+	}
+
+	void TimerWheel::TakeAll(Timer*& head, Array<TimerPtr>& expired)
+	{
+		if (!head)
+			return;
+
+		size_t first = expired.size();
+		while (head)
+		{
+			Timer* timer = head;
+			Unlink(timer);
+			expired.push_back(TimerPtr(timer));
+		}
+
+		// timers are linked at the head, restore the insertion order
+		std::reverse(expired.begin() + first, expired.end());
+	}
+
+	void TimerWheel::Cascade(int level)
+	{
+		Timer*& head = slots_[level][(current_ >> (slot_bits * level)) & slot_mask];
+		while (head)
+		{
+			Timer* timer = head;
+			Unlink(timer);
+
+			// timers due at this tick go to the lowest level and expire right away
+			Place(timer, std::max(timer->deadline_, current_));
+		}
+	}
+}
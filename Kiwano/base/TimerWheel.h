@@ -0,0 +1,114 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/helper.h"
+#include "../common/noncopyable.hpp"
+#include "SmartPtr.hpp"
+
+namespace kiwano
+{
+	class Timer;
+
+	KGE_DECLARE_SMART_PTR(Timer);
+
+	// 分层时间轮
+	// 以毫秒为刻度, 共 4 层, 每层 64 个槽. 任务按到期时间放入对应层的槽中,
+	// 高层的槽到期时下放到低层, 每次推进的开销只与经过的非空槽和到期任务数量有关.
+	// 已到期的任务 (如无间隔的任务) 放入待执行队列, 在下一次推进时取出
+	class KGE_API TimerWheel
+		: protected Noncopyable
+	{
+	public:
+		TimerWheel();
+
+		~TimerWheel();
+
+		// 添加任务, 到期时间由任务的 deadline_ 指定
+		void Insert(
+			Timer* timer
+		);
+
+		// 移除任务
+		void Remove(
+			Timer* timer
+		);
+
+		// 推进到指定时刻, 到期的任务按到期顺序追加到 expired 中
+		void Advance(
+			long long now,
+			Array<TimerPtr>& expired
+		);
+
+		// 清空时间轮
+		void Clear();
+
+		// 获取当前时刻
+		inline long long GetCurrentTime() const		{ return current_; }
+
+		// 获取任务数量
+		inline size_t GetTimerCount() const			{ return size_; }
+
+	private:
+		enum : int
+		{
+			slot_bits	= 6,
+			slot_count	= 1 << slot_bits,
+			slot_mask	= slot_count - 1,
+			level_count	= 4,
+		};
+
+		void Place(
+			Timer* timer,
+			long long deadline
+		);
+
+		void Link(
+			Timer* timer,
+			int level,
+			int slot
+		);
+
+		Timer*& GetSlot(
+			int level,
+			int slot
+		);
+
+		void TakeAll(
+			Timer*& head,
+			Array<TimerPtr>& expired
+		);
+
+		void Unlink(
+			Timer* timer
+		);
+
+		void Cascade(
+			int level
+		);
+
+	private:
+		long long	current_;
+		size_t		size_;
+		size_t		level_size_[level_count + 1];
+		Timer*		slots_[level_count][slot_count];
+		Timer*		pending_;
+	};
+}
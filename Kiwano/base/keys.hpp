@@ -19,25 +19,27 @@
 // THE SOFTWARE.
 
 #pragma once
-#include "../macros.h"
+#include "../common/defines.h"
 
 namespace kiwano
 {
-	// 갴
+	// 鼠标按键
+	// 键值与 Windows 虚拟键码一致
 	struct MouseButton
 	{
 		typedef int Value;
 
 		enum : Value
 		{
-			Left	= VK_LBUTTON,	// 
-			Right	= VK_RBUTTON,	// Ҽ
-			Middle	= VK_MBUTTON	// м
+			Left	= 0x01,	// 鼠标左键
+			Right	= 0x02,	// 鼠标右键
+			Middle	= 0x04	// 鼠标中键
 		};
 	};
 
 
-	// ֵ
+	// 按键键值
+	// 键值与 Windows 虚拟键码一致
 	struct KeyCode
 	{
 		typedef int Value;
@@ -45,19 +47,19 @@ namespace kiwano
 		enum : Value
 		{
 			Unknown = 0,
-			Up		= VK_UP,
-			Left	= VK_LEFT,
-			Right	= VK_RIGHT,
-			Down	= VK_DOWN,
-			Enter	= VK_RETURN,
-			Space	= VK_SPACE,
-			Esc		= VK_ESCAPE,
-			Ctrl	= VK_CONTROL,
-			Shift	= VK_SHIFT,
-			Alt		= VK_MENU,
-			Tab		= VK_TAB,
-			Delete	= VK_DELETE,
-			Back	= VK_BACK,
+			Up		= 0x26,
+			Left	= 0x25,
+			Right	= 0x27,
+			Down	= 0x28,
+			Enter	= 0x0D,
+			Space	= 0x20,
+			Esc		= 0x1B,
+			Ctrl	= 0x11,
+			Shift	= 0x10,
+			Alt		= 0x12,
+			Tab		= 0x09,
+			Delete	= 0x2E,
+			Back	= 0x08,
 
 			A = 0x41,
 			B,
@@ -97,7 +99,7 @@ namespace kiwano
 			Num8,
 			Num9,
 
-			Numpad0 = VK_NUMPAD0,
+			Numpad0 = 0x60,
 			Numpad1,
 			Numpad2,
 			Numpad3,
@@ -108,7 +110,7 @@ namespace kiwano
 			Numpad8,
 			Numpad9,
 
-			F1 = VK_F1,
+			F1 = 0x70,
 			F2,
 			F3,
 			F4,
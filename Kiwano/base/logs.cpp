@@ -22,6 +22,8 @@
 #include <iostream>
 #include <fstream>
 
+#ifdef _WIN32
+
 namespace
 {
 	std::streambuf* cin_buffer, * cout_buffer, * cerr_buffer;
@@ -120,10 +122,14 @@ namespace
 	}
 }
 
+#endif // _WIN32
+
 namespace kiwano
 {
 	namespace __console_colors
 	{
+#ifdef _WIN32
+
 		const WORD _blue = FOREGROUND_BLUE | FOREGROUND_INTENSITY;
 		const WORD _green = FOREGROUND_GREEN | FOREGROUND_INTENSITY;
 		const WORD _red = FOREGROUND_RED | FOREGROUND_INTENSITY;
@@ -165,6 +171,40 @@ namespace kiwano
 
 #undef DECLARE_COLOR
 #undef DECLARE_BG_COLOR
+#undef DECLARE_HANDLE_COLOR
+
+#else
+
+		// console colors are only supported on Windows
+#define DECLARE_HANDLE_COLOR(NAME)\
+	std::wostream& (NAME)(std::wostream& _out) { return _out; }
+
+#define DECLARE_COLOR(COLOR) \
+	DECLARE_HANDLE_COLOR(stdout_##COLOR)\
+	DECLARE_HANDLE_COLOR(stderr_##COLOR)
+
+#define DECLARE_BG_COLOR(COLOR) \
+	DECLARE_HANDLE_COLOR(stdout_##COLOR##_bg)\
+	DECLARE_HANDLE_COLOR(stderr_##COLOR##_bg)
+
+		DECLARE_COLOR(red);
+		DECLARE_COLOR(green);
+		DECLARE_COLOR(yellow);
+		DECLARE_COLOR(blue);
+		DECLARE_COLOR(white);
+		DECLARE_COLOR(reset);
+
+		DECLARE_BG_COLOR(red);
+		DECLARE_BG_COLOR(green);
+		DECLARE_BG_COLOR(yellow);
+		DECLARE_BG_COLOR(blue);
+		DECLARE_BG_COLOR(white);
+
+#undef DECLARE_COLOR
+#undef DECLARE_BG_COLOR
+#undef DECLARE_HANDLE_COLOR
+
+#endif // _WIN32
 	}
 
 	Logger::Logger()
@@ -179,11 +219,17 @@ namespace kiwano
 
 	Logger::~Logger()
 	{
+#ifdef _WIN32
 		FreeAllocatedConsole();
+#endif
 	}
 
 	void Logger::ResetOutputStream()
 	{
+#ifndef _WIN32
+		RedirectOutputStreamBuffer(std::wcout.rdbuf());
+		RedirectErrorStreamBuffer(std::wcerr.rdbuf());
+#else
 		bool has_console = ::GetConsoleWindow() != nullptr;
 		if (has_console)
 		{
@@ -204,6 +250,7 @@ namespace kiwano
 			RedirectOutputStreamBuffer(std::wcout.rdbuf());
 			RedirectErrorStreamBuffer(std::wcerr.rdbuf());
 		}
+#endif
 	}
 
 	std::wstreambuf* Logger::RedirectOutputStreamBuffer(std::wstreambuf* buf)
@@ -218,7 +265,7 @@ namespace kiwano
 
 	void Logger::Printf(const wchar_t* format, ...)
 	{
-		va_list args = nullptr;
+		va_list args;
 		va_start(args, format);
 
 		Outputf(output_stream_, Logger::DefaultOutputColor, nullptr, format, args);
@@ -230,7 +277,7 @@ namespace kiwano
 	{
 		using namespace __console_colors;
 
-		va_list args = nullptr;
+		va_list args;
 		va_start(args, format);
 
 		Outputf(output_stream_, stdout_blue, nullptr, format, args);
@@ -242,7 +289,7 @@ namespace kiwano
 	{
 		using namespace __console_colors;
 
-		va_list args = nullptr;
+		va_list args;
 		va_start(args, format);
 
 		Outputf(output_stream_, stdout_yellow_bg, L" Warning:", format, args);
@@ -254,7 +301,7 @@ namespace kiwano
 	{
 		using namespace __console_colors;
 
-		va_list args = nullptr;
+		va_list args;
 		va_start(args, format);
 
 		Outputf(error_stream_, stderr_red_bg, L" Error:", format, args);
@@ -269,12 +316,37 @@ namespace kiwano
 			std::wstring output = MakeOutputStringf(prompt, format, args);
 
 			os << color << output << std::flush;
-			::OutputDebugStringW(output.c_str());
+			OutputDebugger(output.c_str());
 
 			ResetConsoleColor();
 		}
 	}
 
+	void Logger::ResetConsoleColor() const
+	{
+#ifdef _WIN32
+		::SetConsoleTextAttribute(::GetStdHandle(STD_OUTPUT_HANDLE), default_stdout_color_);
+		::SetConsoleTextAttribute(::GetStdHandle(STD_ERROR_HANDLE), default_stderr_color_);
+#endif
+	}
+
+	void Logger::OutputDebugger(const wchar_t* str)
+	{
+#ifdef _WIN32
+		::OutputDebugStringW(str);
+#else
+		KGE_NOT_USED(str);
+#endif
+	}
+
+	std::wostream& Logger::DefaultOutputColor(std::wostream& out)
+	{
+#ifdef _WIN32
+		::SetConsoleTextAttribute(::GetStdHandle(STD_OUTPUT_HANDLE), Logger::Instance().default_stdout_color_);
+#endif
+		return out;
+	}
+
 	std::wstring Logger::MakeOutputStringf(const wchar_t* prompt, const wchar_t* format, va_list args) const
 	{
 		static wchar_t temp_buffer[1024 * 3 + 1];
@@ -287,8 +359,12 @@ namespace kiwano
 
 		if (format)
 		{
+#ifdef _WIN32
 			const auto len = ::_vscwprintf(format, args) + 1;
 			::_vsnwprintf_s(temp_buffer, len, len, format, args);
+#else
+			std::vswprintf(temp_buffer, sizeof(temp_buffer) / sizeof(temp_buffer[0]), format, args);
+#endif
 
 			ss << ' ' << temp_buffer;
 		}
@@ -299,13 +375,20 @@ namespace kiwano
 	{
 		std::time_t unix = std::time(nullptr);
 		std::tm tmbuf;
+#ifdef _WIN32
 		localtime_s(&tmbuf, &unix);
+#else
+		localtime_r(&unix, &tmbuf);
+#endif
 		out << std::put_time(&tmbuf, L"[kiwano] %H:%M:%S");
 		return out;
 	}
 
 	void Logger::ShowConsole(bool show)
 	{
+#ifndef _WIN32
+		KGE_NOT_USED(show);
+#else
 		HWND current_console = ::GetConsoleWindow();
 		if (show)
 		{
@@ -342,6 +425,7 @@ namespace kiwano
 				}
 			}
 		}
+#endif
 
 		ResetOutputStream();
 	}
@@ -19,26 +19,29 @@
 // THE SOFTWARE.
 
 #pragma once
-#include "../macros.h"
+#include "../common/defines.h"
 #include "../common/Singleton.hpp"
+#include <cstdarg>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
 
 #ifndef KGE_LOG
 #	ifdef KGE_DEBUG
-#		define KGE_LOG(FORMAT, ...) kiwano::Logger::Instance().Messagef((FORMAT ## "\n"), __VA_ARGS__)
-#	else
+#		define KGE_LOG(FORMAT, ...) kiwano::Logger::Instance().Messagef((FORMAT "\n"), ##__VA_ARGS__)
+#	elif defined(_MSC_VER)
 #		define KGE_LOG __noop
+#	else
+#		define KGE_LOG(FORMAT, ...) ((void)0)
 #	endif
 #endif
 
 #ifndef KGE_WARNING_LOG
-#	define KGE_WARNING_LOG(FORMAT, ...) kiwano::Logger::Instance().Warningf((FORMAT ## "\n"), __VA_ARGS__)
+#	define KGE_WARNING_LOG(FORMAT, ...) kiwano::Logger::Instance().Warningf((FORMAT "\n"), ##__VA_ARGS__)
 #endif
 
 #ifndef KGE_ERROR_LOG
-#	define KGE_ERROR_LOG(FORMAT, ...) kiwano::Logger::Instance().Errorf((FORMAT ## "\n"), __VA_ARGS__)
+#	define KGE_ERROR_LOG(FORMAT, ...) kiwano::Logger::Instance().Errorf((FORMAT "\n"), ##__VA_ARGS__)
 #endif
 
 namespace kiwano
@@ -49,13 +52,13 @@ namespace kiwano
 		KGE_DECLARE_SINGLETON(Logger);
 
 	public:
-		// ʾرտ̨
+		// 显示或关闭控制台
 		void ShowConsole(bool show);
 
-		//  Logger
+		// 启用 Logger
 		void Enable();
 
-		//  Logger
+		// 禁用 Logger
 		void Disable();
 
 		void Printf(const wchar_t* format, ...);
@@ -116,14 +119,17 @@ namespace kiwano
 
 		void ResetConsoleColor() const;
 
+		// 输出到调试器, 仅 Windows 平台有效
+		static void OutputDebugger(const wchar_t* str);
+
 		static std::wostream& DefaultOutputColor(std::wostream& out);
 
 		static std::wostream& OutPrefix(std::wostream& out);
 
 	private:
 		bool enabled_;
-		WORD default_stdout_color_;
-		WORD default_stderr_color_;
+		unsigned short default_stdout_color_;
+		unsigned short default_stderr_color_;
 
 		std::wostream output_stream_;
 		std::wostream error_stream_;
@@ -234,7 +240,7 @@ namespace kiwano
 			Output(os, color, prompt, std::forward<_Args>(args)...);
 
 			os << std::endl;
-			::OutputDebugStringW(L"\r\n");
+			OutputDebugger(L"\r\n");
 		}
 	}
 
@@ -246,7 +252,7 @@ namespace kiwano
 			std::wstring output = MakeOutputString(prompt, std::forward<_Args>(args)...);
 
 			os << color << output << std::flush;
-			::OutputDebugStringW(output.c_str());
+			OutputDebugger(output.c_str());
 
 			ResetConsoleColor();
 		}
@@ -265,24 +271,15 @@ namespace kiwano
 
 		return ss.str();
 	}
-
-	inline void Logger::ResetConsoleColor() const
-	{
-		::SetConsoleTextAttribute(::GetStdHandle(STD_OUTPUT_HANDLE), default_stdout_color_);
-		::SetConsoleTextAttribute(::GetStdHandle(STD_ERROR_HANDLE), default_stderr_color_);
-	}
-
-	inline std::wostream& Logger::DefaultOutputColor(std::wostream& out)
-	{
-		::SetConsoleTextAttribute(::GetStdHandle(STD_OUTPUT_HANDLE), Logger::Instance().default_stdout_color_);
-		return out;
-	}
 }
 
 //
 // Display stack trace on exception
 //
 
+#ifdef _WIN32
+
+#include "../macros.h"
 #include "../third-party/StackWalker/StackWalker.h"
 
 namespace kiwano
@@ -301,3 +298,5 @@ namespace kiwano
 		}
 	}
 }
+
+#endif // _WIN32
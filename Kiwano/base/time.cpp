@@ -20,6 +20,7 @@
 
 #include "time.h"
 #include "logs.h"
+#include <chrono>
 #include <regex>
 #include <unordered_map>
 
@@ -32,43 +33,47 @@ namespace kiwano
 		//-------------------------------------------------------
 
 		Time::Time()
+			: dur_(0)
 		{
 		}
 
-		Time::Time(long dur)
+		Time::Time(long long dur)
 			: dur_(dur)
 		{
 		}
 
 		const Time Time::operator+(const Duration & dur) const
 		{
-			return Time{ dur_ + dur.Milliseconds() };
+			return Time{ dur_ + dur.Nanoseconds() };
 		}
 
 		const Time Time::operator-(const Duration & dur) const
 		{
-			return Time{ dur_ - dur.Milliseconds() };
+			return Time{ dur_ - dur.Nanoseconds() };
 		}
 
 		Time & Time::operator+=(const Duration & other)
 		{
-			dur_ += other.Milliseconds();
+			dur_ += other.Nanoseconds();
 			return (*this);
 		}
 
 		Time & Time::operator-=(const Duration &other)
 		{
-			dur_ -= other.Milliseconds();
+			dur_ -= other.Nanoseconds();
 			return (*this);
 		}
 
 		const Duration Time::operator-(const Time & other) const
 		{
-			return Duration(dur_ - other.dur_);
+			Duration dur;
+			dur.SetNanoseconds(dur_ - other.dur_);
+			return dur;
 		}
 
 		Time Time::Now() noexcept
 		{
+#ifdef _WIN32
 			static LARGE_INTEGER freq = {};
 			if (freq.QuadPart == 0LL)
 			{
@@ -79,9 +84,13 @@ namespace kiwano
 			LARGE_INTEGER count;
 			QueryPerformanceCounter(&count);
 
-			const long long whole = (count.QuadPart / freq.QuadPart) * 1000LL;
-			const long long part = (count.QuadPart % freq.QuadPart) * 1000LL / freq.QuadPart;
-			return Time{ static_cast<long>(whole + part) };
+			const long long whole = (count.QuadPart / freq.QuadPart) * 1000000000LL;
+			const long long part = (count.QuadPart % freq.QuadPart) * 1000000000LL / freq.QuadPart;
+			return Time{ whole + part };
+#else
+			const auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+			return Time{ std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count() };
+#endif
 		}
 
 
@@ -89,7 +98,19 @@ namespace kiwano
 		// Duration
 		//-------------------------------------------------------
 
-		const Duration Ms	= 1L;
+		namespace
+		{
+			inline Duration MakeDuration(long long nanoseconds)
+			{
+				Duration dur;
+				dur.SetNanoseconds(nanoseconds);
+				return dur;
+			}
+		}
+
+		const Duration Ns	= MakeDuration(1LL);
+		const Duration Us	= 1000 * Ns;
+		const Duration Ms	= 1000 * Us;
 		const Duration Sec	= 1000 * Ms;
 		const Duration Min	= 60 * Sec;
 		const Duration Hour	= 60 * Min;
@@ -101,6 +122,8 @@ namespace kiwano
 			typedef std::unordered_map<String, Duration> UnitMap;
 			const auto unit_map = UnitMap
 			{
+				{L"ns", Ns},
+				{L"us", Us},
 				{L"ms", Ms},
 				{L"s", Sec},
 				{L"m", Min},
@@ -109,34 +132,34 @@ namespace kiwano
 		}
 
 		Duration::Duration()
-			: milliseconds_(0)
+			: nanoseconds_(0)
 		{
 		}
 
 		Duration::Duration(long milliseconds)
-			: milliseconds_(milliseconds)
+			: nanoseconds_(milliseconds * 1000000LL)
 		{
 		}
 
 		float Duration::Seconds() const
 		{
-			long sec = milliseconds_ / Sec.milliseconds_;
-			long ms = milliseconds_ % Sec.milliseconds_;
-			return static_cast<float>(sec) + static_cast<float>(ms) / 1000.f;
+			long long sec = nanoseconds_ / Sec.nanoseconds_;
+			long long ns = nanoseconds_ % Sec.nanoseconds_;
+			return static_cast<float>(sec) + static_cast<float>(ns / 1e9);
 		}
 
 		float Duration::Minutes() const
 		{
-			long min = milliseconds_ / Min.milliseconds_;
-			long ms = milliseconds_ % Min.milliseconds_;
-			return static_cast<float>(min) + static_cast<float>(ms) / (60 * 1000.f);
+			long long min = nanoseconds_ / Min.nanoseconds_;
+			long long ns = nanoseconds_ % Min.nanoseconds_;
+			return static_cast<float>(min) + static_cast<float>(ns / (60 * 1e9));
 		}
 
 		float Duration::Hours() const
 		{
-			long hour = milliseconds_ / Hour.milliseconds_;
-			long ms = milliseconds_ % Hour.milliseconds_;
-			return static_cast<float>(hour) + static_cast<float>(ms) / (60 * 60 * 1000.f);
+			long long hour = nanoseconds_ / Hour.nanoseconds_;
+			long long ns = nanoseconds_ % Hour.nanoseconds_;
+			return static_cast<float>(hour) + static_cast<float>(ns / (60 * 60 * 1e9));
 		}
 
 		String kiwano::time::Duration::ToString() const
@@ -147,17 +170,17 @@ namespace kiwano
 			}
 
 			String result;
-			long total_ms = milliseconds_;
-			if (total_ms < 0)
+			long long total = nanoseconds_;
+			if (total < 0)
 			{
 				result.append(L"-");
-				total_ms = -total_ms;
+				total = -total;
 			}
 
-			long hour = total_ms / Hour.milliseconds_;
-			long min = total_ms / Min.milliseconds_ - hour * 60;
-			long sec = total_ms / Sec.milliseconds_ - (hour * 60 * 60 + min * 60);
-			long ms = total_ms % Sec.milliseconds_;
+			long long hour = total / Hour.nanoseconds_;
+			long long min = total / Min.nanoseconds_ - hour * 60;
+			long long sec = total / Sec.nanoseconds_ - (hour * 60 * 60 + min * 60);
+			long long ms = (total % Sec.nanoseconds_) / Ms.nanoseconds_;
 
 			if (hour)
 			{
@@ -174,7 +197,7 @@ namespace kiwano
 				auto float_to_str = [](float val) -> std::wstring
 				{
 					wchar_t buf[10] = {};
-					::swprintf_s(buf, L"%.2f", val);
+					std::swprintf(buf, 10, L"%.2f", val);
 					return std::wstring(buf);
 				};
 
@@ -185,178 +208,186 @@ namespace kiwano
 			{
 				result.append(kiwano::to_wstring(sec)).append(L"s");
 			}
+			else if (!hour && !min)
+			{
+				// less than a millisecond
+				if (total % Us.nanoseconds_ == 0)
+					result.append(kiwano::to_wstring(total / Us.nanoseconds_)).append(L"us");
+				else
+					result.append(kiwano::to_wstring(total)).append(L"ns");
+			}
 			return result;
 		}
 
 		bool Duration::operator==(const Duration & other) const
 		{
-			return milliseconds_ == other.milliseconds_;
+			return nanoseconds_ == other.nanoseconds_;
 		}
 
 		bool Duration::operator!=(const Duration & other) const
 		{
-			return milliseconds_ != other.milliseconds_;
+			return nanoseconds_ != other.nanoseconds_;
 		}
 
 		bool Duration::operator>(const Duration & other) const
 		{
-			return milliseconds_ > other.milliseconds_;
+			return nanoseconds_ > other.nanoseconds_;
 		}
 
 		bool Duration::operator>=(const Duration & other) const
 		{
-			return milliseconds_ >= other.milliseconds_;
+			return nanoseconds_ >= other.nanoseconds_;
 		}
 
 		bool Duration::operator<(const Duration & other) const
 		{
-			return milliseconds_ < other.milliseconds_;
+			return nanoseconds_ < other.nanoseconds_;
 		}
 
 		bool Duration::operator<=(const Duration & other) const
 		{
-			return milliseconds_ <= other.milliseconds_;
+			return nanoseconds_ <= other.nanoseconds_;
 		}
 
 		float kiwano::time::Duration::operator/(const Duration & other) const
 		{
-			return static_cast<float>(milliseconds_) / other.milliseconds_;
+			return static_cast<float>(static_cast<double>(nanoseconds_) / other.nanoseconds_);
 		}
 
 		const Duration Duration::operator+(const Duration & other) const
 		{
-			return Duration(milliseconds_ + other.milliseconds_);
+			return MakeDuration(nanoseconds_ + other.nanoseconds_);
 		}
 
 		const Duration Duration::operator-(const Duration & other) const
 		{
-			return Duration(milliseconds_ - other.milliseconds_);
+			return MakeDuration(nanoseconds_ - other.nanoseconds_);
 		}
 
 		const Duration Duration::operator-() const
 		{
-			return Duration(-milliseconds_);
+			return MakeDuration(-nanoseconds_);
 		}
 
 		const Duration Duration::operator*(int val) const
 		{
-			return Duration(milliseconds_ * val);
+			return MakeDuration(nanoseconds_ * val);
 		}
 
 		const Duration kiwano::time::Duration::operator*(unsigned long long val) const
 		{
-			return Duration(static_cast<long>(milliseconds_ * val));
+			return MakeDuration(nanoseconds_ * static_cast<long long>(val));
 		}
 
 		const Duration Duration::operator*(float val) const
 		{
-			return Duration(static_cast<long>(milliseconds_ * val));
+			return MakeDuration(static_cast<long long>(static_cast<double>(nanoseconds_) * val));
 		}
 
 		const Duration Duration::operator*(double val) const
 		{
-			return Duration(static_cast<long>(milliseconds_ * val));
+			return MakeDuration(static_cast<long long>(static_cast<double>(nanoseconds_) * val));
 		}
 
 		const Duration Duration::operator*(long double val) const
 		{
-			return Duration(static_cast<long>(milliseconds_ * val));
+			return MakeDuration(static_cast<long long>(static_cast<double>(nanoseconds_) * val));
 		}
 
 		const Duration Duration::operator/(int val) const
 		{
-			return Duration(milliseconds_ / val);
+			return MakeDuration(nanoseconds_ / val);
 		}
 
 		const Duration Duration::operator/(float val) const
 		{
-			return Duration(static_cast<long>(milliseconds_ / val));
+			return MakeDuration(static_cast<long long>(static_cast<double>(nanoseconds_) / val));
 		}
 
 		const Duration Duration::operator/(double val) const
 		{
-			return Duration(static_cast<long>(milliseconds_ / val));
+			return MakeDuration(static_cast<long long>(static_cast<double>(nanoseconds_) / val));
 		}
 
 		Duration & Duration::operator+=(const Duration &other)
 		{
-			milliseconds_ += other.milliseconds_;
+			nanoseconds_ += other.nanoseconds_;
 			return (*this);
 		}
 
 		Duration & Duration::operator-=(const Duration &other)
 		{
-			milliseconds_ -= other.milliseconds_;
+			nanoseconds_ -= other.nanoseconds_;
 			return (*this);
 		}
 
 		Duration & Duration::operator*=(int val)
 		{
-			milliseconds_ *= val;
+			nanoseconds_ *= val;
 			return (*this);
 		}
 
 		Duration & Duration::operator/=(int val)
 		{
-			milliseconds_ = static_cast<long>(milliseconds_ / val);
+			nanoseconds_ /= val;
 			return (*this);
 		}
 
 		Duration & Duration::operator*=(float val)
 		{
-			milliseconds_ = static_cast<long>(milliseconds_ * val);
+			nanoseconds_ = static_cast<long long>(static_cast<double>(nanoseconds_) * val);
 			return (*this);
 		}
 
 		Duration & Duration::operator/=(float val)
 		{
-			milliseconds_ = static_cast<long>(milliseconds_ / val);
+			nanoseconds_ = static_cast<long long>(static_cast<double>(nanoseconds_) / val);
 			return (*this);
 		}
 
 		Duration & Duration::operator*=(double val)
 		{
-			milliseconds_ = static_cast<long>(milliseconds_ * val);
+			nanoseconds_ = static_cast<long long>(static_cast<double>(nanoseconds_) * val);
 			return (*this);
 		}
 
 		Duration & Duration::operator/=(double val)
 		{
-			milliseconds_ = static_cast<long>(milliseconds_ / val);
+			nanoseconds_ = static_cast<long long>(static_cast<double>(nanoseconds_) / val);
 			return (*this);
 		}
 
-		const Duration kiwano::time::operator*(int val, const Duration & dur)
+		const Duration operator*(int val, const Duration & dur)
 		{
 			return dur * val;
 		}
 
-		const Duration kiwano::time::operator/(int val, const Duration & dur)
+		const Duration operator/(int val, const Duration & dur)
 		{
 			return dur / val;
 		}
 
-		const Duration kiwano::time::operator*(float val, const Duration & dur)
+		const Duration operator*(float val, const Duration & dur)
 		{
 			return dur * val;
 		}
 
-		const Duration kiwano::time::operator/(float val, const Duration & dur)
+		const Duration operator/(float val, const Duration & dur)
 		{
 			return dur / val;
 		}
 
-		const Duration kiwano::time::operator*(double val, const Duration & dur)
+		const Duration operator*(double val, const Duration & dur)
 		{
 			return dur * val;
 		}
 
-		const Duration kiwano::time::operator/(double val, const Duration & dur)
+		const Duration operator/(double val, const Duration & dur)
 		{
 			return dur / val;
 		}
 
-		const Duration kiwano::time::operator*(long double val, const Duration & dur)
+		const Duration operator*(long double val, const Duration & dur)
 		{
 			return dur * val;
 		}
@@ -376,7 +407,7 @@ namespace kiwano
 
 			if (str.empty() || str == L"0") { return d; }
 
-			// λ
+			// 符号位
 			if (str[0] == L'-' || str[0] == L'+')
 			{
 				negative = (str[0] == L'-');
@@ -385,7 +416,7 @@ namespace kiwano
 
 			while (pos < len)
 			{
-				// ֵ
+				// 数值
 				size_t i = pos;
 				for (; i < len; ++i)
 				{
@@ -405,7 +436,7 @@ namespace kiwano
 					return Duration();
 				}
 
-				// λ
+				// 单位
 				for (; i < len; ++i)
 				{
 					wchar_t ch = str[i];
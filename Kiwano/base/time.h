@@ -19,7 +19,7 @@
 // THE SOFTWARE.
 
 #pragma once
-#include "../macros.h"
+#include "../common/defines.h"
 #include "../common/String.h"
 #include <ostream>
 #include <istream>
@@ -28,16 +28,18 @@ namespace kiwano
 {
 	namespace time
 	{
-		// ʱ
+		// 时间段
 		//
-		// ʱαʾ:
-		//     5 : time::Sec * 5
-		//     1.5 Сʱ: time::Hour * 1.5
-		//     3 Сʱ 45  15 : time::Hour * 3 + time::Min * 45 + time::Sec * 15
-		//  VS2015 ߰汾ʹ time literals:
-		//     5 : 5_s
-		//     1.5 Сʱ: 1.5_h
-		//     3 Сʱ 45  15 : 3_h + 45_m + 15_s
+		// 时间段表示法:
+		//     5 秒: time::Sec * 5
+		//     1.5 小时: time::Hour * 1.5
+		//     3 小时 45 分 15 秒: time::Hour * 3 + time::Min * 45 + time::Sec * 15
+		// 在 VS2015 及更高版本可以使用 time literals:
+		//     5 秒: 5_s
+		//     1.5 小时: 1.5_h
+		//     3 小时 45 分 15 秒: 3_h + 45_m + 15_s
+		//
+		// 内部以纳秒为单位存储
 		//
 		struct KGE_API Duration
 		{
@@ -47,30 +49,40 @@ namespace kiwano
 				long milliseconds
 			);
 
-			// תΪ
-			inline long Milliseconds() const		{ return milliseconds_; }
+			// 转化为纳秒
+			inline long long Nanoseconds() const	{ return nanoseconds_; }
+
+			// 转化为微秒
+			inline long long Microseconds() const	{ return nanoseconds_ / 1000LL; }
+
+			// 转化为毫秒
+			inline long long Milliseconds() const	{ return nanoseconds_ / 1000000LL; }
 
-			// תΪ
+			// 转化为秒
 			float Seconds() const;
 
-			// תΪ
+			// 转化为分钟
 			float Minutes() const;
 
-			// תΪСʱ
+			// 转化为小时
 			float Hours() const;
 
-			// ʱǷ
-			inline bool IsZero() const				{ return milliseconds_ == 0LL; }
+			// 时长是否是零
+			inline bool IsZero() const				{ return nanoseconds_ == 0LL; }
 
-			inline void SetMilliseconds(long ms)	{ milliseconds_ = ms; }
+			inline void SetNanoseconds(long long ns)	{ nanoseconds_ = ns; }
 
-			inline void SetSeconds(float seconds)	{ milliseconds_ = static_cast<long>(seconds * 1000.f); }
+			inline void SetMicroseconds(long long us)	{ nanoseconds_ = us * 1000LL; }
 
-			inline void SetMinutes(float minutes)	{ milliseconds_ = static_cast<long>(minutes * 60 * 1000.f); }
+			inline void SetMilliseconds(long ms)	{ nanoseconds_ = ms * 1000000LL; }
 
-			inline void SetHours(float hours)		{ milliseconds_ = static_cast<long>(hours * 60 * 60 * 1000.f); }
+			inline void SetSeconds(float seconds)	{ nanoseconds_ = static_cast<long long>(seconds * 1e9); }
 
-			// תΪַ
+			inline void SetMinutes(float minutes)	{ nanoseconds_ = static_cast<long long>(minutes * 60 * 1e9); }
+
+			inline void SetHours(float hours)		{ nanoseconds_ = static_cast<long long>(hours * 60 * 60 * 1e9); }
+
+			// 转为字符串
 			String ToString() const;
 
 			inline operator bool() const			{ return !IsZero(); }
@@ -114,11 +126,11 @@ namespace kiwano
 			friend const Duration operator/ (double, const Duration &);
 
 		public:
-			// ʱθʽ
+			// 时间段格式化
 			//
-			// ʱַзŵĸ, Ҵʱ䵥λ׺
-			// : "300ms", "-1.5h", "2h45m"
-			// ʱ䵥λ "ms", "s", "m", "h"
+			// 时间段字符串允许是有符号的浮点数, 并且带有时间单位后缀
+			// 例如: "300ms", "-1.5h", "2h45m"
+			// 允许的时间单位有 "ns", "us", "ms", "s", "m", "h"
 			static Duration Parse(const String& parse_str);
 
 			template <typename _Char>
@@ -139,30 +151,34 @@ namespace kiwano
 			}
 
 		private:
-			long milliseconds_;
+			long long nanoseconds_;
 		};
 
-		/* Ԥʱ */
-		KGE_API extern const Duration Ms;		// 
-		KGE_API extern const Duration Sec;		// 
-		KGE_API extern const Duration Min;		// 
-		KGE_API extern const Duration Hour;		// Сʱ
+		/* 预定义的时间段 */
+		KGE_API extern const Duration Ns;		// 纳秒
+		KGE_API extern const Duration Us;		// 微秒
+		KGE_API extern const Duration Ms;		// 毫秒
+		KGE_API extern const Duration Sec;		// 秒
+		KGE_API extern const Duration Min;		// 分钟
+		KGE_API extern const Duration Hour;		// 小时
 
 
-		// ʱ
+		// 时间
 		//
-		// ȡǰʱ: Time now = Time::Now();
-		// ʱ, õһ Duration , :
+		// 获取当前时间: Time now = Time::Now();
+		// 两时间相减, 得到一个 Duration 对象, 例如:
 		//     Time t1, t2;
-		//     int ms = (t2 - t1).Milliseconds();  // ȡʱĺ
+		//     long long ms = (t2 - t1).Milliseconds();  // 获取两时间相差的毫秒数
 		// 
 		struct KGE_API Time
 		{
 			Time();
 
-			Time(long);
+			explicit Time(
+				long long nanoseconds
+			);
 
-			// Ƿʱ
+			// 是否是零时
 			inline bool IsZero() const { return dur_ == 0; }
 
 			const Time operator + (const Duration &) const;
@@ -174,13 +190,13 @@ namespace kiwano
 			const Duration operator - (const Time &) const;
 
 		public:
-			// ȡǰʱ
-			// ڸʱϵͳʱ俪ʼ, ޷ʽʱ, 
-			// Ҳ޷øʱ Unix ʱ
+			// 获取当前时间
+			// 由于该时间点基于系统启动时间开始计算, 所以无法格式化该时间, 
+			// 也无法获得该时间的 Unix 时间戳
 			static Time Now() noexcept;
 
 		private:
-			long dur_;
+			long long dur_;
 		};
 	}
 }
@@ -28,28 +28,28 @@ namespace kiwano
 	class KGE_API Window
 	{
 	public:
-		// ȡ
+		// 获取标题
 		String GetTitle() const;
 
-		// ȡڴС
+		// 获取窗口大小
 		Size GetSize() const;
 
-		// ȡڿ
+		// 获取窗口宽度
 		float GetWidth() const;
 
-		// ȡڸ߶
+		// 获取窗口高度
 		float GetHeight() const;
 
-		// ñ
+		// 设置标题
 		void SetTitle(String const& title);
 
-		// ôͼ
+		// 设置窗口图标
 		void SetIcon(LPCWSTR icon_resource);
 
-		// 贰ڴС
+		// 重设窗口大小
 		void Resize(int width, int height);
 
-		// ȫģʽ
+		// 设置全屏模式
 		void SetFullscreen(bool fullscreen, int width, int height);
 
 	public:
@@ -22,9 +22,34 @@
 #include <memory>
 #include <type_traits>
 #include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
 
 namespace kiwano
 {
+	template <typename _Ty, typename _Manager>
+	class IntrusivePtr;
+
+
+	//
+	// is_trivially_relocatable<>
+	// Objects of a trivially relocatable type can be moved to another address
+	// by copying their bytes, without calling move constructor and destructor
+	//
+	template <typename _Ty>
+	struct is_trivially_relocatable
+		: public std::integral_constant<bool, std::is_trivially_copyable<_Ty>::value>
+	{
+	};
+
+	template <typename _Ty, typename _Manager>
+	struct is_trivially_relocatable<IntrusivePtr<_Ty, _Manager>>
+		: public std::true_type
+	{
+	};
+
+
 	//
 	// ArrayManager<> with memory operations
 	//
@@ -51,8 +76,8 @@ namespace kiwano
 		using const_reference			= const value_type &;
 		using reverse_iterator			= std::reverse_iterator<iterator>;
 		using const_reverse_iterator	= std::reverse_iterator<const_iterator>;
-		using allocator_type			= typename _Alloc;
-		using manager					= typename _Manager;
+		using allocator_type			= _Alloc;
+		using manager					= _Manager;
 		using initializer_list			= std::initializer_list<value_type>;
 
 	public:
@@ -64,7 +89,7 @@ namespace kiwano
 		inline Array(Array&& src) noexcept												: Array() { swap(src); }
 		inline ~Array()																	{ destroy(); }
 
-		template <typename _Iter>
+		template <typename _Iter, typename = typename std::enable_if<!std::is_integral<_Iter>::value>::type>
 		inline Array(_Iter first, _Iter last)											: Array() { assign(first, last); }
 
 		inline Array&		operator=(const Array& src)									{ if (&src != this) { resize(src.size_); manager::copy_data(begin(), src.cbegin(), size_); } return (*this); }
@@ -85,14 +110,23 @@ namespace kiwano
 		inline void			resize(size_type new_size, const _Ty& v);
 		inline void			reserve(size_type new_capacity);
 
-		inline void			push_back(const _Ty& val)									{ resize(size_ + 1, val); }
-		inline void			pop_back()													{ if (empty()) throw std::out_of_range("pop() called on empty vector"); resize(size_ - 1); }
-		inline void			push_front(const _Ty& val)									{ if (size_ == 0) push_back(val); else insert(begin(), val); }
+		inline void			push_back(const _Ty& val)									{ emplace_back(val); }
+		inline void			push_back(_Ty&& val)										{ emplace_back(std::move(val)); }
+		inline void			pop_back()													{ if (empty()) throw std::out_of_range("pop() called on empty vector"); manager::destroy(end() - 1, 1); --size_; }
+		inline void			push_front(const _Ty& val)									{ emplace(cbegin(), val); }
+		inline void			push_front(_Ty&& val)										{ emplace(cbegin(), std::move(val)); }
+
+		template <typename... _Args>
+		inline reference	emplace_back(_Args&&... args);
+
+		template <typename... _Args>
+		inline iterator		emplace(const_iterator where, _Args&&... args);
 
 		inline iterator		erase(const_iterator where)									{ return erase(where, where + 1); }
 		inline iterator		erase(const_iterator first, const_iterator last);
 
-		inline iterator		insert(const_iterator where, const _Ty& v);
+		inline iterator		insert(const_iterator where, const _Ty& v)					{ return emplace(where, v); }
+		inline iterator		insert(const_iterator where, _Ty&& v)						{ return emplace(where, std::move(v)); }
 
 		inline bool						empty() const									{ return size_ == 0; }
 		inline size_type				size() const									{ return size_; }
@@ -105,6 +139,8 @@ namespace kiwano
 		inline bool						contains(const _Ty& v) const					{ auto data = cbegin();  const auto data_end = cend(); while (data != data_end) if (*(data++) == v) return true; return false; }
 		inline size_type				index_of(const_iterator it) const				{ check_offset(it - cbegin(), "invalid array position"); return it - data_; }
 
+		inline value_type*				data()											{ return data_; }
+		inline const value_type*		data() const									{ return data_; }
 		inline iterator					begin()											{ return iterator(data_); }
 		inline const_iterator			begin() const									{ return const_iterator(data_); }
 		inline const_iterator			cbegin() const									{ return begin(); }
@@ -160,44 +196,102 @@ namespace kiwano
 		auto new_data = manager::allocate(new_capacity);
 		if (data_)
 		{
-			manager::construct(new_data, size_/* only construct needed size */);
-			manager::copy_data(new_data, data_, size_);
-			/* destroy old memory, but not resize */
-			destroy();
+			/* move elements to new memory, and free the old one without destruction */
+			manager::relocate(new_data, data_, size_);
+			manager::deallocate(data_, capacity_);
 		}
 		data_ = new_data;
 		capacity_ = new_capacity;
 	}
 
 	template<typename _Ty, typename _Alloc, typename _Manager>
+	template<typename... _Args>
+	inline typename Array<_Ty, _Alloc, _Manager>::reference
+		Array<_Ty, _Alloc, _Manager>::emplace_back(_Args&&... args)
+	{
+		if (size_ < capacity_)
+		{
+			manager::construct_at(data_ + size_, std::forward<_Args>(args)...);
+		}
+		else
+		{
+			const auto new_capacity = grow_capacity(size_ + 1);
+			auto new_data = manager::allocate(new_capacity);
+
+			/* construct the new element before relocating, args may refer to an element of this array */
+			manager::construct_at(new_data + size_, std::forward<_Args>(args)...);
+			if (data_)
+			{
+				manager::relocate(new_data, data_, size_);
+				manager::deallocate(data_, capacity_);
+			}
+			data_ = new_data;
+			capacity_ = new_capacity;
+		}
+		return data_[size_++];
+	}
+
+	template<typename _Ty, typename _Alloc, typename _Manager>
+	template<typename... _Args>
 	inline typename Array<_Ty, _Alloc, _Manager>::iterator
-		Array<_Ty, _Alloc, _Manager>::erase(const_iterator first, const_iterator last)
+		Array<_Ty, _Alloc, _Manager>::emplace(const_iterator where, _Args&&... args)
 	{
-		const auto off = first - begin();
-		const auto count = last - first;
+		const auto off = static_cast<size_type>(where - cbegin());
+		if (off > size_)
+			throw std::out_of_range("invalid vector position");
 
-		if (count != 0)
+		if (off == size_)
 		{
-			check_offset(off);
+			emplace_back(std::forward<_Args>(args)...);
+			return begin() + off;
+		}
+
+		/* args may refer to an element which is going to be moved */
+		value_type val(std::forward<_Args>(args)...);
+
+		if (size_ == capacity_)
+		{
+			reserve(grow_capacity(size_ + 1));
+		}
 
-			manager::move_data(begin() + off, begin() + off + count, size_ - off - count);
-			resize(size_ - count);  // do destruction
+		if (manager::is_relocatable)
+		{
+			manager::relocate(begin() + off + 1, begin() + off, size_ - off);
+			manager::construct_at(begin() + off, std::move(val));
 		}
+		else
+		{
+			manager::construct_at(end(), std::move(*(end() - 1)));
+			manager::move_data(begin() + off + 1, begin() + off, size_ - off - 1);
+			data_[off] = std::move(val);
+		}
+		++size_;
 		return begin() + off;
 	}
 
 	template<typename _Ty, typename _Alloc, typename _Manager>
 	inline typename Array<_Ty, _Alloc, _Manager>::iterator
-		Array<_Ty, _Alloc, _Manager>::insert(const_iterator where, const _Ty& v)
+		Array<_Ty, _Alloc, _Manager>::erase(const_iterator first, const_iterator last)
 	{
-		const auto off = where - begin();
-		const auto insert_at = begin() + off;
+		const auto off = first - begin();
+		const auto count = last - first;
 
-		check_offset(off);
-		
-		resize(size_ + 1);
-		manager::move_data(insert_at + 1, insert_at, size_ - off - 1);
-		data_[off] = v;
+		if (count != 0)
+		{
+			check_offset(off);
+
+			if (manager::is_relocatable)
+			{
+				manager::destroy(begin() + off, count);
+				manager::relocate(begin() + off, begin() + off + count, size_ - off - count);
+			}
+			else
+			{
+				manager::move_data(begin() + off, begin() + off + count, size_ - off - count);
+				manager::destroy(end() - count, count);
+			}
+			size_ -= count;
+		}
 		return begin() + off;
 	}
 
@@ -209,17 +303,22 @@ namespace kiwano
 	{
 		using value_type		= _Ty;
 		using size_type			= size_t;
-		using allocator_type	= typename _Alloc;
+		using allocator_type	= _Alloc;
+
+		static const bool is_relocatable = true;
 
 		static inline void copy_data(value_type* dest, const value_type* src, size_type count)	{ if (src == dest) return; ::memcpy(dest, src, (size_t)count * sizeof(value_type)); }
-		static inline void copy_data(value_type* dest, size_type count, const value_type& val)	{ ::memset(dest, (int)val, (size_t)count * sizeof(value_type)); }
+		static inline void copy_data(value_type* dest, size_type count, const value_type& val)	{ std::fill_n(dest, count, val); }
 		static inline void move_data(value_type* dest, const value_type* src, size_type count)	{ if (src == dest) return; ::memmove(dest, src, (size_t)count * sizeof(value_type)); }
+		static inline void relocate(value_type* dest, value_type* src, size_type count)		{ move_data(dest, src, count); }
 
 		static inline value_type* allocate(size_type count)										{ return get_allocator().allocate(count); }
 		static inline void deallocate(value_type*& ptr, size_type count)						{ if (ptr) { get_allocator().deallocate(ptr, count); ptr = nullptr; } }
 
 		static inline void construct(value_type* ptr, size_type count)							{ }
 		static inline void construct(value_type* ptr, size_type count, const value_type& val)	{ while (count) { --count; *(ptr + count) = val; } }
+		template <typename... _Args>
+		static inline void construct_at(value_type* ptr, _Args&&... args)						{ ::new (ptr) value_type(std::forward<_Args>(args)...); }
 		static inline void destroy(value_type* ptr, size_type count)							{ }
 
 	private:
@@ -238,11 +337,13 @@ namespace kiwano
 	{
 		using value_type		= _Ty;
 		using size_type			= size_t;
-		using allocator_type	= typename _Alloc;
+		using allocator_type	= _Alloc;
+
+		static const bool is_relocatable = is_trivially_relocatable<_Ty>::value;
 
 		static inline void copy_data(value_type* dest, const value_type* src, size_type count)		{ if (src == dest) return; while (count--) (*dest++) = (*src++); }
 		static inline void copy_data(value_type* dest, size_type count, const value_type& val)		{ while (count--) (*dest++) = val; }
-		static inline void move_data(value_type* dest, const value_type* src, size_type count)
+		static inline void move_data(value_type* dest, value_type* src, size_type count)
 		{
 			if (src == dest) return;
 			if (dest > src && dest < src + count)
@@ -250,15 +351,21 @@ namespace kiwano
 				src = src + count - 1;
 				dest = dest + count - 1;
 				while (count--)
-					(*dest--) = (*src--);
+					(*dest--) = std::move(*src--);
 			}
 			else
 			{
 				while (count--)
-					(*dest++) = (*src++);
+					(*dest++) = std::move(*src++);
 			}
 		}
 
+		// move objects to uninitialized memory, the source memory will be treated as uninitialized
+		static inline void relocate(value_type* dest, value_type* src, size_type count)
+		{
+			relocate(dest, src, count, std::integral_constant<bool, is_relocatable>{});
+		}
+
 		static inline value_type* allocate(size_type count)										{ return get_allocator().allocate(count); }
 		static inline void deallocate(value_type*& ptr, size_type count)						{ if (ptr) { get_allocator().deallocate(ptr, count); ptr = nullptr; } }
 
@@ -266,7 +373,25 @@ namespace kiwano
 		static inline void construct(value_type* ptr, size_type count, const value_type& val)	{ while (count) get_allocator().construct(ptr + (--count), val); }
 		static inline void destroy(value_type* ptr, size_type count)							{ while (count) get_allocator().destroy(ptr + (--count)); }
 
+		template <typename... _Args>
+		static inline void construct_at(value_type* ptr, _Args&&... args)						{ get_allocator().construct(ptr, std::forward<_Args>(args)...); }
+
 	private:
+		static inline void relocate(value_type* dest, value_type* src, size_type count, std::true_type)
+		{
+			if (src == dest || count == 0) return;
+			::memmove(static_cast<void*>(dest), static_cast<const void*>(src), (size_t)count * sizeof(value_type));
+		}
+
+		static inline void relocate(value_type* dest, value_type* src, size_type count, std::false_type)
+		{
+			for (size_type i = 0; i < count; ++i)
+			{
+				get_allocator().construct(dest + i, std::move(src[i]));
+				get_allocator().destroy(src + i);
+			}
+		}
+
 		static allocator_type& get_allocator()
 		{
 			static allocator_type allocator_;
@@ -19,15 +19,17 @@
 // THE SOFTWARE.
 
 #pragma once
-#include "../macros.h"
+#include "defines.h"
 #include <functional>
 
 // #define KGE_DEBUG_ENABLE_LIST_CHECK
 
 #ifdef KGE_DEBUG_ENABLE_LIST_CHECK
 #	define KGE_DEBUG_CHECK_LIST(list_ptr) list_ptr->Check()
-#else
+#elif defined(_MSC_VER)
 #	define KGE_DEBUG_CHECK_LIST __noop
+#else
+#	define KGE_DEBUG_CHECK_LIST(list_ptr) ((void)0)
 #endif
 
 namespace kiwano
@@ -19,7 +19,8 @@
 // THE SOFTWARE.
 
 #pragma once
-#include "../macros.h"
+#include "defines.h"
+#include <cstddef>
 #include <utility>
 #include <type_traits>
 
@@ -39,20 +40,20 @@ namespace kiwano
 
 		IntrusivePtr(Type* p) noexcept : ptr_(p)
 		{
-			typename _Manager::AddRef(ptr_);
+			_Manager::AddRef(ptr_);
 		}
 
 		IntrusivePtr(const IntrusivePtr& other) noexcept
 			: ptr_(other.ptr_)
 		{
-			typename _Manager::AddRef(ptr_);
+			_Manager::AddRef(ptr_);
 		}
 
 		template <typename _UTy>
 		IntrusivePtr(const IntrusivePtr<_UTy, _Manager>& other) noexcept
 			: ptr_(other.Get())
 		{
-			typename _Manager::AddRef(ptr_);
+			_Manager::AddRef(ptr_);
 		}
 
 		IntrusivePtr(IntrusivePtr&& other) noexcept
@@ -63,7 +64,7 @@ namespace kiwano
 
 		~IntrusivePtr() noexcept
 		{
-			typename _Manager::Release(ptr_);
+			_Manager::Release(ptr_);
 		}
 
 		inline Type* Get() const noexcept { return ptr_; }
@@ -109,7 +110,7 @@ namespace kiwano
 
 		inline IntrusivePtr& operator =(IntrusivePtr&& other) noexcept
 		{
-			typename _Manager::Release(ptr_);
+			_Manager::Release(ptr_);
 			ptr_ = other.ptr_;
 			other.ptr_ = nullptr;
 			return *this;
@@ -23,6 +23,7 @@
 #include <cstdint>
 #include <cctype>
 #include <array>
+#include <algorithm>
 #include <iosfwd>
 
 namespace kiwano
@@ -976,13 +977,8 @@ namespace kiwano
 			void dump_float(float_type val)
 			{
 				const auto digits = std::numeric_limits<float_type>::max_digits10;
-				const auto len = ::_scwprintf(L"%.*g", digits, val);
-				if (len)
-				{
-					number_buffer[0] = '\0';
-					::swprintf_s(&number_buffer[0], len + 1, L"%.*g", digits, val);
-				}
-				else
+				const auto len = std::swprintf(&number_buffer[0], number_buffer.size(), L"%.*g", digits, val);
+				if (len <= 0)
 				{
 					number_buffer[0] = '0';
 					number_buffer[1] = '.';
@@ -1050,7 +1046,7 @@ namespace kiwano
 						else
 						{
 							wchar_t escaped[7] = { 0 };
-							::swprintf_s(escaped, 7, L"\\u%04x", char_byte);
+							std::swprintf(escaped, 7, L"\\u%04x", char_byte);
 							out->write(escaped);
 						}
 						break;
@@ -1063,7 +1059,7 @@ namespace kiwano
 			output_adapter<char_type>* out;
 			char_type indent_char;
 			string_type indent_string;
-			std::array<char_type, 21> number_buffer;
+			std::array<char_type, 32> number_buffer;	// 足够容纳 17 位有效数字和指数
 		};
 	} // end of namespace __json_detail
 
@@ -1830,8 +1826,8 @@ namespace kiwano
 		using integer_type				= _IntegerTy;
 		using float_type				= _FloatTy;
 		using boolean_type				= _BooleanTy;
-		using array_type				= typename _ArrayTy<basic_json, allocator_type<basic_json>>;
-		using object_type				= typename _ObjectTy<string_type, basic_json, std::less<string_type>, allocator_type<std::pair<const string_type, basic_json>>>;
+		using array_type				= _ArrayTy<basic_json, allocator_type<basic_json>>;
+		using object_type				= _ObjectTy<string_type, basic_json, std::less<string_type>, allocator_type<std::pair<const string_type, basic_json>>>;
 		using initializer_list			= std::initializer_list<basic_json>;
 
 		using iterator					= __json_detail::iterator_impl<basic_json>;
@@ -1882,9 +1878,9 @@ namespace kiwano
 		}
 
 		template <
-			typename _IntegerTy,
-			typename std::enable_if<std::is_integral<_IntegerTy>::value, int>::type = 0>
-		basic_json(_IntegerTy value)
+			typename _IntTy,
+			typename std::enable_if<std::is_integral<_IntTy>::value, int>::type = 0>
+		basic_json(_IntTy value)
 			: value_(static_cast<integer_type>(value))
 		{
 		}
@@ -2245,13 +2241,13 @@ namespace kiwano
 		}
 
 		template <
-			typename _IntegerTy,
-			typename std::enable_if<std::is_integral<_IntegerTy>::value, int>::type = 0>
-		inline bool get_value(_IntegerTy& val) const
+			typename _IntTy,
+			typename std::enable_if<std::is_integral<_IntTy>::value, int>::type = 0>
+		inline bool get_value(_IntTy& val) const
 		{
 			if (is_integer())
 			{
-				val = static_cast<_IntegerTy>(value_.data.number_integer);
+				val = static_cast<_IntTy>(value_.data.number_integer);
 				return true;
 			}
 			return false;
@@ -2563,7 +2559,13 @@ namespace kiwano
 				switch (lhs_type)
 				{
 				case JsonType::Array:
-					return (*lhs.value_.data.vector == *rhs.value_.data.vector);
+				{
+					// Array 没有 operator==，逐个比较元素
+					const auto& lhs_vector = *lhs.value_.data.vector;
+					const auto& rhs_vector = *rhs.value_.data.vector;
+					return (lhs_vector.size() == rhs_vector.size()
+						&& std::equal(lhs_vector.cbegin(), lhs_vector.cend(), rhs_vector.cbegin()));
+				}
 
 				case JsonType::Object:
 					return (*lhs.value_.data.object == *rhs.value_.data.object);
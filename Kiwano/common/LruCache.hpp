@@ -0,0 +1,160 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../macros.h"
+#include "helper.h"
+#include "noncopyable.hpp"
+#include <memory>
+#include <utility>
+
+namespace kiwano
+{
+	// LRU 缓存
+	// 每项有一个开销值, 总开销超过容量时淘汰最久未使用的项
+	template <typename _Kty, typename _Ty, typename _Hash = std::hash<_Kty>>
+	class LruCache
+		: protected Noncopyable
+	{
+	public:
+		struct Stats
+		{
+			size_t hits;		// 命中次数
+			size_t misses;		// 未命中次数
+			size_t evictions;	// 淘汰次数
+		};
+
+	public:
+		explicit LruCache(size_t capacity)
+			: capacity_(capacity)
+			, cost_(0)
+			, stats_()
+		{
+		}
+
+		// 查找缓存并标记为最近使用, 未命中时返回空指针
+		_Ty* Get(_Kty const& key)
+		{
+			auto iter = items_.find(key);
+			if (iter == items_.end())
+			{
+				++stats_.misses;
+				return nullptr;
+			}
+
+			++stats_.hits;
+			order_.splice(order_.begin(), order_, iter->second.order);
+			return std::addressof(iter->second.value);
+		}
+
+		// 添加缓存
+		// 开销大于容量的项不会被缓存
+		void Put(_Kty const& key, _Ty value, size_t cost = 1)
+		{
+			if (cost > capacity_)
+			{
+				Remove(key);
+				return;
+			}
+
+			auto iter = items_.find(key);
+			if (iter != items_.end())
+			{
+				cost_ -= iter->second.cost;
+				iter->second.value = std::move(value);
+				iter->second.cost = cost;
+				order_.splice(order_.begin(), order_, iter->second.order);
+			}
+			else
+			{
+				order_.push_front(key);
+				items_.insert(std::make_pair(key, Item{ std::move(value), cost, order_.begin() }));
+			}
+
+			cost_ += cost;
+			Trim();
+		}
+
+		// 移除缓存
+		bool Remove(_Kty const& key)
+		{
+			auto iter = items_.find(key);
+			if (iter == items_.end())
+				return false;
+
+			cost_ -= iter->second.cost;
+			order_.erase(iter->second.order);
+			items_.erase(iter);
+			return true;
+		}
+
+		// 清空缓存
+		void Clear()
+		{
+			order_.clear();
+			items_.clear();
+			cost_ = 0;
+		}
+
+		// 设置容量, 超出的项会被立即淘汰
+		void SetCapacity(size_t capacity)
+		{
+			capacity_ = capacity;
+			Trim();
+		}
+
+		inline size_t GetCapacity() const	{ return capacity_; }
+
+		inline size_t GetCost() const		{ return cost_; }
+
+		inline size_t GetCount() const		{ return items_.size(); }
+
+		inline Stats const& GetStats() const	{ return stats_; }
+
+		inline void ResetStats()			{ stats_ = Stats{}; }
+
+	private:
+		void Trim()
+		{
+			while (cost_ > capacity_ && !order_.empty())
+			{
+				auto iter = items_.find(order_.back());
+				cost_ -= iter->second.cost;
+				items_.erase(iter);
+				order_.pop_back();
+				++stats_.evictions;
+			}
+		}
+
+	private:
+		struct Item
+		{
+			_Ty value;
+			size_t cost;
+			typename List<_Kty>::iterator order;
+		};
+
+		size_t capacity_;
+		size_t cost_;
+		Stats stats_;
+		List<_Kty> order_;
+		UnorderedMap<_Kty, Item, _Hash> items_;
+	};
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "noncopyable.hpp"
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace kiwano
+{
+	// 多生产者单消费者队列
+	// 任意线程可以无锁地压入元素, 只有一个线程可以取出元素
+	template <typename _Ty>
+	class MpscQueue
+		: protected Noncopyable
+	{
+		struct Node
+		{
+			std::atomic<Node*> next;
+			_Ty value;
+
+			Node() : next(nullptr), value() {}
+		};
+
+	public:
+		MpscQueue()
+			: head_(&stub_)
+			, tail_(&stub_)
+		{
+		}
+
+		~MpscQueue()
+		{
+			_Ty value;
+			while (Pop(value))
+				;
+		}
+
+		// 压入元素, 可在任意线程调用
+		void Push(_Ty value)
+		{
+			Node* node = new Node;
+			node->value = std::move(value);
+			PushNode(node);
+		}
+
+		// 取出元素, 只能在消费线程调用
+		// 生产者正在压入时可能暂时返回 false
+		bool Pop(_Ty& value)
+		{
+			Node* tail = tail_;
+			Node* next = tail->next.load(std::memory_order_acquire);
+
+			// skip the stub node
+			if (tail == &stub_)
+			{
+				if (!next)
+					return false;
+
+				tail_ = next;
+				tail = next;
+				next = next->next.load(std::memory_order_acquire);
+			}
+
+			if (!next)
+			{
+				// the last node can only be taken once the stub is behind it
+				if (tail != head_.load(std::memory_order_acquire))
+					return false;
+
+				PushNode(&stub_);
+				next = tail->next.load(std::memory_order_acquire);
+				if (!next)
+					return false;
+			}
+
+			tail_ = next;
+			value = std::move(tail->value);
+			delete tail;
+			return true;
+		}
+
+	private:
+		void PushNode(Node* node)
+		{
+			node->next.store(nullptr, std::memory_order_relaxed);
+			Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+			prev->next.store(node, std::memory_order_release);
+		}
+
+	private:
+		std::atomic<Node*> head_;
+		Node* tail_;
+		Node stub_;
+	};
+}
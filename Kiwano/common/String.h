@@ -22,6 +22,7 @@
 #include <string>
 #include <algorithm>
 #include <codecvt>
+#include <locale>
 #include <ostream>
 #include <istream>
 #include <cstring>
@@ -245,7 +246,7 @@ namespace kiwano
 		inline String&		operator=(const wchar_t* cstr)				{ if (const_str_ != cstr) String{ cstr }.swap(*this); return *this; }
 		inline String&		operator=(std::wstring const& str)			{ String{ str }.swap(*this); return *this; }
 		inline String&		operator=(String const& rhs)				{ if (this != &rhs) String{ rhs }.swap(*this); return *this; }
-		inline String&		operator=(String && rhs) noexcept			{ if (this != &rhs) String{ rhs }.swap(*this); return *this; }
+		inline String&		operator=(String && rhs) noexcept			{ if (this != &rhs) String{ std::move(rhs) }.swap(*this); return *this; }
 
 	public:
 		static const String::size_type npos = static_cast<size_type>(-1);
@@ -261,6 +262,10 @@ namespace kiwano
 		void deallocate(wchar_t*& ptr, size_type count);
 
 		void destroy();
+		void reset_buffer(size_type new_cap);
+
+		inline bool is_using_sso() const									{ return operable_ && str_ == sso_; }
+		inline size_type grow_capacity(size_type new_size) const			{ return std::max(std::max(new_size, capacity_ + capacity_ / 2), static_cast<size_type>(sso_capacity)); }
 
 		void discard_const_data();
 		void check_operability();
@@ -277,9 +282,7 @@ namespace kiwano
 			discard_const_data();
 			if (diff > capacity_)
 			{
-				destroy();
-				str_ = allocate(diff + 1);
-				capacity_ = diff;
+				reset_buffer(diff);
 			}
 			size_ = diff;
 
@@ -306,6 +309,10 @@ namespace kiwano
 		size_type size_;
 		size_type capacity_;
 		const bool operable_;
+
+		// 短字符串直接存放在内部缓冲区中, 避免堆内存分配
+		enum : size_type { sso_capacity = 15 };
+		value_type sso_[sso_capacity + 1];
 	};
 
 
@@ -402,13 +409,13 @@ namespace kiwano
 			const auto matches_end = first + (first_size - count) + 1;
 			for (auto iter = first + offset; ; ++iter)
 			{
-				iter = typename _Traits::find(iter, static_cast<size_t>(matches_end - iter), *second);
+				iter = _Traits::find(iter, static_cast<size_t>(matches_end - iter), *second);
 				if (!iter)
 				{
 					return static_cast<size_t>(-1);
 				}
 
-				if (typename _Traits::compare(iter, second, count) == 0)
+				if (_Traits::compare(iter, second, count) == 0)
 				{
 					return static_cast<size_t>(iter - first);
 				}
@@ -424,7 +431,7 @@ namespace kiwano
 			{
 				for (auto iter = first + std::min(pos, first_size - 1); ; --iter)
 				{
-					if (typename _Traits::find(second, count, *iter))
+					if (_Traits::find(second, count, *iter))
 					{
 						return static_cast<size_t>(iter - first);
 					}
@@ -443,15 +450,22 @@ namespace kiwano
 		public:
 			chs_codecvt() : codecvt_byname("chs") {}
 
+#ifdef _WIN32
+			using converter = chs_codecvt;
+#else
+			// 其他平台没有 chs 区域, 多字节字符串按 UTF-8 转换
+			using converter = std::codecvt_utf8<wchar_t>;
+#endif
+
 			static inline std::wstring string_to_wide(std::string const& str)
 			{
-				std::wstring_convert<chs_codecvt> conv;
+				std::wstring_convert<converter> conv;
 				return conv.from_bytes(str);
 			}
 
 			static inline std::string wide_to_string(std::wstring const& str)
 			{
-				std::wstring_convert<chs_codecvt> conv;
+				std::wstring_convert<converter> conv;
 				return conv.to_bytes(str);
 			}
 		};
@@ -543,6 +557,11 @@ namespace kiwano
 		, capacity_(rhs.capacity_)
 		, operable_(rhs.operable_)
 	{
+		if (rhs.is_using_sso())
+		{
+			char_traits::copy(sso_, rhs.sso_, size_ + 1);
+			str_ = sso_;
+		}
 		rhs.str_ = nullptr;
 		rhs.size_ = rhs.capacity_ = 0;
 	}
@@ -560,9 +579,7 @@ namespace kiwano
 		{
 			if (count > capacity_)
 			{
-				destroy();
-				str_ = allocate(count + 1);
-				capacity_ = count;
+				reset_buffer(count);
 			}
 			size_ = count;
 
@@ -585,9 +602,7 @@ namespace kiwano
 		{
 			if (count > capacity_)
 			{
-				destroy();
-				str_ = allocate(count + 1);
-				capacity_ = count;
+				reset_buffer(count);
 			}
 			size_ = count;
 
@@ -615,9 +630,7 @@ namespace kiwano
 
 		if (count > capacity_)
 		{
-			destroy();
-			str_ = allocate(count + 1);
-			capacity_ = count;
+			reset_buffer(count);
 		}
 		size_ = count;
 
@@ -645,6 +658,7 @@ namespace kiwano
 		size_type new_size = size_ - count;
 		iterator erase_at = begin().base() + offset;
 		char_traits::move(erase_at.base(), erase_at.base() + count, new_size - offset + 1);
+		size_ = new_size;
 		return (*this);
 	}
 
@@ -774,19 +788,18 @@ namespace kiwano
 	{
 		check_operability();
 
-		size_t new_size = size_ + count;
-		size_t new_cap = new_size + 1;
-		wchar_t* new_str = allocate(new_cap);
-
-		char_traits::move(new_str, str_, size_);
-		char_traits::assign(new_str + size_, count, ch);
-		char_traits::assign(new_str[new_size], value_type());
+		if (count == 0)
+			return (*this);
 
-		destroy();
+		const size_type new_size = size_ + count;
+		if (new_size > capacity_)
+		{
+			reserve(grow_capacity(new_size));
+		}
 
-		str_ = new_str;
+		char_traits::assign(str_ + size_, count, ch);
 		size_ = new_size;
-		capacity_ = new_cap;
+		char_traits::assign(str_[size_], value_type());
 		return (*this);
 	}
 
@@ -794,19 +807,30 @@ namespace kiwano
 	{
 		check_operability();
 
-		size_t new_size = size_ + count;
-		size_t new_cap = new_size + 1;
-		wchar_t* new_str = allocate(new_cap);
+		if (count == 0)
+			return (*this);
 
-		char_traits::move(new_str, str_, size_);
-		char_traits::move(new_str + size_, cstr, count);
-		char_traits::assign(new_str[new_size], value_type());
+		const size_type new_size = size_ + count;
+		if (new_size > capacity_)
+		{
+			// cstr may point to this string, keep the old buffer until copied
+			const size_type new_cap = grow_capacity(new_size);
+			wchar_t* new_str = allocate(new_cap + 1);
 
-		destroy();
+			char_traits::move(new_str, str_, size_);
+			char_traits::move(new_str + size_, cstr, count);
+
+			deallocate(str_, capacity_ + 1);
+			str_ = new_str;
+			capacity_ = new_cap;
+		}
+		else
+		{
+			char_traits::move(str_ + size_, cstr, count);
+		}
 
-		str_ = new_str;
 		size_ = new_size;
-		capacity_ = new_cap;
+		char_traits::assign(str_[size_], value_type());
 		return (*this);
 	}
 
@@ -818,21 +842,7 @@ namespace kiwano
 			return (*this);
 
 		count = other.clamp_suffix_size(pos, count);
-
-		size_t new_size = size_ + count;
-		size_t new_cap = new_size + 1;
-		wchar_t* new_str = allocate(new_cap);
-
-		char_traits::move(new_str, str_, size_);
-		char_traits::move(new_str + size_, other.begin().base() + pos, count);
-		char_traits::assign(new_str[new_size], value_type());
-
-		destroy();
-
-		str_ = new_str;
-		size_ = new_size;
-		capacity_ = new_cap;
-		return (*this);
+		return append(other.c_str() + pos, count);
 	}
 
 	inline void String::reserve(const size_type new_cap)
@@ -842,12 +852,15 @@ namespace kiwano
 
 		check_operability();
 
-		wchar_t* new_str = allocate(new_cap);
-		char_traits::move(new_str, str_, capacity_);
+		const size_type old_size = size_;
+		wchar_t* new_str = allocate(new_cap + 1);
+		char_traits::move(new_str, str_, old_size);
+		char_traits::assign(new_str[old_size], value_type());
 
 		destroy();
 
 		str_ = new_str;
+		size_ = old_size;
 		capacity_ = new_cap;
 	}
 
@@ -1052,12 +1065,16 @@ namespace kiwano
 
 	inline wchar_t * String::allocate(size_type count)
 	{
+		// use the inline buffer if it's free and large enough
+		if (count <= sso_capacity + 1 && !is_using_sso())
+			return sso_;
 		return get_allocator().allocate(count);
 	}
 
 	inline void String::deallocate(wchar_t*& ptr, size_type count)
 	{
-		get_allocator().deallocate(ptr, count);
+		if (ptr != sso_)
+			get_allocator().deallocate(ptr, count);
 		ptr = nullptr;
 	}
 
@@ -1074,14 +1091,39 @@ namespace kiwano
 		size_ = capacity_ = 0;
 	}
 
+	inline void String::reset_buffer(size_type new_cap)
+	{
+		destroy();
+
+		if (new_cap < sso_capacity)
+			new_cap = sso_capacity;
+
+		str_ = allocate(new_cap + 1);
+		capacity_ = new_cap;
+	}
+
 	inline void String::swap(String & rhs) noexcept
 	{
+		const bool lhs_sso = is_using_sso();
+		const bool rhs_sso = rhs.is_using_sso();
+
 		std::swap(const_str_, rhs.const_str_);
 		std::swap(size_, rhs.size_);
 		std::swap(capacity_, rhs.capacity_);
 
 		// swap const datas
 		std::swap(*const_cast<bool*>(&operable_), *const_cast<bool*>(&rhs.operable_));
+
+		// inline buffers can not be swapped by pointers
+		if (lhs_sso || rhs_sso)
+		{
+			std::swap_ranges(sso_, sso_ + sso_capacity + 1, rhs.sso_);
+
+			if (lhs_sso)
+				rhs.str_ = rhs.sso_;
+			if (rhs_sso)
+				str_ = sso_;
+		}
 	}
 
 	inline void String::discard_const_data()
@@ -1180,7 +1222,7 @@ namespace kiwano
 			}
 			catch (...)
 			{
-				os.setstate(std::ios_base::badbit, true);
+				os.setstate(std::ios_base::badbit);
 			}
 		}
 
@@ -1228,7 +1270,7 @@ namespace kiwano
 			}
 			catch (...)
 			{
-				is.setstate(std::ios_base::badbit, true);
+				is.setstate(std::ios_base::badbit);
 			}
 		}
 
@@ -1315,6 +1357,7 @@ namespace kiwano
 	template<typename ..._Args>
 	inline String format_wstring(const wchar_t* const fmt, _Args&&... args)
 	{
+#ifdef _MSC_VER
 		const auto len = static_cast<String::size_type>(::_scwprintf(fmt, std::forward<_Args>(args)...));
 		if (len)
 		{
@@ -1323,6 +1366,18 @@ namespace kiwano
 			return str;
 		}
 		return String{};
+#else
+		// swprintf 无法计算输出长度, 缓冲区不足时扩大后重试
+		std::wstring buffer;
+		for (size_t size = 64; size <= (1 << 20); size *= 2)
+		{
+			buffer.resize(size);
+			const int len = std::swprintf(&buffer[0], size, fmt, args...);
+			if (len >= 0 && static_cast<size_t>(len) < size)
+				return String(buffer.c_str(), static_cast<String::size_type>(len));
+		}
+		return String{};
+#endif
 	}
 
 	namespace __to_string_detail
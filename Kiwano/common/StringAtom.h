@@ -0,0 +1,179 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "String.h"
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+
+namespace kiwano
+{
+	//
+	// StringAtom
+	// Interned string, equal strings share the same entry,
+	// so that comparison is a pointer comparison and hash is computed only once
+	//
+	// Entries are never removed, so the table grows with the number of distinct
+	// strings ever interned. It is meant for names (nodes, timers, actions, listeners),
+	// not for arbitrary runtime text. Hits are served from a small per-thread cache
+	// without locking, only misses take the global mutex
+	//
+	class StringAtom
+	{
+		using table_type	= std::unordered_map<String, size_t>;
+		using entry_type	= table_type::value_type;
+
+		static const size_t cache_size = 256;
+
+	public:
+		inline StringAtom()											: entry_(nullptr) {}
+		inline explicit StringAtom(String const& str)				: entry_(intern(str)) {}
+		inline explicit StringAtom(const wchar_t* str)				: entry_(intern(String(str))) {}
+
+		inline bool				empty() const						{ return entry_ == nullptr; }
+		inline String const&	str() const							{ return entry_ ? entry_->first : empty_string(); }
+		inline const wchar_t*	c_str() const						{ return str().c_str(); }
+		inline size_t			hash() const						{ return entry_ ? entry_->second : 0; }
+
+		inline bool operator==(StringAtom const& rhs) const			{ return entry_ == rhs.entry_; }
+		inline bool operator!=(StringAtom const& rhs) const			{ return entry_ != rhs.entry_; }
+
+		// Find an interned string without interning it.
+		// Returns false if the string has never been interned,
+		// in which case no atom can be equal to it
+		static inline bool find(String const& str, StringAtom& atom)
+		{
+			if (str.empty())
+			{
+				atom.entry_ = nullptr;
+				return true;
+			}
+
+			const size_t hash = str.hash();
+			if (entry_type const* entry = find_cached(str, hash))
+			{
+				atom.entry_ = entry;
+				return true;
+			}
+
+			std::lock_guard<std::mutex> lock(get_mutex());
+
+			auto iter = get_table().find(str);
+			if (iter == get_table().end())
+				return false;
+
+			atom.entry_ = &(*iter);
+			store_cached(atom.entry_);
+			return true;
+		}
+
+		// Number of interned strings
+		static inline size_t interned_count()
+		{
+			return get_count().load(std::memory_order_relaxed);
+		}
+
+	private:
+		static inline entry_type const* intern(String const& str)
+		{
+			if (str.empty())
+				return nullptr;
+
+			const size_t hash = str.hash();
+			if (entry_type const* entry = find_cached(str, hash))
+				return entry;
+
+			std::lock_guard<std::mutex> lock(get_mutex());
+
+			auto& table = get_table();
+			auto iter = table.find(str);
+			if (iter == table.end())
+			{
+				// the key must own its data, str may be a view of a temporary buffer
+				iter = table.emplace(String(str.c_str(), str.size()), hash).first;
+				get_count().store(table.size(), std::memory_order_relaxed);
+			}
+
+			store_cached(&(*iter));
+			return &(*iter);
+		}
+
+		// Entries are never erased and unordered_map never moves its nodes,
+		// so a cached entry pointer stays valid for the lifetime of the process
+		static inline entry_type const* find_cached(String const& str, size_t hash)
+		{
+			entry_type const* entry = get_cache()[hash % cache_size];
+			if (entry && entry->second == hash && entry->first == str)
+				return entry;
+			return nullptr;
+		}
+
+		static inline void store_cached(entry_type const* entry)
+		{
+			get_cache()[entry->second % cache_size] = entry;
+		}
+
+		static inline entry_type const** get_cache()
+		{
+			thread_local entry_type const* cache[cache_size] = {};
+			return cache;
+		}
+
+		static inline std::atomic<size_t>& get_count()
+		{
+			static std::atomic<size_t> count(0);
+			return count;
+		}
+
+		static inline table_type& get_table()
+		{
+			static table_type table;
+			return table;
+		}
+
+		static inline std::mutex& get_mutex()
+		{
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		static inline String const& empty_string()
+		{
+			static String empty;
+			return empty;
+		}
+
+	private:
+		entry_type const* entry_;
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<::kiwano::StringAtom>
+	{
+		inline size_t operator()(const kiwano::StringAtom& key) const
+		{
+			return key.hash();
+		}
+	};
+}
@@ -20,6 +20,8 @@
 
 #pragma once
 #include <stdexcept>
+#include <atomic>
+#include <type_traits>
 
 namespace kiwano
 {
@@ -58,129 +60,189 @@ namespace kiwano
 
 		template<typename _Ty, typename _Ret, typename... _Args>
 		struct is_callable
-			: public std::bool_constant<__callable_detail::helper<_Ty, _Ret, _Args...>::value>
+			: public std::integral_constant<bool, __callable_detail::helper<_Ty, _Ret, _Args...>::value>
 		{
 		};
 
 		//
-		// Callable
+		// Storage
 		//
 
-		template<typename _Ret, typename... _Args>
-		class Callable
+		// 内联存储区, 可容纳约 3 个指针大小的可调用对象
+		union Storage
 		{
-		public:
-			virtual ~Callable() {}
+			void* ptr;
+			typename std::aligned_storage<sizeof(void*) * 3, std::alignment_of<double>::value>::type buf;
+		};
 
-			virtual void AddRef() = 0;
-			virtual void Release() = 0;
-			virtual _Ret Invoke(_Args... args) const = 0;
+		enum class ManageOp
+		{
+			Clone,
+			Move,
+			Destroy,
 		};
 
-		template<typename _Ret, typename... _Args>
-		class RefCountCallable
-			: public Callable<_Ret, _Args...>
+		template<typename _Ty>
+		struct is_inline_storable
+			: public std::integral_constant<bool,
+				sizeof(_Ty) <= sizeof(Storage) &&
+				std::alignment_of<Storage>::value % std::alignment_of<_Ty>::value == 0 &&
+				std::is_nothrow_move_constructible<_Ty>::value &&
+				std::is_copy_constructible<_Ty>::value
+			>
 		{
-		public:
-			RefCountCallable() : ref_count_(0) {}
+		};
+
+		template<typename _Ty>
+		struct is_trivially_storable
+			: public std::integral_constant<bool,
+				is_inline_storable<_Ty>::value &&
+				std::is_trivially_copyable<_Ty>::value &&
+				std::is_trivially_destructible<_Ty>::value
+			>
+		{
+		};
 
-			virtual void AddRef() override
+		//
+		// InlineCallable
+		// 可调用对象直接存放在 Closure 内部, 复制时逐个复制
+		//
+
+		template<typename _Ty, typename _Ret, typename... _Args>
+		struct InlineCallable
+		{
+			static inline _Ty* Get(Storage const& storage)
 			{
-				++ref_count_;
+				return const_cast<_Ty*>(reinterpret_cast<const _Ty*>(&storage.buf));
 			}
 
-			virtual void Release() override
+			static inline void Create(Storage& storage, _Ty&& val)
 			{
-				--ref_count_;
-				if (ref_count_ <= 0)
+				::new (&storage.buf) _Ty(std::move(val));
+			}
+
+			static _Ret Invoke(Storage const& storage, _Args... args)
+			{
+				return (*Get(storage))(std::forward<_Args>(args)...);
+			}
+
+			static void Manage(ManageOp op, Storage& dest, Storage& src)
+			{
+				switch (op)
 				{
-					delete this;
+				case ManageOp::Clone:
+					::new (&dest.buf) _Ty(*Get(src));
+					break;
+				case ManageOp::Move:
+					::new (&dest.buf) _Ty(std::move(*Get(src)));
+					Get(src)->~_Ty();
+					break;
+				case ManageOp::Destroy:
+					Get(dest)->~_Ty();
+					break;
 				}
 			}
-
-		private:
-			int ref_count_;
 		};
 
+		//
+		// SharedCallable
+		// 可调用对象存放在堆上, 多个 Closure 通过原子引用计数共享
+		//
+
 		template<typename _Ty, typename _Ret, typename... _Args>
-		class ProxyCallable
-			: public RefCountCallable<_Ret, _Args...>
+		struct SharedCallable
 		{
-		public:
-			ProxyCallable(_Ty&& val)
-				: callee_(std::move(val))
+			struct Holder
 			{
+				std::atomic<long> ref_count;
+				_Ty callee;
+
+				Holder(_Ty&& val) : ref_count(1), callee(std::move(val)) {}
+			};
+
+			static inline Holder* Get(Storage const& storage)
+			{
+				return static_cast<Holder*>(storage.ptr);
 			}
 
-			virtual _Ret Invoke(_Args... args) const override
+			static inline bool Create(Storage& storage, _Ty&& val)
 			{
-				return callee_(std::forward<_Args>(args)...);
+				storage.ptr = new (std::nothrow) Holder(std::move(val));
+				return storage.ptr != nullptr;
 			}
 
-			static inline Callable<_Ret, _Args...>* Make(_Ty&& val)
+			static _Ret Invoke(Storage const& storage, _Args... args)
 			{
-				return new (std::nothrow) ProxyCallable<_Ty, _Ret, _Args...>(std::move(val));
+				return Get(storage)->callee(std::forward<_Args>(args)...);
 			}
 
-		private:
-			_Ty callee_;
+			static void Manage(ManageOp op, Storage& dest, Storage& src)
+			{
+				switch (op)
+				{
+				case ManageOp::Clone:
+					Get(src)->ref_count.fetch_add(1, std::memory_order_relaxed);
+					dest.ptr = src.ptr;
+					break;
+				case ManageOp::Move:
+					dest.ptr = src.ptr;
+					src.ptr = nullptr;
+					break;
+				case ManageOp::Destroy:
+					if (Get(dest)->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					{
+						delete Get(dest);
+					}
+					break;
+				}
+			}
 		};
 
+		//
+		// ProxyMemCallable
+		//
+
 		template<typename _Ty, typename _Ret, typename... _Args>
 		class ProxyMemCallable
-			: public RefCountCallable<_Ret, _Args...>
 		{
 		public:
 			typedef _Ret(_Ty::* _FuncType)(_Args...);
 
-			virtual _Ret Invoke(_Args... args) const override
-			{
-				return (static_cast<_Ty*>(ptr_)->*func_)(std::forward<_Args>(args)...);
-			}
-
-			static inline Callable<_Ret, _Args...>* Make(void* ptr, _FuncType func)
+			ProxyMemCallable(_Ty* ptr, _FuncType func)
+				: ptr_(ptr)
+				, func_(func)
 			{
-				return new (std::nothrow) ProxyMemCallable<_Ty, _Ret, _Args...>(ptr, func);
 			}
 
-		protected:
-			ProxyMemCallable(void* ptr, _FuncType func)
-				: ptr_(ptr)
-				, func_(func)
+			inline _Ret operator()(_Args... args) const
 			{
+				return (ptr_->*func_)(std::forward<_Args>(args)...);
 			}
 
 		protected:
-			void* ptr_;
+			_Ty* ptr_;
 			_FuncType func_;
 		};
 
 		template<typename _Ty, typename _Ret, typename... _Args>
 		class ProxyConstMemCallable
-			: public RefCountCallable<_Ret, _Args...>
 		{
 		public:
 			typedef _Ret(_Ty::* _FuncType)(_Args...) const;
 
-			virtual _Ret Invoke(_Args... args) const override
-			{
-				return (static_cast<_Ty*>(ptr_)->*func_)(std::forward<_Args>(args)...);
-			}
-
-			static inline Callable<_Ret, _Args...>* Make(void* ptr, _FuncType func)
+			ProxyConstMemCallable(_Ty* ptr, _FuncType func)
+				: ptr_(ptr)
+				, func_(func)
 			{
-				return new (std::nothrow) ProxyConstMemCallable<_Ty, _Ret, _Args...>(ptr, func);
 			}
 
-		protected:
-			ProxyConstMemCallable(void* ptr, _FuncType func)
-				: ptr_(ptr)
-				, func_(func)
+			inline _Ret operator()(_Args... args) const
 			{
+				return (ptr_->*func_)(std::forward<_Args>(args)...);
 			}
 
 		protected:
-			void* ptr_;
+			_Ty* ptr_;
 			_FuncType func_;
 		};
 	}
@@ -193,7 +255,7 @@ namespace kiwano
 	public:
 		bad_function_call() {}
 
-		virtual const char* what() const override
+		virtual const char* what() const noexcept override
 		{
 			return "bad function call";
 		}
@@ -203,66 +265,83 @@ namespace kiwano
 	//
 	// Closure details
 	//
+	// 不超过 3 个指针大小的可调用对象 (函数指针, 成员函数, 捕获少量变量的 lambda)
+	// 直接存放在 Closure 内部, 构造和复制均不分配内存
+	// 较大的可调用对象存放在堆上, 复制时共享, 引用计数是线程安全的
+	//
 	template<typename _Ty>
 	class Closure;
 
 	template<typename _Ret, typename... _Args>
 	class Closure<_Ret(_Args...)>
 	{
+		using Storage = __closure_detail::Storage;
+		using ManageOp = __closure_detail::ManageOp;
+		using InvokeFunc = _Ret(*)(Storage const&, _Args...);
+		using ManageFunc = void(*)(ManageOp, Storage&, Storage&);
+
 	public:
 		Closure()
-			: callable_(nullptr)
+			: invoke_(nullptr)
+			, manage_(nullptr)
 		{
 		}
 
 		Closure(std::nullptr_t)
-			: callable_(nullptr)
+			: invoke_(nullptr)
+			, manage_(nullptr)
 		{
 		}
 
 		Closure(const Closure& rhs)
-			: callable_(rhs.callable_)
+			: invoke_(nullptr)
+			, manage_(nullptr)
 		{
-			if (callable_) callable_->AddRef();
+			copy(rhs);
 		}
 
-		Closure(Closure&& rhs)
-			: callable_(rhs.callable_)
+		Closure(Closure&& rhs) noexcept
+			: invoke_(nullptr)
+			, manage_(nullptr)
 		{
-			rhs.callable_ = nullptr;
+			move(rhs);
 		}
 
 		Closure(_Ret(*func)(_Args...))
+			: invoke_(nullptr)
+			, manage_(nullptr)
 		{
-			callable_ = __closure_detail::ProxyCallable<_Ret(*)(_Args...), _Ret, _Args...>::Make(std::move(func));
-			if (callable_) callable_->AddRef();
+			if (func) init(std::move(func));
 		}
 
 		template<
 			typename _Ty,
 			typename = typename std::enable_if<__closure_detail::is_callable<_Ty, _Ret, _Args...>::value, int>::type>
 		Closure(_Ty val)
+			: invoke_(nullptr)
+			, manage_(nullptr)
 		{
-			callable_ = __closure_detail::ProxyCallable<_Ty, _Ret, _Args...>::Make(std::move(val));
-			if (callable_) callable_->AddRef();
+			init(std::move(val));
 		}
 
 		template<typename _Ty,
 			typename _Uty,
 			typename = typename std::enable_if<std::is_same<_Ty, _Uty>::value || std::is_base_of<_Ty, _Uty>::value, int>::type>
 		Closure(_Uty* ptr, _Ret(_Ty::* func)(_Args...))
+			: invoke_(nullptr)
+			, manage_(nullptr)
 		{
-			callable_ = __closure_detail::ProxyMemCallable<_Ty, _Ret, _Args...>::Make(ptr, func);
-			if (callable_) callable_->AddRef();
+			init(__closure_detail::ProxyMemCallable<_Ty, _Ret, _Args...>(ptr, func));
 		}
 
 		template<typename _Ty,
 			typename _Uty,
 			typename = typename std::enable_if<std::is_same<_Ty, _Uty>::value || std::is_base_of<_Ty, _Uty>::value, int>::type>
 		Closure(_Uty* ptr, _Ret(_Ty::* func)(_Args...) const)
+			: invoke_(nullptr)
+			, manage_(nullptr)
 		{
-			callable_ = __closure_detail::ProxyConstMemCallable<_Ty, _Ret, _Args...>::Make(ptr, func);
-			if (callable_) callable_->AddRef();
+			init(__closure_detail::ProxyConstMemCallable<_Ty, _Ret, _Args...>(ptr, func));
 		}
 
 		~Closure()
@@ -270,51 +349,174 @@ namespace kiwano
 			tidy();
 		}
 
-		inline void swap(const Closure& rhs)
+		inline void swap(Closure& rhs)
 		{
-			std::swap(callable_, rhs.callable_);
+			Closure tmp(std::move(rhs));
+			rhs = std::move(*this);
+			*this = std::move(tmp);
 		}
 
 		inline _Ret operator()(_Args... args) const
 		{
-			if (!callable_)
+			if (!invoke_)
 				throw bad_function_call();
-			return callable_->Invoke(std::forward<_Args>(args)...);
+			return invoke_(storage_, std::forward<_Args>(args)...);
 		}
 
 		inline operator bool() const
 		{
-			return !!callable_;
+			return !!invoke_;
 		}
 
 		inline Closure& operator=(const Closure& rhs)
 		{
-			tidy();
-			callable_ = rhs.callable_;
-			if (callable_) callable_->AddRef();
+			if (this != &rhs)
+			{
+				tidy();
+				copy(rhs);
+			}
 			return (*this);
 		}
 
-		inline Closure& operator=(Closure&& rhs)
+		inline Closure& operator=(Closure&& rhs) noexcept
 		{
-			tidy();
-			callable_ = rhs.callable_;
-			rhs.callable_ = nullptr;
+			if (this != &rhs)
+			{
+				tidy();
+				move(rhs);
+			}
 			return (*this);
 		}
 
 	private:
+		template<typename _Ty>
+		inline void init(_Ty&& val)
+		{
+			init(std::move(val), __closure_detail::is_inline_storable<_Ty>{});
+		}
+
+		template<typename _Ty>
+		inline void init(_Ty&& val, std::true_type)
+		{
+			using _Callable = __closure_detail::InlineCallable<_Ty, _Ret, _Args...>;
+
+			_Callable::Create(storage_, std::move(val));
+			invoke_ = &_Callable::Invoke;
+			manage_ = __closure_detail::is_trivially_storable<_Ty>::value ? nullptr : &_Callable::Manage;
+		}
+
+		template<typename _Ty>
+		inline void init(_Ty&& val, std::false_type)
+		{
+			using _Callable = __closure_detail::SharedCallable<_Ty, _Ret, _Args...>;
+
+			if (_Callable::Create(storage_, std::move(val)))
+			{
+				invoke_ = &_Callable::Invoke;
+				manage_ = &_Callable::Manage;
+			}
+		}
+
+		inline void copy(const Closure& rhs)
+		{
+			if (rhs.manage_)
+				rhs.manage_(ManageOp::Clone, storage_, const_cast<Storage&>(rhs.storage_));
+			else
+				storage_ = rhs.storage_;
+
+			invoke_ = rhs.invoke_;
+			manage_ = rhs.manage_;
+		}
+
+		inline void move(Closure& rhs)
+		{
+			if (rhs.manage_)
+				rhs.manage_(ManageOp::Move, storage_, rhs.storage_);
+			else
+				storage_ = rhs.storage_;
+
+			invoke_ = rhs.invoke_;
+			manage_ = rhs.manage_;
+			rhs.invoke_ = nullptr;
+			rhs.manage_ = nullptr;
+		}
+
 		inline void tidy()
 		{
-			if (callable_)
+			if (manage_)
 			{
-				callable_->Release();
-				callable_ = nullptr;
+				manage_(ManageOp::Destroy, storage_, storage_);
 			}
+			invoke_ = nullptr;
+			manage_ = nullptr;
+		}
+
+	private:
+		Storage		storage_;
+		InvokeFunc	invoke_;
+		ManageFunc	manage_;
+	};
+
+
+	//
+	// FunctionRef details
+	//
+	// 不持有可调用对象的轻量引用, 仅适用于同步调用的回调参数
+	// 被引用的对象必须在 FunctionRef 使用期间保持有效
+	//
+	template<typename _Ty>
+	class FunctionRef;
+
+	template<typename _Ret, typename... _Args>
+	class FunctionRef<_Ret(_Args...)>
+	{
+		union Callee
+		{
+			void* obj;
+			_Ret(*func)(_Args...);
+		};
+
+		using InvokeFunc = _Ret(*)(Callee, _Args...);
+
+	public:
+		FunctionRef(_Ret(*func)(_Args...))
+			: invoke_(&InvokeFunction)
+		{
+			callee_.func = func;
+		}
+
+		template<
+			typename _Ty,
+			typename = typename std::enable_if<
+				!std::is_same<typename std::decay<_Ty>::type, FunctionRef>::value &&
+				__closure_detail::is_callable<typename std::decay<_Ty>::type, _Ret, _Args...>::value, int
+			>::type>
+		FunctionRef(_Ty&& callee)
+			: invoke_(&InvokeObject<typename std::remove_reference<_Ty>::type>)
+		{
+			callee_.obj = const_cast<void*>(static_cast<const void*>(std::addressof(callee)));
+		}
+
+		inline _Ret operator()(_Args... args) const
+		{
+			return invoke_(callee_, std::forward<_Args>(args)...);
+		}
+
+	private:
+		static _Ret InvokeFunction(Callee callee, _Args... args)
+		{
+			return callee.func(std::forward<_Args>(args)...);
+		}
+
+		template<typename _Ty>
+		static _Ret InvokeObject(Callee callee, _Args... args)
+		{
+			return (*static_cast<_Ty*>(callee.obj))(std::forward<_Args>(args)...);
 		}
 
 	private:
-		__closure_detail::Callable<_Ret, _Args...>* callable_;
+		Callee		callee_;
+		InvokeFunc	invoke_;
 	};
 
 	template<typename _Ty,
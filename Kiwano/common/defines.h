@@ -0,0 +1,61 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// 与平台无关的宏定义
+// 不包含平台头文件, 可以在其他平台的工具和测试中使用
+
+#include <cassert>
+
+#if defined(DEBUG) || defined(_DEBUG)
+#	define KGE_DEBUG
+#endif
+
+
+#ifndef KGE_ASSERT
+#	ifdef KGE_DEBUG
+#		define KGE_ASSERT(EXPR) assert(EXPR)
+#	elif defined(_MSC_VER)
+#		define KGE_ASSERT __noop
+#	else
+#		define KGE_ASSERT(EXPR) ((void)0)
+#	endif
+#endif
+
+#ifndef KGE_API
+/* Building or calling Kiwano as a static library */
+#	define KGE_API
+#elif defined(_MSC_VER)
+/*
+ * C4251 can be ignored if you are deriving from a type in the 
+ * C++ Standard Library, compiling a debug release (/MTd) and 
+ * where the compiler error message refers to _Container_base.
+ */
+#	pragma warning (disable: 4251)
+#endif
+
+#define KGE_NOT_USED(VAR) ((void)VAR)
+
+#ifdef _MSC_VER
+#	define KGE_DEPRECATED(...) __declspec(deprecated(__VA_ARGS__))
+#else
+#	define KGE_DEPRECATED(...) [[deprecated(__VA_ARGS__)]]
+#endif
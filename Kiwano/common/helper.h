@@ -21,6 +21,7 @@
 #pragma once
 #include "Array.h"
 #include "String.h"
+#include "StringAtom.h"
 #include <set>
 #include <map>
 #include <list>
@@ -19,3 +19,6 @@
 
 //---- Define DirectX version. Defaults to using Direct3D11
 //#define KGE_USE_DIRECTX10
+
+//---- Draw batched sprites with ID2D1SpriteBatch. Requires the Windows 10 SDK, falls back to DrawBitmap at runtime
+//#define KGE_USE_D2D_SPRITE_BATCH
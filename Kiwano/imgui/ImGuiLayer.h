@@ -36,18 +36,18 @@ namespace kiwano
 	public:
 		virtual ~ImGuiLayer();
 
-		//  ImGui Ԫ
+		// 添加 ImGui 元素
 		void AddItem(
 			ImGuiPipeline const& item,
 			String const& name
 		);
 
-		// Ƴ ImGui Ԫ
+		// 移除 ImGui 元素
 		void RemoveItem(
 			String const& name
 		);
 
-		// ƳԪ
+		// 移除所有元素
 		void RemoveAllItems();
 
 	public:
@@ -33,9 +33,9 @@ namespace kiwano
 		friend class ImGuiLayer;
 
 	public:
-		//  ImGui ͼ
+		// 创建 ImGui 图层
 		ImGuiLayerPtr CreateLayer(
-			Scene* scene		/* ָ */
+			Scene* scene		/* 指定场景 */
 		);
 
 	private:
@@ -21,6 +21,10 @@
 #pragma once
 #include "kiwano.h"
 
+#include "audio/VoicePool.h"
+#include "audio/AudioDecoder.h"
+#include "audio/WaveDecoder.h"
+#include "audio/AudioStream.h"
 #include "audio/audio.h"
 #include "audio/Sound.h"
 #include "audio/Player.h"
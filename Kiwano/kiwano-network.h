@@ -24,6 +24,7 @@
 #include "network/helper.h"
 #include "network/HttpRequest.h"
 #include "network/HttpResponse.h"
+#include "network/HttpCache.h"
 #include "network/HttpClient.h"
 
 // CURL
@@ -34,9 +34,12 @@
 
 #include "common/Array.h"
 #include "common/String.h"
+#include "common/StringAtom.h"
 #include "common/helper.h"
 #include "common/closure.hpp"
 #include "common/IntrusiveList.hpp"
+#include "common/MpscQueue.hpp"
+#include "common/LruCache.hpp"
 #include "common/IntrusivePtr.hpp"
 #include "common/ComPtr.hpp"
 #include "common/noncopyable.hpp"
@@ -54,6 +57,8 @@
 #include "math/Vec2.hpp"
 #include "math/rand.h"
 #include "math/Matrix.hpp"
+#include "math/MatrixBatch.h"
+#include "math/EaseTable.h"
 
 
 //
@@ -74,6 +79,10 @@
 #include "base/EventDispatcher.h"
 #include "base/Timer.h"
 #include "base/TimerManager.h"
+#include "base/TimerWheel.h"
+#include "base/PerformQueue.h"
+#include "base/FrameStepper.h"
+#include "base/ThreadPool.h"
 #include "base/AsyncTask.h"
 #include "base/Resource.h"
 
@@ -85,6 +94,7 @@
 #include "2d/Image.h"
 #include "2d/GifImage.h"
 #include "2d/Frames.h"
+#include "2d/TextureAtlas.h"
 #include "2d/Geometry.h"
 #include "2d/Action.h"
 #include "2d/ActionGroup.h"
@@ -94,11 +104,14 @@
 #include "2d/ActionManager.h"
 #include "2d/Transition.h"
 
+#include "2d/NodeStorage.h"
+#include "2d/SpatialIndex.h"
 #include "2d/Node.h"
 #include "2d/Scene.h"
 #include "2d/Layer.h"
 #include "2d/Sprite.h"
 #include "2d/Text.h"
+#include "2d/SdfFont.h"
 #include "2d/Canvas.h"
 #include "2d/GeometryNode.h"
 #include "2d/DebugNode.h"
@@ -112,6 +125,8 @@
 #include "utils/DataUtil.h"
 #include "utils/File.h"
 #include "utils/ResLoader.h"
+#include "utils/RectPacker.h"
+#include "utils/SdfGlyphAtlas.h"
 
 
 //
@@ -79,32 +79,5 @@
 // Compile-time Config Header File
 #include "config.h"
 
-
-#if defined(DEBUG) || defined(_DEBUG)
-#	define KGE_DEBUG
-#endif
-
-
-#ifndef KGE_ASSERT
-#	ifdef KGE_DEBUG
-#		define KGE_ASSERT(EXPR) assert(EXPR)
-#	else
-#		define KGE_ASSERT __noop
-#	endif
-#endif
-
-#ifndef KGE_API
-/* Building or calling Kiwano as a static library */
-#	define KGE_API
-#else
-/*
- * C4251 can be ignored if you are deriving from a type in the 
- * C++ Standard Library, compiling a debug release (/MTd) and 
- * where the compiler error message refers to _Container_base.
- */
-#	pragma warning (disable: 4251)
-#endif
-
-#define KGE_NOT_USED(VAR) ((void)VAR)
-
-#define KGE_DEPRECATED(...) __declspec(deprecated(__VA_ARGS__))
+// Platform-independent Macros
+#include "common/defines.h"
@@ -0,0 +1,70 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "EaseTable.h"
+#include <cmath>
+
+namespace kiwano
+{
+	namespace math
+	{
+		namespace
+		{
+			// samples taken between two table points when measuring the error
+			const size_t error_samples = 16;
+		}
+
+		EaseTable::EaseTable()
+			: last_(0)
+			, scale_(0.f)
+			, first_(0.f)
+			, last_value_(1.f)
+			, max_error_(0.f)
+		{
+		}
+
+		EaseTable::EaseTable(FunctionRef<float(float)> func, size_t resolution)
+			: EaseTable()
+		{
+			if (resolution < 2)
+				resolution = 2;
+
+			last_ = resolution - 1;
+			scale_ = static_cast<float>(last_);
+
+			values_.resize(resolution);
+			for (size_t i = 0; i < resolution; ++i)
+			{
+				values_[i] = func(static_cast<float>(i) / scale_);
+			}
+
+			first_ = values_[0];
+			last_value_ = values_[last_];
+
+			for (size_t i = 0; i < last_ * error_samples; ++i)
+			{
+				const float step = static_cast<float>(i) / static_cast<float>(last_ * error_samples);
+				const float error = std::fabs((*this)(step) - func(step));
+				if (error > max_error_)
+					max_error_ = error;
+			}
+		}
+	}
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/defines.h"
+#include "../common/Array.h"
+#include "../common/closure.hpp"
+
+namespace kiwano
+{
+	namespace math
+	{
+		// 缓动函数查找表
+		// 预先对缓动函数均匀采样, 计算时在相邻采样点间线性插值
+		class KGE_API EaseTable
+		{
+		public:
+			EaseTable();
+
+			EaseTable(
+				FunctionRef<float(float)> func,	/* 缓动函数 */
+				size_t resolution = 256			/* 采样点数量 */
+			);
+
+			// 计算缓动值
+			inline float operator()(float step) const
+			{
+				if (!(step > 0.f))
+					return first_;
+
+				const float pos = step * scale_;
+				const size_t index = static_cast<size_t>(pos);
+				if (index >= last_)
+					return last_value_;
+
+				const float* values = values_.data();
+				return values[index] + (values[index + 1] - values[index]) * (pos - static_cast<float>(index));
+			}
+
+			// 获取采样点数量
+			inline size_t GetResolution() const { return values_.size(); }
+
+			// 获取与原函数相比的最大误差
+			inline float GetMaxError() const { return max_error_; }
+
+		private:
+			Array<float>	values_;
+			size_t			last_;
+			float			scale_;
+			float			first_;
+			float			last_value_;
+			float			max_error_;
+		};
+	}
+}
@@ -69,12 +69,7 @@ namespace kiwano
 					m[i] = p[i];
 			}
 
-			MatrixT(MatrixT const& other)
-				: _11(other._11), _12(other._12)
-				, _21(other._21), _22(other._22)
-				, _31(other._31), _32(other._32)
-			{
-			}
+			MatrixT(MatrixT const& other) = default;
 
 			template <typename T>
 			MatrixT(T const& other)
@@ -0,0 +1,464 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "MatrixBatch.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#	define KGE_SIMD_X86
+#	include <intrin.h>
+#	define KGE_TARGET_SSE2
+#	define KGE_TARGET_AVX
+#elif defined(__i386__) || defined(__x86_64__)
+#	define KGE_SIMD_X86
+#	include <immintrin.h>
+#	include <cpuid.h>
+	// GCC and Clang only emit instructions the function is compiled for
+#	define KGE_TARGET_SSE2 __attribute__((target("sse2")))
+#	define KGE_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+namespace kiwano
+{
+	namespace math
+	{
+		namespace
+		{
+			//
+			// Scalar kernels
+			//
+
+			void MultiplyMatricesScalar(Matrix* out, Matrix const* lhs, Matrix const* rhs, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					const float* l = lhs[i].m;
+					const float* r = rhs[i].m;
+
+					// use temporaries so that out is allowed to alias lhs or rhs
+					const float m11 = l[0] * r[0] + l[1] * r[2];
+					const float m12 = l[0] * r[1] + l[1] * r[3];
+					const float m21 = l[2] * r[0] + l[3] * r[2];
+					const float m22 = l[2] * r[1] + l[3] * r[3];
+					const float m31 = l[4] * r[0] + l[5] * r[2] + r[4];
+					const float m32 = l[4] * r[1] + l[5] * r[3] + r[5];
+
+					float* o = out[i].m;
+					o[0] = m11; o[1] = m12;
+					o[2] = m21; o[3] = m22;
+					o[4] = m31; o[5] = m32;
+				}
+			}
+
+			void InvertMatricesScalar(Matrix* out, Matrix const* matrices, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					out[i] = Matrix::Invert(matrices[i]);
+				}
+			}
+
+			void TransformPointsScalar(Vec2* out, Matrix const& matrix, Vec2 const* points, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					out[i] = matrix.Transform(points[i]);
+				}
+			}
+
+			void TransformPointsByMatricesScalar(Vec2* out, Matrix const* matrices, Vec2 const* points, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					out[i] = matrices[i].Transform(points[i]);
+				}
+			}
+
+#ifdef KGE_SIMD_X86
+
+			//
+			// SSE2 kernels, one matrix (or two points) per iteration
+			//
+
+			KGE_TARGET_SSE2 inline __m128 LoadFloat2(const float* p)
+			{
+				return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p)));
+			}
+
+			KGE_TARGET_SSE2 inline void StoreFloat2(float* p, __m128 v)
+			{
+				_mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(v));
+			}
+
+			KGE_TARGET_SSE2 void MultiplyMatricesSSE2(Matrix* out, Matrix const* lhs, Matrix const* rhs, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					const __m128 l = _mm_loadu_ps(lhs[i].m);		// l11 l12 l21 l22
+					const __m128 r = _mm_loadu_ps(rhs[i].m);		// r11 r12 r21 r22
+					const __m128 lt = LoadFloat2(lhs[i].m + 4);		// l31 l32
+					const __m128 rt = LoadFloat2(rhs[i].m + 4);		// r31 r32
+
+					const __m128 r0 = _mm_movelh_ps(r, r);			// r11 r12 r11 r12
+					const __m128 r1 = _mm_movehl_ps(r, r);			// r21 r22 r21 r22
+
+					const __m128 lx = _mm_shuffle_ps(l, l, _MM_SHUFFLE(2, 2, 0, 0));
+					const __m128 ly = _mm_shuffle_ps(l, l, _MM_SHUFFLE(3, 3, 1, 1));
+					const __m128 m = _mm_add_ps(_mm_mul_ps(lx, r0), _mm_mul_ps(ly, r1));
+
+					const __m128 tx = _mm_shuffle_ps(lt, lt, _MM_SHUFFLE(0, 0, 0, 0));
+					const __m128 ty = _mm_shuffle_ps(lt, lt, _MM_SHUFFLE(1, 1, 1, 1));
+					const __m128 t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, r0), _mm_mul_ps(ty, r1)), rt);
+
+					_mm_storeu_ps(out[i].m, m);
+					StoreFloat2(out[i].m + 4, t);
+				}
+			}
+
+			KGE_TARGET_SSE2 void InvertMatricesSSE2(Matrix* out, Matrix const* matrices, size_t count)
+			{
+				const __m128 sign = _mm_setr_ps(1.f, -1.f, -1.f, 1.f);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					const float* p = matrices[i].m;
+					const __m128 v = _mm_loadu_ps(p);				// m11 m12 m21 m22
+					const __m128 t = LoadFloat2(p + 4);				// m31 m32
+
+					const float det = 1.f / (p[0] * p[3] - p[1] * p[2]);
+					const __m128 d = _mm_mul_ps(sign, _mm_set1_ps(det));
+
+					// m22 -m12 -m21 m11
+					const __m128 m = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 2, 1, 3)), d);
+
+					// m31' = -(m31 * m11' + m32 * m21'), m32' = -(m31 * m12' + m32 * m22')
+					const __m128 m0 = _mm_movelh_ps(m, m);
+					const __m128 m1 = _mm_movehl_ps(m, m);
+					const __m128 tx = _mm_shuffle_ps(t, t, _MM_SHUFFLE(0, 0, 0, 0));
+					const __m128 ty = _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1));
+					const __m128 tr = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(_mm_mul_ps(tx, m0), _mm_mul_ps(ty, m1)));
+
+					_mm_storeu_ps(out[i].m, m);
+					StoreFloat2(out[i].m + 4, tr);
+				}
+			}
+
+			KGE_TARGET_SSE2 void TransformPointsSSE2(Vec2* out, Matrix const& matrix, Vec2 const* points, size_t count)
+			{
+				const __m128 m0 = _mm_setr_ps(matrix._11, matrix._12, matrix._11, matrix._12);
+				const __m128 m1 = _mm_setr_ps(matrix._21, matrix._22, matrix._21, matrix._22);
+				const __m128 m2 = _mm_setr_ps(matrix._31, matrix._32, matrix._31, matrix._32);
+
+				const float* src = &points[0].x;
+				float* dest = &out[0].x;
+
+				size_t i = 0;
+				for (; i + 2 <= count; i += 2)
+				{
+					const __m128 p = _mm_loadu_ps(src + i * 2);		// x0 y0 x1 y1
+					const __m128 px = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+					const __m128 py = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+					_mm_storeu_ps(dest + i * 2, _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m0), _mm_mul_ps(py, m1)), m2));
+				}
+				TransformPointsScalar(out + i, matrix, points + i, count - i);
+			}
+
+			KGE_TARGET_SSE2 void TransformPointsByMatricesSSE2(Vec2* out, Matrix const* matrices, Vec2 const* points, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					const __m128 m = _mm_loadu_ps(matrices[i].m);
+					const __m128 t = LoadFloat2(matrices[i].m + 4);
+					const __m128 p = LoadFloat2(&points[i].x);
+
+					const __m128 px = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+					const __m128 py = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+					const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m), _mm_mul_ps(py, _mm_movehl_ps(m, m))), t);
+					StoreFloat2(&out[i].x, r);
+				}
+			}
+
+			//
+			// AVX kernels, two matrices per iteration (one in each 128-bit lane)
+			//
+
+			KGE_TARGET_AVX inline __m256 LoadLinearParts(Matrix const* matrices)
+			{
+				return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(matrices[0].m)), _mm_loadu_ps(matrices[1].m), 1);
+			}
+
+			KGE_TARGET_AVX inline __m256 LoadTranslations(Matrix const* matrices)
+			{
+				return _mm256_insertf128_ps(_mm256_castps128_ps256(LoadFloat2(matrices[0].m + 4)), LoadFloat2(matrices[1].m + 4), 1);
+			}
+
+			KGE_TARGET_AVX inline void StoreMatrices(Matrix* matrices, __m256 linear, __m256 translation)
+			{
+				_mm_storeu_ps(matrices[0].m, _mm256_castps256_ps128(linear));
+				_mm_storeu_ps(matrices[1].m, _mm256_extractf128_ps(linear, 1));
+				StoreFloat2(matrices[0].m + 4, _mm256_castps256_ps128(translation));
+				StoreFloat2(matrices[1].m + 4, _mm256_extractf128_ps(translation, 1));
+			}
+
+			KGE_TARGET_AVX void MultiplyMatricesAVX(Matrix* out, Matrix const* lhs, Matrix const* rhs, size_t count)
+			{
+				size_t i = 0;
+				for (; i + 2 <= count; i += 2)
+				{
+					const __m256 l = LoadLinearParts(lhs + i);
+					const __m256 r = LoadLinearParts(rhs + i);
+					const __m256 lt = LoadTranslations(lhs + i);
+					const __m256 rt = LoadTranslations(rhs + i);
+
+					const __m256 r0 = _mm256_shuffle_ps(r, r, _MM_SHUFFLE(1, 0, 1, 0));
+					const __m256 r1 = _mm256_shuffle_ps(r, r, _MM_SHUFFLE(3, 2, 3, 2));
+
+					const __m256 lx = _mm256_moveldup_ps(l);
+					const __m256 ly = _mm256_movehdup_ps(l);
+					const __m256 m = _mm256_add_ps(_mm256_mul_ps(lx, r0), _mm256_mul_ps(ly, r1));
+
+					const __m256 tx = _mm256_moveldup_ps(lt);
+					const __m256 ty = _mm256_movehdup_ps(lt);
+					const __m256 t = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tx, r0), _mm256_mul_ps(ty, r1)), rt);
+
+					StoreMatrices(out + i, m, t);
+				}
+				MultiplyMatricesSSE2(out + i, lhs + i, rhs + i, count - i);
+			}
+
+			KGE_TARGET_AVX void InvertMatricesAVX(Matrix* out, Matrix const* matrices, size_t count)
+			{
+				const __m256 sign = _mm256_setr_ps(1.f, -1.f, -1.f, 1.f, 1.f, -1.f, -1.f, 1.f);
+				const __m256 one = _mm256_set1_ps(1.f);
+
+				size_t i = 0;
+				for (; i + 2 <= count; i += 2)
+				{
+					const __m256 v = LoadLinearParts(matrices + i);
+					const __m256 t = LoadTranslations(matrices + i);
+
+					// determinant of each lane, m11 * m22 - m12 * m21
+					const __m256 cross = _mm256_mul_ps(v, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)));
+					const __m256 det = _mm256_sub_ps(
+						_mm256_shuffle_ps(cross, cross, _MM_SHUFFLE(0, 0, 0, 0)),
+						_mm256_shuffle_ps(cross, cross, _MM_SHUFFLE(1, 1, 1, 1))
+					);
+					const __m256 d = _mm256_mul_ps(sign, _mm256_div_ps(one, det));
+
+					// m22 -m12 -m21 m11
+					const __m256 m = _mm256_mul_ps(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 2, 1, 3)), d);
+
+					const __m256 m0 = _mm256_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 1, 0));
+					const __m256 m1 = _mm256_shuffle_ps(m, m, _MM_SHUFFLE(3, 2, 3, 2));
+					const __m256 tx = _mm256_moveldup_ps(t);
+					const __m256 ty = _mm256_movehdup_ps(t);
+					const __m256 tr = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_add_ps(_mm256_mul_ps(tx, m0), _mm256_mul_ps(ty, m1)));
+
+					StoreMatrices(out + i, m, tr);
+				}
+				InvertMatricesSSE2(out + i, matrices + i, count - i);
+			}
+
+			KGE_TARGET_AVX void TransformPointsAVX(Vec2* out, Matrix const& matrix, Vec2 const* points, size_t count)
+			{
+				const __m256 m0 = _mm256_setr_ps(matrix._11, matrix._12, matrix._11, matrix._12, matrix._11, matrix._12, matrix._11, matrix._12);
+				const __m256 m1 = _mm256_setr_ps(matrix._21, matrix._22, matrix._21, matrix._22, matrix._21, matrix._22, matrix._21, matrix._22);
+				const __m256 m2 = _mm256_setr_ps(matrix._31, matrix._32, matrix._31, matrix._32, matrix._31, matrix._32, matrix._31, matrix._32);
+
+				const float* src = &points[0].x;
+				float* dest = &out[0].x;
+
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4)
+				{
+					const __m256 p = _mm256_loadu_ps(src + i * 2);	// x0 y0 x1 y1 x2 y2 x3 y3
+					const __m256 px = _mm256_moveldup_ps(p);
+					const __m256 py = _mm256_movehdup_ps(p);
+					_mm256_storeu_ps(dest + i * 2, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m0), _mm256_mul_ps(py, m1)), m2));
+				}
+				TransformPointsSSE2(out + i, matrix, points + i, count - i);
+			}
+
+			KGE_TARGET_AVX void TransformPointsByMatricesAVX(Vec2* out, Matrix const* matrices, Vec2 const* points, size_t count)
+			{
+				size_t i = 0;
+				for (; i + 2 <= count; i += 2)
+				{
+					const __m256 m = LoadLinearParts(matrices + i);
+					const __m256 t = LoadTranslations(matrices + i);
+
+					// x0 y0 x0 y0 | x1 y1 x1 y1
+					const __m128 p = _mm_loadu_ps(&points[i].x);
+					const __m256 pp = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_movelh_ps(p, p)), _mm_movehl_ps(p, p), 1);
+
+					const __m256 px = _mm256_moveldup_ps(pp);
+					const __m256 py = _mm256_movehdup_ps(pp);
+					const __m256 m1 = _mm256_shuffle_ps(m, m, _MM_SHUFFLE(3, 2, 3, 2));
+					const __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m), _mm256_mul_ps(py, m1)), t);
+
+					// the lower two floats of each lane hold the results
+					const __m128 lo = _mm256_castps256_ps128(r);
+					const __m128 hi = _mm256_extractf128_ps(r, 1);
+					_mm_storeu_ps(&out[i].x, _mm_movelh_ps(lo, hi));
+				}
+				TransformPointsByMatricesSSE2(out + i, matrices + i, points + i, count - i);
+			}
+
+			void CpuId(int info[4], int leaf)
+			{
+#	ifdef _MSC_VER
+				__cpuid(info, leaf);
+#	else
+				unsigned int regs[4] = {};
+				__get_cpuid(static_cast<unsigned int>(leaf), &regs[0], &regs[1], &regs[2], &regs[3]);
+				for (int i = 0; i < 4; ++i)
+					info[i] = static_cast<int>(regs[i]);
+#	endif
+			}
+
+			unsigned long long ReadXCR0()
+			{
+#	ifdef _MSC_VER
+				return _xgetbv(0);
+#	else
+				unsigned int eax, edx;
+				__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+				return (static_cast<unsigned long long>(edx) << 32) | eax;
+#	endif
+			}
+
+			bool IsSSE2Supported()
+			{
+#	if defined(_M_X64) || defined(__x86_64__)
+				return true;
+#	else
+				int info[4];
+				CpuId(info, 1);
+				return (info[3] & (1 << 26)) != 0;
+#	endif
+			}
+
+			// the kernels only use AVX instructions, AVX2 is not required
+			bool IsAVXSupported()
+			{
+				int info[4];
+				CpuId(info, 1);
+				const bool osxsave = (info[2] & (1 << 27)) != 0;
+				const bool avx = (info[2] & (1 << 28)) != 0;
+				if (!osxsave || !avx)
+					return false;
+
+				// the OS must save the YMM registers on context switches
+				return (ReadXCR0() & 0x6) == 0x6;
+			}
+
+#endif // KGE_SIMD_X86
+
+			struct Kernels
+			{
+				void (*multiply)(Matrix*, Matrix const*, Matrix const*, size_t);
+				void (*invert)(Matrix*, Matrix const*, size_t);
+				void (*transform)(Vec2*, Matrix const&, Vec2 const*, size_t);
+				void (*transform_by_matrices)(Vec2*, Matrix const*, Vec2 const*, size_t);
+			};
+
+			Kernels MakeKernels(SimdLevel level)
+			{
+				switch (level)
+				{
+#ifdef KGE_SIMD_X86
+				case SimdLevel::AVX:
+					return Kernels{ MultiplyMatricesAVX, InvertMatricesAVX, TransformPointsAVX, TransformPointsByMatricesAVX };
+				case SimdLevel::SSE2:
+					return Kernels{ MultiplyMatricesSSE2, InvertMatricesSSE2, TransformPointsSSE2, TransformPointsByMatricesSSE2 };
+#endif
+				default:
+					return Kernels{ MultiplyMatricesScalar, InvertMatricesScalar, TransformPointsScalar, TransformPointsByMatricesScalar };
+				}
+			}
+
+			SimdLevel DetectSimdLevel()
+			{
+#ifdef KGE_SIMD_X86
+				if (IsAVXSupported())
+					return SimdLevel::AVX;
+				if (IsSSE2Supported())
+					return SimdLevel::SSE2;
+#endif
+				return SimdLevel::Scalar;
+			}
+
+			struct Dispatcher
+			{
+				SimdLevel supported;
+				SimdLevel current;
+				Kernels kernels;
+
+				Dispatcher()
+				{
+					supported = current = DetectSimdLevel();
+					kernels = MakeKernels(current);
+				}
+
+				static Dispatcher& Instance()
+				{
+					static Dispatcher instance;
+					return instance;
+				}
+			};
+		}
+
+		SimdLevel GetSupportedSimdLevel()
+		{
+			return Dispatcher::Instance().supported;
+		}
+
+		SimdLevel GetSimdLevel()
+		{
+			return Dispatcher::Instance().current;
+		}
+
+		void SetSimdLevel(SimdLevel level)
+		{
+			auto& dispatcher = Dispatcher::Instance();
+			dispatcher.current = std::min(level, dispatcher.supported);
+			dispatcher.kernels = MakeKernels(dispatcher.current);
+		}
+
+		void MultiplyMatrices(Matrix* out, Matrix const* lhs, Matrix const* rhs, size_t count)
+		{
+			Dispatcher::Instance().kernels.multiply(out, lhs, rhs, count);
+		}
+
+		void InvertMatrices(Matrix* out, Matrix const* matrices, size_t count)
+		{
+			Dispatcher::Instance().kernels.invert(out, matrices, count);
+		}
+
+		void TransformPoints(Vec2* out, Matrix const& matrix, Vec2 const* points, size_t count)
+		{
+			Dispatcher::Instance().kernels.transform(out, matrix, points, count);
+		}
+
+		void TransformPoints(Vec2* out, Matrix const* matrices, Vec2 const* points, size_t count)
+		{
+			Dispatcher::Instance().kernels.transform_by_matrices(out, matrices, points, count);
+		}
+	}
+}
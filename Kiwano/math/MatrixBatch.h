@@ -0,0 +1,81 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/defines.h"
+#include "Vec2.hpp"
+#include "Matrix.hpp"
+
+namespace kiwano
+{
+	namespace math
+	{
+		// SIMD 指令集等级
+		enum class SimdLevel : int
+		{
+			Scalar,		/* 不使用 SIMD */
+			SSE2,		/* SSE2 */
+			AVX			/* AVX */
+		};
+
+		// 获取当前 CPU 支持的最高 SIMD 等级
+		KGE_API SimdLevel GetSupportedSimdLevel();
+
+		// 获取批量运算使用的 SIMD 等级
+		KGE_API SimdLevel GetSimdLevel();
+
+		// 设置批量运算使用的 SIMD 等级
+		// 超出 CPU 支持范围时使用支持的最高等级
+		KGE_API void SetSimdLevel(
+			SimdLevel level
+		);
+
+		// 批量矩阵乘法 out[i] = lhs[i] * rhs[i]
+		KGE_API void MultiplyMatrices(
+			Matrix* out,
+			Matrix const* lhs,
+			Matrix const* rhs,
+			size_t count
+		);
+
+		// 批量矩阵求逆 out[i] = Invert(matrices[i])
+		KGE_API void InvertMatrices(
+			Matrix* out,
+			Matrix const* matrices,
+			size_t count
+		);
+
+		// 使用同一矩阵批量变换点 out[i] = matrix.Transform(points[i])
+		KGE_API void TransformPoints(
+			Vec2* out,
+			Matrix const& matrix,
+			Vec2 const* points,
+			size_t count
+		);
+
+		// 批量变换点 out[i] = matrices[i].Transform(points[i])
+		KGE_API void TransformPoints(
+			Vec2* out,
+			Matrix const* matrices,
+			Vec2 const* points,
+			size_t count
+		);
+	}
+}
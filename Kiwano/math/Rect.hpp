@@ -25,15 +25,15 @@ namespace kiwano
 {
 	namespace math
 	{
-		// 
+		// 矩形
 		template <typename _Ty>
 		struct RectT
 		{
 		public:
 			using value_type = _Ty;
 
-			Vec2T<value_type> origin;	// Ͻ
-			Vec2T<value_type> size;	// Ⱥ͸߶
+			Vec2T<value_type> origin;	// 左上角坐标
+			Vec2T<value_type> size;	// 宽度和高度
 
 		public:
 			RectT() {}
@@ -56,19 +56,9 @@ namespace kiwano
 				, size(size.x, size.y)
 			{}
 
-			RectT(
-				const RectT& other
-			)
-				: origin(other.origin.x, other.origin.y)
-				, size(other.size.x, other.size.y)
-			{}
+			RectT(const RectT& other) = default;
 
-			RectT& operator= (const RectT& other)
-			{
-				origin = other.origin;
-				size = other.size;
-				return *this;
-			}
+			RectT& operator= (const RectT& other) = default;
 
 			inline bool operator== (const RectT& rect) const
 			{
@@ -97,14 +87,14 @@ namespace kiwano
 
 			inline bool IsEmpty() const { return origin.IsOrigin() && size.IsOrigin(); }
 
-			// жϵǷھ
+			// 判断点是否在矩形内
 			inline bool ContainsPoint(const Vec2& point) const
 			{
 				return	point.x >= origin.x && point.x <= (origin.x + size.x) &&
 					point.y >= origin.y && point.y <= (origin.y + size.y);
 			}
 
-			// жǷཻ
+			// 判断两矩形是否相交
 			inline bool Intersects(const RectT& rect) const
 			{
 				return !((origin.x + size.x)			< rect.origin.x ||
@@ -37,7 +37,7 @@ namespace kiwano
 
 			Vec2T(value_type x, value_type y) : x(x), y(y) {}
 
-			Vec2T(const Vec2T& other) : x(other.x), y(other.y) {}
+			Vec2T(const Vec2T& other) = default;
 
 			inline value_type Length() const
 			{
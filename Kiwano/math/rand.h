@@ -26,11 +26,11 @@ namespace kiwano
 	namespace math
 	{
 		//
-		// 
+		// 随机数
 		// 
-		// ȡָΧڵһ, :
-		// int n = math::Rand(1, 5);  // ȡ 1~5 ڵ,  1  5
-		// ȡڲ, ȡ:
+		// 获取指定范围内的一个随机数, 如:
+		// int n = math::Rand(1, 5);  // 获取 1~5 内的随机整数, 包含 1 和 5
+		// 产生的随机数类型取决于参数的类型, 如获取随机浮点数:
 		// double d = math::Rand(1.2, 1.5);
 		//
 
@@ -0,0 +1,814 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "HttpCache.h"
+#include "../base/logs.h"
+#include <ctime>
+#include <cstdio>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+
+#ifdef _WIN32
+#	include "../macros.h"
+#	include "../utils/Path.h"
+#else
+#	include <cerrno>
+#	include <codecvt>
+#	include <locale>
+#	include <dirent.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+// CURL
+#include "../third-party/curl/curl.h"
+
+namespace
+{
+	using namespace kiwano;
+	using namespace kiwano::network;
+
+	const char cache_file_magic[4] = { 'K', 'H', 'C', '1' };
+
+	// index changes kept in memory before the index file is rewritten
+	const size_t index_flush_interval = 32;
+
+	// caches with a directory that are alive in this process
+	// a cache opened on the same directory flushes them first, so their bodies are not taken for orphans
+	std::mutex open_caches_mutex;
+	Map<String, Array<HttpCache*>> open_caches;
+
+	long long now_seconds()
+	{
+		return static_cast<long long>(std::time(nullptr));
+	}
+
+	size_t entry_bytes(HttpCache::Entry const& entry)
+	{
+		const size_t data_bytes = entry.data ? entry.data->size() : 0;
+		return entry.key.size() + entry.header.size() + data_bytes + entry.etag.size() + entry.last_modified.size();
+	}
+
+	// file names are a stable hash of the key, the key itself is stored in the file
+	std::string hash_name(std::string const& key)
+	{
+		unsigned long long hash = 14695981039346656037ULL;
+		for (auto ch : key)
+		{
+			hash ^= static_cast<unsigned char>(ch);
+			hash *= 1099511628211ULL;
+		}
+
+		char name[17];
+		std::snprintf(name, sizeof(name), "%016llx", hash);
+		return name;
+	}
+
+	std::string to_lower(std::string str)
+	{
+		for (auto& ch : str)
+			ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+		return str;
+	}
+
+	std::string trim(std::string const& str)
+	{
+		size_t begin = str.find_first_not_of(" \t\r\n");
+		if (begin == std::string::npos)
+			return std::string();
+
+		size_t end = str.find_last_not_of(" \t\r\n");
+		return str.substr(begin, end - begin + 1);
+	}
+
+	// fields of the last header block, earlier blocks belong to redirects or 100 continue
+	UnorderedMap<std::string, std::string> parse_header(std::string const& header)
+	{
+		UnorderedMap<std::string, std::string> fields;
+
+		size_t pos = 0;
+		while (pos < header.size())
+		{
+			size_t end = header.find('\n', pos);
+			if (end == std::string::npos)
+				end = header.size();
+
+			std::string line = header.substr(pos, end - pos);
+			pos = end + 1;
+
+			if (line.compare(0, 5, "HTTP/") == 0)
+			{
+				fields.clear();
+				continue;
+			}
+
+			size_t colon = line.find(':');
+			if (colon != std::string::npos)
+			{
+				fields[to_lower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+			}
+		}
+		return fields;
+	}
+
+	std::string find_field(UnorderedMap<std::string, std::string> const& fields, const char* name)
+	{
+		auto iter = fields.find(name);
+		return iter != fields.end() ? iter->second : std::string();
+	}
+
+	// returns false if the response must not be stored
+	bool update_entry(HttpCache::Entry& entry, std::string const& header)
+	{
+		auto fields = parse_header(header);
+
+		bool no_cache = false;
+		long long max_age = -1;
+
+		std::string cache_control = to_lower(find_field(fields, "cache-control"));
+		size_t pos = 0;
+		while (pos <= cache_control.size())
+		{
+			size_t end = cache_control.find(',', pos);
+			if (end == std::string::npos)
+				end = cache_control.size();
+
+			std::string directive = trim(cache_control.substr(pos, end - pos));
+			pos = end + 1;
+
+			if (directive == "no-store")
+				return false;
+			else if (directive == "no-cache")
+				no_cache = true;
+			else if (directive.compare(0, 8, "max-age=") == 0)
+				max_age = std::atoll(directive.c_str() + 8);
+		}
+
+		if (find_field(fields, "vary") == "*")
+			return false;
+
+		std::string etag = find_field(fields, "etag");
+		if (!etag.empty())
+			entry.etag = etag;
+
+		std::string last_modified = find_field(fields, "last-modified");
+		if (!last_modified.empty())
+			entry.last_modified = last_modified;
+
+		long long lifetime = 0;
+		if (no_cache)
+		{
+			lifetime = 0;
+		}
+		else if (max_age >= 0)
+		{
+			lifetime = max_age;
+		}
+		else
+		{
+			std::string expires = find_field(fields, "expires");
+			if (!expires.empty())
+			{
+				// measure against the server clock
+				std::string date = find_field(fields, "date");
+				long long server_now = date.empty() ? now_seconds() : static_cast<long long>(curl_getdate(date.c_str(), nullptr));
+				long long expires_time = static_cast<long long>(curl_getdate(expires.c_str(), nullptr));
+				lifetime = (expires_time > 0 && server_now > 0) ? expires_time - server_now : 0;
+			}
+		}
+
+		long long age = std::atoll(find_field(fields, "age").c_str());
+		entry.expires = now_seconds() + std::max(lifetime - age, 0LL);
+
+		return lifetime - age > 0 || !entry.etag.empty() || !entry.last_modified.empty();
+	}
+
+#ifdef _WIN32
+	const wchar_t path_separator = L'\\';
+#else
+	const wchar_t path_separator = L'/';
+
+	std::string to_native_path(String const& path)
+	{
+		std::wstring_convert<std::codecvt_utf8<wchar_t>> utf8_conv;
+		return utf8_conv.to_bytes(path.c_str());
+	}
+#endif
+
+	// paths are wide on windows and utf-8 elsewhere
+	std::FILE* open_file(String const& path, const wchar_t* mode)
+	{
+		std::FILE* file = nullptr;
+#ifdef _WIN32
+		if (0 != _wfopen_s(&file, path.c_str(), mode))
+			return nullptr;
+#else
+		file = std::fopen(to_native_path(path).c_str(), to_native_path(mode).c_str());
+#endif
+		return file;
+	}
+
+	void delete_file(String const& path)
+	{
+#ifdef _WIN32
+		::DeleteFileW(path.c_str());
+#else
+		::unlink(to_native_path(path).c_str());
+#endif
+	}
+
+	bool create_folder(String const& path)
+	{
+#ifdef _WIN32
+		return Path::CreateFolder(path);
+#else
+		// create every missing parent as well
+		const std::string native = to_native_path(path);
+		for (size_t pos = native.find('/', 1); ; pos = native.find('/', pos + 1))
+		{
+			const std::string parent = native.substr(0, pos);
+			if (!parent.empty() && 0 != ::mkdir(parent.c_str(), 0755) && errno != EEXIST)
+				return false;
+
+			if (pos == std::string::npos)
+				break;
+		}
+		return true;
+#endif
+	}
+
+	bool write_string(std::FILE* file, std::string const& str)
+	{
+		unsigned long long size = str.size();
+		return 1 == std::fwrite(&size, sizeof(size), 1, file)
+			&& str.size() == std::fwrite(str.data(), 1, str.size(), file);
+	}
+
+	bool read_string(std::FILE* file, std::string& str, unsigned long long limit)
+	{
+		unsigned long long size = 0;
+		if (1 != std::fread(&size, sizeof(size), 1, file) || size > limit)
+			return false;
+
+		str.resize(static_cast<size_t>(size));
+		return str.size() == std::fread(&str[0], 1, str.size(), file);
+	}
+
+	bool is_cache_file_name(std::string const& name)
+	{
+		if (name.size() != 16)
+			return false;
+
+		for (auto ch : name)
+		{
+			if (!std::isxdigit(static_cast<unsigned char>(ch)) || std::isupper(static_cast<unsigned char>(ch)))
+				return false;
+		}
+		return true;
+	}
+
+	// names of the files in the directory that look like cache bodies
+	Array<std::string> list_cache_files(String const& directory)
+	{
+		Array<std::string> names;
+
+#ifdef _WIN32
+		WIN32_FIND_DATAW data;
+		HANDLE find = ::FindFirstFileW((directory + L"*").c_str(), &data);
+		if (find == INVALID_HANDLE_VALUE)
+			return names;
+
+		do
+		{
+			if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+				continue;
+
+			// cache names are plain ascii
+			std::string name;
+			for (const wchar_t* ch = data.cFileName; *ch && *ch < 0x80; ++ch)
+				name.push_back(static_cast<char>(*ch));
+
+			if (name.size() == std::wcslen(data.cFileName) && is_cache_file_name(name))
+				names.push_back(name);
+		} while (::FindNextFileW(find, &data));
+
+		::FindClose(find);
+#else
+		const std::string native = to_native_path(directory);
+		DIR* dir = ::opendir(native.c_str());
+		if (!dir)
+			return names;
+
+		while (dirent* entry = ::readdir(dir))
+		{
+			struct stat info;
+			const std::string name = entry->d_name;
+			if (is_cache_file_name(name)
+				&& 0 == ::stat((native + name).c_str(), &info)
+				&& S_ISREG(info.st_mode))
+			{
+				names.push_back(name);
+			}
+		}
+
+		::closedir(dir);
+#endif
+		return names;
+	}
+}
+
+namespace kiwano
+{
+	namespace network
+	{
+		HttpCache::HttpCache(String const& directory, size_t memory_budget, size_t disk_budget)
+			: directory_(directory)
+			, memory_budget_(memory_budget)
+			, disk_budget_(disk_budget)
+			, memory_bytes_(0)
+			, disk_bytes_(0)
+			, serial_(0)
+			, index_changes_(0)
+			, stats_()
+		{
+			if (!directory_.empty())
+			{
+				wchar_t last = directory_.at(directory_.size() - 1);
+				if (last != L'\\' && last != L'/')
+				{
+					directory_.push_back(path_separator);
+				}
+
+				if (create_folder(directory_))
+				{
+					std::lock_guard<std::mutex> lock(open_caches_mutex);
+
+					auto& caches = open_caches[directory_];
+					for (auto cache : caches)
+					{
+						cache->Flush();
+					}
+					caches.push_back(this);
+
+					LoadIndex();
+				}
+				else
+				{
+					KGE_ERROR_LOG(L"HttpCache: failed to create directory %s", directory_.c_str());
+					directory_.clear();
+				}
+			}
+		}
+
+		HttpCache::~HttpCache()
+		{
+			if (directory_.empty())
+				return;
+
+			// a cache opened meanwhile must see the final index
+			std::lock_guard<std::mutex> lock(open_caches_mutex);
+			Flush();
+
+			auto& caches = open_caches[directory_];
+			caches.erase(std::find(caches.begin(), caches.end(), this));
+			if (caches.empty())
+			{
+				open_caches.erase(directory_);
+			}
+		}
+
+		void HttpCache::SetMemoryBudget(size_t bytes)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			memory_budget_ = bytes;
+			TrimMemory();
+		}
+
+		size_t HttpCache::GetMemoryBudget() const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return memory_budget_;
+		}
+
+		void HttpCache::SetDiskBudget(size_t bytes)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			disk_budget_ = bytes;
+			TrimDisk(std::string());
+		}
+
+		size_t HttpCache::GetDiskBudget() const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return disk_budget_;
+		}
+
+		String const& HttpCache::GetDirectory() const
+		{
+			return directory_;
+		}
+
+		void HttpCache::Clear()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			memory_.clear();
+			memory_order_.clear();
+			memory_bytes_ = 0;
+
+			while (!disk_.empty())
+			{
+				RemoveFromDisk(disk_.begin()->first);
+			}
+			SaveIndex();
+		}
+
+		void HttpCache::Flush()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			if (index_changes_)
+			{
+				SaveIndex();
+			}
+		}
+
+		HttpCache::Stats HttpCache::GetStats() const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			Stats stats = stats_;
+			stats.count = disk_.size();
+			for (const auto& pair : memory_)
+			{
+				if (!disk_.count(hash_name(pair.first)))
+					++stats.count;
+			}
+			stats.memory_bytes = memory_bytes_;
+			stats.disk_bytes = disk_bytes_;
+			return stats;
+		}
+
+		bool HttpCache::Lookup(std::string const& key, Entry& entry)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			auto iter = memory_.find(key);
+			if (iter != memory_.end())
+			{
+				memory_order_.splice(memory_order_.begin(), memory_order_, iter->second.order);
+				entry = iter->second.entry;
+			}
+			else if (!LoadFromDisk(key, entry))
+			{
+				++stats_.misses;
+				return false;
+			}
+			else
+			{
+				InsertToMemory(entry);
+			}
+
+			if (IsFresh(entry))
+				++stats_.hits;
+			else
+				++stats_.revalidations;
+			return true;
+		}
+
+		void HttpCache::Store(std::string const& key, long response_code, std::string const& header, HttpBuffer const& data)
+		{
+			if (response_code != 200)
+				return;
+
+			Entry entry;
+			entry.key = key;
+			entry.response_code = response_code;
+			entry.header = header;
+			entry.data = data;
+			entry.expires = 0;
+
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			if (update_entry(entry, header))
+			{
+				Insert(entry);
+			}
+			else
+			{
+				// a stored copy is outdated now
+				auto iter = memory_.find(key);
+				if (iter != memory_.end())
+				{
+					memory_bytes_ -= iter->second.bytes;
+					memory_order_.erase(iter->second.order);
+					memory_.erase(iter);
+				}
+
+				if (disk_.count(hash_name(key)))
+				{
+					RemoveFromDisk(hash_name(key));
+					MarkIndexDirty();
+				}
+			}
+		}
+
+		void HttpCache::Revalidate(Entry& entry, std::string const& header)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			++stats_.not_modified;
+			if (update_entry(entry, header))
+			{
+				Insert(entry);
+			}
+		}
+
+		bool HttpCache::IsFresh(Entry const& entry)
+		{
+			return entry.expires > now_seconds();
+		}
+
+		void HttpCache::Insert(Entry const& entry)
+		{
+			InsertToMemory(entry);
+
+			if (!directory_.empty())
+			{
+				SaveToDisk(entry);
+			}
+		}
+
+		void HttpCache::InsertToMemory(Entry const& entry)
+		{
+			auto iter = memory_.find(entry.key);
+			if (iter != memory_.end())
+			{
+				memory_bytes_ -= iter->second.bytes;
+				memory_order_.erase(iter->second.order);
+				memory_.erase(iter);
+			}
+
+			const size_t bytes = entry_bytes(entry);
+			if (bytes > memory_budget_)
+				return;
+
+			memory_order_.push_front(entry.key);
+
+			MemoryItem& item = memory_[entry.key];
+			item.entry = entry;
+			item.bytes = bytes;
+			item.order = memory_order_.begin();
+			memory_bytes_ += bytes;
+
+			TrimMemory();
+		}
+
+		void HttpCache::TrimMemory()
+		{
+			// evicted entries stay on disk
+			while (memory_bytes_ > memory_budget_ && !memory_order_.empty())
+			{
+				auto iter = memory_.find(memory_order_.back());
+				memory_bytes_ -= iter->second.bytes;
+				memory_.erase(iter);
+				memory_order_.pop_back();
+			}
+		}
+
+		bool HttpCache::LoadFromDisk(std::string const& key, Entry& entry)
+		{
+			const std::string name = hash_name(key);
+
+			auto iter = disk_.find(name);
+			if (iter == disk_.end())
+				return false;
+
+			std::FILE* file = open_file(GetFilePath(name), L"rb");
+			if (!file)
+			{
+				RemoveFromDisk(name);
+				MarkIndexDirty();
+				return false;
+			}
+
+			const unsigned long long limit = iter->second.bytes;
+
+			char magic[4] = { 0 };
+			long long response_code = 0;
+			std::string data;
+			bool ok = 1 == std::fread(magic, sizeof(magic), 1, file)
+				&& 0 == std::memcmp(magic, cache_file_magic, sizeof(magic))
+				&& read_string(file, entry.key, limit)
+				&& 1 == std::fread(&response_code, sizeof(response_code), 1, file)
+				&& 1 == std::fread(&entry.expires, sizeof(entry.expires), 1, file)
+				&& read_string(file, entry.etag, limit)
+				&& read_string(file, entry.last_modified, limit)
+				&& read_string(file, entry.header, limit)
+				&& read_string(file, data, limit);
+			std::fclose(file);
+
+			entry.response_code = static_cast<long>(response_code);
+			entry.data = std::make_shared<const std::string>(std::move(data));
+
+			if (!ok || entry.key != key)
+			{
+				// a damaged file, or another key with the same hash
+				if (!ok)
+				{
+					RemoveFromDisk(name);
+					MarkIndexDirty();
+				}
+				return false;
+			}
+
+			// the new order is written with the next index flush
+			iter->second.serial = ++serial_;
+			MarkIndexDirty();
+			return true;
+		}
+
+		void HttpCache::SaveToDisk(Entry const& entry)
+		{
+			const std::string name = hash_name(entry.key);
+			const size_t bytes = entry_bytes(entry);
+
+			if (disk_.count(name))
+			{
+				RemoveFromDisk(name);
+			}
+
+			if (bytes > disk_budget_)
+			{
+				MarkIndexDirty();
+				return;
+			}
+
+			std::FILE* file = open_file(GetFilePath(name), L"wb");
+			if (!file)
+			{
+				KGE_WARNING_LOG(L"HttpCache: failed to write cache file");
+				MarkIndexDirty();
+				return;
+			}
+
+			const long long response_code = entry.response_code;
+			bool ok = 1 == std::fwrite(cache_file_magic, sizeof(cache_file_magic), 1, file)
+				&& write_string(file, entry.key)
+				&& 1 == std::fwrite(&response_code, sizeof(response_code), 1, file)
+				&& 1 == std::fwrite(&entry.expires, sizeof(entry.expires), 1, file)
+				&& write_string(file, entry.etag)
+				&& write_string(file, entry.last_modified)
+				&& write_string(file, entry.header)
+				&& write_string(file, entry.data ? *entry.data : std::string());
+			ok = (0 == std::fclose(file)) && ok;
+
+			if (ok)
+			{
+				disk_[name] = DiskItem{ bytes, ++serial_ };
+				disk_bytes_ += bytes;
+				TrimDisk(name);
+			}
+			else
+			{
+				delete_file(GetFilePath(name));
+			}
+			MarkIndexDirty();
+		}
+
+		void HttpCache::TrimDisk(std::string const& keep)
+		{
+			bool changed = false;
+			while (disk_bytes_ > disk_budget_)
+			{
+				auto oldest = disk_.end();
+				for (auto iter = disk_.begin(); iter != disk_.end(); ++iter)
+				{
+					if (iter->first != keep && (oldest == disk_.end() || iter->second.serial < oldest->second.serial))
+						oldest = iter;
+				}
+
+				if (oldest == disk_.end())
+					break;
+
+				RemoveFromDisk(oldest->first);
+				changed = true;
+			}
+
+			if (changed)
+			{
+				MarkIndexDirty();
+			}
+		}
+
+		void HttpCache::RemoveFromDisk(std::string const& name)
+		{
+			// the name may belong to the erased item
+			delete_file(GetFilePath(name));
+
+			auto iter = disk_.find(name);
+			if (iter != disk_.end())
+			{
+				disk_bytes_ -= iter->second.bytes;
+				disk_.erase(iter);
+			}
+		}
+
+		void HttpCache::LoadIndex()
+		{
+			std::FILE* file = open_file(directory_ + L"index", L"r");
+			if (!file)
+			{
+				RemoveUnlistedFiles();
+				return;
+			}
+
+			char name[32] = { 0 };
+			unsigned long long bytes = 0;
+			unsigned long long serial = 0;
+			while (3 == std::fscanf(file, "%31s %llu %llu", name, &bytes, &serial))
+			{
+				disk_[name] = DiskItem{ static_cast<size_t>(bytes), serial };
+				disk_bytes_ += static_cast<size_t>(bytes);
+				serial_ = std::max(serial_, serial);
+			}
+			std::fclose(file);
+
+			RemoveUnlistedFiles();
+			TrimDisk(std::string());
+		}
+
+		void HttpCache::RemoveUnlistedFiles()
+		{
+			// bodies written after the last index save are lost to the index after an unclean exit,
+			// nothing would ever evict them
+			bool removed = false;
+			for (const auto& name : list_cache_files(directory_))
+			{
+				if (!disk_.count(name))
+				{
+					delete_file(GetFilePath(name));
+					removed = true;
+				}
+			}
+
+			if (removed)
+			{
+				KGE_WARNING_LOG(L"HttpCache: removed cache files missing from the index");
+			}
+		}
+
+		void HttpCache::SaveIndex()
+		{
+			if (directory_.empty())
+				return;
+
+			std::FILE* file = open_file(directory_ + L"index", L"w");
+			if (!file)
+				return;
+
+			for (const auto& pair : disk_)
+			{
+				std::fprintf(file, "%s %llu %llu\n", pair.first.c_str(),
+					static_cast<unsigned long long>(pair.second.bytes), pair.second.serial);
+			}
+
+			if (0 == std::fclose(file))
+			{
+				index_changes_ = 0;
+			}
+		}
+
+		void HttpCache::MarkIndexDirty()
+		{
+			if (++index_changes_ >= index_flush_interval)
+			{
+				SaveIndex();
+			}
+		}
+
+		String HttpCache::GetFilePath(std::string const& name) const
+		{
+			return directory_ + String(name.c_str());
+		}
+	}
+}
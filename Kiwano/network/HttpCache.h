@@ -0,0 +1,196 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "helper.h"
+#include "../base/Object.h"
+#include <mutex>
+
+namespace kiwano
+{
+	namespace network
+	{
+		// HTTP 缓存
+		// 缓存 GET 请求的响应, 遵循 Cache-Control 和 Expires
+		// 过期的响应通过 ETag 和 Last-Modified 向服务器验证, 未修改时继续使用缓存
+		// 磁盘索引每累积若干次修改写入一次, 调用 Flush 或销毁时也会写入
+		class KGE_API HttpCache
+			: public Object
+		{
+		public:
+			struct Stats
+			{
+				size_t hits;			// 直接使用缓存的次数
+				size_t revalidations;	// 向服务器验证的次数
+				size_t not_modified;	// 验证后继续使用缓存的次数
+				size_t misses;			// 未命中的次数
+				size_t count;			// 缓存的响应数量
+				size_t memory_bytes;	// 内存缓存大小
+				size_t disk_bytes;		// 磁盘缓存大小
+			};
+
+			// 缓存的响应
+			struct Entry
+			{
+				std::string key;
+				long response_code;
+				std::string header;
+				HttpBuffer data;		// 与缓存共享, 不可修改
+				std::string etag;
+				std::string last_modified;
+				long long expires;		// 过期时间 (秒)
+			};
+
+		public:
+			// directory 为空时只使用内存缓存
+			HttpCache(
+				String const& directory = L"",
+				size_t memory_budget = 4 * 1024 * 1024,
+				size_t disk_budget = 32 * 1024 * 1024
+			);
+
+			virtual ~HttpCache();
+
+			// 设置内存缓存的大小上限
+			void SetMemoryBudget(
+				size_t bytes
+			);
+
+			size_t GetMemoryBudget() const;
+
+			// 设置磁盘缓存的大小上限
+			void SetDiskBudget(
+				size_t bytes
+			);
+
+			size_t GetDiskBudget() const;
+
+			// 获取磁盘缓存目录
+			String const& GetDirectory() const;
+
+			// 清空缓存
+			void Clear();
+
+			// 将磁盘索引的修改写入文件
+			void Flush();
+
+			// 获取统计数据
+			Stats GetStats() const;
+
+		public:
+			// 以下方法由 HttpClient 在网络线程中调用
+
+			// 查找缓存
+			bool Lookup(
+				std::string const& key,
+				Entry& entry
+			);
+
+			// 保存响应, 不可缓存的响应会被忽略
+			void Store(
+				std::string const& key,
+				long response_code,
+				std::string const& header,
+				HttpBuffer const& data
+			);
+
+			// 服务器返回 304 时更新缓存的有效期
+			void Revalidate(
+				Entry& entry,
+				std::string const& header
+			);
+
+			// 缓存是否仍在有效期内
+			static bool IsFresh(
+				Entry const& entry
+			);
+
+		protected:
+			struct MemoryItem
+			{
+				Entry entry;
+				size_t bytes;
+				List<std::string>::iterator order;
+			};
+
+			struct DiskItem
+			{
+				size_t bytes;
+				unsigned long long serial;
+			};
+
+			void Insert(
+				Entry const& entry
+			);
+
+			void InsertToMemory(
+				Entry const& entry
+			);
+
+			bool LoadFromDisk(
+				std::string const& key,
+				Entry& entry
+			);
+
+			void SaveToDisk(
+				Entry const& entry
+			);
+
+			void TrimMemory();
+
+			void TrimDisk(
+				std::string const& keep
+			);
+
+			void RemoveFromDisk(
+				std::string const& name
+			);
+
+			void LoadIndex();
+
+			// 删除索引中没有记录的缓存文件
+			void RemoveUnlistedFiles();
+
+			void SaveIndex();
+
+			void MarkIndexDirty();
+
+			String GetFilePath(
+				std::string const& name
+			) const;
+
+		protected:
+			String directory_;
+			size_t memory_budget_;
+			size_t disk_budget_;
+			size_t memory_bytes_;
+			size_t disk_bytes_;
+			unsigned long long serial_;
+			size_t index_changes_;
+			Stats stats_;
+
+			List<std::string> memory_order_;
+			UnorderedMap<std::string, MemoryItem> memory_;
+			UnorderedMap<std::string, DiskItem> disk_;
+
+			mutable std::mutex mutex_;
+		};
+	}
+}
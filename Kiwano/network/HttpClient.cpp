@@ -18,14 +18,18 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-#include "../kiwano-network.h"
+#include "HttpClient.h"
+#include "../base/logs.h"
+#include "../base/PerformQueue.h"
 #include <thread>
 #include <codecvt>
 
 // CURL
 #include "../third-party/curl/curl.h"
 
-#pragma comment(lib, "libcurl.lib")
+#ifdef _MSC_VER
+#	pragma comment(lib, "libcurl.lib")
+#endif
 
 namespace
 {
@@ -44,6 +48,24 @@ namespace
 		return total;
 	}
 
+	long long get_file_size(std::FILE* file)
+	{
+#ifdef _WIN32
+		if (0 != _fseeki64(file, 0, SEEK_END))
+			return -1;
+
+		long long size = _ftelli64(file);
+		_fseeki64(file, 0, SEEK_SET);
+#else
+		if (0 != fseeko(file, 0, SEEK_END))
+			return -1;
+
+		long long size = static_cast<long long>(ftello(file));
+		fseeko(file, 0, SEEK_SET);
+#endif
+		return size;
+	}
+
 	std::string convert_to_utf8(String const& str)
 	{
 		std::wstring_convert<std::codecvt_utf8<wchar_t>> utf8_conv;
@@ -61,6 +83,19 @@ namespace
 		return result;
 	}
 
+	// paths are wide on windows and utf-8 elsewhere
+	std::FILE* open_file(String const& path, const wchar_t* mode)
+	{
+		std::FILE* file = nullptr;
+#ifdef _WIN32
+		if (0 != _wfopen_s(&file, path.c_str(), mode))
+			return nullptr;
+#else
+		file = std::fopen(convert_to_utf8(path).c_str(), convert_to_utf8(mode).c_str());
+#endif
+		return file;
+	}
+
 	String convert_from_utf8(std::string const& str)
 	{
 		std::wstring_convert<std::codecvt_utf8<wchar_t>> utf8_conv;
@@ -78,13 +113,44 @@ namespace
 		return result;
 	}
 
+	// only plain GET responses held in memory are cached and shared
+	bool is_cacheable(HttpRequest const& request)
+	{
+		return request.GetType() == HttpRequest::Type::Get
+			&& request.GetDownloadFile().empty()
+			&& request.GetUploadFile().empty()
+			&& !request.GetUploadCallback()
+			&& !request.GetDataCallback();
+	}
+
+	std::string get_cache_key(HttpRequest const& request)
+	{
+		std::string key = convert_to_utf8(request.GetUrl());
+		for (const auto& pair : request.GetHeaders())
+		{
+			key += "\n" + pair.first.to_string() + ":" + pair.second.to_string();
+		}
+		return key;
+	}
+
+	// a single transfer driven by the multi handle of the network thread
 	class Curl
 	{
 	public:
-		Curl()
+		Curl(HttpRequestPtr request)
 			: curl_(curl_easy_init())
 			, curl_headers_(nullptr)
+			, request_(std::move(request))
+			, upload_file_(nullptr)
+			, download_file_(nullptr)
+			, resume_from_(0)
+			, progress_()
+			, cache_(nullptr)
+			, cached_()
+			, has_cached_(false)
+			, fresh_(false)
 		{
+			error_buffer_[0] = '\0';
 		}
 
 		~Curl()
@@ -100,15 +166,26 @@ namespace
 				curl_slist_free_all(curl_headers_);
 				curl_headers_ = nullptr;
 			}
+
+			CloseFiles();
 		}
 
-		bool Init(HttpClient* client, Array<std::string> const& headers, std::string const& url, std::string* response_data, std::string* response_header, char* error_buffer)
+		bool Init(HttpClient* client, CURLSH* share)
 		{
-			if (!SetOption(CURLOPT_ERRORBUFFER, error_buffer))
+			if (!curl_)
+				return false;
+
+			url_ = convert_to_utf8(request_->GetUrl());
+
+			if (!SetOption(CURLOPT_PRIVATE, this))
+				return false;
+			if (!SetOption(CURLOPT_SHARE, share))
 				return false;
-			if (!SetOption(CURLOPT_TIMEOUT, client->GetTimeoutForRead()))
+			if (!SetOption(CURLOPT_ERRORBUFFER, error_buffer_))
 				return false;
-			if (!SetOption(CURLOPT_CONNECTTIMEOUT, client->GetTimeoutForConnect()))
+			if (!SetOption(CURLOPT_TIMEOUT_MS, static_cast<long>(client->GetTimeoutForRead().Milliseconds())))
+				return false;
+			if (!SetOption(CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(client->GetTimeoutForConnect().Milliseconds())))
 				return false;
 
 			const auto ssl_ca_file = client->GetSSLVerification().to_string();
@@ -129,34 +206,249 @@ namespace
 
 			if (!SetOption(CURLOPT_NOSIGNAL, 1L))
 				return false;
-			if (!SetOption(CURLOPT_ACCEPT_ENCODING, ""))
+
+			// byte ranges of a file on disk do not match a compressed body
+			if (request_->GetDownloadFile().empty() && !SetOption(CURLOPT_ACCEPT_ENCODING, ""))
 				return false;
 
+			// continue from the end of a partially downloaded file
+			if (!request_->GetDownloadFile().empty() && request_->IsDownloadResumable())
+			{
+				if (std::FILE* file = open_file(request_->GetDownloadFile(), L"rb"))
+				{
+					resume_from_ = std::max(get_file_size(file), 0LL);
+					std::fclose(file);
+				}
+			}
+
+			// the body is read from a file or a callback instead of memory
+			bool upload_stream = false;
+			long long upload_size = -1;
+			if (!request_->GetUploadFile().empty())
+			{
+				upload_file_ = open_file(request_->GetUploadFile(), L"rb");
+				if (!upload_file_)
+				{
+					KGE_ERROR_LOG(L"HttpClient: failed to open upload file %s", request_->GetUploadFile().c_str());
+					return false;
+				}
+				upload_stream = true;
+				upload_size = get_file_size(upload_file_);
+			}
+			else if (request_->GetUploadCallback())
+			{
+				upload_stream = true;
+				upload_size = request_->GetUploadSize();
+			}
+
 			// set request headers
-			if (!headers.empty())
+			for (const auto& pair : request_->GetHeaders())
 			{
-				for (const auto& header : headers)
+				std::string header = pair.first.to_string() + ":" + pair.second.to_string();
+				curl_headers_ = curl_slist_append(curl_headers_, header.c_str());
+			}
+
+			if (resume_from_ > 0)
+			{
+				std::string header = "Range: bytes=" + std::to_string(resume_from_) + "-";
+				curl_headers_ = curl_slist_append(curl_headers_, header.c_str());
+			}
+
+			// ask the server whether the cached response is still valid
+			if (has_cached_)
+			{
+				if (!cached_.etag.empty())
 				{
+					std::string header = "If-None-Match: " + cached_.etag;
 					curl_headers_ = curl_slist_append(curl_headers_, header.c_str());
 				}
-				if (!SetOption(CURLOPT_HTTPHEADER, curl_headers_))
-					return false;
+
+				if (!cached_.last_modified.empty())
+				{
+					std::string header = "If-Modified-Since: " + cached_.last_modified;
+					curl_headers_ = curl_slist_append(curl_headers_, header.c_str());
+				}
+			}
+
+			// curl only sends a post of unknown size chunked when asked to
+			if (upload_stream && upload_size < 0 && request_->GetType() == HttpRequest::Type::Post)
+			{
+				curl_headers_ = curl_slist_append(curl_headers_, "Transfer-Encoding: chunked");
+			}
+
+			if (curl_headers_ && !SetOption(CURLOPT_HTTPHEADER, curl_headers_))
+				return false;
+
+			if (!SetOption(CURLOPT_URL, url_.c_str())
+				|| !SetOption(CURLOPT_WRITEFUNCTION, &Curl::OnWrite)
+				|| !SetOption(CURLOPT_WRITEDATA, this)
+				|| !SetOption(CURLOPT_HEADERFUNCTION, write_data)
+				|| !SetOption(CURLOPT_HEADERDATA, &response_header_)
+				|| !SetOption(CURLOPT_NOPROGRESS, 0L)
+				|| !SetOption(CURLOPT_XFERINFOFUNCTION, &Curl::OnProgress)
+				|| !SetOption(CURLOPT_XFERINFODATA, this))
+				return false;
+
+			if (upload_stream
+				&& (!SetOption(CURLOPT_READFUNCTION, &Curl::OnRead) || !SetOption(CURLOPT_READDATA, this)))
+				return false;
+
+			// the body is sent from the request without a copy
+			const std::string& data = request_->GetRawData();
+
+			switch (request_->GetType())
+			{
+			case HttpRequest::Type::Get:
+				return SetOption(CURLOPT_FOLLOWLOCATION, 1L);
+			case HttpRequest::Type::Post:
+				if (upload_stream)
+				{
+					return SetOption(CURLOPT_POST, 1L)
+						&& SetOption(CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(upload_size));
+				}
+				return SetOption(CURLOPT_POST, 1L)
+					&& SetOption(CURLOPT_POSTFIELDS, data.c_str())
+					&& SetOption(CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(data.size()));
+			case HttpRequest::Type::Put:
+				if (upload_stream)
+				{
+					return SetOption(CURLOPT_UPLOAD, 1L)
+						&& SetOption(CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(upload_size));
+				}
+				return SetOption(CURLOPT_CUSTOMREQUEST, "PUT")
+					&& SetOption(CURLOPT_POSTFIELDS, data.c_str())
+					&& SetOption(CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(data.size()));
+			case HttpRequest::Type::Delete:
+				return SetOption(CURLOPT_CUSTOMREQUEST, "DELETE")
+					&& SetOption(CURLOPT_FOLLOWLOCATION, 1L);
+			default:
+				KGE_ERROR_LOG(L"HttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
+				return false;
+			}
+		}
+
+		Array<HttpResponsePtr> Complete(CURLcode result)
+		{
+			long response_code = 0;
+			if (curl_ && !fresh_)
+			{
+				curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &response_code);
 			}
 
-			return SetOption(CURLOPT_URL, url.c_str())
-				&& SetOption(CURLOPT_WRITEFUNCTION, write_data)
-				&& SetOption(CURLOPT_WRITEDATA, response_data)
-				&& SetOption(CURLOPT_HEADERFUNCTION, write_data)
-				&& SetOption(CURLOPT_HEADERDATA, response_header);
+			bool from_cache = false;
+			HttpBuffer data;
+			if (has_cached_ && (fresh_ || (result == CURLE_OK && response_code == 304)))
+			{
+				if (!fresh_)
+				{
+					cache_->Revalidate(cached_, response_header_);
+				}
+
+				result = CURLE_OK;
+				response_code = cached_.response_code;
+				response_header_ = std::move(cached_.header);
+				data = cached_.data;
+				from_cache = true;
+			}
+			else
+			{
+				data = std::make_shared<const std::string>(std::move(response_data_));
+
+				if (cache_ && result == CURLE_OK)
+				{
+					cache_->Store(cache_key_, response_code, response_header_, data);
+				}
+			}
+
+			bool ok = (result == CURLE_OK) && (response_code >= 200 && response_code < 300);
+
+			if (!request_->GetDownloadFile().empty())
+			{
+				// a resumed file that is already complete
+				if (result == CURLE_OK && response_code == 416 && resume_from_ > 0)
+				{
+					ok = true;
+				}
+
+				// an empty body still replaces the file
+				if (ok && !download_file_ && response_code != 206 && response_code != 416)
+				{
+					ok = OpenDownloadFile(response_code);
+				}
+
+				if (download_file_ && 0 != std::fclose(download_file_))
+				{
+					ok = false;
+				}
+				download_file_ = nullptr;
+			}
+			CloseFiles();
+
+			const String header = convert_from_utf8(response_header_);
+			const String error = ok ? String() : String(error_buffer_[0] ? error_buffer_ : curl_easy_strerror(result));
+
+			// every request that shares this transfer gets its own response
+			Array<HttpResponsePtr> responses;
+			for (size_t i = 0; i <= followers_.size(); ++i)
+			{
+				const bool last = (i == followers_.size());
+
+				HttpResponsePtr response = new (std::nothrow) HttpResponse(std::move(last ? request_ : followers_[i]));
+				if (!response)
+					continue;
+
+				response->SetResponseCode(response_code);
+				response->SetHeader(header);
+				response->SetData(data);
+				response->SetFromCache(from_cache);
+				response->SetSucceed(ok);
+				if (!ok)
+				{
+					response->SetError(error);
+				}
+				responses.push_back(std::move(response));
+			}
+			return responses;
 		}
 
-		bool Perform(long* response_code)
+		// responses of cacheable requests are stored in the cache
+		void SetCache(HttpCache* cache, std::string&& key)
 		{
-			if (CURLE_OK != curl_easy_perform(curl_))
+			cache_ = cache;
+			cache_key_ = std::move(key);
+		}
+
+		// a fresh entry completes without a transfer, a stale one is revalidated
+		void UseCacheEntry(HttpCache::Entry&& entry)
+		{
+			has_cached_ = true;
+			fresh_ = HttpCache::IsFresh(entry);
+			cached_ = std::move(entry);
+		}
+
+		inline bool IsFresh() const							{ return fresh_; }
+
+		inline std::string const& GetCacheKey() const		{ return cache_key_; }
+
+		// an identical request sent while this one is running
+		void AddFollower(HttpRequestPtr&& request)
+		{
+			followers_.push_back(std::move(request));
+		}
+
+		inline Array<HttpRequestPtr> const& GetFollowers() const	{ return followers_; }
+
+		bool IsCancelled() const
+		{
+			if (!request_->IsCancelled())
 				return false;
 
-			CURLcode code = curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, response_code);
-			return code == CURLE_OK && (*response_code >= 200 && *response_code < 300);
+			for (const auto& follower : followers_)
+			{
+				if (!follower->IsCancelled())
+					return false;
+			}
+			return true;
 		}
 
 		template <typename ..._Args>
@@ -165,77 +457,123 @@ namespace
 			return CURLE_OK == curl_easy_setopt(curl_, option, std::forward<_Args>(args)...);
 		}
 
-	public:
-		static inline bool GetRequest(
-			HttpClient* client,
-			Array<std::string> const& headers,
-			std::string const& url,
-			long* response_code,
-			std::string* response_data,
-			std::string* response_header,
-			char* error_buffer)
-		{
-			Curl curl;
-			return curl.Init(client, headers, url, response_data, response_header, error_buffer)
-				&& curl.SetOption(CURLOPT_FOLLOWLOCATION, true)
-				&& curl.Perform(response_code);
-		}
-
-		static inline bool PostRequest(
-			HttpClient* client,
-			Array<std::string> const& headers,
-			std::string const& url,
-			std::string const& request_data,
-			long* response_code,
-			std::string* response_data,
-			std::string* response_header,
-			char* error_buffer)
-		{
-			Curl curl;
-			return curl.Init(client, headers, url, response_data, response_header, error_buffer)
-				&& curl.SetOption(CURLOPT_POST, 1)
-				&& curl.SetOption(CURLOPT_POSTFIELDS, request_data.c_str())
-				&& curl.SetOption(CURLOPT_POSTFIELDSIZE, request_data.size())
-				&& curl.Perform(response_code);
-		}
-
-		static inline bool PutRequest(
-			HttpClient* client,
-			Array<std::string> const& headers,
-			std::string const& url,
-			std::string const& request_data,
-			long* response_code,
-			std::string* response_data,
-			std::string* response_header,
-			char* error_buffer)
-		{
-			Curl curl;
-			return curl.Init(client, headers, url, response_data, response_header, error_buffer)
-				&& curl.SetOption(CURLOPT_CUSTOMREQUEST, "PUT")
-				&& curl.SetOption(CURLOPT_POSTFIELDS, request_data.c_str())
-				&& curl.SetOption(CURLOPT_POSTFIELDSIZE, request_data.size())
-				&& curl.Perform(response_code);
-		}
-
-		static inline bool DeleteRequest(
-			HttpClient* client,
-			Array<std::string> const& headers,
-			std::string const& url,
-			long* response_code,
-			std::string* response_data,
-			std::string* response_header,
-			char* error_buffer)
-		{
-			Curl curl;
-			return curl.Init(client, headers, url, response_data, response_header, error_buffer)
-				&& curl.SetOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-				&& curl.SetOption(CURLOPT_FOLLOWLOCATION, true)
-				&& curl.Perform(response_code);
+		inline CURL* GetHandle() const					{ return curl_; }
+
+		inline HttpRequestPtr const& GetRequest() const	{ return request_; }
+
+		inline HttpProgress const& GetProgress() const	{ return progress_; }
+
+	private:
+		static size_t OnWrite(char* data, size_t size, size_t nmemb, void* userp)
+		{
+			const size_t total = size * nmemb;
+			return static_cast<Curl*>(userp)->Write(data, total) ? total : 0;
+		}
+
+		static size_t OnRead(char* buffer, size_t size, size_t nitems, void* userp)
+		{
+			Curl* curl = static_cast<Curl*>(userp);
+			const size_t total = size * nitems;
+
+			if (curl->upload_file_)
+			{
+				const size_t read = std::fread(buffer, 1, total, curl->upload_file_);
+				return std::ferror(curl->upload_file_) ? CURL_READFUNC_ABORT : read;
+			}
+			return std::min(curl->request_->GetUploadCallback()(buffer, total), total);
+		}
+
+		static int OnProgress(void* userp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+		{
+			Curl* curl = static_cast<Curl*>(userp);
+			curl->progress_.downloaded = curl->resume_from_ + dlnow;
+			curl->progress_.download_total = dltotal ? curl->resume_from_ + dltotal : 0;
+			curl->progress_.uploaded = ulnow;
+			curl->progress_.upload_total = ultotal;
+			return 0;
+		}
+
+		bool Write(const char* data, size_t size)
+		{
+			long response_code = 0;
+			curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &response_code);
+
+			// error pages are kept in the response
+			if (response_code < 200 || response_code >= 300)
+			{
+				response_data_.append(data, size);
+				return true;
+			}
+
+			if (request_->GetDataCallback())
+			{
+				return request_->GetDataCallback()(data, size);
+			}
+
+			if (!request_->GetDownloadFile().empty())
+			{
+				if (!download_file_ && !OpenDownloadFile(response_code))
+					return false;
+				return size == std::fwrite(data, 1, size, download_file_);
+			}
+
+			response_data_.append(data, size);
+			return true;
+		}
+
+		bool OpenDownloadFile(long response_code)
+		{
+			// the server may ignore the range and send the whole file
+			if (response_code != 206)
+			{
+				resume_from_ = 0;
+			}
+
+			const wchar_t* mode = resume_from_ > 0 ? L"ab" : L"wb";
+			download_file_ = open_file(request_->GetDownloadFile(), mode);
+			if (!download_file_)
+			{
+				KGE_ERROR_LOG(L"HttpClient: failed to open download file %s", request_->GetDownloadFile().c_str());
+				return false;
+			}
+			return true;
+		}
+
+		void CloseFiles()
+		{
+			if (upload_file_)
+			{
+				std::fclose(upload_file_);
+				upload_file_ = nullptr;
+			}
+
+			if (download_file_)
+			{
+				std::fclose(download_file_);
+				download_file_ = nullptr;
+			}
 		}
 
 	private:
 		CURL* curl_;
 		curl_slist* curl_headers_;
+		HttpRequestPtr request_;
+		std::string url_;
+		std::string response_data_;
+		std::string response_header_;
+		char error_buffer_[CURL_ERROR_SIZE];
+
+		std::FILE* upload_file_;
+		std::FILE* download_file_;
+		long long resume_from_;
+		HttpProgress progress_;
+
+		HttpCache* cache_;
+		std::string cache_key_;
+		HttpCache::Entry cached_;
+		bool has_cached_;
+		bool fresh_;
+		Array<HttpRequestPtr> followers_;
 	};
 }
 
@@ -243,9 +581,33 @@ namespace kiwano
 {
 	namespace network
 	{
+		void HttpRequest::SetData(String const& data)
+		{
+			data_ = convert_to_utf8(data);
+		}
+
+		String HttpRequest::GetData() const
+		{
+			return convert_from_utf8(data_);
+		}
+
+		String HttpResponse::GetData() const
+		{
+			return convert_from_utf8(GetRawData());
+		}
+
+		std::string const& HttpResponse::GetRawData() const
+		{
+			static const std::string empty;
+			return response_data_ ? *response_data_ : empty;
+		}
+
 		HttpClient::HttpClient()
 			: timeout_for_connect_(30000 /* 30 seconds */)
 			, timeout_for_read_(60000 /* 60 seconds */)
+			, quit_(false)
+			, max_concurrent_requests_(8)
+			, max_connections_per_host_(4)
 		{
 		}
 
@@ -253,12 +615,25 @@ namespace kiwano
 		{
 			::curl_global_init(CURL_GLOBAL_ALL);
 
-			std::thread thread(MakeClosure(this, &HttpClient::NetworkThread));
-			thread.detach();
+			quit_ = false;
+			network_thread_ = std::thread(MakeClosure(this, &HttpClient::NetworkThread));
 		}
 
 		void HttpClient::DestroyComponent()
 		{
+			{
+				std::lock_guard<std::mutex> lock(request_mutex_);
+				quit_ = true;
+			}
+			sleep_condition_.notify_one();
+
+			if (network_thread_.joinable())
+			{
+				network_thread_.join();
+			}
+
+			retired_caches_.clear();
+
 			::curl_global_cleanup();
 		}
 
@@ -267,87 +642,286 @@ namespace kiwano
 			if (!request)
 				return;
 
-			request_mutex_.lock();
-			request_queue_.push(request);
-			request_mutex_.unlock();
+			request->cancelled_ = false;
+
+			{
+				std::lock_guard<std::mutex> lock(request_mutex_);
+
+				// requests with the same priority are sent in order
+				auto iter = std::upper_bound(request_queue_.begin(), request_queue_.end(), request,
+					[](HttpRequestPtr const& lhs, HttpRequestPtr const& rhs) { return lhs->GetPriority() > rhs->GetPriority(); });
+				request_queue_.insert(iter, request);
+			}
 
 			sleep_condition_.notify_one();
 		}
 
+		void HttpClient::SetMaxConcurrentRequests(size_t count)
+		{
+			std::lock_guard<std::mutex> lock(request_mutex_);
+			max_concurrent_requests_ = std::max(count, size_t(1));
+		}
+
+		size_t HttpClient::GetMaxConcurrentRequests() const
+		{
+			std::lock_guard<std::mutex> lock(request_mutex_);
+			return max_concurrent_requests_;
+		}
+
+		void HttpClient::SetMaxConnectionsPerHost(size_t count)
+		{
+			std::lock_guard<std::mutex> lock(request_mutex_);
+			max_connections_per_host_ = count;
+		}
+
+		size_t HttpClient::GetMaxConnectionsPerHost() const
+		{
+			std::lock_guard<std::mutex> lock(request_mutex_);
+			return max_connections_per_host_;
+		}
+
+		void HttpClient::SetCache(HttpCachePtr cache)
+		{
+			std::lock_guard<std::mutex> lock(request_mutex_);
+
+			// the network thread may still use the old cache
+			if (cache_)
+			{
+				cache_->Flush();
+				retired_caches_.push_back(cache_);
+			}
+			cache_ = cache;
+		}
+
+		HttpCachePtr HttpClient::GetCache() const
+		{
+			std::lock_guard<std::mutex> lock(request_mutex_);
+			return cache_;
+		}
+
 		void HttpClient::NetworkThread()
 		{
+			// the multi handle keeps a connection cache, so connections are reused across requests
+			CURLM* multi = ::curl_multi_init();
+
+			// dns and tls sessions are shared by all transfers, only this thread uses them
+			CURLSH* share = ::curl_share_init();
+			::curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+			::curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+			size_t connections_per_host = 0;
+			Array<Curl*> transfers;
+			Array<HttpRequestPtr> requests;
+			HttpCache* cache = nullptr;
+
+			// cacheable transfers in flight, identical requests wait for them
+			UnorderedMap<std::string, Curl*> pending;
+
+			auto update_progress = [&](Curl* curl)
+			{
+				UpdateProgress(curl->GetRequest(), curl->GetProgress());
+				for (const auto& follower : curl->GetFollowers())
+				{
+					UpdateProgress(follower, curl->GetProgress());
+				}
+			};
+
+			// reference counts are not atomic, so requests are only moved on this thread
+			// and every request goes back to the main thread in a response, even a cancelled one
+			auto finish = [&](Curl* curl, CURLcode result)
+			{
+				update_progress(curl);
+
+				auto iter = pending.find(curl->GetCacheKey());
+				if (iter != pending.end() && iter->second == curl)
+				{
+					pending.erase(iter);
+				}
+
+				Array<HttpResponsePtr> responses = curl->Complete(result);
+				delete curl;
+
+				for (auto& response : responses)
+				{
+					response_mutex_.lock();
+					response_queue_.push(std::move(response));
+					response_mutex_.unlock();
+
+					PerformQueue::Instance().Push(MakeClosure(this, &HttpClient::DispatchResponseCallback));
+				}
+			};
+
 			while (true)
 			{
-				HttpRequestPtr request;
 				{
-					std::lock_guard<std::mutex> lock(request_mutex_);
-					while (request_queue_.empty())
+					std::unique_lock<std::mutex> lock(request_mutex_);
+
+					if (transfers.empty())
+					{
+						sleep_condition_.wait(lock, [this]() { return quit_ || !request_queue_.empty(); });
+					}
+
+					if (quit_)
+						break;
+
+					cache = cache_.Get();
+
+					if (connections_per_host != max_connections_per_host_)
 					{
-						sleep_condition_.wait(request_mutex_);
+						connections_per_host = max_connections_per_host_;
+						::curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(connections_per_host));
+					}
+
+					while (transfers.size() + requests.size() < max_concurrent_requests_ && !request_queue_.empty())
+					{
+						requests.push_back(std::move(request_queue_.front()));
+						request_queue_.erase(request_queue_.begin());
 					}
-					request = request_queue_.front();
-					request_queue_.pop();
 				}
 
-				HttpResponsePtr response = new (std::nothrow) HttpResponse(request);
-				Perform(request, response);
+				for (auto& request : requests)
+				{
+					std::string cache_key;
+					if (cache && !request->IsCancelled() && is_cacheable(*request))
+					{
+						cache_key = get_cache_key(*request);
+
+						auto iter = pending.find(cache_key);
+						if (iter != pending.end())
+						{
+							iter->second->AddFollower(std::move(request));
+							continue;
+						}
+					}
 
-				response_mutex_.lock();
-				response_queue_.push(response);
-				response_mutex_.unlock();
+					Curl* curl = new (std::nothrow) Curl(std::move(request));
+					if (!curl)
+						continue;
 
-				Application::PreformInMainThread(MakeClosure(this, &HttpClient::DispatchResponseCallback));
-			}
-		}
+					if (!cache_key.empty())
+					{
+						HttpCache::Entry entry;
+						if (cache->Lookup(cache_key, entry))
+						{
+							curl->UseCacheEntry(std::move(entry));
+						}
+						curl->SetCache(cache, std::move(cache_key));
+					}
 
-		void HttpClient::Perform(HttpRequestPtr request, HttpResponsePtr response)
-		{
-			bool ok = false;
-			long response_code = 0;
-			char error_message[256] = { 0 };
-			std::string response_header;
-			std::string response_data;
+					if (curl->GetRequest()->IsCancelled())
+					{
+						finish(curl, CURLE_ABORTED_BY_CALLBACK);
+					}
+					else if (curl->IsFresh())
+					{
+						finish(curl, CURLE_OK);
+					}
+					else if (curl->Init(this, share) && CURLM_OK == ::curl_multi_add_handle(multi, curl->GetHandle()))
+					{
+						transfers.push_back(curl);
 
-			std::string url = convert_to_utf8(request->GetUrl());
-			std::string data = convert_to_utf8(request->GetData());
+						if (!curl->GetCacheKey().empty())
+						{
+							pending[curl->GetCacheKey()] = curl;
+						}
+					}
+					else
+					{
+						finish(curl, CURLE_FAILED_INIT);
+					}
+				}
+				requests.clear();
 
-			Array<std::string> headers;
-			headers.reserve(request->GetHeaders().size());
-			for (const auto& pair : request->GetHeaders())
-			{
-				headers.push_back(pair.first.to_string() + ":" + pair.second.to_string());
-			}
+				// drop cancelled transfers
+				for (auto iter = transfers.begin(); iter != transfers.end();)
+				{
+					if ((*iter)->IsCancelled())
+					{
+						::curl_multi_remove_handle(multi, (*iter)->GetHandle());
+						finish(*iter, CURLE_ABORTED_BY_CALLBACK);
+						iter = transfers.erase(iter);
+					}
+					else
+					{
+						++iter;
+					}
+				}
 
-			switch (request->GetType())
-			{
-			case HttpRequest::Type::Get:
-				ok = Curl::GetRequest(this, headers, url, &response_code, &response_data, &response_header, error_message);
-				break;
-			case HttpRequest::Type::Post:
-				ok = Curl::PostRequest(this, headers, url, data, &response_code, &response_data, &response_header, error_message);
-				break;
-			case HttpRequest::Type::Put:
-				ok = Curl::PutRequest(this, headers, url, data, &response_code, &response_data, &response_header, error_message);
-				break;
-			case HttpRequest::Type::Delete:
-				ok = Curl::DeleteRequest(this, headers, url, &response_code, &response_data, &response_header, error_message);
-				break;
-			default:
-				KGE_ERROR_LOG(L"HttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
-				return;
+				int running = 0;
+				::curl_multi_perform(multi, &running);
+
+				int left = 0;
+				while (CURLMsg* msg = ::curl_multi_info_read(multi, &left))
+				{
+					if (msg->msg != CURLMSG_DONE)
+						continue;
+
+					Curl* curl = nullptr;
+					::curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &curl);
+
+					// the message is invalid after the handle is removed
+					CURLcode result = msg->data.result;
+					::curl_multi_remove_handle(multi, msg->easy_handle);
+
+					transfers.erase(std::find(transfers.begin(), transfers.end(), curl));
+					finish(curl, result);
+				}
+
+				for (auto curl : transfers)
+				{
+					update_progress(curl);
+				}
+
+				// new requests are picked up at the latest when the wait times out
+				if (!transfers.empty())
+				{
+					::curl_multi_wait(multi, nullptr, 0, 10, nullptr);
+				}
 			}
 
-			response->SetResponseCode(response_code);
-			response->SetHeader(response_header);
-			response->SetData(convert_from_utf8(response_data));
-			if (!ok)
+			for (auto curl : transfers)
 			{
-				response->SetSucceed(false);
-				response->SetError(error_message);
+				::curl_multi_remove_handle(multi, curl->GetHandle());
+
+				curl->GetRequest()->Cancel();
+				for (const auto& follower : curl->GetFollowers())
+				{
+					follower->Cancel();
+				}
+				finish(curl, CURLE_ABORTED_BY_CALLBACK);
 			}
-			else
+
+			::curl_multi_cleanup(multi);
+			::curl_share_cleanup(share);
+		}
+
+		void HttpClient::UpdateProgress(HttpRequestPtr const& request, HttpProgress const& progress)
+		{
+			if (request->downloaded_ == progress.downloaded && request->download_total_ == progress.download_total
+				&& request->uploaded_ == progress.uploaded && request->upload_total_ == progress.upload_total)
+				return;
+
+			request->downloaded_ = progress.downloaded;
+			request->download_total_ = progress.download_total;
+			request->uploaded_ = progress.uploaded;
+			request->upload_total_ = progress.upload_total;
+
+			// at most one pending callback per request, it reads the latest progress
+			// the request stays alive until its response, which is dispatched after this callback
+			if (request->GetProgressCallback() && !request->progress_pending_.exchange(true))
 			{
-				response->SetSucceed(true);
+				HttpRequest* ptr = request.Get();
+				PerformQueue::Instance().Push([ptr]()
+				{
+					HttpRequestPtr request = ptr;
+					request->progress_pending_ = false;
+
+					const auto& callback = request->GetProgressCallback();
+					if (callback && !request->IsCancelled())
+					{
+						callback(request, request->GetProgress());
+					}
+				});
 			}
 		}
 
@@ -368,7 +942,7 @@ namespace kiwano
 				HttpRequestPtr request = response->GetRequest();
 				const auto& callback = request->GetResponseCallback();
 
-				if (callback)
+				if (callback && !request->IsCancelled())
 				{
 					callback(request, response);
 				}
@@ -19,13 +19,21 @@
 // THE SOFTWARE.
 
 #pragma once
+#include "HttpResponse.h"
+#include "HttpCache.h"
+#include "../base/time.h"
+#include "../base/Component.h"
+#include "../common/Singleton.hpp"
 #include <mutex>
+#include <thread>
 #include <condition_variable>
 
 namespace kiwano
 {
 	namespace network
 	{
+		// HTTP 客户端
+		// 请求在网络线程中并发执行, 同一主机的连接和 TLS 会话会被复用
 		class KGE_API HttpClient
 			: public Singleton<HttpClient>
 			, public Component
@@ -33,10 +41,33 @@ namespace kiwano
 			KGE_DECLARE_SINGLETON(HttpClient);
 
 		public:
+			// 发送请求
 			void Send(
 				HttpRequestPtr request
 			);
 
+			// 设置同时进行的最大请求数量, 默认为 8
+			void SetMaxConcurrentRequests(
+				size_t count
+			);
+
+			size_t GetMaxConcurrentRequests() const;
+
+			// 设置同一主机的最大连接数量, 默认为 4
+			void SetMaxConnectionsPerHost(
+				size_t count
+			);
+
+			size_t GetMaxConnectionsPerHost() const;
+
+			// 设置 HTTP 缓存, 为空时不使用缓存
+			// 使用缓存时, 同时发送的相同 GET 请求只会访问一次网络
+			void SetCache(
+				HttpCachePtr cache
+			);
+
+			HttpCachePtr GetCache() const;
+
 			inline void SetTimeoutForConnect(Duration timeout)
 			{
 				timeout_for_connect_ = timeout;
@@ -77,9 +108,9 @@ namespace kiwano
 
 			void NetworkThread();
 
-			void Perform(
-				HttpRequestPtr request,
-				HttpResponsePtr response
+			void UpdateProgress(
+				HttpRequestPtr const& request,
+				HttpProgress const& progress
 			);
 
 			void DispatchResponseCallback();
@@ -90,8 +121,17 @@ namespace kiwano
 
 			String ssl_verification_;
 
-			std::mutex request_mutex_;
-			Queue<HttpRequestPtr> request_queue_;
+			bool quit_;
+			size_t max_concurrent_requests_;
+			size_t max_connections_per_host_;
+			std::thread network_thread_;
+
+			// 按优先级排列的待发送请求
+			mutable std::mutex request_mutex_;
+			Array<HttpRequestPtr> request_queue_;
+
+			HttpCachePtr cache_;
+			Array<HttpCachePtr> retired_caches_;
 
 			std::mutex response_mutex_;
 			Queue<HttpResponsePtr> response_queue_;
@@ -19,6 +19,11 @@
 // THE SOFTWARE.
 
 #pragma once
+#include "helper.h"
+#include "../base/Object.h"
+#include "../common/closure.hpp"
+#include "../common/Json.h"
+#include <atomic>
 
 namespace kiwano
 {
@@ -26,6 +31,23 @@ namespace kiwano
 	{
 		typedef Closure<void(HttpRequestPtr, HttpResponsePtr)> ResponseCallback;
 
+		// 传输进度, 总大小未知时为 0
+		struct HttpProgress
+		{
+			long long downloaded;
+			long long download_total;
+			long long uploaded;
+			long long upload_total;
+		};
+
+		typedef Closure<void(HttpRequestPtr, HttpProgress const&)> ProgressCallback;
+
+		// 接收数据回调, 在网络线程中执行, 返回 false 时中断请求
+		typedef Closure<bool(const char* data, size_t size)> DataCallback;
+
+		// 上传数据回调, 在网络线程中执行, 返回写入 buffer 的字节数, 返回 0 表示数据结束
+		typedef Closure<size_t(char* buffer, size_t size)> UploadCallback;
+
 		class KGE_API HttpRequest
 			: public Object
 		{
@@ -40,13 +62,22 @@ namespace kiwano
 			};
 
 			inline HttpRequest()
-				: type_(Type::Unknown)
+				: HttpRequest(Type::Unknown)
 			{
 
 			}
 
 			inline HttpRequest(Type type)
 				: type_(type)
+				, priority_(0)
+				, cancelled_(false)
+				, upload_size_(-1)
+				, download_resume_(false)
+				, progress_pending_(false)
+				, downloaded_(0)
+				, download_total_(0)
+				, uploaded_(0)
+				, upload_total_(0)
 			{
 
 			}
@@ -71,22 +102,104 @@ namespace kiwano
 				return type_;
 			}
 
-			inline void SetData(String const& data)
+			// 设置文本数据, 以 UTF-8 编码发送
+			void SetData(String const& data);
+
+			// 设置二进制数据
+			inline void SetData(const void* data, size_t size)
 			{
-				data_ = data;
+				data_.assign(static_cast<const char*>(data), size);
 			}
 
 			inline void SetJsonData(Json const& json)
 			{
 				SetHeader(L"Content-Type", L"application/json;charset=UTF-8");
-				data_ = json.dump();
+				SetData(json.dump());
 			}
 
-			inline String const& GetData() const
+			String GetData() const;
+
+			inline std::string const& GetRawData() const
 			{
 				return data_;
 			}
 
+			// 从文件上传数据, 文件在发送时读取
+			inline void SetUploadFile(String const& file_path)
+			{
+				upload_file_ = file_path;
+				upload_cb_ = nullptr;
+			}
+
+			inline String const& GetUploadFile() const
+			{
+				return upload_file_;
+			}
+
+			// 从回调上传数据, 大小未知时使用分块传输
+			inline void SetUploadCallback(UploadCallback const& callback, long long size = -1)
+			{
+				upload_cb_ = callback;
+				upload_size_ = size;
+				upload_file_.clear();
+			}
+
+			inline UploadCallback const& GetUploadCallback() const
+			{
+				return upload_cb_;
+			}
+
+			inline long long GetUploadSize() const
+			{
+				return upload_size_;
+			}
+
+			// 将响应数据直接写入文件, 不再保存在响应中
+			// resume 为 true 时从已有文件的末尾继续下载 (服务器需支持 Range 请求)
+			inline void SetDownloadFile(String const& file_path, bool resume = false)
+			{
+				download_file_ = file_path;
+				download_resume_ = resume;
+			}
+
+			inline String const& GetDownloadFile() const
+			{
+				return download_file_;
+			}
+
+			inline bool IsDownloadResumable() const
+			{
+				return download_resume_;
+			}
+
+			// 设置接收数据回调, 响应数据不再保存在响应中
+			inline void SetDataCallback(DataCallback const& callback)
+			{
+				data_cb_ = callback;
+			}
+
+			inline DataCallback const& GetDataCallback() const
+			{
+				return data_cb_;
+			}
+
+			// 设置进度回调, 在主线程中执行
+			inline void SetProgressCallback(ProgressCallback const& callback)
+			{
+				progress_cb_ = callback;
+			}
+
+			inline ProgressCallback const& GetProgressCallback() const
+			{
+				return progress_cb_;
+			}
+
+			// 获取传输进度
+			inline HttpProgress GetProgress() const
+			{
+				return HttpProgress{ downloaded_, download_total_, uploaded_, upload_total_ };
+			}
+
 			inline void SetHeaders(Map<String, String> const& headers)
 			{
 				headers_ = headers;
@@ -110,6 +223,11 @@ namespace kiwano
 				return headers_;
 			}
 
+			inline Map<String, String> const& GetHeaders() const
+			{
+				return headers_;
+			}
+
 			inline String const& GetHeader(String const& header) const
 			{
 				return headers_.at(header);
@@ -125,12 +243,55 @@ namespace kiwano
 				return response_cb_;
 			}
 
+			// 设置优先级
+			// 优先级高的请求先发送, 默认为 0
+			inline void SetPriority(int priority)
+			{
+				priority_ = priority;
+			}
+
+			inline int GetPriority() const
+			{
+				return priority_;
+			}
+
+			// 取消请求
+			// 未完成的请求会被中断, 且不再执行回调
+			inline void Cancel()
+			{
+				cancelled_ = true;
+			}
+
+			inline bool IsCancelled() const
+			{
+				return cancelled_;
+			}
+
 		protected:
+			friend class HttpClient;
+
 			Type type_;
+			int priority_;
+			std::atomic<bool> cancelled_;
 			String url_;
-			String data_;
+			std::string data_;
 			Map<String, String> headers_;
 			ResponseCallback response_cb_;
+
+			String upload_file_;
+			UploadCallback upload_cb_;
+			long long upload_size_;
+			String download_file_;
+			bool download_resume_;
+			DataCallback data_cb_;
+			ProgressCallback progress_cb_;
+
+			// 由网络线程更新
+			std::atomic<bool> progress_pending_;
+			std::atomic<long long> downloaded_;
+			std::atomic<long long> download_total_;
+			std::atomic<long long> uploaded_;
+			std::atomic<long long> upload_total_;
 		};
 	}
 }
@@ -19,6 +19,7 @@
 // THE SOFTWARE.
 
 #pragma once
+#include "HttpRequest.h"
 
 namespace kiwano
 {
@@ -29,8 +30,9 @@ namespace kiwano
 		{
 		public:
 			inline HttpResponse(HttpRequestPtr request)
-				: request_(request)
+				: request_(std::move(request))
 				, succeed_(false)
+				, from_cache_(false)
 				, response_code_(0)
 			{
 			}
@@ -70,14 +72,27 @@ namespace kiwano
 				return response_header_;
 			}
 
-			inline void SetData(String const& response_data)
+			inline void SetData(HttpBuffer const& response_data)
 			{
 				response_data_ = response_data;
 			}
 
-			inline String const& GetData() const
+			// 获取文本数据, 按 UTF-8 解码
+			String GetData() const;
+
+			// 获取二进制数据
+			// 数据写入文件或接收数据回调时为空
+			std::string const& GetRawData() const;
+
+			inline void SetFromCache(bool from_cache)
+			{
+				from_cache_ = from_cache;
+			}
+
+			// 响应是否来自缓存
+			inline bool IsFromCache() const
 			{
-				return response_data_;
+				return from_cache_;
 			}
 
 			inline void SetError(String const& error_buffer)
@@ -92,11 +107,12 @@ namespace kiwano
 
 		protected:
 			bool succeed_;
+			bool from_cache_;
 			long response_code_;
 			HttpRequestPtr request_;
 
 			String response_header_;
-			String response_data_;
+			HttpBuffer response_data_;
 			String error_buffer_;
 		};
 	}
@@ -19,6 +19,9 @@
 // THE SOFTWARE.
 
 #pragma once
+#include "../base/SmartPtr.hpp"
+#include <memory>
+#include <string>
 
 namespace kiwano
 {
@@ -26,5 +29,9 @@ namespace kiwano
 	{
 		KGE_DECLARE_SMART_PTR(HttpRequest);
 		KGE_DECLARE_SMART_PTR(HttpResponse);
+		KGE_DECLARE_SMART_PTR(HttpCache);
+
+		// 响应数据, 在缓存和响应之间共享
+		typedef std::shared_ptr<const std::string> HttpBuffer;
 	}
 }
@@ -23,34 +23,23 @@
 #include "../base/logs.h"
 #include "../base/input.h"
 #include "../base/Event.hpp"
+#include "../base/ThreadPool.h"
 #include "../renderer/render.h"
 #include "../2d/Scene.h"
 #include "../2d/DebugNode.h"
 #include "../2d/Transition.h"
 #include <windowsx.h>  // GET_X_LPARAM, GET_Y_LPARAM
 #include <imm.h>  // ImmAssociateContext
-#include <mutex>  // std::mutex
 
 #pragma comment(lib, "imm32.lib")
 
-namespace kiwano
-{
-	using FunctionToPerform = Closure<void()>;
-
-	namespace
-	{
-		std::mutex				 perform_mutex_;
-		Queue<FunctionToPerform> functions_to_perform_;
-	}
-}
-
 namespace kiwano
 {
 	Application::Application()
 		: end_(true)
 		, inited_(false)
+		, headless_(false)
 		, main_window_(nullptr)
-		, time_scale_(1.f)
 	{
 		ThrowIfFailed(
 			::CoInitialize(nullptr)
@@ -60,6 +49,7 @@ namespace kiwano
 
 		Use(&Renderer::Instance());
 		Use(&Input::Instance());
+		Use(&ThreadPool::Instance());
 	}
 
 	Application::~Application()
@@ -71,16 +61,25 @@ namespace kiwano
 
 	void Application::Init(const Options& options)
 	{
-		ThrowIfFailed(
-			main_window_->Create(
-				options.title,
-				options.width,
-				options.height,
-				options.icon,
-				options.fullscreen,
-				Application::WndProc
-			)
-		);
+		headless_ = options.headless;
+
+		if (headless_)
+		{
+			Renderer::Instance().Resize(options.width, options.height);
+		}
+		else
+		{
+			ThrowIfFailed(
+				main_window_->Create(
+					options.title,
+					options.width,
+					options.height,
+					options.icon,
+					options.fullscreen,
+					Application::WndProc
+				)
+			);
+		}
 
 		Renderer::Instance().SetClearColor(options.clear_color);
 		Renderer::Instance().SetVSyncEnabled(options.vsync);
@@ -94,19 +93,36 @@ namespace kiwano
 		// Everything is ready
 		OnStart();
 
-		HWND hwnd = main_window_->GetHandle();
+		if (!headless_)
+		{
+			HWND hwnd = main_window_->GetHandle();
 
-		// disable imm
-		::ImmAssociateContext(hwnd, nullptr);
+			// disable imm
+			::ImmAssociateContext(hwnd, nullptr);
 
-		// use Application instance in message loop
-		::SetWindowLongPtr(hwnd, GWLP_USERDATA, LONG_PTR(this));
+			// use Application instance in message loop
+			::SetWindowLongPtr(hwnd, GWLP_USERDATA, LONG_PTR(this));
+		}
 
 		inited_ = true;
 	}
 
 	void Application::Run()
 	{
+		if (headless_)
+		{
+			if (!inited_)
+				throw std::exception("Calling Application::Run before Application::Init");
+
+			end_ = false;
+			while (!end_)
+			{
+				Update();
+				Render();
+			}
+			return;
+		}
+
 		HWND hwnd = main_window_->GetHandle();
 
 		if (!hwnd)
@@ -131,6 +147,25 @@ namespace kiwano
 		end_ = true;
 	}
 
+	void Application::Step(Duration dt)
+	{
+		KGE_ASSERT(inited_ && "Calling Application::Step before Application::Init");
+
+		UpdateFrame(dt);
+		Render();
+	}
+
+	void Application::InjectEvent(Event& evt)
+	{
+		Input::Instance().HandleEvent(evt);
+
+		// input events are blocked during transitions, as in the window procedure
+		if (transition_ && !WindowEvent::Check(evt.type))
+			return;
+
+		DispatchEvent(evt);
+	}
+
 	void Application::Destroy()
 	{
 		transition_.Reset();
@@ -219,7 +254,12 @@ namespace kiwano
 
 	void Application::SetTimeScale(float scale_factor)
 	{
-		time_scale_ = scale_factor;
+		stepper_.SetTimeScale(scale_factor);
+	}
+
+	void Application::SetFixedTimeStep(Duration step, int max_steps_per_frame)
+	{
+		stepper_.SetFixedTimeStep(step, max_steps_per_frame);
 	}
 
 	void Application::ShowDebugInfo(bool show)
@@ -241,9 +281,31 @@ namespace kiwano
 		static auto last = Time::Now();
 
 		const auto now = Time::Now();
-		const auto dt = (now - last) * time_scale_;
+		const auto dt = now - last;
 		last = now;
 
+		UpdateFrame(dt);
+	}
+
+	void Application::UpdateFrame(Duration dt)
+	{
+		const int steps = stepper_.Update(dt, MakeClosure(this, &Application::UpdateStep));
+
+		// keep key states until a step has seen them
+		if (steps)
+			Input::Instance().Update();
+	}
+
+	void Application::DispatchEvent(Event& evt)
+	{
+		if (!curr_scene_)
+			return;
+
+		stepper_.Dispatch([&]() { curr_scene_->Dispatch(evt); });
+	}
+
+	void Application::UpdateStep(Duration dt)
+	{
 		if (transition_)
 		{
 			transition_->Update(dt);
@@ -265,26 +327,6 @@ namespace kiwano
 			next_scene_ = nullptr;
 		}
 
-		// perform functions
-		{
-			if (!functions_to_perform_.empty())
-			{
-				perform_mutex_.lock();
-				auto functions = std::move(functions_to_perform_);
-				perform_mutex_.unlock();
-
-				while (!functions.empty())
-				{
-					auto& func = functions.front();
-					if (func)
-					{
-						func();
-					}
-					functions.pop();
-				}
-			}
-		}
-
 		OnUpdate(dt);
 
 		if (curr_scene_)
@@ -295,11 +337,14 @@ namespace kiwano
 
 		if (debug_node_)
 			debug_node_->Update(dt);
-
-		Input::Instance().Update();
 	}
 
 	void Application::Render()
+	{
+		stepper_.Render(MakeClosure(this, &Application::RenderFrame));
+	}
+
+	void Application::RenderFrame()
 	{
 		ThrowIfFailed(
 			Renderer::Instance().BeginDraw()
@@ -324,10 +369,19 @@ namespace kiwano
 		);
 	}
 
-	void Application::PreformInMainThread(Closure<void()> function)
+	void Application::SetPerformTimeBudget(Duration budget)
+	{
+		stepper_.SetPerformTimeBudget(budget);
+	}
+
+	void Application::PreformInMainThread(Closure<void()> function, PerformPriority priority)
+	{
+		PerformQueue::Instance().Push(std::move(function), priority);
+	}
+
+	PerformStats const& Application::GetPerformStats()
 	{
-		std::lock_guard<std::mutex> lock(perform_mutex_);
-		functions_to_perform_.push(function);
+		return PerformQueue::Instance().GetStats();
 	}
 
 	LRESULT CALLBACK Application::WndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
@@ -365,7 +419,7 @@ namespace kiwano
 				evt.key.code = static_cast<int>(wparam);
 				evt.key.count = static_cast<int>(lparam & 0xFF);
 
-				app->curr_scene_->Dispatch(evt);
+				app->DispatchEvent(evt);
 			}
 		}
 		break;
@@ -378,7 +432,7 @@ namespace kiwano
 				evt.key.c = static_cast<char>(wparam);
 				evt.key.count = static_cast<int>(lparam & 0xFF);
 
-				app->curr_scene_->Dispatch(evt);
+				app->DispatchEvent(evt);
 			}
 		}
 		break;
@@ -417,7 +471,7 @@ namespace kiwano
 				else if (msg == WM_RBUTTONDOWN || msg == WM_RBUTTONUP) { evt.mouse.button = MouseButton::Right; }
 				else if (msg == WM_MBUTTONDOWN || msg == WM_MBUTTONUP) { evt.mouse.button = MouseButton::Middle; }
 
-				app->curr_scene_->Dispatch(evt);
+				app->DispatchEvent(evt);
 			}
 
 			if (msg == WM_MOUSEMOVE)
@@ -450,7 +504,7 @@ namespace kiwano
 					Event evt(Event::WindowResized);
 					evt.win.width = static_cast<int>(width);
 					evt.win.height = static_cast<int>(height);
-					app->curr_scene_->Dispatch(evt);
+					app->DispatchEvent(evt);
 				}
 
 				app->GetWindow()->UpdateWindowRect();
@@ -468,7 +522,7 @@ namespace kiwano
 				Event evt(Event::WindowMoved);
 				evt.win.x = x;
 				evt.win.y = y;
-				app->curr_scene_->Dispatch(evt);
+				app->DispatchEvent(evt);
 			}
 		}
 		break;
@@ -483,7 +537,7 @@ namespace kiwano
 			{
 				Event evt(Event::WindowFocusChanged);
 				evt.win.focus = active;
-				app->curr_scene_->Dispatch(evt);
+				app->DispatchEvent(evt);
 			}
 		}
 		break;
@@ -496,7 +550,7 @@ namespace kiwano
 			{
 				Event evt(Event::WindowTitleChanged);
 				evt.win.title = reinterpret_cast<const wchar_t*>(lparam);
-				app->curr_scene_->Dispatch(evt);
+				app->DispatchEvent(evt);
 			}
 		}
 		break;
@@ -533,7 +587,7 @@ namespace kiwano
 			if (app->curr_scene_)
 			{
 				Event evt(Event::WindowClosed);
-				app->curr_scene_->Dispatch(evt);
+				app->DispatchEvent(evt);
 			}
 
 			app->OnDestroy();
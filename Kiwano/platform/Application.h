@@ -23,18 +23,22 @@
 #include "../base/time.h"
 #include "../base/window.h"
 #include "../base/Component.h"
+#include "../base/Event.hpp"
+#include "../base/PerformQueue.h"
+#include "../base/FrameStepper.h"
 
 namespace kiwano
 {
 	struct Options
 	{
-		String	title;				// 
-		int		width;				// 
-		int		height;				// ߶
-		LPCWSTR	icon;				// ͼ
-		Color	clear_color;		// ɫ
-		bool	vsync;				// ֱͬ
-		bool	fullscreen;			// ȫģʽ
+		String	title;				// 标题
+		int		width;				// 宽度
+		int		height;				// 高度
+		LPCWSTR	icon;				// 图标
+		Color	clear_color;		// 清屏颜色
+		bool	vsync;				// 垂直同步
+		bool	fullscreen;			// 全屏模式
+		bool	headless;			// 无窗口模式
 
 		Options(
 			String const& title = L"Kiwano Game",
@@ -43,7 +47,8 @@ namespace kiwano
 			LPCWSTR icon = nullptr,
 			Color clear_color = Color::Black,
 			bool vsync = true,
-			bool fullscreen = false
+			bool fullscreen = false,
+			bool headless = false
 		)
 			: title(title)
 			, width(width)
@@ -52,6 +57,7 @@ namespace kiwano
 			, clear_color(clear_color)
 			, vsync(vsync)
 			, fullscreen(fullscreen)
+			, headless(headless)
 		{}
 	};
 
@@ -64,89 +70,147 @@ namespace kiwano
 
 		virtual ~Application();
 
-		// ʼ
+		// 初始化
 		void Init(
 			Options const& options
 		);
 
-		// ʱ
+		// 启动时
 		virtual void OnStart() {}
 
-		// رʱ
+		// 关闭时
 		virtual bool OnClosing() { return true; }
 
-		// ʱ
+		// 销毁时
 		virtual void OnDestroy() {}
 
-		// Ⱦʱ
+		// 渲染时
 		virtual void OnRender() {}
 
-		// ʱ
+		// 更新时
 		virtual void OnUpdate(Duration dt) { KGE_NOT_USED(dt); }
 
-		// 
+		// 运行
+		// 无窗口模式下以真实时间循环更新, 直到调用 Quit
 		void Run();
 
-		// 
+		// 步进一帧
+		// 以指定的时间间隔更新并渲染一帧, 用于无窗口模式下的测试
+		void Step(
+			Duration dt
+		);
+
+		// 注入输入事件
+		// 更新输入状态并将事件分发到当前场景, 用于无窗口模式下模拟输入
+		void InjectEvent(
+			Event& evt
+		);
+
+		// 结束
 		void Quit();
 
-		// 
+		// 销毁
 		void Destroy();
 
-		// 
+		// 添加组件
 		void Use(
 			Component* component
 		);
 
-		// ж
+		// 卸载组件
 		void Remove(
 			Component* component
 		);
 
-		// л
+		// 切换场景
 		void EnterScene(
-			ScenePtr scene				/*  */
+			ScenePtr scene				/* 场景 */
 		);
 
-		// л
+		// 切换场景
 		void EnterScene(
-			ScenePtr scene,				/*  */
-			TransitionPtr transition	/*  */
+			ScenePtr scene,				/* 场景 */
+			TransitionPtr transition	/* 场景动画 */
 		);
 
-		// ȡǰ
+		// 获取当前场景
 		ScenePtr GetCurrentScene();
 
-		// ȡ
+		// 获取主窗口
 		inline Window* GetWindow() const { return main_window_; }
 
-		// ʱ
+		// 是否是无窗口模式
+		inline bool IsHeadless() const { return headless_; }
+
+		// 获取上一帧各阶段耗时
+		// 事件分发耗时为两次更新之间分发的所有事件的总耗时
+		inline FrameTimings const& GetFrameTimings() const { return stepper_.GetFrameTimings(); }
+
+		// 设置时间缩放因子
 		void SetTimeScale(
 			float scale_factor
 		);
 
-		// ʾϢ
+		// 设置固定时间步长
+		// 步长不为零时, 每帧按固定步长更新若干次, 剩余时间留到下一帧
+		// 默认为 0, 即每帧更新一次
+		void SetFixedTimeStep(
+			Duration step,
+			int max_steps_per_frame = 8	/* 每帧最多更新次数 */
+		);
+
+		// 获取固定时间步长
+		inline Duration GetFixedTimeStep() const		{ return stepper_.GetFixedTimeStep(); }
+
+		// 获取插值系数
+		// 固定步长模式下为剩余时间与步长之比, 范围 [0, 1), 用于渲染时在两次更新之间插值
+		inline float GetInterpolationAlpha() const		{ return stepper_.GetInterpolationAlpha(); }
+
+		// 显示调试信息
 		void ShowDebugInfo(
 			bool show = true
 		);
 
-		//  Kiwano ִ߳к
-		// ̵߳ Kiwano ʱʹ
+		// 设置每帧执行主线程函数的时间上限
+		// 超出时剩余的函数留到之后的帧执行, 每帧至少执行一个函数
+		// 默认为 0, 即每帧执行全部函数
+		void SetPerformTimeBudget(
+			Duration budget
+		);
+
+		// 获取每帧执行主线程函数的时间上限
+		inline Duration GetPerformTimeBudget() const	{ return stepper_.GetPerformTimeBudget(); }
+
+		// 在 Kiwano 主线程中执行函数
+		// 当在其他线程调用 Kiwano 函数时使用, 优先级高的函数先执行
 		static void PreformInMainThread(
-			Closure<void()> function
+			Closure<void()> function,
+			PerformPriority priority = PerformPriority::Normal
 		);
 
+		// 获取主线程函数的执行情况
+		static PerformStats const& GetPerformStats();
+
 	protected:
 		void Render();
 
+		void RenderFrame();
+
 		void Update();
 
+		void UpdateFrame(Duration dt);
+
+		void UpdateStep(Duration dt);
+
+		void DispatchEvent(Event& evt);
+
 		static LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 
 	protected:
 		bool			end_;
 		bool			inited_;
-		float			time_scale_;
+		bool			headless_;
+		FrameStepper	stepper_;
 
 		ScenePtr		curr_scene_;
 		ScenePtr		next_scene_;
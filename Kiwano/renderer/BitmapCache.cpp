@@ -0,0 +1,223 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "BitmapCache.h"
+
+namespace kiwano
+{
+	namespace
+	{
+		size_t GetBytesPerPixel(DXGI_FORMAT format)
+		{
+			switch (format)
+			{
+			case DXGI_FORMAT_A8_UNORM:
+			case DXGI_FORMAT_R8_UNORM:
+				return 1;
+			case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			case DXGI_FORMAT_R16G16B16A16_UNORM:
+				return 8;
+			case DXGI_FORMAT_R32G32B32A32_FLOAT:
+				return 16;
+			default:
+				return 4;
+			}
+		}
+	}
+
+	BitmapCache::BitmapCache(size_t budget)
+		: budget_(budget)
+		, resident_bytes_(0)
+		, pinned_count_(0)
+		, hits_(0)
+		, misses_(0)
+		, evictions_(0)
+	{
+	}
+
+	ComPtr<ID2D1Bitmap> BitmapCache::Get(size_t key)
+	{
+		auto iter = items_.find(key);
+		if (iter == items_.end())
+		{
+			++misses_;
+			return nullptr;
+		}
+
+		++hits_;
+		order_.splice(order_.begin(), order_, iter->second.order);
+		return iter->second.bitmap;
+	}
+
+	void BitmapCache::Put(size_t key, ComPtr<ID2D1Bitmap> const& bitmap)
+	{
+		if (!bitmap)
+			return;
+
+		bool pinned = false;
+		auto iter = items_.find(key);
+		if (iter != items_.end())
+		{
+			pinned = iter->second.pinned;
+			Remove(key);
+		}
+
+		const size_t bytes = GetBitmapBytes(bitmap.Get());
+
+		order_.push_front(key);
+		auto result = items_.insert(std::make_pair(key, Item{ bitmap, bytes, 0, pinned, order_.begin() }));
+		resident_bytes_ += bytes;
+		if (pinned)
+			++pinned_count_;
+
+		// the caller has not retained the new bitmap yet
+		Evict(&result.first->second);
+	}
+
+	bool BitmapCache::Retain(size_t key, ID2D1Bitmap* bitmap)
+	{
+		auto iter = items_.find(key);
+		if (iter == items_.end() || iter->second.bitmap.Get() != bitmap)
+			return false;
+
+		++iter->second.users;
+		return true;
+	}
+
+	bool BitmapCache::Release(size_t key, ID2D1Bitmap* bitmap)
+	{
+		// a replaced bitmap belongs to an older entry and is not counted any more
+		auto iter = items_.find(key);
+		if (iter == items_.end() || iter->second.bitmap.Get() != bitmap || !iter->second.users)
+			return false;
+
+		--iter->second.users;
+		return true;
+	}
+
+	bool BitmapCache::Remove(size_t key)
+	{
+		auto iter = items_.find(key);
+		if (iter == items_.end())
+			return false;
+
+		resident_bytes_ -= iter->second.bytes;
+		if (iter->second.pinned)
+			--pinned_count_;
+
+		order_.erase(iter->second.order);
+		items_.erase(iter);
+		return true;
+	}
+
+	bool BitmapCache::SetPinned(size_t key, bool pinned)
+	{
+		auto iter = items_.find(key);
+		if (iter == items_.end())
+			return false;
+
+		if (iter->second.pinned != pinned)
+		{
+			iter->second.pinned = pinned;
+			if (pinned)
+				++pinned_count_;
+			else
+				--pinned_count_;
+		}
+		return true;
+	}
+
+	bool BitmapCache::SetPinned(Resource const& res, bool pinned)
+	{
+		return SetPinned(res.GetHashCode(), pinned);
+	}
+
+	void BitmapCache::SetBudget(size_t bytes)
+	{
+		budget_ = bytes;
+		Trim();
+	}
+
+	void BitmapCache::Trim()
+	{
+		Evict(nullptr);
+	}
+
+	void BitmapCache::Evict(Item const* keep)
+	{
+		// walk from the least recently used end, skipping bitmaps that are still in use
+		auto iter = order_.end();
+		while (resident_bytes_ > budget_ && iter != order_.begin())
+		{
+			--iter;
+
+			auto item = items_.find(*iter);
+			if (item->second.pinned || item->second.users || &item->second == keep)
+				continue;
+
+			resident_bytes_ -= item->second.bytes;
+			items_.erase(item);
+			iter = order_.erase(iter);
+			++evictions_;
+		}
+	}
+
+	void BitmapCache::Clear()
+	{
+		order_.clear();
+		items_.clear();
+		resident_bytes_ = 0;
+		pinned_count_ = 0;
+	}
+
+	BitmapCache::Stats BitmapCache::GetStats() const
+	{
+		Stats stats;
+		stats.resident_bytes = resident_bytes_;
+		stats.count = items_.size();
+		stats.pinned = pinned_count_;
+		stats.in_use = 0;
+		for (const auto& pair : items_)
+		{
+			if (pair.second.users)
+				++stats.in_use;
+		}
+		stats.hits = hits_;
+		stats.misses = misses_;
+		stats.evictions = evictions_;
+		return stats;
+	}
+
+	void BitmapCache::ResetStats()
+	{
+		hits_ = 0;
+		misses_ = 0;
+		evictions_ = 0;
+	}
+
+	size_t BitmapCache::GetBitmapBytes(ID2D1Bitmap* bitmap)
+	{
+		if (!bitmap)
+			return 0;
+
+		const D2D1_SIZE_U size = bitmap->GetPixelSize();
+		return static_cast<size_t>(size.width) * size.height * GetBytesPerPixel(bitmap->GetPixelFormat().format);
+	}
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "helper.hpp"
+#include "../common/helper.h"
+#include "../common/noncopyable.hpp"
+#include "../base/Resource.h"
+
+namespace kiwano
+{
+	// 位图缓存
+	// 按资源缓存设备位图, 显存占用超过预算时淘汰最久未使用的位图
+	// 仍被图片使用或被固定的位图不会被淘汰
+	class KGE_API BitmapCache
+		: protected Noncopyable
+	{
+	public:
+		struct Stats
+		{
+			size_t resident_bytes;	// 缓存位图占用的显存
+			size_t count;			// 缓存的位图数量
+			size_t pinned;			// 固定的位图数量
+			size_t in_use;			// 被图片使用的位图数量
+			size_t hits;			// 命中次数
+			size_t misses;			// 未命中次数
+			size_t evictions;		// 淘汰次数
+		};
+
+	public:
+		BitmapCache(
+			size_t budget = 256 * 1024 * 1024	// 显存预算 (字节)
+		);
+
+		// 查找位图, 未命中时返回空
+		ComPtr<ID2D1Bitmap> Get(
+			size_t key
+		);
+
+		// 添加位图, 超出预算时淘汰未使用的位图
+		void Put(
+			size_t key,
+			ComPtr<ID2D1Bitmap> const& bitmap
+		);
+
+		// 图片持有缓存的位图时调用, 使用中的位图不会被淘汰
+		// 位图已被替换或移除时返回 false
+		bool Retain(
+			size_t key,
+			ID2D1Bitmap* bitmap
+		);
+
+		// 图片不再持有位图时调用, 与 Retain 成对使用
+		bool Release(
+			size_t key,
+			ID2D1Bitmap* bitmap
+		);
+
+		// 移除位图
+		bool Remove(
+			size_t key
+		);
+
+		// 固定位图, 固定的位图不会被淘汰
+		bool SetPinned(
+			size_t key,
+			bool pinned
+		);
+
+		// 固定资源对应的位图
+		bool SetPinned(
+			Resource const& res,
+			bool pinned
+		);
+
+		// 设置显存预算 (字节)
+		void SetBudget(
+			size_t bytes
+		);
+
+		// 获取显存预算 (字节)
+		inline size_t GetBudget() const		{ return budget_; }
+
+		// 淘汰未使用的位图直到不超过预算
+		// 位图只在添加时检查预算, 释放大量图片后可以手动调用
+		void Trim();
+
+		// 清空缓存
+		void Clear();
+
+		Stats GetStats() const;
+
+		void ResetStats();
+
+		// 计算位图占用的显存
+		static size_t GetBitmapBytes(
+			ID2D1Bitmap* bitmap
+		);
+
+	private:
+		struct Item
+		{
+			ComPtr<ID2D1Bitmap> bitmap;
+			size_t bytes;
+			size_t users;
+			bool pinned;
+			List<size_t>::iterator order;
+		};
+
+		void Evict(
+			Item const* keep
+		);
+
+		size_t budget_;
+		size_t resident_bytes_;
+		size_t pinned_count_;
+		size_t hits_;
+		size_t misses_;
+		size_t evictions_;
+		List<size_t> order_;
+		UnorderedMap<size_t, Item> items_;
+	};
+}
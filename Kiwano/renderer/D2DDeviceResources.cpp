@@ -28,10 +28,125 @@
 
 namespace kiwano
 {
+	namespace
+	{
+		// bitmap without pixel storage, stands in for device bitmaps when
+		// there is no device context (headless mode) so that images keep
+		// their sizes and draw calls can still be recorded
+		class NullBitmap
+			: public ID2D1Bitmap
+		{
+		public:
+			NullBitmap(ID2D1Factory* factory, D2D1_SIZE_U const& size, float dpi)
+				: ref_count_(0)
+				, factory_(factory)
+				, size_(size)
+				, dpi_(dpi)
+			{
+			}
+
+			STDMETHOD_(void, GetFactory)(ID2D1Factory** factory) const
+			{
+				*factory = factory_.Get();
+				if (*factory)
+					(*factory)->AddRef();
+			}
+
+			STDMETHOD_(D2D1_SIZE_F, GetSize)() const
+			{
+				return D2D1::SizeF(size_.width * 96.f / dpi_, size_.height * 96.f / dpi_);
+			}
+
+			STDMETHOD_(D2D1_SIZE_U, GetPixelSize)() const
+			{
+				return size_;
+			}
+
+			STDMETHOD_(D2D1_PIXEL_FORMAT, GetPixelFormat)() const
+			{
+				return D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED);
+			}
+
+			STDMETHOD_(void, GetDpi)(FLOAT* dpi_x, FLOAT* dpi_y) const
+			{
+				*dpi_x = dpi_;
+				*dpi_y = dpi_;
+			}
+
+			STDMETHOD(CopyFromBitmap)(D2D1_POINT_2U const* dest_point, ID2D1Bitmap* bitmap, D2D1_RECT_U const* src_rect)
+			{
+				KGE_NOT_USED(dest_point);
+				KGE_NOT_USED(bitmap);
+				KGE_NOT_USED(src_rect);
+				return S_OK;
+			}
+
+			STDMETHOD(CopyFromRenderTarget)(D2D1_POINT_2U const* dest_point, ID2D1RenderTarget* render_target, D2D1_RECT_U const* src_rect)
+			{
+				KGE_NOT_USED(dest_point);
+				KGE_NOT_USED(render_target);
+				KGE_NOT_USED(src_rect);
+				return S_OK;
+			}
+
+			STDMETHOD(CopyFromMemory)(D2D1_RECT_U const* dst_rect, void const* src_data, UINT32 pitch)
+			{
+				KGE_NOT_USED(dst_rect);
+				KGE_NOT_USED(src_data);
+				KGE_NOT_USED(pitch);
+				return S_OK;
+			}
+
+			unsigned long STDMETHODCALLTYPE AddRef()
+			{
+				return InterlockedIncrement(&ref_count_);
+			}
+
+			unsigned long STDMETHODCALLTYPE Release()
+			{
+				unsigned long newCount = InterlockedDecrement(&ref_count_);
+
+				if (newCount == 0)
+				{
+					delete this;
+					return 0;
+				}
+
+				return newCount;
+			}
+
+			HRESULT STDMETHODCALLTYPE QueryInterface(IID const& riid, void** object)
+			{
+				if (__uuidof(ID2D1Bitmap) == riid
+					|| __uuidof(ID2D1Image) == riid
+					|| __uuidof(ID2D1Resource) == riid
+					|| __uuidof(IUnknown) == riid)
+				{
+					*object = this;
+				}
+				else
+				{
+					*object = nullptr;
+					return E_NOINTERFACE;
+				}
+
+				AddRef();
+
+				return S_OK;
+			}
+
+		private:
+			unsigned long			ref_count_;
+			ComPtr<ID2D1Factory>	factory_;
+			D2D1_SIZE_U				size_;
+			float					dpi_;
+		};
+	}
 
 	D2DDeviceResources::D2DDeviceResources()
 		: ref_count_(0)
 		, dpi_(96.f)
+		, text_cache_(this)
 	{
 		CreateDeviceIndependentResources();
 	}
@@ -81,6 +196,7 @@ namespace kiwano
 	void D2DDeviceResources::DiscardResources()
 	{
 		ClearImageCache();
+		text_cache_.Clear();
 
 		d2d_factory_.Reset();
 		d2d_device_.Reset();
@@ -226,120 +342,156 @@ namespace kiwano
 
 	HRESULT D2DDeviceResources::CreateBitmapFromFile(ComPtr<ID2D1Bitmap> & bitmap, String const & file_path)
 	{
-		if (!imaging_factory_ || !d2d_device_context_)
+		return CreateBitmapFromResource(bitmap, Resource(file_path));
+	}
+
+	HRESULT D2DDeviceResources::CreateBitmapFromResource(ComPtr<ID2D1Bitmap> & bitmap, Resource const & res)
+	{
+		if (!imaging_factory_)
 			return E_UNEXPECTED;
 
-		size_t hash_code = std::hash<String>{}(file_path);
-		if (bitmap_cache_.find(hash_code) != bitmap_cache_.end())
+		size_t hash_code = res.GetHashCode();
+		if (auto cached = bitmap_cache_.Get(hash_code))
 		{
-			bitmap = bitmap_cache_[hash_code];
+			bitmap = cached;
 			return S_OK;
 		}
 
-		ComPtr<IWICBitmapDecoder>		decoder;
-		ComPtr<IWICBitmapFrameDecode>	source;
-		ComPtr<IWICStream>				stream;
-		ComPtr<IWICFormatConverter>		converter;
-		ComPtr<ID2D1Bitmap>				bitmap_tmp;
+		ComPtr<IWICBitmapSource>	source;
+		ComPtr<ID2D1Bitmap>			bitmap_tmp;
 
-		HRESULT hr = imaging_factory_->CreateDecoderFromFilename(
-			file_path.c_str(),
-			nullptr,
-			GENERIC_READ,
-			WICDecodeMetadataCacheOnLoad,
-			&decoder
-		);
+		HRESULT hr = CreateBitmapSource(source, res);
 
 		if (SUCCEEDED(hr))
 		{
-			hr = decoder->GetFrame(0, &source);
+			hr = CreateBitmapFromSource(bitmap_tmp, source.Get());
 		}
 
 		if (SUCCEEDED(hr))
 		{
-			hr = imaging_factory_->CreateFormatConverter(&converter);
+			bitmap = bitmap_tmp;
+			bitmap_cache_.Put(hash_code, bitmap);
 		}
 
-		if (SUCCEEDED(hr))
+		return hr;
+	}
+
+	HRESULT D2DDeviceResources::CreateBitmapFromSource(ComPtr<ID2D1Bitmap> & bitmap, IWICBitmapSource* source)
+	{
+		if (!source)
+			return E_INVALIDARG;
+
+		if (!d2d_device_context_)
 		{
-			// ͼƬʽת 32bppPBGRA
-			hr = converter->Initialize(
-				source.Get(),
-				GUID_WICPixelFormat32bppPBGRA,
-				WICBitmapDitherTypeNone,
-				nullptr,
-				0.f,
-				WICBitmapPaletteTypeMedianCut
-			);
+			UINT width = 0, height = 0;
+			HRESULT hr = source->GetSize(&width, &height);
+
+			if (SUCCEEDED(hr))
+			{
+				hr = CreateNullBitmap(bitmap, D2D1::SizeU(width, height));
+			}
+			return hr;
 		}
 
+		ComPtr<ID2D1Bitmap> bitmap_tmp;
+		HRESULT hr = d2d_device_context_->CreateBitmapFromWicBitmap(
+			source,
+			nullptr,
+			&bitmap_tmp
+		);
+
 		if (SUCCEEDED(hr))
 		{
-			hr = d2d_device_context_->CreateBitmapFromWicBitmap(
-				converter.Get(),
-				nullptr,
-				&bitmap_tmp
-			);
+			bitmap = bitmap_tmp;
 		}
+		return hr;
+	}
+
+	HRESULT D2DDeviceResources::CreateBitmap(ComPtr<ID2D1Bitmap> & bitmap, D2D1_SIZE_U const & size, const void * data, UINT32 pitch)
+	{
+		if (!d2d_device_context_)
+			return CreateNullBitmap(bitmap, size);
+
+		ComPtr<ID2D1Bitmap> bitmap_tmp;
+		HRESULT hr = d2d_device_context_->CreateBitmap(
+			size,
+			data,
+			pitch,
+			D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)),
+			&bitmap_tmp
+		);
 
 		if (SUCCEEDED(hr))
 		{
 			bitmap = bitmap_tmp;
-			bitmap_cache_.insert(std::make_pair(hash_code, bitmap));
 		}
-
 		return hr;
 	}
 
-	HRESULT D2DDeviceResources::CreateBitmapFromResource(ComPtr<ID2D1Bitmap> & bitmap, Resource const & res)
+	HRESULT D2DDeviceResources::CreateNullBitmap(ComPtr<ID2D1Bitmap> & bitmap, D2D1_SIZE_U const & size)
 	{
-		if (!imaging_factory_ || !d2d_device_context_)
-			return E_UNEXPECTED;
+		ComPtr<ID2D1Bitmap> bitmap_tmp = new (std::nothrow) NullBitmap(d2d_factory_.Get(), size, dpi_);
+		if (!bitmap_tmp)
+			return E_OUTOFMEMORY;
 
-		size_t hash_code = res.GetHashCode();
-		if (bitmap_cache_.find(hash_code) != bitmap_cache_.end())
-		{
-			bitmap = bitmap_cache_[hash_code];
-			return S_OK;
-		}
+		bitmap = bitmap_tmp;
+		return S_OK;
+	}
+
+	HRESULT D2DDeviceResources::CreateBitmapSource(ComPtr<IWICBitmapSource> & source, Resource const & res)
+	{
+		if (!imaging_factory_)
+			return E_UNEXPECTED;
 
 		ComPtr<IWICBitmapDecoder>		decoder;
-		ComPtr<IWICBitmapFrameDecode>	source;
+		ComPtr<IWICBitmapFrameDecode>	frame;
 		ComPtr<IWICStream>				stream;
 		ComPtr<IWICFormatConverter>		converter;
-		ComPtr<ID2D1Bitmap>				bitmap_tmp;
-
-		// Դ
-		LPVOID buffer;
-		DWORD buffer_size;
-		HRESULT hr = res.Load(buffer, buffer_size) ? S_OK : E_FAIL;
-
-		if (SUCCEEDED(hr))
-		{
-			hr = imaging_factory_->CreateStream(&stream);
-		}
 
-		if (SUCCEEDED(hr))
-		{
-			hr = stream->InitializeFromMemory(
-				static_cast<WICInProcPointer>(buffer),
-				buffer_size
-			);
-		}
-
-		if (SUCCEEDED(hr))
+		HRESULT hr = S_OK;
+		if (res.IsFileType())
 		{
-			hr = imaging_factory_->CreateDecoderFromStream(
-				stream.Get(),
+			hr = imaging_factory_->CreateDecoderFromFilename(
+				res.GetFileName().c_str(),
 				nullptr,
+				GENERIC_READ,
 				WICDecodeMetadataCacheOnLoad,
 				&decoder
 			);
 		}
+		else
+		{
+			LPVOID buffer;
+			DWORD buffer_size;
+			hr = res.Load(buffer, buffer_size) ? S_OK : E_FAIL;
+
+			if (SUCCEEDED(hr))
+			{
+				hr = imaging_factory_->CreateStream(&stream);
+			}
+
+			if (SUCCEEDED(hr))
+			{
+				hr = stream->InitializeFromMemory(
+					static_cast<WICInProcPointer>(buffer),
+					buffer_size
+				);
+			}
+
+			if (SUCCEEDED(hr))
+			{
+				hr = imaging_factory_->CreateDecoderFromStream(
+					stream.Get(),
+					nullptr,
+					WICDecodeMetadataCacheOnLoad,
+					&decoder
+				);
+			}
+		}
 
 		if (SUCCEEDED(hr))
 		{
-			hr = decoder->GetFrame(0, &source);
+			hr = decoder->GetFrame(0, &frame);
 		}
 
 		if (SUCCEEDED(hr))
@@ -349,9 +501,9 @@ namespace kiwano
 
 		if (SUCCEEDED(hr))
 		{
-			// ͼƬʽת 32bppPBGRA
+			// 图片格式转换成 32bppPBGRA
 			hr = converter->Initialize(
-				source.Get(),
+				frame.Get(),
 				GUID_WICPixelFormat32bppPBGRA,
 				WICBitmapDitherTypeNone,
 				nullptr,
@@ -362,19 +514,8 @@ namespace kiwano
 
 		if (SUCCEEDED(hr))
 		{
-			hr = d2d_device_context_->CreateBitmapFromWicBitmap(
-				converter.Get(),
-				nullptr,
-				&bitmap_tmp
-			);
-		}
-
-		if (SUCCEEDED(hr))
-		{
-			bitmap = bitmap_tmp;
-			bitmap_cache_.insert(std::make_pair(hash_code, bitmap));
+			source = converter;
 		}
-
 		return hr;
 	}
 
@@ -499,7 +640,7 @@ namespace kiwano
 
 	void D2DDeviceResources::ClearImageCache()
 	{
-		bitmap_cache_.clear();
+		bitmap_cache_.Clear();
 	}
 
 	ID2D1StrokeStyle* D2DDeviceResources::GetStrokeStyle(StrokeStyle stroke) const
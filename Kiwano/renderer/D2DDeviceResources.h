@@ -20,6 +20,8 @@
 
 #pragma once
 #include "helper.hpp"
+#include "TextCache.h"
+#include "BitmapCache.h"
 #include "../base/Resource.h"
 #include "../2d/Font.hpp"
 #include "../2d/TextStyle.hpp"
@@ -43,6 +45,28 @@ namespace kiwano
 			_In_ Resource const& res
 		);
 
+		// 解码图片为 32bppPBGRA 格式的位图源, 不创建设备位图
+		HRESULT CreateBitmapSource(
+			_Out_ ComPtr<IWICBitmapSource>& source,
+			_In_ Resource const& res
+		);
+
+		// 从位图源创建设备位图
+		// 没有设备时 (无头模式) 创建只有尺寸、不含像素数据的位图
+		HRESULT CreateBitmapFromSource(
+			_Out_ ComPtr<ID2D1Bitmap>& bitmap,
+			_In_ IWICBitmapSource* source
+		);
+
+		// 创建 32bppPBGRA 格式的位图
+		// 没有设备时 (无头模式) 创建只有尺寸、不含像素数据的位图
+		HRESULT CreateBitmap(
+			_Out_ ComPtr<ID2D1Bitmap>& bitmap,
+			_In_ D2D1_SIZE_U const& size,
+			_In_opt_ const void* data,
+			_In_ UINT32 pitch
+		);
+
 		HRESULT CreateTextFormat(
 			_Out_ ComPtr<IDWriteTextFormat>& text_format,
 			_In_ Font const& font,
@@ -78,6 +102,12 @@ namespace kiwano
 
 		ID2D1StrokeStyle*				GetStrokeStyle(StrokeStyle stroke) const;
 
+		// 获取位图缓存
+		inline BitmapCache&				GetBitmapCache()				{ return bitmap_cache_; }
+
+		// 获取文字缓存
+		inline TextCache&				GetTextCache()					{ return text_cache_; }
+
 	public:
 		unsigned long STDMETHODCALLTYPE AddRef();
 
@@ -95,12 +125,18 @@ namespace kiwano
 
 		HRESULT CreateDeviceIndependentResources();
 
+		HRESULT CreateNullBitmap(
+			_Out_ ComPtr<ID2D1Bitmap>& bitmap,
+			_In_ D2D1_SIZE_U const& size
+		);
+
 	private:
 		unsigned long ref_count_;
 		float dpi_;
 
-		using BitmapMap = UnorderedMap<size_t, ComPtr<ID2D1Bitmap>>;
-		BitmapMap bitmap_cache_;
+		BitmapCache bitmap_cache_;
+
+		TextCache text_cache_;
 
 		ComPtr<ID2D1Factory1>		d2d_factory_;
 		ComPtr<ID2D1Device>			d2d_device_;
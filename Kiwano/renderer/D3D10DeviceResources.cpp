@@ -99,7 +99,9 @@ namespace kiwano
 			{
 				hr = res->CreateDeviceIndependentResources();
 
-				if (SUCCEEDED(hr))
+				// without a window (headless mode) only the device independent
+				// resources are created
+				if (SUCCEEDED(hr) && hwnd)
 				{
 					RECT rc;
 					GetClientRect(hwnd, &rc);
@@ -109,11 +111,11 @@ namespace kiwano
 					res->logical_size_.y = float(rc.bottom - rc.top);
 
 					hr = res->CreateDeviceResources();
-				}
 
-				if (SUCCEEDED(hr))
-				{
-					hr = res->CreateWindowSizeDependentResources();
+					if (SUCCEEDED(hr))
+					{
+						hr = res->CreateWindowSizeDependentResources();
+					}
 				}
 
 				if (SUCCEEDED(hr))
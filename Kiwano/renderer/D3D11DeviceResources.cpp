@@ -75,7 +75,9 @@ namespace kiwano
 			{
 				hr = res->CreateDeviceIndependentResources();
 
-				if (SUCCEEDED(hr))
+				// without a window (headless mode) only the device independent
+				// resources are created
+				if (SUCCEEDED(hr) && hwnd)
 				{
 					RECT rc;
 					GetClientRect(hwnd, &rc);
@@ -85,11 +87,11 @@ namespace kiwano
 					res->logical_size_.y = float(rc.bottom - rc.top);
 
 					hr = res->CreateDeviceResources();
-				}
 
-				if (SUCCEEDED(hr))
-				{
-					hr = res->CreateWindowSizeDependentResources();
+					if (SUCCEEDED(hr))
+					{
+						hr = res->CreateWindowSizeDependentResources();
+					}
 				}
 
 				if (SUCCEEDED(hr))
@@ -0,0 +1,225 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "RenderCommand.h"
+#include <algorithm>
+
+namespace kiwano
+{
+	namespace
+	{
+		// key layout: depth (24 bits) | texture slot (16 bits) | sequence (24 bits)
+		// sequence keeps keys unique, so an unstable sort still preserves the recorded order
+		const int depth_shift = 40;
+		const int slot_shift = 24;
+		const unsigned long long slot_mask = 0xFFFF;
+		const unsigned long long sequence_mask = 0xFFFFFF;
+
+		inline bool IsDrawCommand(RenderCommandType type)
+		{
+			return type == RenderCommandType::Sprite
+				|| type == RenderCommandType::FillGeometry
+				|| type == RenderCommandType::DrawGeometry
+				|| type == RenderCommandType::FillRectangle
+				|| type == RenderCommandType::Text;
+		}
+	}
+
+	void RecordingRenderBackend::DrawSpriteBatch(RenderCommand const& first, SpriteBatchItem const* items, unsigned int count)
+	{
+		KGE_NOT_USED(items);
+		calls_.push_back(Call{ RenderCommandType::Sprite, first.texture, count });
+	}
+
+	void RecordingRenderBackend::Execute(RenderCommand const& cmd)
+	{
+		calls_.push_back(Call{ cmd.type, nullptr, 1 });
+	}
+
+	void RecordingRenderBackend::Reset()
+	{
+		calls_.resize(0);
+	}
+
+
+	RenderCommandList::RenderCommandList()
+		: needs_sort_(false)
+		, sprite_run_(false)
+		, reorder_level_(0)
+		, depth_(0)
+		, last_texture_(nullptr)
+		, last_slot_(0)
+		, stats_{}
+	{
+	}
+
+	RenderCommandList::~RenderCommandList()
+	{
+	}
+
+	RenderCommand& RenderCommandList::Record(RenderCommandType type, const void* texture)
+	{
+		unsigned long long slot = 0;
+		if (reorder_level_ > 0 && type == RenderCommandType::Sprite)
+		{
+			// consecutive sprites in a reorder group share one depth and are sorted by texture
+			if (!sprite_run_)
+			{
+				++depth_;
+				sprite_run_ = true;
+				last_slot_ = 0;
+			}
+
+			if (texture != last_texture_ || last_slot_ == 0)
+			{
+				auto iter = texture_slots_.find(texture);
+				if (iter == texture_slots_.end())
+				{
+					const auto next = static_cast<unsigned int>(texture_slots_.size() + 1);
+					iter = texture_slots_.insert(std::make_pair(texture, next)).first;
+				}
+
+				// a texture change inside a run means the run may need sorting
+				if (last_slot_ != 0 && last_texture_ != texture)
+					needs_sort_ = true;
+
+				last_texture_ = texture;
+				last_slot_ = iter->second;
+			}
+			slot = last_slot_ & slot_mask;
+		}
+		else
+		{
+			// anything else is a barrier, sprites never move across it
+			++depth_;
+			sprite_run_ = false;
+			last_slot_ = 0;
+		}
+
+		const auto sequence = static_cast<unsigned long long>(commands_.size());
+
+		RenderCommand& cmd = commands_.emplace_back();
+		cmd.type = type;
+		cmd.texture = texture;
+		cmd.key = (depth_ << depth_shift) | (slot << slot_shift) | (sequence & sequence_mask);
+		return cmd;
+	}
+
+	void RenderCommandList::BeginReorder()
+	{
+		++reorder_level_;
+	}
+
+	void RenderCommandList::EndReorder()
+	{
+		if (reorder_level_ > 0 && --reorder_level_ == 0)
+		{
+			sprite_run_ = false;
+			last_slot_ = 0;
+		}
+	}
+
+	void RenderCommandList::Execute(RenderBackend* backend)
+	{
+		if (commands_.empty())
+			return;
+
+		const size_t count = commands_.size();
+		order_.resize(count);
+
+		const RenderCommand* cmd = commands_.data();
+		RenderCommand const** order = order_.data();
+		for (size_t i = 0; i < count; ++i)
+		{
+			order[i] = cmd + i;
+		}
+
+		if (needs_sort_)
+		{
+			std::sort(order, order + count, [](RenderCommand const* lhs, RenderCommand const* rhs)
+				{
+					return lhs->key < rhs->key;
+				}
+			);
+		}
+
+		stats_.commands += static_cast<unsigned int>(count);
+
+		Submit(backend, order, count);
+		Clear();
+	}
+
+	void RenderCommandList::Submit(RenderBackend* backend, RenderCommand const* const* commands, size_t count)
+	{
+		size_t i = 0;
+		while (i < count)
+		{
+			RenderCommand const* cmd = commands[i];
+			if (cmd->type != RenderCommandType::Sprite)
+			{
+				if (backend)
+					backend->Execute(*cmd);
+
+				if (IsDrawCommand(cmd->type))
+					++stats_.draw_calls;
+				++i;
+				continue;
+			}
+
+			// merge consecutive sprites sharing the same texture
+			RenderCommand const* first = cmd;
+
+			batch_.resize(0);
+			for (; i < count; ++i)
+			{
+				cmd = commands[i];
+				if (cmd->type != RenderCommandType::Sprite || cmd->texture != first->texture)
+					break;
+
+				batch_.push_back(SpriteBatchItem{ cmd->src_rect, cmd->dest_rect, cmd->transform, cmd->opacity });
+			}
+
+			const auto batch_size = static_cast<unsigned int>(batch_.size());
+			if (backend)
+				backend->DrawSpriteBatch(*first, batch_.data(), batch_size);
+
+			stats_.sprites += batch_size;
+			++stats_.batches;
+			++stats_.draw_calls;
+		}
+	}
+
+	void RenderCommandList::Clear()
+	{
+		commands_.resize(0);
+		texture_slots_.clear();
+
+		needs_sort_ = false;
+		sprite_run_ = false;
+		depth_ = 0;
+		last_texture_ = nullptr;
+		last_slot_ = 0;
+	}
+
+	void RenderCommandList::ResetStats()
+	{
+		stats_ = Stats{};
+	}
+}
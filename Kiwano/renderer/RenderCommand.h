@@ -0,0 +1,214 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/helper.h"
+#include "../common/noncopyable.hpp"
+#include "../math/helper.h"
+#include "../2d/Color.h"
+
+// 命令只记录资源指针, 无需包含 Direct2D 头文件
+struct ID2D1Bitmap;
+struct ID2D1Geometry;
+struct ID2D1Layer;
+struct IDWriteTextLayout;
+
+namespace kiwano
+{
+	// 画笔样式, 定义见 include-forwards.h
+	enum class StrokeStyle : int;
+
+	// 渲染命令类型
+	enum class RenderCommandType : int
+	{
+		Sprite,			/* 位图 */
+		FillGeometry,	/* 填充几何形状 */
+		DrawGeometry,	/* 描边几何形状 */
+		FillRectangle,	/* 填充矩形 */
+		Text,			/* 文字布局 */
+		PushClip,		/* 开始裁剪 */
+		PopClip,		/* 结束裁剪 */
+		PushLayer,		/* 开始图层 */
+		PopLayer		/* 结束图层 */
+	};
+
+	// 渲染命令
+	// 记录一次绘制所需的全部状态, 不依赖设备上下文的当前状态
+	// 资源只记录指针, 调用方需保证资源在命令提交前有效, 见 Renderer::Retain
+	struct RenderCommand
+	{
+		RenderCommandType			type;
+		unsigned long long			key;			// 排序键
+		Matrix						transform;		// 二维变换, 裁剪命令为裁剪区域的变换
+		float						opacity;		// 透明度, 图层命令为图层透明度
+
+		const void*					texture;		// 纹理标识, 用于排序与合批
+		Rect						src_rect;
+		Rect						dest_rect;		// 目标区域, 裁剪、图层和矩形命令为其区域
+
+		union
+		{
+			ID2D1Bitmap*			bitmap;			// 精灵命令
+			ID2D1Geometry*			geometry;		// 几何形状命令
+			IDWriteTextLayout*		text_layout;	// 文字命令
+			ID2D1Layer*				layer;			// 图层命令
+		};
+
+		Color						color;			// 填充色或描边色, 文字命令为文字颜色
+		Color						outline_color;	// 文字描边颜色
+		float						stroke_width;	// 线宽, 文字命令为描边线宽
+		StrokeStyle					stroke;
+		bool						outline;		// 文字是否描边
+	};
+
+	// 精灵批次中的一个精灵
+	struct SpriteBatchItem
+	{
+		Rect	src_rect;
+		Rect	dest_rect;
+		Matrix	transform;
+		float	opacity;
+	};
+
+	// 渲染后端
+	// 消费命令列表, 由具体的图形 API 实现
+	class KGE_API RenderBackend
+	{
+	public:
+		virtual ~RenderBackend() {}
+
+		// 绘制共享同一纹理的一批精灵, first 为批次中的第一条命令
+		virtual void DrawSpriteBatch(
+			RenderCommand const& first,
+			SpriteBatchItem const* items,
+			unsigned int count
+		) = 0;
+
+		// 执行除精灵外的其他命令
+		virtual void Execute(
+			RenderCommand const& cmd
+		) = 0;
+	};
+
+	// 记录后端
+	// 不进行实际绘制, 只记录提交的批次和命令, 用于无窗口运行和统计合批效果
+	class KGE_API RecordingRenderBackend
+		: public RenderBackend
+	{
+	public:
+		struct Call
+		{
+			RenderCommandType	type;
+			const void*			texture;
+			unsigned int		count;	// 精灵批次中的精灵数量, 其他命令为 1
+		};
+
+		void DrawSpriteBatch(
+			RenderCommand const& first,
+			SpriteBatchItem const* items,
+			unsigned int count
+		) override;
+
+		void Execute(
+			RenderCommand const& cmd
+		) override;
+
+		// 清空记录
+		void Reset();
+
+		// 获取所有提交记录
+		inline Array<Call> const& GetCalls() const	{ return calls_; }
+
+	private:
+		Array<Call> calls_;
+	};
+
+	// 渲染命令列表
+	// 节点渲染时将绘制操作按遍历顺序记录在此, 提交时按排序键排序,
+	// 并把共享同一纹理的连续精灵合并为一次批量绘制
+	class KGE_API RenderCommandList
+		: protected Noncopyable
+	{
+	public:
+		struct Stats
+		{
+			unsigned int commands;		// 记录的命令数
+			unsigned int draw_calls;	// 提交给后端的绘制次数
+			unsigned int sprites;		// 精灵数
+			unsigned int batches;		// 精灵批次数
+		};
+
+	public:
+		RenderCommandList();
+
+		~RenderCommandList();
+
+		// 记录一条命令, 返回的命令由调用方填写
+		RenderCommand& Record(
+			RenderCommandType type,
+			const void* texture = nullptr
+		);
+
+		// 开始可重排分组
+		// 组内连续的精灵可以按纹理重新排序以便合并, 调用方需保证它们互不重叠
+		void BeginReorder();
+
+		// 结束可重排分组
+		void EndReorder();
+
+		// 排序、合批并提交给后端, 然后清空列表
+		void Execute(
+			RenderBackend* backend
+		);
+
+		// 丢弃所有未提交的命令
+		void Clear();
+
+		// 重置统计数据
+		void ResetStats();
+
+		inline bool IsEmpty() const				{ return commands_.empty(); }
+
+		inline size_t GetCommandCount() const	{ return commands_.size(); }
+
+		inline Stats const& GetStats() const	{ return stats_; }
+
+	private:
+		void Submit(
+			RenderBackend* backend,
+			RenderCommand const* const* commands,
+			size_t count
+		);
+
+	private:
+		bool							needs_sort_;
+		bool							sprite_run_;
+		int								reorder_level_;
+		unsigned long long				depth_;
+		const void*						last_texture_;
+		unsigned int					last_slot_;
+		Stats							stats_;
+
+		Array<RenderCommand>			commands_;
+		Array<RenderCommand const*>		order_;
+		Array<SpriteBatchItem>			batch_;
+		UnorderedMap<const void*, unsigned int>	texture_slots_;
+	};
+}
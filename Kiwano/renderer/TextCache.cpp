@@ -0,0 +1,229 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "TextCache.h"
+#include "D2DDeviceResources.h"
+
+namespace kiwano
+{
+	namespace
+	{
+		void AppendKey(std::string& key, const void* data, size_t size)
+		{
+			key.append(static_cast<const char*>(data), size);
+		}
+
+		template <typename _Ty>
+		void AppendKey(std::string& key, _Ty const& value)
+		{
+			AppendKey(key, &value, sizeof(value));
+		}
+
+		void AppendKey(std::string& key, String const& str)
+		{
+			AppendKey(key, str.length());
+			AppendKey(key, str.c_str(), str.length() * sizeof(wchar_t));
+		}
+
+		void MakeFormatKey(std::string& key, Font const& font, TextStyle const& text_style)
+		{
+			AppendKey(key, font.family);
+			AppendKey(key, font.size);
+			AppendKey(key, font.weight);
+			AppendKey(key, font.italic);
+			AppendKey(key, text_style.line_spacing);
+			AppendKey(key, text_style.alignment);
+			AppendKey(key, text_style.wrap);
+		}
+	}
+
+	TextCache::TextCache(D2DDeviceResources* device_resources)
+		: device_resources_(device_resources)
+		, formats_(32)
+		, layouts_(256)
+		, outlines_(512)
+	{
+	}
+
+	HRESULT TextCache::GetTextFormat(ComPtr<IDWriteTextFormat>& text_format, Font const& font, TextStyle const& text_style)
+	{
+		std::string key;
+		MakeFormatKey(key, font, text_style);
+
+		if (auto cached = formats_.Get(key))
+		{
+			text_format = *cached;
+			return S_OK;
+		}
+
+		HRESULT hr = device_resources_->CreateTextFormat(text_format, font, text_style);
+		if (SUCCEEDED(hr))
+		{
+			formats_.Put(key, text_format);
+		}
+		return hr;
+	}
+
+	HRESULT TextCache::GetTextLayout(ComPtr<IDWriteTextLayout>& text_layout, Size& layout_size, String const& text, Font const& font, TextStyle const& text_style)
+	{
+		std::string key;
+		MakeFormatKey(key, font, text_style);
+		AppendKey(key, text_style.wrap_width);
+		AppendKey(key, text_style.underline);
+		AppendKey(key, text_style.strikethrough);
+		AppendKey(key, text);
+
+		if (auto cached = layouts_.Get(key))
+		{
+			text_layout = cached->text_layout;
+			layout_size = cached->layout_size;
+			return S_OK;
+		}
+
+		ComPtr<IDWriteTextFormat> text_format;
+		HRESULT hr = GetTextFormat(text_format, font, text_style);
+
+		if (SUCCEEDED(hr))
+		{
+			hr = device_resources_->CreateTextLayout(text_layout, layout_size, text, text_format, text_style);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			layouts_.Put(key, LayoutItem{ text_layout, layout_size });
+		}
+		return hr;
+	}
+
+	HRESULT TextCache::GetGlyphRunOutline(ComPtr<ID2D1Geometry>& geometry, DWRITE_GLYPH_RUN const* glyph_run)
+	{
+		const UINT32 count = glyph_run->glyphCount;
+		const bool has_advances = glyph_run->glyphAdvances != nullptr;
+		const bool has_offsets = glyph_run->glyphOffsets != nullptr;
+
+		// the face pointer identifies the font file, index and simulations
+		std::string key;
+		key.reserve(32 + count * (sizeof(UINT16) + sizeof(FLOAT) + sizeof(DWRITE_GLYPH_OFFSET)));
+		AppendKey(key, glyph_run->fontFace);
+		AppendKey(key, glyph_run->fontEmSize);
+		AppendKey(key, glyph_run->isSideways);
+		AppendKey(key, glyph_run->bidiLevel % 2);
+		AppendKey(key, count);
+		AppendKey(key, glyph_run->glyphIndices, count * sizeof(UINT16));
+		AppendKey(key, has_advances);
+		if (has_advances)
+		{
+			AppendKey(key, glyph_run->glyphAdvances, count * sizeof(FLOAT));
+		}
+		AppendKey(key, has_offsets);
+		if (has_offsets)
+		{
+			AppendKey(key, glyph_run->glyphOffsets, count * sizeof(DWRITE_GLYPH_OFFSET));
+		}
+
+		if (auto cached = outlines_.Get(key))
+		{
+			geometry = cached->geometry;
+			return S_OK;
+		}
+
+		HRESULT hr = CreateGlyphRunOutline(geometry, device_resources_->GetD2DFactory(), glyph_run);
+		if (SUCCEEDED(hr))
+		{
+			outlines_.Put(key, OutlineItem{ glyph_run->fontFace, geometry });
+		}
+		return hr;
+	}
+
+	void TextCache::SetCapacity(size_t formats, size_t layouts, size_t outlines)
+	{
+		formats_.SetCapacity(formats);
+		layouts_.SetCapacity(layouts);
+		outlines_.SetCapacity(outlines);
+	}
+
+	void TextCache::Clear()
+	{
+		formats_.Clear();
+		layouts_.Clear();
+		outlines_.Clear();
+	}
+
+	TextCache::Stats TextCache::GetStats() const
+	{
+		Stats stats;
+		stats.format_hits = formats_.GetStats().hits;
+		stats.format_misses = formats_.GetStats().misses;
+		stats.layout_hits = layouts_.GetStats().hits;
+		stats.layout_misses = layouts_.GetStats().misses;
+		stats.outline_hits = outlines_.GetStats().hits;
+		stats.outline_misses = outlines_.GetStats().misses;
+		stats.evictions = formats_.GetStats().evictions + layouts_.GetStats().evictions + outlines_.GetStats().evictions;
+		return stats;
+	}
+
+	void TextCache::ResetStats()
+	{
+		formats_.ResetStats();
+		layouts_.ResetStats();
+		outlines_.ResetStats();
+	}
+
+	HRESULT TextCache::CreateGlyphRunOutline(ComPtr<ID2D1Geometry>& geometry, ID2D1Factory* factory, DWRITE_GLYPH_RUN const* glyph_run)
+	{
+		if (!factory)
+			return E_UNEXPECTED;
+
+		ComPtr<ID2D1PathGeometry> path_geo;
+		ComPtr<ID2D1GeometrySink> sink;
+
+		HRESULT hr = factory->CreatePathGeometry(&path_geo);
+
+		if (SUCCEEDED(hr))
+		{
+			hr = path_geo->Open(&sink);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = glyph_run->fontFace->GetGlyphRunOutline(
+				glyph_run->fontEmSize,
+				glyph_run->glyphIndices,
+				glyph_run->glyphAdvances,
+				glyph_run->glyphOffsets,
+				glyph_run->glyphCount,
+				glyph_run->isSideways,
+				glyph_run->bidiLevel % 2,
+				sink.Get()
+			);
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			hr = sink->Close();
+		}
+
+		if (SUCCEEDED(hr))
+		{
+			geometry = path_geo;
+		}
+		return hr;
+	}
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "helper.hpp"
+#include "../common/helper.h"
+#include "../common/LruCache.hpp"
+#include "../2d/Font.hpp"
+#include "../2d/TextStyle.hpp"
+#include <dwrite.h>
+
+namespace kiwano
+{
+	class D2DDeviceResources;
+
+	// 文字缓存
+	// 按字体和样式缓存文字格式, 按字体、样式和字符串缓存文字布局,
+	// 按字体、字号和字形缓存字形轮廓, 逐帧重绘的文字不必重复创建
+	class KGE_API TextCache
+		: protected Noncopyable
+	{
+	public:
+		struct Stats
+		{
+			size_t format_hits;		// 文字格式命中次数
+			size_t format_misses;	// 文字格式未命中次数
+			size_t layout_hits;		// 文字布局命中次数
+			size_t layout_misses;	// 文字布局未命中次数
+			size_t outline_hits;	// 字形轮廓命中次数
+			size_t outline_misses;	// 字形轮廓未命中次数
+			size_t evictions;		// 淘汰次数
+		};
+
+	public:
+		TextCache(
+			D2DDeviceResources* device_resources
+		);
+
+		// 获取文字格式
+		HRESULT GetTextFormat(
+			_Out_ ComPtr<IDWriteTextFormat>& text_format,
+			_In_ Font const& font,
+			_In_ TextStyle const& text_style
+		);
+
+		// 获取文字布局
+		// 布局会被共享, 取得后不要修改
+		HRESULT GetTextLayout(
+			_Out_ ComPtr<IDWriteTextLayout>& text_layout,
+			_Out_ Size& layout_size,
+			_In_ String const& text,
+			_In_ Font const& font,
+			_In_ TextStyle const& text_style
+		);
+
+		// 获取字形轮廓, 轮廓以基线起点为原点
+		HRESULT GetGlyphRunOutline(
+			_Out_ ComPtr<ID2D1Geometry>& geometry,
+			_In_ DWRITE_GLYPH_RUN const* glyph_run
+		);
+
+		// 设置缓存容量 (项数)
+		// 默认为 32 个文字格式, 256 个文字布局, 512 个字形轮廓, 设为 0 时不缓存
+		void SetCapacity(
+			size_t formats,
+			size_t layouts,
+			size_t outlines
+		);
+
+		void Clear();
+
+		Stats GetStats() const;
+
+		void ResetStats();
+
+		// 创建字形轮廓, 不经过缓存
+		static HRESULT CreateGlyphRunOutline(
+			_Out_ ComPtr<ID2D1Geometry>& geometry,
+			_In_ ID2D1Factory* factory,
+			_In_ DWRITE_GLYPH_RUN const* glyph_run
+		);
+
+	private:
+		struct LayoutItem
+		{
+			ComPtr<IDWriteTextLayout> text_layout;
+			Size layout_size;
+		};
+
+		struct OutlineItem
+		{
+			ComPtr<IDWriteFontFace> font_face;	// 保证字体对象的地址不被复用
+			ComPtr<ID2D1Geometry> geometry;
+		};
+
+		D2DDeviceResources*						device_resources_;
+		LruCache<std::string, ComPtr<IDWriteTextFormat>>	formats_;
+		LruCache<std::string, LayoutItem>		layouts_;
+		LruCache<std::string, OutlineItem>		outlines_;
+	};
+}
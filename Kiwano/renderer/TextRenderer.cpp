@@ -19,6 +19,7 @@
 // THE SOFTWARE.
 
 #include "TextRenderer.h"
+#include "TextCache.h"
 
 namespace kiwano
 {
@@ -27,7 +28,8 @@ namespace kiwano
 	{
 	public:
 		TextRenderer(
-			ID2D1RenderTarget* pRT
+			ID2D1RenderTarget* pRT,
+			TextCache* pTextCache
 		);
 
 		~TextRenderer();
@@ -111,17 +113,19 @@ namespace kiwano
 		ID2D1RenderTarget*		pRT_;
 		ID2D1SolidColorBrush*	pBrush_;
 		ID2D1StrokeStyle*		pCurrStrokeStyle_;
+		TextCache*				pTextCache_;
 	};
 
 	HRESULT ITextRenderer::Create(
 		ITextRenderer** ppTextRenderer,
-		ID2D1RenderTarget* pRT)
+		ID2D1RenderTarget* pRT,
+		TextCache* pTextCache)
 	{
 		HRESULT hr = E_FAIL;
 
 		if (ppTextRenderer)
 		{
-			TextRenderer* pTextRenderer = new (std::nothrow) TextRenderer(pRT);
+			TextRenderer* pTextRenderer = new (std::nothrow) TextRenderer(pRT, pTextCache);
 			if (pTextRenderer)
 			{
 				hr = pTextRenderer->CreateDeviceResources();
@@ -144,7 +148,7 @@ namespace kiwano
 		return hr;
 	}
 
-	TextRenderer::TextRenderer(ID2D1RenderTarget* pRT)
+	TextRenderer::TextRenderer(ID2D1RenderTarget* pRT, TextCache* pTextCache)
 		: cRefCount_(0)
 		, pFactory_(NULL)
 		, pRT_(pRT)
@@ -154,6 +158,7 @@ namespace kiwano
 		, fOutlineWidth(1)
 		, bShowOutline_(TRUE)
 		, pCurrStrokeStyle_(NULL)
+		, pTextCache_(pTextCache)
 	{
 		pRT_->AddRef();
 		pRT_->GetFactory(&pFactory_);
@@ -210,52 +215,22 @@ namespace kiwano
 
 		HRESULT hr = S_OK;
 
-		ID2D1PathGeometry* pPathGeometry = NULL;
-		hr = pFactory_->CreatePathGeometry(
-			&pPathGeometry
-		);
-
-		ID2D1GeometrySink* pSink = NULL;
-		if (SUCCEEDED(hr))
-		{
-			hr = pPathGeometry->Open(
-				&pSink
-			);
-		}
-
-		if (SUCCEEDED(hr))
+		// outlines are cached at the baseline origin and placed with the transform
+		ComPtr<ID2D1Geometry> pGeometry;
+		if (pTextCache_)
 		{
-			hr = glyphRun->fontFace->GetGlyphRunOutline(
-				glyphRun->fontEmSize,
-				glyphRun->glyphIndices,
-				glyphRun->glyphAdvances,
-				glyphRun->glyphOffsets,
-				glyphRun->glyphCount,
-				glyphRun->isSideways,
-				glyphRun->bidiLevel % 2,
-				pSink
-			);
+			hr = pTextCache_->GetGlyphRunOutline(pGeometry, glyphRun);
 		}
-
-		if (SUCCEEDED(hr))
+		else
 		{
-			hr = pSink->Close();
+			hr = TextCache::CreateGlyphRunOutline(pGeometry, pFactory_, glyphRun);
 		}
 
-		D2D1::Matrix3x2F const matrix = D2D1::Matrix3x2F(
-			1.0f, 0.0f,
-			0.0f, 1.0f,
-			baselineOriginX, baselineOriginY
-		);
-
-		ID2D1TransformedGeometry* pTransformedGeometry = NULL;
+		D2D1::Matrix3x2F transform;
 		if (SUCCEEDED(hr))
 		{
-			hr = pFactory_->CreateTransformedGeometry(
-				pPathGeometry,
-				&matrix,
-				&pTransformedGeometry
-			);
+			pRT_->GetTransform(&transform);
+			pRT_->SetTransform(D2D1::Matrix3x2F::Translation(baselineOriginX, baselineOriginY) * transform);
 		}
 
 		if (SUCCEEDED(hr) && bShowOutline_)
@@ -263,7 +238,7 @@ namespace kiwano
 			pBrush_->SetColor(sOutlineColor_);
 
 			pRT_->DrawGeometry(
-				pTransformedGeometry,
+				pGeometry.Get(),
 				pBrush_,
 				fOutlineWidth,
 				pCurrStrokeStyle_
@@ -275,14 +250,12 @@ namespace kiwano
 			pBrush_->SetColor(sFillColor_);
 
 			pRT_->FillGeometry(
-				pTransformedGeometry,
+				pGeometry.Get(),
 				pBrush_
 			);
-		}
 
-		DX::SafeRelease(pPathGeometry);
-		DX::SafeRelease(pSink);
-		DX::SafeRelease(pTransformedGeometry);
+			pRT_->SetTransform(transform);
+		}
 
 		return hr;
 	}
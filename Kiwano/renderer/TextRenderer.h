@@ -24,13 +24,16 @@
 
 namespace kiwano
 {
+	class TextCache;
+
 	interface ITextRenderer
 		: public IDWriteTextRenderer
 	{
 	public:
 		static KGE_API HRESULT Create(
 			_Out_ ITextRenderer** ppTextRenderer,
-			_In_ ID2D1RenderTarget* pRT
+			_In_ ID2D1RenderTarget* pRT,
+			_In_opt_ TextCache* pTextCache = nullptr	// 字形轮廓缓存, 为空时逐帧创建
 		);
 
 		STDMETHOD_(void, SetTextStyle)(
@@ -33,8 +33,11 @@ namespace kiwano
 		, clear_color_(Color::Black)
 		, opacity_(1.f)
 		, collecting_data_(false)
+		, headless_(false)
+		, device_transform_valid_(false)
 	{
 		status_.primitives = 0;
+		status_.draw_calls = 0;
 	}
 
 	Renderer::~Renderer()
@@ -43,6 +46,25 @@ namespace kiwano
 
 	void Renderer::SetupComponent(Application* app)
 	{
+		if (app->IsHeadless())
+		{
+			// no window and no device, draw calls are only recorded
+			headless_ = true;
+			hwnd_ = nullptr;
+			device_resources_ = nullptr;
+
+			// images and text layouts still need the device independent factories
+			ThrowIfFailed(
+				DeviceResources::Create(
+					&device_resources_,
+					nullptr
+				)
+			);
+
+			factory_ = device_resources_->GetD2DFactory();
+			return;
+		}
+
 		KGE_LOG(L"Creating device resources");
 
 		hwnd_ = app->GetWindow()->GetHandle();
@@ -79,6 +101,13 @@ namespace kiwano
 	{
 		KGE_LOG(L"Destroying device resources");
 
+		commands_.Clear();
+		retained_.resize(0);
+
+#if defined(KGE_USE_D2D_SPRITE_BATCH)
+		sprite_batch_.Reset();
+		device_context3_.Reset();
+#endif
 		drawing_state_block_.Reset();
 		text_renderer_.Reset();
 		solid_color_brush_.Reset();
@@ -100,7 +129,8 @@ namespace kiwano
 		{
 			hr = ITextRenderer::Create(
 				&text_renderer_,
-				device_context_.Get()
+				device_context_.Get(),
+				&device_resources_->GetTextCache()
 			);
 		}
 
@@ -109,6 +139,22 @@ namespace kiwano
 			SetAntialiasMode(antialias_);
 			SetTextAntialiasMode(text_antialias_);
 		}
+
+#if defined(KGE_USE_D2D_SPRITE_BATCH)
+		if (SUCCEEDED(hr))
+		{
+			// sprite batches need ID2D1DeviceContext3 (Windows 10),
+			// otherwise every sprite of a batch is drawn with DrawBitmap
+			device_context3_ = nullptr;
+			sprite_batch_ = nullptr;
+
+			if (SUCCEEDED(device_context_->QueryInterface(IID_PPV_ARGS(&device_context3_))))
+			{
+				if (FAILED(device_context3_->CreateSpriteBatch(&sprite_batch_)))
+					device_context3_ = nullptr;
+			}
+		}
+#endif
 		return hr;
 	}
 
@@ -125,15 +171,28 @@ namespace kiwano
 
 	HRESULT Renderer::BeginDraw()
 	{
-		if (!device_context_)
+		if (!device_context_ && !headless_)
 			return E_UNEXPECTED;
 
 		if (collecting_data_)
 		{
 			status_.start = Time::Now();
 			status_.primitives = 0;
+			status_.draw_calls = 0;
+		}
+
+		commands_.Clear();
+		commands_.ResetStats();
+		retained_.resize(0);
+		transform_ = Matrix{};
+
+		if (headless_)
+		{
+			recorder_.Reset();
+			return S_OK;
 		}
 
+		device_transform_valid_ = false;
 		device_context_->SaveDrawingState(drawing_state_block_.Get());
 
 		device_context_->BeginDraw();
@@ -142,10 +201,24 @@ namespace kiwano
 
 	HRESULT Renderer::EndDraw()
 	{
+		HRESULT hr = Flush();
+
+		if (collecting_data_)
+		{
+			status_.draw_calls = static_cast<int>(commands_.GetStats().draw_calls);
+		}
+
+		if (headless_)
+		{
+			if (collecting_data_)
+				status_.duration = Time::Now() - status_.start;
+			return hr;
+		}
+
 		if (!device_context_)
 			return E_UNEXPECTED;
 
-		HRESULT hr = device_context_->EndDraw();
+		hr = device_context_->EndDraw();
 
 		device_context_->RestoreDrawingState(drawing_state_block_.Get());
 
@@ -169,7 +242,7 @@ namespace kiwano
 
 		if (hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET)
 		{
-			//  Direct3D 豸ִйʧǰ豸Դ
+			// 如果 Direct3D 设备在执行过程中消失，将丢弃当前的设备相关资源
 			hr = HandleDeviceLost();
 		}
 
@@ -183,7 +256,7 @@ namespace kiwano
 	HRESULT Renderer::CreateLayer(ComPtr<ID2D1Layer>& layer)
 	{
 		if (!device_context_)
-			return E_UNEXPECTED;
+			return headless_ ? S_OK : E_UNEXPECTED;
 
 		layer = nullptr;
 		return device_context_->CreateLayer(&layer);
@@ -196,17 +269,19 @@ namespace kiwano
 		StrokeStyle stroke
 	)
 	{
-		if (!solid_color_brush_ || !device_context_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
-		solid_color_brush_->SetColor(DX::ConvertToColorF(stroke_color));
+		if (!geometry)
+			return S_OK;
 
-		device_context_->DrawGeometry(
-			geometry.Get(),
-			solid_color_brush_.Get(),
-			stroke_width,
-			device_resources_->GetStrokeStyle(stroke)
-		);
+		RenderCommand& cmd = commands_.Record(RenderCommandType::DrawGeometry);
+		cmd.transform = transform_;
+		cmd.opacity = opacity_;
+		cmd.geometry = geometry.Get();
+		cmd.color = stroke_color;
+		cmd.stroke_width = stroke_width;
+		cmd.stroke = stroke;
 
 		if (collecting_data_)
 			++status_.primitives;
@@ -215,33 +290,53 @@ namespace kiwano
 
 	HRESULT Renderer::FillGeometry(ComPtr<ID2D1Geometry> const & geometry, Color const& fill_color)
 	{
-		if (!solid_color_brush_ || !device_context_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
-		solid_color_brush_->SetColor(DX::ConvertToColorF(fill_color));
-		device_context_->FillGeometry(
-			geometry.Get(),
-			solid_color_brush_.Get()
-		);
+		if (!geometry)
+			return S_OK;
+
+		RenderCommand& cmd = commands_.Record(RenderCommandType::FillGeometry);
+		cmd.transform = transform_;
+		cmd.opacity = opacity_;
+		cmd.geometry = geometry.Get();
+		cmd.color = fill_color;
 
+		if (collecting_data_)
+			++status_.primitives;
+		return S_OK;
+	}
+
+	HRESULT Renderer::FillRectangle(Rect const& rect, Color const& fill_color)
+	{
+		if (!IsDrawable())
+			return E_UNEXPECTED;
+
+		RenderCommand& cmd = commands_.Record(RenderCommandType::FillRectangle);
+		cmd.transform = transform_;
+		cmd.opacity = opacity_;
+		cmd.dest_rect = rect;
+		cmd.color = fill_color;
+
+		if (collecting_data_)
+			++status_.primitives;
 		return S_OK;
 	}
 
 	HRESULT Renderer::DrawImage(ImagePtr image, Rect const& dest_rect)
 	{
-		if (!device_context_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
-		if (!image->GetBitmap())
+		if (!image || !image->GetBitmap())
 			return S_OK;
 
-		device_context_->DrawBitmap(
-			image->GetBitmap().Get(),
-			DX::ConvertToRectF(dest_rect),
-			opacity_,
-			D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
-			DX::ConvertToRectF(image->GetCropRect())
-		);
+		RenderCommand& cmd = commands_.Record(RenderCommandType::Sprite, image->GetBitmap().Get());
+		cmd.transform = transform_;
+		cmd.opacity = opacity_;
+		cmd.bitmap = image->GetBitmap().Get();
+		cmd.src_rect = image->GetBitmapRect();
+		cmd.dest_rect = dest_rect;
 
 		if (collecting_data_)
 			++status_.primitives;
@@ -250,34 +345,46 @@ namespace kiwano
 
 	HRESULT Renderer::DrawBitmap(ComPtr<ID2D1Bitmap> const & bitmap, Rect const& src_rect, Rect const& dest_rect)
 	{
-		if (!device_context_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
 		if (!bitmap)
 			return S_OK;
 
 		// Do not crop bitmap 
-		device_context_->DrawBitmap(
-			bitmap.Get(),
-			DX::ConvertToRectF(dest_rect),
-			opacity_,
-			D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
-			DX::ConvertToRectF(src_rect)
-		);
+		RenderCommand& cmd = commands_.Record(RenderCommandType::Sprite, bitmap.Get());
+		cmd.transform = transform_;
+		cmd.opacity = opacity_;
+		cmd.bitmap = bitmap.Get();
+		cmd.src_rect = src_rect;
+		cmd.dest_rect = dest_rect;
 
 		if (collecting_data_)
-		++status_.primitives;
+			++status_.primitives;
 		return S_OK;
 	}
 
 	HRESULT Renderer::DrawTextLayout(ComPtr<IDWriteTextLayout> const& text_layout)
 	{
-		if (!text_renderer_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
+		if (!text_layout)
+			return S_OK;
+
+		RenderCommand& cmd = commands_.Record(RenderCommandType::Text);
+		cmd.transform = transform_;
+		cmd.opacity = opacity_;
+		cmd.text_layout = text_layout.Get();
+		cmd.color = text_style_.color;
+		cmd.outline = text_style_.outline;
+		cmd.outline_color = text_style_.outline_color;
+		cmd.stroke_width = text_style_.outline_width;
+		cmd.stroke = text_style_.outline_stroke;
+
 		if (collecting_data_)
 			++status_.primitives;
-		return text_layout->Draw(nullptr, text_renderer_.Get(), 0, 0);
+		return S_OK;
 	}
 
 	void Renderer::SetVSyncEnabled(bool enabled)
@@ -287,52 +394,42 @@ namespace kiwano
 
 	HRESULT Renderer::PushClip(const Matrix & clip_matrix, const Size & clip_size)
 	{
-		if (!device_context_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
-		device_context_->SetTransform(DX::ConvertToMatrix3x2F(clip_matrix));
-		device_context_->PushAxisAlignedClip(
-			D2D1::RectF(0, 0, clip_size.x, clip_size.y),
-			D2D1_ANTIALIAS_MODE_PER_PRIMITIVE
-		);
+		RenderCommand& cmd = commands_.Record(RenderCommandType::PushClip);
+		cmd.transform = clip_matrix;
+		cmd.dest_rect = Rect{ 0, 0, clip_size.x, clip_size.y };
 		return S_OK;
 	}
 
 	HRESULT Renderer::PopClip()
 	{
-		if (!device_context_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
-		device_context_->PopAxisAlignedClip();
+		commands_.Record(RenderCommandType::PopClip);
 		return S_OK;
 	}
 
 	HRESULT Renderer::PushLayer(ComPtr<ID2D1Layer> const& layer, LayerProperties const& properties)
 	{
-		if (!device_context_ || !solid_color_brush_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
-		device_context_->PushLayer(
-			D2D1::LayerParameters(
-				DX::ConvertToRectF(properties.area),
-				nullptr,
-				D2D1_ANTIALIAS_MODE_PER_PRIMITIVE,
-				D2D1::Matrix3x2F::Identity(),
-				properties.opacity,
-				solid_color_brush_.Get(),
-				D2D1_LAYER_OPTIONS_NONE
-			),
-			layer.Get()
-		);
+		RenderCommand& cmd = commands_.Record(RenderCommandType::PushLayer);
+		cmd.layer = layer.Get();
+		cmd.dest_rect = properties.area;
+		cmd.opacity = properties.opacity;
 		return S_OK;
 	}
 
 	HRESULT Renderer::PopLayer()
 	{
-		if (!device_context_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
-		device_context_->PopLayer();
+		commands_.Record(RenderCommandType::PopLayer);
 		return S_OK;
 	}
 
@@ -340,13 +437,219 @@ namespace kiwano
 	{
 		output_size_.x = static_cast<float>(width);
 		output_size_.y = static_cast<float>(height);
-		if (device_resources_)
+		if (device_resources_ && !headless_)
 		{
 			return device_resources_->SetLogicalSize(output_size_);
 		}
 		return S_OK;
 	}
 
+	void Renderer::Retain(IUnknown* resource)
+	{
+		// consecutive calls usually pass the same resource
+		if (resource && (retained_.empty() || retained_.back().Get() != resource))
+		{
+			retained_.push_back(resource);
+		}
+	}
+
+	HRESULT Renderer::Flush()
+	{
+		if (headless_)
+		{
+			commands_.Execute(&recorder_);
+			retained_.resize(0);
+			return S_OK;
+		}
+
+		if (!device_context_)
+		{
+			commands_.Clear();
+			retained_.resize(0);
+			return E_UNEXPECTED;
+		}
+
+		commands_.Execute(this);
+		retained_.resize(0);
+
+		// the device may be used directly after flushing
+		device_transform_valid_ = false;
+		return S_OK;
+	}
+
+	bool Renderer::IsDrawable() const
+	{
+		return device_context_ || headless_;
+	}
+
+	void Renderer::SetDeviceTransform(const Matrix & matrix)
+	{
+		if (device_transform_valid_ && std::equal(matrix.m, matrix.m + 6, device_transform_.m))
+			return;
+
+		device_transform_ = matrix;
+		device_transform_valid_ = true;
+		device_context_->SetTransform(DX::ConvertToMatrix3x2F(matrix));
+	}
+
+	void Renderer::DrawSpriteBatch(RenderCommand const& first, SpriteBatchItem const* items, unsigned int count)
+	{
+		ID2D1Bitmap* bitmap = first.bitmap;
+		if (!bitmap)
+			return;
+
+#if defined(KGE_USE_D2D_SPRITE_BATCH)
+		if (sprite_batch_ && count > 1)
+		{
+			sprite_dest_rects_.resize(count);
+			sprite_src_rects_.resize(count);
+			sprite_colors_.resize(count);
+			sprite_transforms_.resize(count);
+
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				// sprite batches take integer source rectangles
+				Rect const& src = items[i].src_rect;
+				sprite_dest_rects_.data()[i] = DX::ConvertToRectF(items[i].dest_rect);
+				sprite_src_rects_.data()[i] = D2D1::RectU(
+					static_cast<UINT32>(src.origin.x + 0.5f),
+					static_cast<UINT32>(src.origin.y + 0.5f),
+					static_cast<UINT32>(src.origin.x + src.size.x + 0.5f),
+					static_cast<UINT32>(src.origin.y + src.size.y + 0.5f)
+				);
+				sprite_colors_.data()[i] = D2D1::ColorF(1.f, 1.f, 1.f, items[i].opacity);
+				sprite_transforms_.data()[i] = DX::ConvertToMatrix3x2F(items[i].transform);
+			}
+
+			sprite_batch_->Clear();
+
+			HRESULT hr = sprite_batch_->AddSprites(
+				count,
+				sprite_dest_rects_.data(),
+				sprite_src_rects_.data(),
+				sprite_colors_.data(),
+				sprite_transforms_.data()
+			);
+
+			if (SUCCEEDED(hr))
+			{
+				// sprite batches can only be drawn in aliased mode
+				SetDeviceTransform(Matrix{});
+				device_context_->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+
+				device_context3_->DrawSpriteBatch(
+					sprite_batch_.Get(),
+					bitmap,
+					D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+					D2D1_SPRITE_OPTIONS_NONE
+				);
+
+				device_context_->SetAntialiasMode(
+					antialias_ ? D2D1_ANTIALIAS_MODE_PER_PRIMITIVE : D2D1_ANTIALIAS_MODE_ALIASED
+				);
+				return;
+			}
+		}
+#endif
+
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			SetDeviceTransform(items[i].transform);
+
+			device_context_->DrawBitmap(
+				bitmap,
+				DX::ConvertToRectF(items[i].dest_rect),
+				items[i].opacity,
+				D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+				DX::ConvertToRectF(items[i].src_rect)
+			);
+		}
+	}
+
+	void Renderer::Execute(RenderCommand const& cmd)
+	{
+		switch (cmd.type)
+		{
+		case RenderCommandType::FillGeometry:
+			SetDeviceTransform(cmd.transform);
+			solid_color_brush_->SetColor(DX::ConvertToColorF(cmd.color));
+			solid_color_brush_->SetOpacity(cmd.opacity);
+			device_context_->FillGeometry(
+				cmd.geometry,
+				solid_color_brush_.Get()
+			);
+			break;
+
+		case RenderCommandType::DrawGeometry:
+			SetDeviceTransform(cmd.transform);
+			solid_color_brush_->SetColor(DX::ConvertToColorF(cmd.color));
+			solid_color_brush_->SetOpacity(cmd.opacity);
+			device_context_->DrawGeometry(
+				cmd.geometry,
+				solid_color_brush_.Get(),
+				cmd.stroke_width,
+				device_resources_->GetStrokeStyle(cmd.stroke)
+			);
+			break;
+
+		case RenderCommandType::FillRectangle:
+			SetDeviceTransform(cmd.transform);
+			solid_color_brush_->SetColor(DX::ConvertToColorF(cmd.color));
+			solid_color_brush_->SetOpacity(cmd.opacity);
+			device_context_->FillRectangle(
+				DX::ConvertToRectF(cmd.dest_rect),
+				solid_color_brush_.Get()
+			);
+			break;
+
+		case RenderCommandType::Text:
+			SetDeviceTransform(cmd.transform);
+			text_renderer_->SetTextStyle(
+				DX::ConvertToColorF(cmd.color),
+				cmd.outline,
+				DX::ConvertToColorF(cmd.outline_color),
+				cmd.stroke_width,
+				device_resources_->GetStrokeStyle(cmd.stroke)
+			);
+			cmd.text_layout->Draw(nullptr, text_renderer_.Get(), 0, 0);
+			break;
+
+		case RenderCommandType::PushClip:
+			SetDeviceTransform(cmd.transform);
+			device_context_->PushAxisAlignedClip(
+				DX::ConvertToRectF(cmd.dest_rect),
+				D2D1_ANTIALIAS_MODE_PER_PRIMITIVE
+			);
+			break;
+
+		case RenderCommandType::PopClip:
+			device_context_->PopAxisAlignedClip();
+			break;
+
+		case RenderCommandType::PushLayer:
+			device_context_->PushLayer(
+				D2D1::LayerParameters(
+					DX::ConvertToRectF(cmd.dest_rect),
+					nullptr,
+					D2D1_ANTIALIAS_MODE_PER_PRIMITIVE,
+					D2D1::Matrix3x2F::Identity(),
+					cmd.opacity,
+					solid_color_brush_.Get(),
+					D2D1_LAYER_OPTIONS_NONE
+				),
+				cmd.layer
+			);
+			break;
+
+		case RenderCommandType::PopLayer:
+			device_context_->PopLayer();
+			break;
+
+		default:
+			break;
+		}
+	}
+
 	void Renderer::StartCollectData()
 	{
 		collecting_data_ = true;
@@ -364,20 +667,16 @@ namespace kiwano
 
 	HRESULT Renderer::SetTransform(const Matrix & matrix)
 	{
-		if (!device_context_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
-		device_context_->SetTransform(DX::ConvertToMatrix3x2F(matrix));
+		transform_ = matrix;
 		return S_OK;
 	}
 
 	void Renderer::SetOpacity(float opacity)
 	{
-		if (opacity_ != opacity)
-		{
-			opacity_ = opacity;
-			solid_color_brush_->SetOpacity(opacity);
-		}
+		opacity_ = opacity;
 	}
 
 	HRESULT Renderer::SetTextStyle(
@@ -388,23 +687,21 @@ namespace kiwano
 		StrokeStyle outline_stroke
 	)
 	{
-		if (!text_renderer_ || !device_resources_)
+		if (!IsDrawable())
 			return E_UNEXPECTED;
 
-		text_renderer_->SetTextStyle(
-			DX::ConvertToColorF(color),
-			has_outline,
-			DX::ConvertToColorF(outline_color),
-			outline_width,
-			device_resources_->GetStrokeStyle(outline_stroke)
-		);
+		text_style_.color = color;
+		text_style_.outline = has_outline;
+		text_style_.outline_color = outline_color;
+		text_style_.outline_width = outline_width;
+		text_style_.outline_stroke = outline_stroke;
 		return S_OK;
 	}
 
 	HRESULT Renderer::SetAntialiasMode(bool enabled)
 	{
 		if (!device_context_)
-			return E_UNEXPECTED;
+			return headless_ ? S_OK : E_UNEXPECTED;
 
 		device_context_->SetAntialiasMode(
 			enabled ? D2D1_ANTIALIAS_MODE_PER_PRIMITIVE : D2D1_ANTIALIAS_MODE_ALIASED
@@ -416,7 +713,7 @@ namespace kiwano
 	HRESULT Renderer::SetTextAntialiasMode(TextAntialias mode)
 	{
 		if (!device_context_)
-			return E_UNEXPECTED;
+			return headless_ ? S_OK : E_UNEXPECTED;
 
 		text_antialias_ = mode;
 		D2D1_TEXT_ANTIALIAS_MODE antialias_mode = D2D1_TEXT_ANTIALIAS_MODE_CLEARTYPE;
@@ -28,6 +28,11 @@
 #include "helper.hpp"
 #include "DeviceResources.h"
 #include "TextRenderer.h"
+#include "RenderCommand.h"
+
+#if defined(KGE_USE_D2D_SPRITE_BATCH)
+#	include <d2d1_3.h>
+#endif
 
 namespace kiwano
 {
@@ -36,11 +41,13 @@ namespace kiwano
 		Time start;
 		Duration duration;
 		int primitives;
+		int draw_calls;
 	};
 
 	class KGE_API Renderer
 		: public Singleton<Renderer>
 		, public Component
+		, protected RenderBackend
 	{
 		KGE_DECLARE_SINGLETON(Renderer);
 
@@ -65,6 +72,11 @@ namespace kiwano
 			Color const& fill_color
 		);
 
+		HRESULT FillRectangle(
+			Rect const& rect,
+			Color const& fill_color
+		);
+
 		HRESULT DrawImage(
 			ImagePtr image,
 			Rect const& dest_rect
@@ -80,27 +92,27 @@ namespace kiwano
 			ComPtr<IDWriteTextLayout> const& text_layout
 		);
 
-		// ɫ
+		// 设置清屏颜色
 		void SetClearColor(
 			Color const& clear_color
 		);
 
-		// ÿģʽ
+		// 设置抗锯齿模式
 		HRESULT SetAntialiasMode(
 			bool enabled
 		);
 
-		// ֿģʽ
+		// 设置文字抗锯齿模式
 		HRESULT SetTextAntialiasMode(
 			TextAntialias mode
 		);
 
-		// رմֱͬ
+		// 开启或关闭垂直同步
 		void SetVSyncEnabled(
 			bool enabled
 		);
 
-		// û͸
+		// 设置画笔透明度
 		void SetOpacity(
 			float opacity
 		);
@@ -136,6 +148,16 @@ namespace kiwano
 			UINT height
 		);
 
+		// 保持资源直到已记录的命令提交或丢弃
+		// 用于在帧内可能被释放的资源, 如缓存中可能被淘汰的位图
+		void Retain(
+			IUnknown* resource
+		);
+
+		// 提交已记录的渲染命令
+		// 直接使用设备上下文绘制前需要先调用
+		HRESULT Flush();
+
 	public:
 		void SetupComponent(Application*) override;
 
@@ -145,6 +167,8 @@ namespace kiwano
 
 		void StopCollectData();
 
+		inline bool						IsHeadless() const			{ return headless_; }
+
 		inline HWND						GetTargetWindow() const		{ return hwnd_; }
 
 		inline RenderStatus const&		GetStatus() const			{ return status_; }
@@ -157,6 +181,10 @@ namespace kiwano
 
 		inline ID2D1SolidColorBrush*	GetSolidColorBrush() const	{ return solid_color_brush_.Get(); }
 
+		inline RenderCommandList&		GetCommandList()			{ return commands_; }
+
+		inline RecordingRenderBackend const& GetRecordingBackend() const	{ return recorder_; }
+
 	private:
 		Renderer();
 
@@ -166,6 +194,22 @@ namespace kiwano
 
 		HRESULT HandleDeviceLost();
 
+		bool IsDrawable() const;
+
+		void SetDeviceTransform(
+			const Matrix& matrix
+		);
+
+		void DrawSpriteBatch(
+			RenderCommand const& first,
+			SpriteBatchItem const* items,
+			unsigned int count
+		) override;
+
+		void Execute(
+			RenderCommand const& cmd
+		) override;
+
 	private:
 		unsigned long ref_count_;
 
@@ -174,11 +218,20 @@ namespace kiwano
 		bool antialias_;
 		bool vsync_;
 		bool collecting_data_;
+		bool headless_;
+		bool device_transform_valid_;
 
 		Size			output_size_;
 		Color			clear_color_;
 		TextAntialias	text_antialias_;
 		RenderStatus	status_;
+		Matrix			transform_;
+		Matrix			device_transform_;
+		TextStyle		text_style_;
+
+		RenderCommandList		commands_;
+		RecordingRenderBackend	recorder_;
+		Array<ComPtr<IUnknown>>	retained_;
 
 		ComPtr<DeviceResources>			device_resources_;
 		ComPtr<ID2D1Factory1>			factory_;
@@ -186,5 +239,14 @@ namespace kiwano
 		ComPtr<ID2D1DrawingStateBlock>	drawing_state_block_;
 		ComPtr<ITextRenderer>			text_renderer_;
 		ComPtr<ID2D1SolidColorBrush>	solid_color_brush_;
+
+#if defined(KGE_USE_D2D_SPRITE_BATCH)
+		ComPtr<ID2D1DeviceContext3>		device_context3_;
+		ComPtr<ID2D1SpriteBatch>		sprite_batch_;
+		Array<D2D1_RECT_F>				sprite_dest_rects_;
+		Array<D2D1_RECT_U>				sprite_src_rects_;
+		Array<D2D1_COLOR_F>				sprite_colors_;
+		Array<D2D1_MATRIX_3X2_F>		sprite_transforms_;
+#endif
 	};
 }
@@ -33,47 +33,47 @@ namespace kiwano
 		Button();
 
 		explicit Button(
-			Callback const& click		/* ťص */
+			Callback const& click		/* 按钮点击回调函数 */
 		);
 
 		Button(
-			Callback const& click,		/* ťص */
-			Callback const& pressed,	/* ť»ص */
-			Callback const& mouse_over,	/* ťص */
-			Callback const& mouse_out	/* ťƳص */
+			Callback const& click,		/* 按钮点击回调函数 */
+			Callback const& pressed,	/* 按钮按下回调函数 */
+			Callback const& mouse_over,	/* 按钮移入回调函数 */
+			Callback const& mouse_out	/* 按钮移出回调函数 */
 		);
 
 		virtual ~Button();
 
-		// ȡť״̬ûǽ
+		// 获取按钮状态是启用还是禁用
 		bool IsEnable() const;
 
-		// ðťû
+		// 设置按钮启用或禁用
 		void SetEnabled(
 			bool enabled
 		);
 
-		// ðťĻص
+		// 设置按钮点击后的回调函数
 		void SetClickCallback(
 			const Callback& func
 		);
 
-		// ðťʱĻص
+		// 设置按钮被按下时的回调函数
 		void SetPressedCallback(
 			const Callback& func
 		);
 
-		// ðţ̌ʱĻص
+		// 设置按钮被抬起时的回调函数
 		void SetReleasedCallback(
 			const Callback& func
 		);
 
-		// 밴ťʱĻص
+		// 设置鼠标移入按钮时的回调函数
 		void SetMouseOverCallback(
 			const Callback& func
 		);
 
-		// ƳťʱĻص
+		// 设置鼠标移出按钮时的回调函数
 		void SetMouseOutCallback(
 			const Callback& func
 		);
@@ -83,7 +83,7 @@ namespace kiwano
 			auto iter = std::find(buttons_.begin(), buttons_.end(), button);
 			if (iter != buttons_.end())
 			{
-				// Ƴťǰ
+				// 移除按钮前，将它启用
 				button->SetEnabled(true);
 				buttons_.erase(iter);
 				return true;
@@ -23,7 +23,7 @@
 
 namespace kiwano
 {
-	// ˵
+	// 菜单
 	class KGE_API Menu
 		: public Node
 	{
@@ -31,31 +31,31 @@ namespace kiwano
 		Menu();
 
 		explicit Menu(
-			Array<ButtonPtr> const& buttons	/* ť */
+			Array<ButtonPtr> const& buttons	/* 按钮数组 */
 		);
 
-		// ȡ˵Ƿ
+		// 获取菜单是否禁用
 		bool IsEnable() const;
 
-		// ȡ˵еİť
+		// 获取菜单中的按钮数量
 		size_t GetButtonCount() const;
 
-		// ò˵û
+		// 设置菜单启用或禁用
 		void SetEnabled(
 			bool enabled
 		);
 
-		// Ӱť
+		// 添加按钮
 		void AddButton(
 			ButtonPtr button
 		);
 
-		// Ƴť
+		// 移除按钮
 		bool RemoveButton(
 			ButtonPtr button
 		);
 
-		// ȡаť
+		// 获取所有按钮
 		Array<ButtonPtr> const& GetAllButtons() const;
 
 	private:
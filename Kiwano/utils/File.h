@@ -25,7 +25,7 @@
 
 namespace kiwano
 {
-    // ļ
+    // 文件
 	class KGE_API  File
 	{
 	public:
@@ -37,27 +37,27 @@ namespace kiwano
 
 		virtual ~File();
 
-		// ļ
+		// 打开文件
 		bool Open(
 			String const& file_name
 		);
 
-		// ļǷ
+		// 文件是否存在
 		bool Exists() const;
 
-		// ɾļ
+		// 删除文件
 		bool Delete();
 
-		// ȡļ·
+		// 获取文件路径
 		String const& GetPath() const;
 
-		// ȡļչ
+		// 获取文件扩展名
 		String GetExtension() const;
 
-		// ͷŶԴʱļĿ¼
+		// 释放二进制资源到临时文件目录
 		static File Extract(
-			Resource const& res,			/* Դ */
-			String const& dest_file_name	/* Ŀļ */
+			Resource const& res,			/* 资源 */
+			String const& dest_file_name	/* 目标文件名 */
 		);
 
 	protected:
@@ -24,41 +24,12 @@
 
 namespace kiwano
 {
-	namespace
-	{
-		// ָļ
-		bool CreateFolder(String const& dir_path)
-		{
-			if (dir_path.empty() || dir_path.size() >= MAX_PATH)
-				return false;
-
-			wchar_t tmp_dir_path[MAX_PATH] = { 0 };
-			size_t length = dir_path.length();
-
-			for (size_t i = 0; i < length; ++i)
-			{
-				tmp_dir_path[i] = dir_path.at(i);
-				if (tmp_dir_path[i] == L'\\' || tmp_dir_path[i] == L'/' || i == (length - 1))
-				{
-					if (::_waccess(tmp_dir_path, 0) != 0)
-					{
-						if (::_wmkdir(tmp_dir_path) != 0)
-						{
-							return false;
-						}
-					}
-				}
-			}
-			return true;
-		}
-	}
-
 	String const& Path::GetTemporaryPath()
 	{
 		static String temp_path;
 		if (temp_path.empty())
 		{
-			// ʱļ·
+			// 设置临时文件保存路径
 			wchar_t path[_MAX_PATH];
 
 			if (0 != ::GetTempPath(_MAX_PATH, path))
@@ -79,7 +50,7 @@ namespace kiwano
 		static String local_app_data_path;
 		if (local_app_data_path.empty())
 		{
-			// ȡ AppData/Local ļе·
+			// 获取 AppData/Local 文件夹的路径
 			wchar_t path[MAX_PATH] = { 0 };
 			::SHGetFolderPath(NULL, CSIDL_LOCAL_APPDATA, NULL, SHGFP_TYPE_CURRENT, path);
 			local_app_data_path = path;
@@ -101,4 +72,29 @@ namespace kiwano
 		}
 		return exe_file_path;
 	}
+
+	bool Path::CreateFolder(String const& dir_path)
+	{
+		if (dir_path.empty() || dir_path.size() >= MAX_PATH)
+			return false;
+
+		wchar_t tmp_dir_path[MAX_PATH] = { 0 };
+		size_t length = dir_path.length();
+
+		for (size_t i = 0; i < length; ++i)
+		{
+			tmp_dir_path[i] = dir_path.at(i);
+			if (tmp_dir_path[i] == L'\\' || tmp_dir_path[i] == L'/' || i == (length - 1))
+			{
+				if (::_waccess(tmp_dir_path, 0) != 0)
+				{
+					if (::_wmkdir(tmp_dir_path) != 0)
+					{
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
 }
\ No newline at end of file
@@ -24,17 +24,22 @@
 
 namespace kiwano
 {
-	// ·
+	// 路径
 	class KGE_API Path
 	{
 	public:
-		// ȡʱļĿ¼
+		// 获取临时文件目录
 		static String const& GetTemporaryPath();
 
-		// ȡ LocalAppData Ŀ¼
+		// 获取 LocalAppData 目录
 		static String const& GetLocalAppDataPath();
 
-		// ȡǰ·
+		// 获取当前程序的运行路径
 		static String const& GetExeFilePath();
+
+		// 创建文件夹, 会逐级创建不存在的上级目录
+		static bool CreateFolder(
+			String const& dir_path
+		);
 	};
 }
@@ -0,0 +1,240 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "RectPacker.h"
+#include <climits>
+
+namespace kiwano
+{
+	namespace
+	{
+		using Box = RectPacker::Box;
+
+		inline bool Contains(Box const& outer, Box const& inner)
+		{
+			return inner.x >= outer.x && inner.y >= outer.y
+				&& inner.x + inner.width <= outer.x + outer.width
+				&& inner.y + inner.height <= outer.y + outer.height;
+		}
+
+		inline bool Intersects(Box const& a, Box const& b)
+		{
+			return a.x < b.x + b.width && b.x < a.x + a.width
+				&& a.y < b.y + b.height && b.y < a.y + a.height;
+		}
+
+		inline void RemoveAt(Array<Box>& rects, size_t index)
+		{
+			// order of free rects does not matter
+			rects[index] = rects[rects.size() - 1];
+			rects.pop_back();
+		}
+	}
+
+	RectPacker::RectPacker(int page_width, int page_height, int padding)
+		: page_width_(page_width)
+		, page_height_(page_height)
+		, padding_(std::max(padding, 0))
+		, used_area_(0)
+	{
+	}
+
+	bool RectPacker::Insert(int width, int height, Box& box)
+	{
+		box.page = -1;
+		box.width = width;
+		box.height = height;
+
+		if (width <= 0 || height <= 0 || width > page_width_ || height > page_height_)
+			return false;
+
+		// every rect reserves the padding on its right and bottom side
+		const int padded_width = width + padding_;
+		const int padded_height = height + padding_;
+
+		Box found = {};
+		int page_index = -1;
+		for (size_t i = 0; i < pages_.size(); ++i)
+		{
+			if (FindPosition(pages_[i], padded_width, padded_height, found))
+			{
+				page_index = static_cast<int>(i);
+				break;
+			}
+		}
+
+		if (page_index < 0)
+		{
+			// the padding may hang over the page border
+			Page page;
+			page.free_rects.push_back(Box{ 0, 0, 0, page_width_ + padding_, page_height_ + padding_ });
+			pages_.push_back(std::move(page));
+
+			page_index = static_cast<int>(pages_.size() - 1);
+			FindPosition(pages_[page_index], padded_width, padded_height, found);
+		}
+
+		found.width = padded_width;
+		found.height = padded_height;
+		Place(pages_[page_index], found);
+
+		box.page = page_index;
+		box.x = found.x;
+		box.y = found.y;
+		used_area_ += static_cast<long long>(width) * height;
+		return true;
+	}
+
+	size_t RectPacker::Insert(Array<Box>& boxes)
+	{
+		Array<size_t> order;
+		order.reserve(boxes.size());
+		for (size_t i = 0; i < boxes.size(); ++i)
+			order.push_back(i);
+
+		// larger rects first, they are the hardest to place later
+		std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs)
+			{
+				Box const& a = boxes[lhs];
+				Box const& b = boxes[rhs];
+
+				const int a_side = std::max(a.width, a.height);
+				const int b_side = std::max(b.width, b.height);
+				if (a_side != b_side)
+					return a_side > b_side;
+				return a.width * a.height > b.width * b.height;
+			}
+		);
+
+		size_t packed = 0;
+		for (auto index : order)
+		{
+			Box& box = boxes[index];
+			if (Insert(box.width, box.height, box))
+				++packed;
+		}
+		return packed;
+	}
+
+	bool RectPacker::FindPosition(Page const& page, int width, int height, Box& box) const
+	{
+		int best_short = INT_MAX;
+		int best_long = INT_MAX;
+
+		for (auto const& free_rect : page.free_rects)
+		{
+			if (free_rect.width < width || free_rect.height < height)
+				continue;
+
+			const int leftover_x = free_rect.width - width;
+			const int leftover_y = free_rect.height - height;
+			const int short_side = std::min(leftover_x, leftover_y);
+			const int long_side = std::max(leftover_x, leftover_y);
+
+			if (short_side < best_short || (short_side == best_short && long_side < best_long))
+			{
+				best_short = short_side;
+				best_long = long_side;
+				box.x = free_rect.x;
+				box.y = free_rect.y;
+			}
+		}
+		return best_short != INT_MAX;
+	}
+
+	void RectPacker::Place(Page& page, Box const& used)
+	{
+		Array<Box>& free_rects = page.free_rects;
+		new_rects_.resize(0);
+
+		// split every free rect overlapped by the used one into up to four maximal rects
+		for (size_t i = 0; i < free_rects.size();)
+		{
+			const Box free_rect = free_rects[i];
+			if (!Intersects(free_rect, used))
+			{
+				++i;
+				continue;
+			}
+
+			if (used.x > free_rect.x)
+				new_rects_.push_back(Box{ 0, free_rect.x, free_rect.y, used.x - free_rect.x, free_rect.height });
+
+			if (used.x + used.width < free_rect.x + free_rect.width)
+				new_rects_.push_back(Box{ 0, used.x + used.width, free_rect.y, free_rect.x + free_rect.width - used.x - used.width, free_rect.height });
+
+			if (used.y > free_rect.y)
+				new_rects_.push_back(Box{ 0, free_rect.x, free_rect.y, free_rect.width, used.y - free_rect.y });
+
+			if (used.y + used.height < free_rect.y + free_rect.height)
+				new_rects_.push_back(Box{ 0, free_rect.x, used.y + used.height, free_rect.width, free_rect.y + free_rect.height - used.y - used.height });
+
+			RemoveAt(free_rects, i);
+		}
+
+		// drop new rects that are contained by another one. an old rect can never be
+		// contained by a new one, since each new rect lies inside a maximal old rect
+		for (size_t i = 0; i < new_rects_.size();)
+		{
+			bool contained = false;
+			for (size_t j = 0; j < new_rects_.size() && !contained; ++j)
+			{
+				if (i != j && Contains(new_rects_[j], new_rects_[i]))
+				{
+					// keep one of two identical rects
+					contained = !Contains(new_rects_[i], new_rects_[j]) || j < i;
+				}
+			}
+
+			for (size_t j = 0; j < free_rects.size() && !contained; ++j)
+			{
+				contained = Contains(free_rects[j], new_rects_[i]);
+			}
+
+			if (contained)
+			{
+				RemoveAt(new_rects_, i);
+				continue;
+			}
+			++i;
+		}
+
+		for (auto const& rect : new_rects_)
+		{
+			free_rects.push_back(rect);
+		}
+	}
+
+	void RectPacker::Reset()
+	{
+		pages_.clear();
+		new_rects_.resize(0);
+		used_area_ = 0;
+	}
+
+	float RectPacker::GetOccupancy() const
+	{
+		if (pages_.empty())
+			return 0.f;
+
+		const long long total = static_cast<long long>(page_width_) * page_height_ * static_cast<long long>(pages_.size());
+		return static_cast<float>(static_cast<double>(used_area_) / static_cast<double>(total));
+	}
+}
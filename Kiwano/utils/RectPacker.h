@@ -0,0 +1,110 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/defines.h"
+#include "../common/Array.h"
+
+namespace kiwano
+{
+	//
+	// 矩形装箱
+	// 使用 MaxRects 算法 (短边最佳匹配) 将矩形放入固定大小的页面, 当前页面放不下时开启新页面
+	// 只做坐标计算, 不涉及图片数据, 可以在离线工具中使用
+	//
+
+	class KGE_API RectPacker
+	{
+	public:
+		struct Box
+		{
+			int page;		// 所在页面, 放置失败时为 -1
+			int x;
+			int y;
+			int width;
+			int height;
+		};
+
+	public:
+		RectPacker(
+			int page_width = 1024,	// 页面宽度
+			int page_height = 1024,	// 页面高度
+			int padding = 1			// 矩形之间的间距
+		);
+
+		// 放入一个矩形, 矩形大于页面时返回 false
+		bool Insert(
+			int width,
+			int height,
+			Box& box
+		);
+
+		// 放入多个矩形
+		// 先按尺寸从大到小排序再放入, 密度比逐个放入更高
+		// 返回成功放入的数量
+		size_t Insert(
+			Array<Box>& boxes	/* 输入宽高, 输出页面和坐标 */
+		);
+
+		// 清空所有页面
+		void Reset();
+
+		// 获取页面数量
+		inline int GetPageCount() const		{ return static_cast<int>(pages_.size()); }
+
+		// 获取页面宽度
+		inline int GetPageWidth() const		{ return page_width_; }
+
+		// 获取页面高度
+		inline int GetPageHeight() const	{ return page_height_; }
+
+		// 获取已放入矩形的总面积 (不含间距)
+		inline long long GetUsedArea() const	{ return used_area_; }
+
+		// 获取填充率, 已放入的面积占所有页面面积的比例
+		float GetOccupancy() const;
+
+	private:
+		struct Page
+		{
+			Array<Box> free_rects;
+		};
+
+		bool FindPosition(
+			Page const& page,
+			int width,
+			int height,
+			Box& box
+		) const;
+
+		void Place(
+			Page& page,
+			Box const& used
+		);
+
+	private:
+		int			page_width_;
+		int			page_height_;
+		int			padding_;
+		long long	used_area_;
+		Array<Page>	pages_;
+		Array<Box>	new_rects_;
+	};
+}
@@ -22,6 +22,7 @@
 #include "../platform/modules.h"
 #include "../2d/Image.h"
 #include "../2d/Frames.h"
+#include "../2d/TextureAtlas.h"
 
 namespace kiwano
 {
@@ -46,6 +47,11 @@ namespace kiwano
 
 	bool ResLoader::AddImage(String const& id, Resource const& image)
 	{
+		if (atlas_)
+		{
+			return AddImage(id, atlas_->Add(LocateRes(image, search_paths_)));
+		}
+
 		ImagePtr ptr = new (std::nothrow) Image;
 		if (ptr)
 		{
@@ -73,6 +79,26 @@ namespace kiwano
 		if (images.empty())
 			return 0;
 
+		if (atlas_)
+		{
+			Array<Resource> located;
+			located.reserve(images.size());
+			for (const auto& image : images)
+			{
+				located.push_back(LocateRes(image, search_paths_));
+			}
+
+			// skip the empty slots of failed images, same as loading them one by one
+			Array<ImagePtr> image_arr;
+			image_arr.reserve(located.size());
+			for (const auto& ptr : atlas_->Add(located))
+			{
+				if (ptr)
+					image_arr.push_back(ptr);
+			}
+			return AddFrames(id, image_arr);
+		}
+
 		Array<ImagePtr> image_arr;
 		image_arr.reserve(images.size());
 
@@ -248,4 +274,9 @@ namespace kiwano
 		}
 	}
 
+	void ResLoader::SetTextureAtlas(TextureAtlasPtr atlas)
+	{
+		atlas_ = atlas;
+	}
+
 }
\ No newline at end of file
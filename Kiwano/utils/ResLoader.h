@@ -29,30 +29,30 @@ namespace kiwano
 	class KGE_API ResLoader
 	{
 	public:
-		// ͼƬ
+		// 添加图片
 		bool AddImage(String const& id, Resource const& image);
 
-		// ͼƬ
+		// 添加图片
 		bool AddImage(String const& id, ImagePtr image);
 
-		// ֡
+		// 添加帧集合
 		size_t AddFrames(String const& id, Array<Resource> const& images);
 
-		// ֡
+		// 添加帧集合
 		size_t AddFrames(String const& id, Array<ImagePtr> const& images);
 
-		// ֡
-		// üͼƬ
+		// 添加帧集合
+		// 按行列数裁剪图片
 		size_t AddFrames(String const& id, Resource const& image, int cols, int rows = 1);
 
-		// ֡
-		// ָüβüͼƬ
+		// 添加帧集合
+		// 按指定裁剪矩形裁剪图片
 		size_t AddFrames(String const& id, Resource const& image, Array<Rect> const& crop_rects);
 
-		// ֡
+		// 添加帧集合
 		bool AddFrames(String const& id, FramesPtr frames);
 
-		// Ӷ
+		// 添加对象
 		bool AddObj(String const& id, ObjectPtr obj);
 
 		ImagePtr GetImage(String const& id) const;
@@ -61,17 +61,26 @@ namespace kiwano
 
 		ObjectPtr GetObj(String const& id) const;
 
-		// ɾָԴ
+		// 删除指定资源
 		void Delete(String const& id);
 
-		// Դ
+		// 销毁所有资源
 		void Destroy();
 
-		// Դ·
+		// 添加资源搜索路径
 		void AddSearchPath(
 			String const& path
 		);
 
+		// 设置纹理图集
+		// 设置后通过 Resource 添加的图片和帧集合会打包进图集, 传入空指针恢复逐张加载
+		void SetTextureAtlas(
+			TextureAtlasPtr atlas
+		);
+
+		// 获取纹理图集
+		inline TextureAtlasPtr GetTextureAtlas() const	{ return atlas_; }
+
 		template<typename _Ty>
 		_Ty* Get(String const& id) const
 		{
@@ -84,5 +93,6 @@ namespace kiwano
 	protected:
 		UnorderedMap<String, ObjectPtr> res_;
 		List<String> search_paths_;
+		TextureAtlasPtr atlas_;
 	};
 }
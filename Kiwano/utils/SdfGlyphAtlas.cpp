@@ -0,0 +1,429 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "SdfGlyphAtlas.h"
+#include <cmath>
+#include <cstring>
+
+// a private copy of the stb_truetype bundled with ImGui
+#pragma warning (push)
+#pragma warning (disable: 4456 4505 4996)
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "../third-party/ImGui/imstb_truetype.h"
+#pragma warning (pop)
+
+namespace kiwano
+{
+	namespace
+	{
+		// distance field value on the glyph edge
+		const int sdf_on_edge = 128;
+
+		inline float Saturate(float value)
+		{
+			return value < 0.f ? 0.f : (value > 1.f ? 1.f : value);
+		}
+
+		inline std::uint32_t PackPremultiplied(float r, float g, float b, float a)
+		{
+			const auto to_byte = [](float value) { return static_cast<std::uint32_t>(Saturate(value) * 255.f + 0.5f); };
+			return (to_byte(a) << 24) | (to_byte(r) << 16) | (to_byte(g) << 8) | to_byte(b);
+		}
+	}
+
+	SdfGlyphAtlas::SdfGlyphAtlas(float base_size, int spread, int page_size)
+		: base_size_(base_size)
+		, spread_(spread)
+		, page_size_(page_size)
+		, max_scaled_page_size_(std::max(page_size, 2048))
+		, font_scale_(0.f)
+		, ascent_(0.f)
+		, descent_(0.f)
+		, line_gap_(0.f)
+		, font_info_(nullptr)
+		, packer_(page_size, page_size, 1)
+	{
+	}
+
+	SdfGlyphAtlas::~SdfGlyphAtlas()
+	{
+		delete font_info_;
+	}
+
+	bool SdfGlyphAtlas::Load(const void* data, size_t size)
+	{
+		delete font_info_;
+		font_info_ = nullptr;
+
+		glyphs_.clear();
+		kernings_.clear();
+		pages_.clear();
+		packer_.Reset();
+
+		if (!data || !size)
+			return false;
+
+		font_data_.assign(static_cast<const std::uint8_t*>(data), static_cast<const std::uint8_t*>(data) + size);
+
+		const int offset = stbtt_GetFontOffsetForIndex(font_data_.data(), 0);
+		if (offset < 0)
+			return false;
+
+		stbtt_fontinfo* info = new stbtt_fontinfo;
+		if (!stbtt_InitFont(info, font_data_.data(), offset))
+		{
+			delete info;
+			return false;
+		}
+
+		int ascent = 0, descent = 0, line_gap = 0;
+		stbtt_GetFontVMetrics(info, &ascent, &descent, &line_gap);
+
+		font_info_ = info;
+		font_scale_ = stbtt_ScaleForPixelHeight(info, base_size_);
+		ascent_ = ascent * font_scale_;
+		descent_ = descent * font_scale_;
+		line_gap_ = line_gap * font_scale_;
+		return true;
+	}
+
+	SdfGlyphAtlas::Glyph const* SdfGlyphAtlas::GetGlyph(std::uint32_t codepoint)
+	{
+		auto iter = glyphs_.find(codepoint);
+		if (iter != glyphs_.end())
+			return &iter->second;
+
+		if (!font_info_)
+			return nullptr;
+
+		const int index = stbtt_FindGlyphIndex(font_info_, static_cast<int>(codepoint));
+
+		int advance = 0, left_bearing = 0;
+		stbtt_GetGlyphHMetrics(font_info_, index, &advance, &left_bearing);
+
+		Glyph glyph = { advance * font_scale_, 0.f, 0.f, -1, 0, 0, 0, 0 };
+
+		// whitespace has no shape and returns no distance field
+		int width = 0, height = 0, x_offset = 0, y_offset = 0;
+		std::uint8_t* sdf = stbtt_GetGlyphSDF(
+			font_info_,
+			font_scale_,
+			index,
+			spread_,
+			static_cast<unsigned char>(sdf_on_edge),
+			static_cast<float>(sdf_on_edge) / spread_,
+			&width,
+			&height,
+			&x_offset,
+			&y_offset
+		);
+
+		RectPacker::Box box;
+		if (sdf && packer_.Insert(width, height, box))
+		{
+			while (static_cast<int>(pages_.size()) <= box.page)
+			{
+				Page page;
+				page.pixels.assign(static_cast<size_t>(page_size_) * page_size_, 0);
+				page.version = 0;
+				pages_.push_back(page);
+			}
+
+			Page& page = pages_[box.page];
+			for (int row = 0; row < height; ++row)
+			{
+				::memcpy(&page.pixels[static_cast<size_t>(box.y + row) * page_size_ + box.x], sdf + row * width, width);
+			}
+			page.rects.push_back(box);
+			++page.version;
+
+			glyph.left = static_cast<float>(x_offset);
+			glyph.top = static_cast<float>(y_offset);
+			glyph.page = box.page;
+			glyph.x = box.x;
+			glyph.y = box.y;
+			glyph.width = width;
+			glyph.height = height;
+		}
+
+		if (sdf)
+		{
+			stbtt_FreeSDF(sdf, nullptr);
+		}
+
+		return &glyphs_.insert(std::make_pair(codepoint, glyph)).first->second;
+	}
+
+	float SdfGlyphAtlas::GetKerning(std::uint32_t first, std::uint32_t second)
+	{
+		if (!font_info_)
+			return 0.f;
+
+		const std::uint64_t key = (static_cast<std::uint64_t>(first) << 32) | second;
+
+		auto iter = kernings_.find(key);
+		if (iter != kernings_.end())
+			return iter->second;
+
+		const float kerning = stbtt_GetCodepointKernAdvance(font_info_, static_cast<int>(first), static_cast<int>(second)) * font_scale_;
+		kernings_.insert(std::make_pair(key, kerning));
+		return kerning;
+	}
+
+	Size SdfGlyphAtlas::Layout(String const& text, float font_size, float line_spacing, TextAlign alignment, Array<Quad>& quads)
+	{
+		quads.resize(0);
+
+		if (!font_info_ || text.empty())
+			return Size{};
+
+		const float scale = font_size / base_size_;
+		const float page_scale = GetPageScale(scale);
+		const float line_height = line_spacing != 0.f ? line_spacing : GetLineHeight() * scale;
+
+		float pen_x = 0.f;
+		float baseline = ascent_ * scale;
+		float max_width = 0.f;
+		int line_count = 1;
+		size_t line_begin = 0;
+		std::uint32_t prev = 0;
+
+		// lines are aligned once their width is known
+		const auto end_line = [&]()
+		{
+			max_width = std::max(max_width, pen_x);
+
+			if (alignment != TextAlign::Left)
+			{
+				for (size_t i = line_begin; i < quads.size(); ++i)
+				{
+					quads[i].dest_rect.origin.x -= (alignment == TextAlign::Center) ? pen_x * 0.5f : pen_x;
+				}
+			}
+			line_begin = quads.size();
+		};
+
+		const size_t length = text.length();
+		for (size_t i = 0; i < length; ++i)
+		{
+			std::uint32_t codepoint = static_cast<std::uint32_t>(text[i]);
+
+			// combine utf-16 surrogate pairs
+			if (codepoint >= 0xD800 && codepoint < 0xDC00 && i + 1 < length)
+			{
+				const std::uint32_t low = static_cast<std::uint32_t>(text[i + 1]);
+				if (low >= 0xDC00 && low < 0xE000)
+				{
+					codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+					++i;
+				}
+			}
+
+			if (codepoint == L'\n')
+			{
+				end_line();
+				pen_x = 0.f;
+				baseline += line_height;
+				++line_count;
+				prev = 0;
+				continue;
+			}
+
+			Glyph const* glyph = GetGlyph(codepoint);
+			if (!glyph)
+				continue;
+
+			if (prev)
+			{
+				pen_x += GetKerning(prev, codepoint) * scale;
+			}
+			prev = codepoint;
+
+			if (glyph->page >= 0)
+			{
+				Quad quad;
+				quad.page = glyph->page;
+				quad.src_rect = Rect{ glyph->x * page_scale, glyph->y * page_scale, glyph->width * page_scale, glyph->height * page_scale };
+				quad.dest_rect = Rect{ pen_x + glyph->left * scale, baseline + glyph->top * scale, glyph->width * scale, glyph->height * scale };
+				quads.push_back(quad);
+			}
+			pen_x += glyph->advance * scale;
+		}
+		end_line();
+
+		// shift aligned lines into the layout box
+		if (alignment != TextAlign::Left)
+		{
+			const float offset = (alignment == TextAlign::Center) ? max_width * 0.5f : max_width;
+			for (auto& quad : quads)
+			{
+				quad.dest_rect.origin.x += offset;
+			}
+		}
+
+		return Size{ max_width, line_height * line_count };
+	}
+
+	int SdfGlyphAtlas::GetScaledPageSize(float scale) const
+	{
+		return std::min(static_cast<int>(std::ceil(page_size_ * GetPageScale(scale))), max_scaled_page_size_);
+	}
+
+	float SdfGlyphAtlas::GetPageScale(float scale) const
+	{
+		return std::min(scale, static_cast<float>(max_scaled_page_size_) / page_size_);
+	}
+
+	void SdfGlyphAtlas::SetMaxScaledPageSize(int size)
+	{
+		max_scaled_page_size_ = std::max(size, page_size_);
+	}
+
+	float SdfGlyphAtlas::SampleDistance(Page const& page, float x, float y) const
+	{
+		// bilinear sample, returns the distance in base size pixels, positive inside
+		const float max_coord = static_cast<float>(page_size_ - 1);
+		x = std::min(std::max(x, 0.f), max_coord);
+		y = std::min(std::max(y, 0.f), max_coord);
+
+		const int x0 = static_cast<int>(x);
+		const int y0 = static_cast<int>(y);
+		const int x1 = std::min(x0 + 1, page_size_ - 1);
+		const int y1 = std::min(y0 + 1, page_size_ - 1);
+		const float fx = x - x0;
+		const float fy = y - y0;
+
+		std::uint8_t const* row0 = &page.pixels[static_cast<size_t>(y0) * page_size_];
+		std::uint8_t const* row1 = &page.pixels[static_cast<size_t>(y1) * page_size_];
+
+		const float top = row0[x0] + (row0[x1] - row0[x0]) * fx;
+		const float bottom = row1[x0] + (row1[x1] - row1[x0]) * fx;
+		const float value = top + (bottom - top) * fy;
+
+		return (value - sdf_on_edge) * spread_ / sdf_on_edge;
+	}
+
+	bool SdfGlyphAtlas::ShadePage(int page_index, Style const& style, float font_scale, std::uint32_t from_version, Array<std::uint32_t>& pixels, RectPacker::Box& region) const
+	{
+		Page const& page = pages_[page_index];
+		if (from_version >= page.version)
+			return false;
+
+		// the page is shaded at the clamped scale and stretched by the difference when drawn,
+		// so outline and shadow are converted from target pixels to page pixels
+		const float scale = GetPageScale(font_scale);
+		const float page_ratio = scale / font_scale;
+		const int size = GetScaledPageSize(scale);
+
+		// scaled bounds of the glyphs to shade
+		const auto scale_rect = [&](RectPacker::Box const& rect)
+		{
+			RectPacker::Box scaled;
+			scaled.page = page_index;
+			scaled.x = static_cast<int>(rect.x * scale);
+			scaled.y = static_cast<int>(rect.y * scale);
+			scaled.width = std::min(static_cast<int>(std::ceil((rect.x + rect.width) * scale)), size) - scaled.x;
+			scaled.height = std::min(static_cast<int>(std::ceil((rect.y + rect.height) * scale)), size) - scaled.y;
+			return scaled;
+		};
+
+		region = scale_rect(page.rects[from_version]);
+		for (std::uint32_t i = from_version + 1; i < page.version; ++i)
+		{
+			const auto scaled = scale_rect(page.rects[i]);
+			const int right = std::max(region.x + region.width, scaled.x + scaled.width);
+			const int bottom = std::max(region.y + region.height, scaled.y + scaled.height);
+			region.x = std::min(region.x, scaled.x);
+			region.y = std::min(region.y, scaled.y);
+			region.width = right - region.x;
+			region.height = bottom - region.y;
+		}
+
+		pixels.resize(0);
+		pixels.resize(static_cast<size_t>(region.width) * region.height);
+		::memset(pixels.data(), 0, pixels.size() * sizeof(std::uint32_t));
+
+		const bool has_outline = style.outline_width > 0.f && style.outline_color.a > 0.f;
+		const bool has_shadow = style.shadow_color.a > 0.f;
+
+		// distances are converted to page pixels so that the edge ramp stays one pixel wide
+		const float inv_scale = 1.f / scale;
+		const float outline_width = has_outline ? style.outline_width * page_ratio : 0.f;
+
+		// older glyphs inside the region are shaded again, the region is uploaded as a whole
+		for (const auto& glyph_rect : page.rects)
+		{
+			const auto rect = scale_rect(glyph_rect);
+			const int left = std::max(rect.x, region.x);
+			const int top = std::max(rect.y, region.y);
+			const int right = std::min(rect.x + rect.width, region.x + region.width);
+			const int bottom = std::min(rect.y + rect.height, region.y + region.height);
+
+			for (int y = top; y < bottom; ++y)
+			{
+				std::uint32_t* dest = &pixels[static_cast<size_t>(y - region.y) * region.width];
+				const float src_y = (y + 0.5f) * inv_scale - 0.5f;
+
+				for (int x = left; x < right; ++x)
+				{
+					const float src_x = (x + 0.5f) * inv_scale - 0.5f;
+					const float distance = SampleDistance(page, src_x, src_y) * scale;
+
+					const float fill_a = Saturate(distance + 0.5f) * style.color.a;
+					float r = style.color.r * fill_a;
+					float g = style.color.g * fill_a;
+					float b = style.color.b * fill_a;
+					float a = fill_a;
+
+					if (has_outline)
+					{
+						const float outline_a = Saturate(distance + outline_width + 0.5f) * style.outline_color.a * (1.f - a);
+						r += style.outline_color.r * outline_a;
+						g += style.outline_color.g * outline_a;
+						b += style.outline_color.b * outline_a;
+						a += outline_a;
+					}
+
+					if (has_shadow)
+					{
+						const float shadow_distance = SampleDistance(
+							page,
+							src_x - style.shadow_offset.x / font_scale,
+							src_y - style.shadow_offset.y / font_scale
+						) * scale;
+
+						const float shadow_a = Saturate(shadow_distance + outline_width + 0.5f) * style.shadow_color.a * (1.f - a);
+						r += style.shadow_color.r * shadow_a;
+						g += style.shadow_color.g * shadow_a;
+						b += style.shadow_color.b * shadow_a;
+						a += shadow_a;
+					}
+
+					if (a > 0.f)
+					{
+						dest[x - region.x] = PackPremultiplied(r, g, b, a);
+					}
+				}
+			}
+		}
+		return true;
+	}
+}
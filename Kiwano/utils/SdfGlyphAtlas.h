@@ -0,0 +1,198 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "../common/defines.h"
+#include "../common/helper.h"
+#include "../common/noncopyable.hpp"
+#include "../math/helper.h"
+#include "../2d/Color.h"
+#include "../2d/TextAlign.hpp"
+#include "RectPacker.h"
+#include <cstdint>
+
+struct stbtt_fontinfo;
+
+namespace kiwano
+{
+	//
+	// 距离场字形图集
+	// 从 TrueType 字体生成字形的有向距离场 (SDF) 并打包进单通道页面, 每个字形只光栅化一次
+	// 距离场与字号无关, 任意字号、颜色、描边和阴影都可以从同一份距离场着色得到
+	// 只做 CPU 端的计算, 不涉及渲染设备
+	//
+
+	class KGE_API SdfGlyphAtlas
+		: protected Noncopyable
+	{
+	public:
+		struct Glyph
+		{
+			float advance;	// 基准字号下的步进宽度
+			float left;		// 距离场左上角相对笔位置的横向偏移
+			float top;		// 距离场左上角相对基线的纵向偏移
+			int page;		// 所在页面, 空白字形为 -1
+			int x;			// 距离场在页面中的位置
+			int y;
+			int width;		// 距离场尺寸, 包含扩展边距
+			int height;
+		};
+
+		struct Quad
+		{
+			int page;		// 所在页面
+			Rect src_rect;	// 在着色后页面中的区域
+			Rect dest_rect;	// 在文字空间中的区域
+		};
+
+		struct Style
+		{
+			Color color;			// 文字颜色
+			Color outline_color;	// 描边颜色
+			float outline_width;	// 描边线宽, 为 0 时不描边
+			Color shadow_color;		// 阴影颜色, 透明时不显示阴影
+			Point shadow_offset;	// 阴影偏移
+		};
+
+	public:
+		// 描边线宽和阴影偏移不能超过扩展边距 (按字号缩放后), 超出的部分会被裁掉
+		SdfGlyphAtlas(
+			float base_size = 32.f,	// 生成距离场的基准字号
+			int spread = 6,			// 距离场扩展边距
+			int page_size = 512		// 页面边长
+		);
+
+		virtual ~SdfGlyphAtlas();
+
+		// 加载 TrueType 字体数据, 数据会被复制
+		bool Load(
+			const void* data,
+			size_t size
+		);
+
+		// 是否已加载字体
+		inline bool IsValid() const						{ return font_info_ != nullptr; }
+
+		// 获取字形, 首次获取时生成距离场
+		Glyph const* GetGlyph(
+			std::uint32_t codepoint
+		);
+
+		// 获取字距调整值 (基准字号)
+		float GetKerning(
+			std::uint32_t first,
+			std::uint32_t second
+		);
+
+		// 排版文字, 支持换行符, 不支持自动换行
+		// 返回文字布局大小
+		Size Layout(
+			String const& text,
+			float font_size,
+			float line_spacing,		/* 为 0 时使用字体默认行高 */
+			TextAlign alignment,
+			Array<Quad>& quads
+		);
+
+		// 把页面中 from_version 之后加入的字形着色为预乘 Alpha 的 BGRA 像素
+		// scale 为目标字号与基准字号之比, 页面按 GetPageScale(scale) 缩放, 输出这些字形在缩放后页面中的包围盒,
+		// pixels 按包围盒宽度紧密排列, 没有需要着色的字形时返回 false
+		bool ShadePage(
+			int page,
+			Style const& style,
+			float scale,
+			std::uint32_t from_version,
+			Array<std::uint32_t>& pixels,
+			RectPacker::Box& region
+		) const;
+
+		// 获取按比例缩放后的页面边长
+		int GetScaledPageSize(
+			float scale
+		) const;
+
+		// 获取页面的实际缩放比例, 缩放后的页面边长不超过上限
+		// 超出上限的部分由绘制时拉伸目标区域补足
+		float GetPageScale(
+			float scale
+		) const;
+
+		// 设置缩放后页面边长的上限, 默认为 2048, 不小于页面边长
+		// 需要在排版前设置, 已排版的文字区域不会更新
+		void SetMaxScaledPageSize(
+			int size
+		);
+
+		// 获取缩放后页面边长的上限
+		inline int GetMaxScaledPageSize() const			{ return max_scaled_page_size_; }
+
+		// 获取页面数量
+		inline int GetPageCount() const					{ return static_cast<int>(pages_.size()); }
+
+		// 获取页面边长
+		inline int GetPageSize() const					{ return page_size_; }
+
+		// 获取页面的距离场数据
+		inline std::uint8_t const* GetPageData(int page) const		{ return pages_[page].pixels.data(); }
+
+		// 获取页面版本, 即页面中的字形数量, 每加入一个字形加一
+		inline std::uint32_t GetPageVersion(int page) const		{ return pages_[page].version; }
+
+		// 获取基准字号
+		inline float GetBaseSize() const				{ return base_size_; }
+
+		// 获取基准字号下的行高
+		inline float GetLineHeight() const				{ return ascent_ - descent_ + line_gap_; }
+
+		// 获取已生成的字形数量
+		inline size_t GetGlyphCount() const				{ return glyphs_.size(); }
+
+	private:
+		struct Page
+		{
+			Array<std::uint8_t> pixels;
+			Array<RectPacker::Box> rects;
+			std::uint32_t version;
+		};
+
+		float SampleDistance(
+			Page const& page,
+			float x,
+			float y
+		) const;
+
+	private:
+		float				base_size_;
+		int					spread_;
+		int					page_size_;
+		int					max_scaled_page_size_;
+		float				font_scale_;
+		float				ascent_;
+		float				descent_;
+		float				line_gap_;
+		stbtt_fontinfo*		font_info_;
+		Array<std::uint8_t>	font_data_;
+		RectPacker			packer_;
+		Array<Page>			pages_;
+
+		UnorderedMap<std::uint32_t, Glyph>	glyphs_;
+		UnorderedMap<std::uint64_t, float>	kernings_;
+	};
+}
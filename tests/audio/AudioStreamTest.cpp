@@ -0,0 +1,203 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "audio/AudioStream.h"
+#include "audio/WaveDecoder.h"
+#include "base/logs.h"
+#include <chrono>
+#include <thread>
+
+// WaveDecoder parsing from memory and from a file, and AudioStream playback on the null audio device
+
+using namespace kiwano;
+
+namespace
+{
+	void Put16(Array<std::uint8_t>& data, unsigned value)
+	{
+		data.push_back(static_cast<std::uint8_t>(value));
+		data.push_back(static_cast<std::uint8_t>(value >> 8));
+	}
+
+	void Put32(Array<std::uint8_t>& data, unsigned value)
+	{
+		Put16(data, value & 0xFFFF);
+		Put16(data, value >> 16);
+	}
+
+	void PutTag(Array<std::uint8_t>& data, const char* tag)
+	{
+		for (int i = 0; i < 4; ++i)
+			data.push_back(static_cast<std::uint8_t>(tag[i]));
+	}
+
+	// RIFF/WAVE with an extra chunk before the data, the samples count up from 0
+	Array<std::uint8_t> MakeWave(AudioFormat const& format, std::uint32_t frames, std::uint16_t tag = 1)
+	{
+		const std::uint32_t data_size = frames * format.GetBlockAlign();
+
+		Array<std::uint8_t> wave;
+		PutTag(wave, "RIFF");
+		Put32(wave, 4 + 24 + 12 + 8 + data_size);
+		PutTag(wave, "WAVE");
+
+		PutTag(wave, "fmt ");
+		Put32(wave, 16);
+		Put16(wave, tag);
+		Put16(wave, format.channels);
+		Put32(wave, format.sample_rate);
+		Put32(wave, format.sample_rate * format.GetBlockAlign());
+		Put16(wave, format.GetBlockAlign());
+		Put16(wave, format.bits_per_sample);
+
+		// odd sized chunks are padded to a word
+		PutTag(wave, "LIST");
+		Put32(wave, 3);
+		wave.push_back('a');
+		wave.push_back('b');
+		wave.push_back('c');
+		wave.push_back(0);
+
+		PutTag(wave, "data");
+		Put32(wave, data_size);
+		for (std::uint32_t i = 0; i < data_size; ++i)
+			wave.push_back(static_cast<std::uint8_t>(i));
+		return wave;
+	}
+
+	void CheckDecoder(WaveDecoder& decoder, AudioFormat const& format, std::uint32_t frames)
+	{
+		KGE_CHECK(decoder.GetFormat() == format);
+		KGE_CHECK(decoder.GetDuration().Milliseconds() == static_cast<long long>(frames) * 1000 / format.sample_rate);
+
+		// reads hand out whole frames only
+		std::uint8_t buffer[7];
+		const std::uint32_t read = decoder.Read(buffer, sizeof(buffer));
+		KGE_CHECK(read == 4);
+		KGE_CHECK(buffer[0] == 0 && buffer[3] == 3);
+
+		Array<std::uint8_t> rest;
+		rest.resize(frames * format.GetBlockAlign());
+		KGE_CHECK(decoder.Read(rest.data(), static_cast<std::uint32_t>(rest.size())) == rest.size() - 4);
+		KGE_CHECK(rest[0] == 4);
+		KGE_CHECK(decoder.Read(rest.data(), 4) == 0);
+
+		KGE_CHECK(decoder.Rewind());
+		KGE_CHECK(decoder.Read(buffer, 4) == 4 && buffer[1] == 1);
+	}
+
+	void TestWaveDecoder()
+	{
+		const AudioFormat format(2, 8000, 16);
+		const auto wave = MakeWave(format, 1000);
+
+		KGE_CHECK(WaveDecoder::IsWave(wave.data(), wave.size()));
+		KGE_CHECK(!WaveDecoder::IsWave(wave.data() + 1, wave.size() - 1));
+
+		WaveDecoder decoder;
+		KGE_CHECK(decoder.Open(wave.data(), wave.size()));
+		CheckDecoder(decoder, format, 1000);
+
+		// the decoder closes the file it is given
+		std::FILE* file = std::tmpfile();
+		KGE_CHECK(file != nullptr);
+		KGE_CHECK(std::fwrite(wave.data(), 1, wave.size(), file) == wave.size());
+		KGE_CHECK(decoder.Open(file));
+		CheckDecoder(decoder, format, 1000);
+		decoder.Close();
+
+		// truncated data plays the whole frames that are there
+		KGE_CHECK(decoder.Open(wave.data(), wave.size() - 402));
+		KGE_CHECK(decoder.GetDuration().Milliseconds() == 899 * 1000 / 8000);
+
+		// compressed formats are left to Media Foundation, the warning is muted
+		// since the wide console output would take over stdout
+		const auto adpcm = MakeWave(format, 10, 2);
+		Logger::Instance().Disable();
+		KGE_CHECK(!decoder.Open(adpcm.data(), adpcm.size()));
+		Logger::Instance().Enable();
+		KGE_CHECK(!decoder.Open(static_cast<std::FILE*>(nullptr)));
+		KGE_CHECK(!decoder.Rewind());
+	}
+
+	// Plays the stream on the null device in 20 ms steps, returns the played time in ms
+	long long PlayThrough(NullAudioDevice& device, AudioStream& stream, long long limit_ms)
+	{
+		long long played = 0;
+		while (stream.IsPlaying() && played < limit_ms)
+		{
+			// let the worker catch up with the device
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			device.Advance(Duration(20));
+			played += 20;
+		}
+		return played;
+	}
+
+	void TestStream()
+	{
+		const AudioFormat format(1, 8000, 16);
+		const auto wave = MakeWave(format, 8000);
+
+		NullAudioDevice device;
+
+		WaveDecoder* decoder = new WaveDecoder;
+		KGE_CHECK(decoder->Open(wave.data(), wave.size()));
+
+		AudioStream stream(&device, decoder, 3, Duration(100));
+		KGE_CHECK(stream.GetBufferSize() == 3 * 1600);
+		KGE_CHECK(stream.GetDuration().Milliseconds() == 1000);
+
+		// the device can never play more than the data, and the worker keeps up
+		KGE_CHECK(stream.Play());
+		long long played = PlayThrough(device, stream, 10000);
+		KGE_CHECK(played >= 1000 && played < 5000);
+		KGE_CHECK(!stream.IsPlaying());
+
+		// one loop plays the data twice
+		KGE_CHECK(stream.Play(1));
+		played = PlayThrough(device, stream, 20000);
+		KGE_CHECK(played >= 2000 && played < 10000);
+
+		// paused streams do not finish
+		KGE_CHECK(stream.Play(-1));
+		stream.Pause();
+		KGE_CHECK(stream.IsPaused() && !stream.IsPlaying());
+		device.Advance(Duration(5000));
+		stream.Resume();
+		KGE_CHECK(stream.IsPlaying());
+
+		// endless loops run until stopped
+		KGE_CHECK(PlayThrough(device, stream, 3000) == 3000);
+		stream.Stop();
+		KGE_CHECK(!stream.IsPlaying() && !stream.IsPaused());
+		KGE_CHECK(device.GetVoiceCount() == 1);
+	}
+}
+
+int main()
+{
+	TestWaveDecoder();
+	TestStream();
+
+	std::printf("AudioStreamTest passed\n");
+	return 0;
+}
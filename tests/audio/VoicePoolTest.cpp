@@ -0,0 +1,231 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "audio/VoicePool.h"
+#include "base/logs.h"
+
+// VoicePool polyphony, stealing and buffer lifetime on the null audio device,
+// and on a device whose flush completes asynchronously like XAudio2
+
+using namespace kiwano;
+
+namespace
+{
+	const AudioFormat format(2, 44100, 16);
+
+	// 100 ms of silence
+	SoundBufferPtr MakeBuffer(AudioFormat const& fmt = format)
+	{
+		const std::uint32_t size = fmt.GetBlockAlign() * fmt.sample_rate / 10;
+		return new SoundBuffer(fmt, new std::uint8_t[size](), size);
+	}
+
+	// Voices hold on to flushed data until the next audio tick
+	class DeferredDevice
+		: public AudioDevice
+	{
+	public:
+		class Voice
+			: public AudioVoice
+		{
+		public:
+			explicit Voice(DeferredDevice* device) : device_(device), queued_(0), flushing_(false) {}
+
+			~Voice() override
+			{
+				++device_->destroyed;
+			}
+
+			bool Submit(SoundBuffer*, int) override	{ queued_ = 1; return true; }
+
+			bool Queue(const std::uint8_t*, std::uint32_t, bool) override	{ ++queued_; return true; }
+
+			std::uint32_t GetQueuedCount() const override	{ return queued_; }
+
+			void Start() override	{}
+			void Pause() override	{}
+
+			void Flush() override	{ flushing_ = queued_ != 0; }
+
+			bool IsFinished() const override	{ return queued_ == 0; }
+
+			void SetVolume(float) override	{}
+
+			void Tick()
+			{
+				if (flushing_)
+					queued_ = 0;
+				flushing_ = false;
+			}
+
+		private:
+			DeferredDevice* device_;
+			std::uint32_t queued_;
+			bool flushing_;
+		};
+
+		int created = 0;
+		int destroyed = 0;
+		Array<Voice*> voices;
+
+		AudioVoice* CreateVoice(AudioFormat const&) override
+		{
+			++created;
+			voices.push_back(new Voice(this));
+			return voices.back();
+		}
+
+		// destroyed voices are left in the list, only call after checking the counters
+		void Tick()
+		{
+			for (int i = destroyed; i < created; ++i)
+				voices[i]->Tick();
+		}
+	};
+
+	void TestPolyphony()
+	{
+		NullAudioDevice device;
+		VoicePool pool(&device, 4);
+
+		auto buffer = MakeBuffer();
+		int owner = 0;
+
+		KGE_CHECK(pool.Play(&owner, buffer.Get(), 0, 0, 2, 1.f));
+		KGE_CHECK(pool.Play(&owner, buffer.Get(), 0, 0, 2, 1.f));
+		KGE_CHECK(pool.GetPlayingCount(&owner) == 2);
+
+		// the owner has used up its voices and replaces its oldest one
+		KGE_CHECK(pool.Play(&owner, buffer.Get(), 0, 0, 2, 1.f));
+		KGE_CHECK(pool.GetPlayingCount(&owner) == 2);
+		KGE_CHECK(pool.GetVoiceCount() == 2);
+
+		// finished voices are reused
+		device.Advance(Duration(150));
+		KGE_CHECK(!pool.IsPlaying(&owner));
+		KGE_CHECK(pool.Play(&owner, buffer.Get(), 0, 0, 2, 1.f));
+		KGE_CHECK(pool.GetVoiceCount() == 2);
+		KGE_CHECK(device.GetVoiceCount() == 2);
+
+		// buffers of another format need their own voice
+		auto mono = MakeBuffer(AudioFormat(1, 22050, 16));
+		int other = 0;
+		KGE_CHECK(pool.Play(&other, mono.Get(), 0, 0, 0, 1.f));
+		KGE_CHECK(pool.GetVoiceCount() == 3);
+	}
+
+	void TestPauseAndLoop()
+	{
+		NullAudioDevice device;
+		VoicePool pool(&device, 4);
+
+		auto buffer = MakeBuffer();
+		int owner = 0;
+
+		KGE_CHECK(pool.Play(&owner, buffer.Get(), 1, 0, 0, 1.f));
+		pool.Pause(&owner);
+		KGE_CHECK(!pool.IsPlaying(&owner));
+		KGE_CHECK(pool.GetPlayingCount(&owner) == 1);
+
+		// paused voices do not advance
+		device.Advance(Duration(500));
+		pool.Resume(&owner);
+		KGE_CHECK(pool.IsPlaying(&owner));
+
+		// one loop plays the buffer twice
+		device.Advance(Duration(150));
+		KGE_CHECK(pool.IsPlaying(&owner));
+		device.Advance(Duration(100));
+		KGE_CHECK(!pool.IsPlaying(&owner));
+
+		// infinite loops never finish on their own
+		KGE_CHECK(pool.Play(&owner, buffer.Get(), -1, 0, 0, 1.f));
+		device.Advance(Duration(10000));
+		KGE_CHECK(pool.IsPlaying(&owner));
+		pool.Stop(&owner);
+		KGE_CHECK(!pool.IsPlaying(&owner));
+	}
+
+	void TestStealing()
+	{
+		NullAudioDevice device;
+		VoicePool pool(&device, 2);
+
+		auto buffer = MakeBuffer();
+		int music = 0, effect = 0, alert = 0;
+
+		KGE_CHECK(pool.Play(&music, buffer.Get(), -1, 5, 0, 1.f));
+		KGE_CHECK(pool.Play(&effect, buffer.Get(), -1, 1, 0, 1.f));
+
+		// a less important sound cannot take a busy voice, the expected warning is muted
+		// since the wide console output would take over stdout
+		int quiet = 0;
+		Logger::Instance().Disable();
+		KGE_CHECK(!pool.Play(&quiet, buffer.Get(), 0, 0, 0, 1.f));
+		Logger::Instance().Enable();
+
+		// an equal or more important one takes the weakest voice
+		KGE_CHECK(pool.Play(&alert, buffer.Get(), 0, 1, 0, 1.f));
+		KGE_CHECK(!pool.IsPlaying(&effect));
+		KGE_CHECK(pool.IsPlaying(&music));
+		KGE_CHECK(pool.IsPlaying(&alert));
+		KGE_CHECK(pool.GetVoiceCount() == 2);
+	}
+
+	void TestDeferredFlush()
+	{
+		DeferredDevice device;
+		{
+			VoicePool pool(&device, 1);
+
+			int owner = 0;
+			auto buffer = MakeBuffer();
+			KGE_CHECK(pool.Play(&owner, buffer.Get(), 0, 0, 0, 1.f));
+
+			// the device may still read the flushed data, so the pool keeps it alive
+			const long refs = buffer->GetRefCount();
+			pool.Stop(&owner);
+			KGE_CHECK(buffer->GetRefCount() == refs);
+
+			device.Tick();
+			KGE_CHECK(pool.Play(&owner, MakeBuffer().Get(), 0, 0, 0, 1.f));
+			KGE_CHECK(buffer->GetRefCount() == refs - 1);
+			KGE_CHECK(device.created == 1);
+
+			// a voice still reading a flushed buffer is destroyed rather than reused
+			int other = 0;
+			KGE_CHECK(pool.Play(&other, MakeBuffer().Get(), 0, 0, 0, 1.f));
+			KGE_CHECK(device.created == 2 && device.destroyed == 1);
+		}
+		KGE_CHECK(device.destroyed == 2);
+	}
+}
+
+int main()
+{
+	TestPolyphony();
+	TestPauseAndLoop();
+	TestStealing();
+	TestDeferredFlush();
+
+	std::printf("VoicePoolTest passed\n");
+	return 0;
+}
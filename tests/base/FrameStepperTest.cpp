@@ -0,0 +1,219 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "base/FrameStepper.h"
+#include "base/PerformQueue.h"
+#include "base/Input.h"
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// Frame stepping without a window or renderer: time scale, fixed steps,
+// main thread functions, stage timings and input fed from synthetic events
+
+using namespace kiwano;
+
+namespace
+{
+	// Sleeps inside a stage so that its timing is measurable
+	void Busy(int ms)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+	}
+
+	void TestTimeScale()
+	{
+		FrameStepper stepper;
+		std::vector<Duration> steps;
+		auto update = [&](Duration dt) { steps.push_back(dt); };
+
+		KGE_CHECK(stepper.Update(Ms * 16, update) == 1);
+		KGE_CHECK(steps.back() == Ms * 16);
+
+		stepper.SetTimeScale(0.5f);
+		KGE_CHECK(stepper.GetTimeScale() == 0.5f);
+		KGE_CHECK(stepper.Update(Ms * 16, update) == 1);
+		KGE_CHECK(steps.back() == Ms * 8);
+
+		stepper.SetTimeScale(0.f);
+		KGE_CHECK(stepper.Update(Ms * 16, update) == 1);
+		KGE_CHECK(steps.back().IsZero());
+	}
+
+	void TestFixedStep()
+	{
+		FrameStepper stepper;
+		stepper.SetFixedTimeStep(Ms * 10, 4);
+		KGE_CHECK(stepper.GetFixedTimeStep() == Ms * 10);
+
+		int calls = 0;
+		auto update = [&](Duration dt) { KGE_CHECK(dt == Ms * 10); ++calls; };
+
+		// 25 ms: two steps, 5 ms left over
+		KGE_CHECK(stepper.Update(Ms * 25, update) == 2);
+		KGE_CHECK(calls == 2);
+		KGE_CHECK(std::abs(stepper.GetInterpolationAlpha() - 0.5f) < 0.001f);
+
+		// 5 ms: catches up with the remainder
+		KGE_CHECK(stepper.Update(Ms * 5, update) == 1);
+		KGE_CHECK(stepper.GetInterpolationAlpha() == 0.f);
+
+		// 3 ms: not enough for a step
+		KGE_CHECK(stepper.Update(Ms * 3, update) == 0);
+		KGE_CHECK(std::abs(stepper.GetInterpolationAlpha() - 0.3f) < 0.001f);
+
+		// a long stall runs at most 4 steps and drops the rest
+		calls = 0;
+		KGE_CHECK(stepper.Update(Ms * 1000, update) == 4);
+		KGE_CHECK(calls == 4);
+		KGE_CHECK(stepper.GetInterpolationAlpha() == 0.f);
+		KGE_CHECK(stepper.Update(Ms * 9, update) == 0);
+
+		// the time scale applies before stepping
+		stepper.SetTimeScale(2.f);
+		KGE_CHECK(stepper.Update(Ms * 15, update) == 3);
+		KGE_CHECK(std::abs(stepper.GetInterpolationAlpha() - 0.9f) < 0.001f);
+
+		// back to one update per frame
+		stepper.SetFixedTimeStep(Duration{});
+		stepper.SetTimeScale(1.f);
+		calls = 0;
+		KGE_CHECK(stepper.Update(Ms * 3, [&](Duration dt) { KGE_CHECK(dt == Ms * 3); ++calls; }) == 1);
+		KGE_CHECK(calls == 1);
+	}
+
+	void TestPerformBeforeUpdate()
+	{
+		FrameStepper stepper;
+		std::vector<int> order;
+
+		std::thread worker([&]() { PerformQueue::Instance().Push([&]() { order.push_back(1); }); });
+		worker.join();
+
+		stepper.Update(Ms * 16, [&](Duration) { order.push_back(2); });
+		KGE_CHECK(order.size() == 2 && order[0] == 1 && order[1] == 2);
+		KGE_CHECK(PerformQueue::Instance().GetStats().performed == 1);
+
+		// functions beyond the budget wait for the next frame
+		stepper.SetPerformTimeBudget(Ms * 1);
+		KGE_CHECK(stepper.GetPerformTimeBudget() == Ms * 1);
+		int performed = 0;
+		for (int i = 0; i < 3; ++i)
+			PerformQueue::Instance().Push([&]() { Busy(5); ++performed; });
+
+		stepper.Update(Ms * 16, [](Duration) {});
+		KGE_CHECK(performed == 1);
+		stepper.Update(Ms * 16, [](Duration) {});
+		stepper.Update(Ms * 16, [](Duration) {});
+		KGE_CHECK(performed == 3);
+	}
+
+	void TestFrameTimings()
+	{
+		FrameStepper stepper;
+
+		// events dispatched between two updates add up
+		stepper.Dispatch([]() { Busy(5); });
+		stepper.Dispatch([]() { Busy(5); });
+		stepper.Update(Ms * 16, [](Duration) { Busy(5); });
+		stepper.Render([]() { Busy(5); });
+
+		FrameTimings timings = stepper.GetFrameTimings();
+		KGE_CHECK(timings.dispatch >= Ms * 10);
+		KGE_CHECK(timings.update >= Ms * 5);
+		KGE_CHECK(timings.render >= Ms * 5);
+
+		// no events in the next frame
+		stepper.Update(Ms * 16, [](Duration) {});
+		KGE_CHECK(stepper.GetFrameTimings().dispatch.IsZero());
+	}
+
+	Event MakeKeyEvent(Event::Type type, int code)
+	{
+		Event evt(type);
+		evt.key.code = code;
+		return evt;
+	}
+
+	Event MakeMouseEvent(Event::Type type, float x, float y, int button = 0)
+	{
+		Event evt(type);
+		evt.mouse.x = x;
+		evt.mouse.y = y;
+		evt.mouse.button = button;
+		return evt;
+	}
+
+	void TestSyntheticInput()
+	{
+		FrameStepper stepper;
+		Input& input = Input::Instance();
+
+		// Application feeds events to Input and clears the edges after each update
+		auto frame = [&]()
+		{
+			if (stepper.Update(Ms * 16, [](Duration) {}))
+				input.Update();
+		};
+
+		input.HandleEvent(MakeKeyEvent(Event::KeyDown, KeyCode::Space));
+		input.HandleEvent(MakeMouseEvent(Event::MouseBtnDown, 10.f, 20.f, MouseButton::Left));
+		input.HandleEvent(MakeMouseEvent(Event::MouseMove, 30.f, 40.f));
+		KGE_CHECK(input.IsDown(KeyCode::Space) && input.WasPressed(KeyCode::Space));
+		KGE_CHECK(input.IsDown(MouseButton::Left) && input.WasPressed(MouseButton::Left));
+		KGE_CHECK(input.GetMouseX() == 30.f && input.GetMouseY() == 40.f);
+
+		frame();
+		KGE_CHECK(input.IsDown(KeyCode::Space) && !input.WasPressed(KeyCode::Space));
+
+		// a repeated key down is not a new press
+		input.HandleEvent(MakeKeyEvent(Event::KeyDown, KeyCode::Space));
+		KGE_CHECK(!input.WasPressed(KeyCode::Space));
+
+		input.HandleEvent(MakeKeyEvent(Event::KeyUp, KeyCode::Space));
+		input.HandleEvent(MakeMouseEvent(Event::MouseBtnUp, 30.f, 40.f, MouseButton::Left));
+		KGE_CHECK(!input.IsDown(KeyCode::Space) && input.WasReleased(KeyCode::Space));
+		KGE_CHECK(!input.IsDown(MouseButton::Left) && input.WasReleased(MouseButton::Left));
+
+		frame();
+		KGE_CHECK(!input.WasReleased(KeyCode::Space) && !input.WasReleased(MouseButton::Left));
+
+		// edges survive a fixed step frame without an update
+		stepper.SetFixedTimeStep(Ms * 20);
+		input.HandleEvent(MakeKeyEvent(Event::KeyDown, KeyCode::Enter));
+		frame();
+		KGE_CHECK(input.WasPressed(KeyCode::Enter));
+		frame();
+		KGE_CHECK(!input.WasPressed(KeyCode::Enter) && input.IsDown(KeyCode::Enter));
+	}
+}
+
+int main()
+{
+	TestTimeScale();
+	TestFixedStep();
+	TestPerformBeforeUpdate();
+	TestFrameTimings();
+	TestSyntheticInput();
+
+	std::printf("FrameStepperTest passed\n");
+	return 0;
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "base/ThreadPool.h"
+#include "base/PerformQueue.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Task throughput and submit-to-run latency of ThreadPool, against a thread per task
+// as AsyncTask used to do, plus the delivery of completion callbacks on the main thread
+
+using namespace kiwano;
+
+namespace
+{
+	// a few hundred nanoseconds of work
+	unsigned Work(unsigned seed)
+	{
+		for (int i = 0; i < 64; ++i)
+			seed = seed * 1664525u + 1013904223u;
+		return seed;
+	}
+
+	double GetMedian(std::vector<double>& values)
+	{
+		std::sort(values.begin(), values.end());
+		return values[values.size() / 2];
+	}
+
+	void CheckTaskGraph()
+	{
+		// fan-out and fan-in: first -> 8 middle tasks -> last
+		std::atomic<int> stage(0);
+		std::atomic<int> middle_done(0);
+		bool last_saw_all = false;
+
+		TaskPtr first = ThreadPool::Instance().Create([&]() { stage = 1; });
+		TaskPtr last = ThreadPool::Instance().Create([&]() { last_saw_all = (middle_done == 8); });
+
+		std::vector<TaskPtr> middle;
+		for (int i = 0; i < 8; ++i)
+		{
+			TaskPtr task = ThreadPool::Instance().Create([&]() { KGE_CHECK(stage == 1); ++middle_done; });
+			task->AddDependency(first);
+			last->AddDependency(task);
+			middle.push_back(task);
+		}
+
+		ThreadPool::Instance().Submit(last);
+		for (auto& task : middle)
+			ThreadPool::Instance().Submit(task);
+		ThreadPool::Instance().Submit(first);
+
+		last->Wait();
+		KGE_CHECK(last_saw_all);
+
+		// cancelling a task skips its dependents, their callbacks still run on the main thread
+		bool ran = false;
+		int callbacks = 0;
+		TaskPtr cancelled = ThreadPool::Instance().Create([&]() { ran = true; });
+		TaskPtr dependent = ThreadPool::Instance().Create([&]() { ran = true; });
+		cancelled->SetCallback([&]() { ++callbacks; });
+		dependent->SetCallback([&]() { ++callbacks; });
+		dependent->AddDependency(cancelled);
+		cancelled->Cancel();
+		ThreadPool::Instance().Submit(dependent);
+		ThreadPool::Instance().Submit(cancelled);
+		dependent->Wait();
+
+		KGE_CHECK(!ran && cancelled->IsCancelled() && dependent->IsCancelled());
+		PerformQueue::Instance().Perform();
+		KGE_CHECK(callbacks == 2);
+	}
+
+	void RunThroughput(int tasks, int threads_tasks, int runs)
+	{
+		std::atomic<unsigned> sink(0);
+
+		const double pool_ns = test::Measure(runs, [&]()
+		{
+			std::vector<TaskPtr> submitted;
+			submitted.reserve(tasks);
+			for (int i = 0; i < tasks; ++i)
+			{
+				submitted.push_back(ThreadPool::Instance().Run([&sink, i]() { sink += Work(i); }));
+			}
+			for (auto& task : submitted)
+				task->Wait();
+		});
+
+		const double thread_ns = test::Measure(runs, [&]()
+		{
+			std::vector<std::thread> threads;
+			threads.reserve(threads_tasks);
+			for (int i = 0; i < threads_tasks; ++i)
+			{
+				threads.emplace_back([&sink, i]() { sink += Work(i); });
+			}
+			for (auto& thread : threads)
+				thread.join();
+		});
+
+		test::DoNotOptimize(sink);
+		std::printf("throughput  pool %8.0f ns/task (%d tasks)  thread per task %8.0f ns/task (%d tasks)\n",
+			pool_ns / tasks, tasks, thread_ns / threads_tasks, threads_tasks);
+	}
+
+	void RunLatency(int samples)
+	{
+		std::vector<double> pool, thread;
+		for (int i = 0; i < samples; ++i)
+		{
+			test::Clock::time_point started;
+
+			auto submit = test::Clock::now();
+			TaskPtr task = ThreadPool::Instance().Run([&started]() { started = test::Clock::now(); });
+			task->Wait();
+			pool.push_back(std::chrono::duration<double, std::nano>(started - submit).count());
+
+			submit = test::Clock::now();
+			std::thread([&started]() { started = test::Clock::now(); }).join();
+			thread.push_back(std::chrono::duration<double, std::nano>(started - submit).count());
+		}
+
+		std::printf("latency     pool %8.0f ns median  thread per task %8.0f ns median\n",
+			GetMedian(pool), GetMedian(thread));
+	}
+
+	void RunCallbacks(int tasks)
+	{
+		int callbacks = 0;
+		std::vector<TaskPtr> submitted;
+		for (int i = 0; i < tasks; ++i)
+		{
+			TaskPtr task = ThreadPool::Instance().Create([]() {});
+			task->SetCallback([&callbacks]() { ++callbacks; });
+			ThreadPool::Instance().Submit(task);
+			submitted.push_back(task);
+		}
+		for (auto& task : submitted)
+			task->Wait();
+
+		PerformQueue::Instance().Perform();
+		KGE_CHECK(callbacks == tasks);
+
+		auto const& stats = PerformQueue::Instance().GetStats();
+		std::printf("callbacks   %d delivered on the main thread in %.1f us, %.0f ns each\n",
+			tasks, stats.drain_time.Seconds() * 1e6, stats.drain_time.Seconds() * 1e9 / tasks);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = test::IsQuick(argc, argv);
+	const int runs = quick ? 1 : 5;
+
+	std::printf("%d worker threads\n", ThreadPool::Instance().GetThreadCount());
+
+	CheckTaskGraph();
+	RunThroughput(quick ? 2000 : 200000, quick ? 200 : 2000, runs);
+	RunLatency(quick ? 100 : 2000);
+	RunCallbacks(quick ? 1000 : 100000);
+	return 0;
+}
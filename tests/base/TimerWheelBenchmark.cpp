@@ -0,0 +1,133 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "base/TimerManager.h"
+#include <memory>
+
+// Per-frame cost of TimerManager against the number of timers it holds.
+// Timers repeat every 1-10 s and frames are 16 ms, so only a few timers are due per frame.
+// The scan reference visits every timer each frame, as the list-based manager did.
+
+using namespace kiwano;
+
+namespace
+{
+	const long long frame_ms = 16;
+
+	class Manager
+		: public TimerManager
+	{
+	public:
+		using TimerManager::UpdateTimers;
+	};
+
+	long long GetInterval(size_t i)
+	{
+		return 1000 + static_cast<long long>((i * 7919) % 9001);
+	}
+
+	// expected calls of a timer repeating every interval after the given time
+	long long GetExpectedCalls(long long interval, long long elapsed)
+	{
+		return elapsed / interval;
+	}
+
+	// a timer of the scan reference, linked like the timers of the list-based manager
+	struct ScanTimer
+	{
+		long long interval;
+		long long elapsed;
+		Closure<void()> callback;
+		std::unique_ptr<ScanTimer> next;
+	};
+
+	void Run(size_t count, int frames)
+	{
+		Manager manager;
+		long long calls = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			manager.AddTimer(new Timer([&calls]() { ++calls; }, Duration(GetInterval(i)), -1, L"spawner"));
+		}
+
+		long long scan_calls = 0;
+		std::unique_ptr<ScanTimer> scan;
+		for (size_t i = count; i > 0; --i)
+		{
+			std::unique_ptr<ScanTimer> timer(new ScanTimer{ GetInterval(i - 1), 0, [&scan_calls]() { ++scan_calls; }, nullptr });
+			timer->next = std::move(scan);
+			scan = std::move(timer);
+		}
+
+		double wheel_ns = 0, scan_ns = 0;
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			auto start = test::Clock::now();
+			manager.UpdateTimers(Duration(frame_ms));
+			wheel_ns += test::ElapsedNs(start);
+
+			start = test::Clock::now();
+			for (ScanTimer* timer = scan.get(); timer; timer = timer->next.get())
+			{
+				timer->elapsed += frame_ms;
+				if (timer->elapsed >= timer->interval)
+				{
+					timer->elapsed -= timer->interval;
+					timer->callback();
+				}
+			}
+			scan_ns += test::ElapsedNs(start);
+		}
+
+		// every timer fired exactly as often as its interval allows
+		long long expected = 0;
+		for (size_t i = 0; i < count; ++i)
+			expected += GetExpectedCalls(GetInterval(i), frame_ms * frames);
+		KGE_CHECK(calls == expected && scan_calls == expected);
+
+		// stopped timers keep quiet, removed timers are gone
+		manager.StopTimers(L"spawner");
+		manager.UpdateTimers(Duration(20000));
+		KGE_CHECK(calls == expected);
+		manager.RemoveTimers(L"spawner");
+		KGE_CHECK(manager.GetAllTimers().IsEmpty());
+
+		// free the chain iteratively, recursive destruction could overflow the stack
+		while (scan)
+			scan = std::move(scan->next);
+
+		std::printf("%7zu timers  wheel %8.2f us/frame  scan %8.2f us/frame  (%lld calls)\n",
+			count, wheel_ns / frames / 1000.0, scan_ns / frames / 1000.0, calls);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = test::IsQuick(argc, argv);
+	const int frames = quick ? 120 : 1200;
+
+	std::printf("16 ms frames, intervals 1-10 s, %d frames\n", frames);
+
+	const size_t counts[] = { 1000, 10000, 100000 };
+	for (size_t count : counts)
+		Run(count, frames);
+	return 0;
+}
@@ -0,0 +1,182 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "common/Array.h"
+#include "base/SmartPtr.hpp"
+#include "math/Matrix.hpp"
+#include <string>
+#include <vector>
+
+// Array vs std::vector for the element types the engine stores:
+// scalars, POD math types, smart pointers and a class without the relocation trait
+
+using namespace kiwano;
+
+namespace
+{
+	class Item
+		: public RefCounter
+	{
+	public:
+		int value = 0;
+	};
+
+	using ItemPtr = SmartPtr<Item>;
+
+	struct Values
+	{
+		std::vector<ItemPtr> items;
+
+		explicit Values(size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				ItemPtr item = new Item;
+				item->value = static_cast<int>(i);
+				items.push_back(item);
+			}
+		}
+
+		void Make(size_t i, int& out) const				{ out = static_cast<int>(i); }
+		void Make(size_t i, Rect& out) const		{ out = Rect(float(i), float(i), 1.f, 1.f); }
+		void Make(size_t i, Matrix& out) const	{ out = Matrix::Translation(Vec2(float(i), 0.f)); }
+		void Make(size_t i, ItemPtr& out) const			{ out = items[i % items.size()]; }
+		void Make(size_t i, std::string& out) const		{ out = "value-" + std::to_string(i); }
+	};
+
+	template <typename _Container, typename _Ty>
+	void PushBack(_Container& c, Array<_Ty> const& src)
+	{
+		for (auto const& v : src)
+			c.push_back(v);
+	}
+
+	template <typename _Container, typename _Ty>
+	void InsertFront(_Container& c, Array<_Ty> const& src)
+	{
+		for (auto const& v : src)
+			c.insert(c.begin(), v);
+	}
+
+	template <typename _Container>
+	void EraseFront(_Container& c)
+	{
+		while (!c.empty())
+			c.erase(c.begin());
+	}
+
+	template <typename _Ty>
+	bool SameElements(Array<_Ty> const& a, std::vector<_Ty> const& v)
+	{
+		if (a.size() != v.size())
+			return false;
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			if (!(a[i] == v[i]))
+				return false;
+		}
+		return true;
+	}
+
+	bool SameElements(Array<Matrix> const& a, std::vector<Matrix> const& v)
+	{
+		if (a.size() != v.size())
+			return false;
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			if (a[i].m[4] != v[i].m[4] || a[i].m[5] != v[i].m[5])
+				return false;
+		}
+		return true;
+	}
+
+	template <typename _Ty>
+	void Run(const char* name, Values const& values, size_t push_count, size_t insert_count, int runs)
+	{
+		Array<_Ty> src;
+		for (size_t i = 0; i < push_count; ++i)
+		{
+			_Ty v;
+			values.Make(i, v);
+			src.push_back(v);
+		}
+
+		Array<_Ty> front(src.begin(), src.begin() + insert_count);
+
+		// same results first
+		{
+			Array<_Ty> a;
+			std::vector<_Ty> v;
+			PushBack(a, src);
+			PushBack(v, src);
+			KGE_CHECK(SameElements(a, v));
+
+			Array<_Ty> af;
+			std::vector<_Ty> vf;
+			InsertFront(af, front);
+			InsertFront(vf, front);
+			KGE_CHECK(SameElements(af, vf));
+
+			af.erase(af.begin() + 1, af.begin() + insert_count / 2);
+			vf.erase(vf.begin() + 1, vf.begin() + insert_count / 2);
+			KGE_CHECK(SameElements(af, vf));
+		}
+
+		double push_array, push_vector;
+		test::MeasurePair(runs, push_array, push_vector,
+			[&]() { Array<_Ty> c; PushBack(c, src); test::DoNotOptimize(c); },
+			[&]() { std::vector<_Ty> c; PushBack(c, src); test::DoNotOptimize(c); });
+
+		double insert_array, insert_vector;
+		test::MeasurePair(runs, insert_array, insert_vector,
+			[&]() { Array<_Ty> c; InsertFront(c, front); test::DoNotOptimize(c); },
+			[&]() { std::vector<_Ty> c; InsertFront(c, front); test::DoNotOptimize(c); });
+
+		double erase_array, erase_vector;
+		test::MeasurePair(runs, erase_array, erase_vector,
+			[&]() { Array<_Ty> c(front); EraseFront(c); test::DoNotOptimize(c); },
+			[&]() { std::vector<_Ty> c(front.begin(), front.end()); EraseFront(c); test::DoNotOptimize(c); });
+
+		std::printf("%-10s push_back %6.2f / %6.2f ns   insert(begin) %8.1f / %8.1f ns   erase(begin) %8.1f / %8.1f ns\n",
+			name,
+			push_array / push_count, push_vector / push_count,
+			insert_array / insert_count, insert_vector / insert_count,
+			erase_array / insert_count, erase_vector / insert_count);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = test::IsQuick(argc, argv);
+	const size_t push_count = quick ? 1000 : 100000;
+	const size_t insert_count = quick ? 200 : 4000;
+	const int runs = quick ? 1 : 7;
+
+	Values values(1024);
+
+	std::printf("per element, Array / std::vector\n");
+	Run<int>("int", values, push_count, insert_count, runs);
+	Run<Rect>("Rect", values, push_count, insert_count, runs);
+	Run<Matrix>("Matrix", values, push_count, insert_count, runs);
+	Run<ItemPtr>("SmartPtr", values, push_count, insert_count, runs);
+	Run<std::string>("string", values, push_count, insert_count, runs);
+	return 0;
+}
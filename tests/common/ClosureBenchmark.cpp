@@ -0,0 +1,134 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "common/closure.hpp"
+#include <cmath>
+#include <functional>
+
+// Construct, copy and invoke costs of Closure and FunctionRef, with std::function for reference
+
+using namespace kiwano;
+
+namespace
+{
+	float Scale(float x)
+	{
+		return x * 0.5f + 0.25f;
+	}
+
+	// a lambda that fits the inline storage, like the bound ease functions
+	auto MakeSmall(float rate)
+	{
+		float offset = 0.25f;
+		return [rate, offset](float x) { return x * rate + offset; };
+	}
+
+	// a lambda larger than the inline storage, stored on the heap and shared by copies
+	auto MakeLarge(float rate)
+	{
+		double a = rate, b = 0.25, c = 1.0, d = 2.0, e = 3.0;
+		return [a, b, c, d, e](float x) { return static_cast<float>(x * a + b + (c + d + e) * 0.0); };
+	}
+
+	template <typename _Wrapper, typename _Callee>
+	void Run(const char* name, _Callee const& callee, size_t count, int runs, double expected)
+	{
+		// same results first
+		{
+			_Wrapper wrapper(callee);
+			_Wrapper copy(wrapper);
+			KGE_CHECK(wrapper(2.f) == callee(2.f) && copy(2.f) == callee(2.f));
+		}
+
+		double construct_ns = test::Measure(runs, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				_Wrapper wrapper(callee);
+				test::DoNotOptimize(wrapper);
+			}
+		});
+
+		_Wrapper source(callee);
+		double copy_ns = test::Measure(runs, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				_Wrapper copy(source);
+				test::DoNotOptimize(copy);
+			}
+		});
+
+		double sum = 0;
+		double invoke_ns = test::Measure(runs, [&]()
+		{
+			sum = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				test::DoNotOptimize(source);
+				sum += source(static_cast<float>(i & 1023) / 1024.f);
+			}
+		});
+		KGE_CHECK(std::abs(sum - expected) < 1e-3 * std::abs(expected) + 1e-3);
+
+		std::printf("%-28s construct %6.2f ns   copy %6.2f ns   invoke %5.2f ns\n",
+			name, construct_ns / count, copy_ns / count, invoke_ns / count);
+	}
+
+	template <typename _Callee>
+	double Expected(_Callee const& callee, size_t count)
+	{
+		double sum = 0;
+		for (size_t i = 0; i < count; ++i)
+			sum += callee(static_cast<float>(i & 1023) / 1024.f);
+		return sum;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = test::IsQuick(argc, argv);
+	const size_t count = quick ? 10000 : 1000000;
+	const int runs = quick ? 1 : 7;
+
+	using Signature = float(float);
+	auto small = MakeSmall(0.5f);
+	auto large = MakeLarge(0.5f);
+	auto func = &Scale;
+
+	const double expected_func = Expected(func, count);
+	const double expected_small = Expected(small, count);
+	const double expected_large = Expected(large, count);
+
+	std::printf("per operation, float(float)\n");
+	Run<Closure<Signature>>("Closure, function pointer", func, count, runs, expected_func);
+	Run<FunctionRef<Signature>>("FunctionRef, function ptr", func, count, runs, expected_func);
+	Run<std::function<Signature>>("std::function, function ptr", func, count, runs, expected_func);
+
+	Run<Closure<Signature>>("Closure, small lambda", small, count, runs, expected_small);
+	Run<FunctionRef<Signature>>("FunctionRef, small lambda", small, count, runs, expected_small);
+	Run<std::function<Signature>>("std::function, small lambda", small, count, runs, expected_small);
+
+	Run<Closure<Signature>>("Closure, large lambda", large, count, runs, expected_large);
+	Run<FunctionRef<Signature>>("FunctionRef, large lambda", large, count, runs, expected_large);
+	Run<std::function<Signature>>("std::function, large lambda", large, count, runs, expected_large);
+	return 0;
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "math/ease.hpp"
+#include "math/EaseTable.h"
+#include <cmath>
+#include <vector>
+
+// Per-evaluation cost of the easing paths a tween can take:
+// the ease function called directly (ActionEased), through a Closure (ActionTween)
+// and through a sampled EaseTable (Ease::Tabulate), plus the table error per resolution
+
+using namespace kiwano;
+
+namespace
+{
+	float ElasticOut(float step)
+	{
+		return math::EaseElasticOut(step, 0.3f);
+	}
+
+	struct Family
+	{
+		const char* name;
+		float(*func)(float);
+	};
+
+	const Family families[] = {
+		{ "QuadInOut", math::EaseQuadInOut },
+		{ "CubicOut", math::EaseCubicOut },
+		{ "ExpoInOut", math::EaseExponentialInOut },
+		{ "SineInOut", math::EaseSineInOut },
+		{ "BackOut", math::EaseBackOut },
+		{ "BounceOut", math::EaseBounceOut },
+		{ "ElasticOut", ElasticOut },
+	};
+
+	template <float(*_Ease)(float)>
+	float SumDirect(std::vector<float> const& steps)
+	{
+		float sum = 0;
+		for (float step : steps)
+			sum += _Ease(step);
+		return sum;
+	}
+
+	template <typename _Func>
+	float SumIndirect(_Func const& func, std::vector<float> const& steps)
+	{
+		float sum = 0;
+		for (float step : steps)
+			sum += func(step);
+		return sum;
+	}
+
+	template <float(*_Ease)(float)>
+	void Run(Family const& family, std::vector<float> const& steps, int runs)
+	{
+		Closure<float(float)> closure(_Ease);
+		Closure<float(float)> tabulated(math::EaseTable(_Ease, 256));
+
+		// the table stays close to the function it samples
+		float max_error[3] = {};
+		const size_t resolutions[3] = { 64, 256, 1024 };
+		for (int i = 0; i < 3; ++i)
+		{
+			math::EaseTable table(_Ease, resolutions[i]);
+			KGE_CHECK(table.GetResolution() == resolutions[i]);
+			KGE_CHECK(table(0.f) == _Ease(0.f) && table(1.f) == _Ease(1.f));
+			max_error[i] = table.GetMaxError();
+		}
+		KGE_CHECK(max_error[2] <= max_error[0]);
+
+		const float direct_sum = SumDirect<_Ease>(steps);
+		KGE_CHECK(SumIndirect(closure, steps) == direct_sum);
+
+		float sink = 0;
+		double direct_ns = 0, closure_ns = 0, table_ns = 0;
+		test::MeasurePair(runs, direct_ns, closure_ns,
+			[&]() { sink += SumDirect<_Ease>(steps); },
+			[&]() { test::DoNotOptimize(closure); sink += SumIndirect(closure, steps); }
+		);
+		table_ns = test::Measure(runs, [&]() { test::DoNotOptimize(tabulated); sink += SumIndirect(tabulated, steps); });
+		test::DoNotOptimize(sink);
+
+		const double count = static_cast<double>(steps.size());
+		std::printf("%-10s  direct %5.2f ns  closure %5.2f ns  table(256) %5.2f ns  |  max error 64: %.1e  256: %.1e  1024: %.1e\n",
+			family.name, direct_ns / count, closure_ns / count, table_ns / count, max_error[0], max_error[1], max_error[2]);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = test::IsQuick(argc, argv);
+	const size_t count = quick ? 10000 : 1000000;
+	const int runs = quick ? 1 : 7;
+
+	std::vector<float> steps(count);
+	for (size_t i = 0; i < count; ++i)
+		steps[i] = static_cast<float>(i) / static_cast<float>(count);
+
+	std::printf("per evaluation, %zu steps in [0, 1)\n", count);
+	Run<math::EaseQuadInOut>(families[0], steps, runs);
+	Run<math::EaseCubicOut>(families[1], steps, runs);
+	Run<math::EaseExponentialInOut>(families[2], steps, runs);
+	Run<math::EaseSineInOut>(families[3], steps, runs);
+	Run<math::EaseBackOut>(families[4], steps, runs);
+	Run<math::EaseBounceOut>(families[5], steps, runs);
+	Run<ElasticOut>(families[6], steps, runs);
+	return 0;
+}
@@ -0,0 +1,178 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "math/MatrixBatch.h"
+#include <cmath>
+#include <vector>
+
+// Batch matrix kernels at every SIMD level the CPU supports, against the scalar kernels,
+// on 1k, 10k and 100k transforms
+
+using namespace kiwano;
+
+namespace
+{
+	const char* GetLevelName(math::SimdLevel level)
+	{
+		switch (level)
+		{
+		case math::SimdLevel::SSE2:
+			return "SSE2";
+		case math::SimdLevel::AVX:
+			return "AVX";
+		default:
+			return "Scalar";
+		}
+	}
+
+	// deterministic, well-conditioned transforms
+	Matrix MakeMatrix(size_t i)
+	{
+		const float angle = static_cast<float>(i % 360) * 0.0174533f;
+		const float scale = 0.5f + static_cast<float>(i % 7) * 0.25f;
+		return Matrix(
+			std::cos(angle) * scale, std::sin(angle) * scale,
+			-std::sin(angle) * scale, std::cos(angle) * scale,
+			static_cast<float>(i % 101), static_cast<float>(i % 53)
+		);
+	}
+
+	bool NearlyEqual(float lhs, float rhs)
+	{
+		return std::abs(lhs - rhs) <= 1e-4f * (1.f + std::abs(lhs) + std::abs(rhs));
+	}
+
+	void CheckSame(std::vector<Matrix> const& lhs, std::vector<Matrix> const& rhs)
+	{
+		for (size_t i = 0; i < lhs.size(); ++i)
+		{
+			for (int j = 0; j < 6; ++j)
+				KGE_CHECK(NearlyEqual(lhs[i].m[j], rhs[i].m[j]));
+		}
+	}
+
+	void CheckSame(std::vector<Vec2> const& lhs, std::vector<Vec2> const& rhs)
+	{
+		for (size_t i = 0; i < lhs.size(); ++i)
+			KGE_CHECK(NearlyEqual(lhs[i].x, rhs[i].x) && NearlyEqual(lhs[i].y, rhs[i].y));
+	}
+
+	struct Data
+	{
+		std::vector<Matrix> lhs, rhs, matrices;
+		std::vector<Vec2> points, vertices;
+
+		// results of the scalar kernels
+		std::vector<Matrix> multiplied, inverted;
+		std::vector<Vec2> transformed, transformed_by_matrices;
+
+		explicit Data(size_t count)
+			: lhs(count), rhs(count), matrices(count), points(count), vertices(count)
+			, multiplied(count), inverted(count), transformed(count), transformed_by_matrices(count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				lhs[i] = MakeMatrix(i);
+				rhs[i] = MakeMatrix(i * 7 + 3);
+				matrices[i] = MakeMatrix(i * 13 + 5);
+				points[i] = Vec2(static_cast<float>(i % 640), static_cast<float>(i % 480));
+			}
+		}
+	};
+
+	void Run(math::SimdLevel level, Data& data, int runs)
+	{
+		const size_t count = data.lhs.size();
+		std::vector<Matrix> matrices(count);
+		std::vector<Vec2> points(count);
+
+		math::SetSimdLevel(level);
+		KGE_CHECK(math::GetSimdLevel() == level);
+
+		// results are checked against the scalar kernels before timing
+		math::MultiplyMatrices(matrices.data(), data.lhs.data(), data.rhs.data(), count);
+		CheckSame(matrices, data.multiplied);
+		math::InvertMatrices(matrices.data(), data.matrices.data(), count);
+		CheckSame(matrices, data.inverted);
+		math::TransformPoints(points.data(), data.matrices[0], data.points.data(), count);
+		CheckSame(points, data.transformed);
+		math::TransformPoints(points.data(), data.matrices.data(), data.points.data(), count);
+		CheckSame(points, data.transformed_by_matrices);
+
+		const double multiply_ns = test::Measure(runs, [&]()
+		{
+			math::MultiplyMatrices(matrices.data(), data.lhs.data(), data.rhs.data(), count);
+			test::DoNotOptimize(matrices);
+		});
+		const double invert_ns = test::Measure(runs, [&]()
+		{
+			math::InvertMatrices(matrices.data(), data.matrices.data(), count);
+			test::DoNotOptimize(matrices);
+		});
+		const double transform_ns = test::Measure(runs, [&]()
+		{
+			math::TransformPoints(points.data(), data.matrices[0], data.points.data(), count);
+			test::DoNotOptimize(points);
+		});
+		const double transform_by_matrices_ns = test::Measure(runs, [&]()
+		{
+			math::TransformPoints(points.data(), data.matrices.data(), data.points.data(), count);
+			test::DoNotOptimize(points);
+		});
+
+		const double n = static_cast<double>(count);
+		std::printf("%7zu  %-6s  multiply %5.2f ns  invert %5.2f ns  transform %5.2f ns  transform by matrices %5.2f ns\n",
+			count, GetLevelName(level), multiply_ns / n, invert_ns / n, transform_ns / n, transform_by_matrices_ns / n);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = test::IsQuick(argc, argv);
+	const int runs = quick ? 1 : 15;
+	const math::SimdLevel supported = math::GetSupportedSimdLevel();
+
+	std::printf("per transform, supported level: %s\n", GetLevelName(supported));
+
+	const size_t counts[] = { 1000, 10000, 100000 };
+	for (size_t count : counts)
+	{
+		Data data(count);
+
+		math::SetSimdLevel(math::SimdLevel::Scalar);
+		math::MultiplyMatrices(data.multiplied.data(), data.lhs.data(), data.rhs.data(), count);
+		math::InvertMatrices(data.inverted.data(), data.matrices.data(), count);
+		math::TransformPoints(data.transformed.data(), data.matrices[0], data.points.data(), count);
+		math::TransformPoints(data.transformed_by_matrices.data(), data.matrices.data(), data.points.data(), count);
+
+		const math::SimdLevel levels[] = { math::SimdLevel::Scalar, math::SimdLevel::SSE2, math::SimdLevel::AVX };
+		for (math::SimdLevel level : levels)
+		{
+			if (level <= supported)
+				Run(level, data, runs);
+		}
+	}
+
+	// requesting a level above the supported one falls back to the supported level
+	math::SetSimdLevel(math::SimdLevel::AVX);
+	KGE_CHECK(math::GetSimdLevel() == supported);
+	return 0;
+}
@@ -0,0 +1,297 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "network/NetworkTest.h"
+#include "network/HttpCache.h"
+#include "base/logs.h"
+#include <mutex>
+#include <dirent.h>
+#include <unistd.h>
+
+// HttpCache freshness, ETag and Last-Modified revalidation, coalescing of identical GETs,
+// the disk layer and the removal of orphaned cache files, against a loopback server
+
+using namespace kiwano;
+using namespace kiwano::network;
+
+namespace
+{
+	struct Resource
+	{
+		std::string body;
+		std::string cache_control;
+		std::string etag;
+		std::string last_modified;
+		int delay_ms;
+	};
+
+	// a server whose resources can change between requests, counts full and 304 replies
+	class Origin
+	{
+	public:
+		Origin() : full(0), not_modified(0) {}
+
+		void Set(std::string const& path, Resource const& resource)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			resources_[path] = resource;
+		}
+
+		test::HttpReply Serve(test::HttpExchange const& exchange)
+		{
+			test::HttpReply reply;
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto iter = resources_.find(exchange.path);
+			if (iter == resources_.end())
+			{
+				reply.status = 404;
+				return reply;
+			}
+
+			const Resource& resource = iter->second;
+			if (!resource.cache_control.empty())
+				reply.headers.emplace_back("Cache-Control", resource.cache_control);
+			if (!resource.etag.empty())
+				reply.headers.emplace_back("ETag", resource.etag);
+			if (!resource.last_modified.empty())
+				reply.headers.emplace_back("Last-Modified", resource.last_modified);
+			reply.delay_ms = resource.delay_ms;
+
+			if ((!resource.etag.empty() && exchange.Header("if-none-match") == resource.etag)
+				|| (!resource.last_modified.empty() && exchange.Header("if-modified-since") == resource.last_modified))
+			{
+				reply.status = 304;
+				++not_modified;
+			}
+			else
+			{
+				reply.body = resource.body;
+				++full;
+			}
+			return reply;
+		}
+
+		std::atomic<int> full;
+		std::atomic<int> not_modified;
+
+	private:
+		std::mutex mutex_;
+		std::map<std::string, Resource> resources_;
+	};
+
+	HttpResponsePtr Fetch(HttpClient& client, test::LoopbackServer const& server, std::string const& path)
+	{
+		HttpResponsePtr result;
+
+		HttpRequestPtr request = new HttpRequest(HttpRequest::Type::Get);
+		request->SetUrl(test::ToUrl(server, path));
+		request->SetResponseCallback([&result](HttpRequestPtr, HttpResponsePtr response) { result = response; });
+		client.Send(request);
+
+		KGE_CHECK(test::PumpUntil([&]() { return !!result; }));
+		return result;
+	}
+
+	void CheckResponse(HttpResponsePtr const& response, std::string const& body, bool from_cache)
+	{
+		KGE_CHECK(response->IsSucceed());
+		KGE_CHECK(response->GetResponseCode() == 200);
+		KGE_CHECK(response->GetRawData() == body);
+		KGE_CHECK(response->IsFromCache() == from_cache);
+	}
+
+	void TestFreshness(HttpClient& client, test::LoopbackServer const& server, Origin& origin)
+	{
+		HttpCachePtr cache = new HttpCache;
+		client.SetCache(cache);
+
+		// fresh entries are served without a request
+		origin.Set("/fresh", Resource{ "fresh body", "max-age=60", "", "", 0 });
+		CheckResponse(Fetch(client, server, "/fresh"), "fresh body", false);
+		CheckResponse(Fetch(client, server, "/fresh"), "fresh body", true);
+		KGE_CHECK(origin.full == 1 && origin.not_modified == 0);
+
+		// no-store responses are never kept
+		origin.Set("/no-store", Resource{ "secret", "no-store, max-age=60", "\"s1\"", "", 0 });
+		CheckResponse(Fetch(client, server, "/no-store"), "secret", false);
+		CheckResponse(Fetch(client, server, "/no-store"), "secret", false);
+		KGE_CHECK(origin.full == 3);
+
+		HttpCache::Stats stats = cache->GetStats();
+		KGE_CHECK(stats.hits == 1);
+		KGE_CHECK(stats.count == 1);
+	}
+
+	void TestRevalidation(HttpClient& client, test::LoopbackServer const& server, Origin& origin)
+	{
+		HttpCachePtr cache = new HttpCache;
+		client.SetCache(cache);
+		origin.full = 0;
+
+		// stale entries send one conditional request and keep the stored body on a 304
+		origin.Set("/etag", Resource{ "version 1", "no-cache", "\"v1\"", "", 0 });
+		CheckResponse(Fetch(client, server, "/etag"), "version 1", false);
+		CheckResponse(Fetch(client, server, "/etag"), "version 1", true);
+		KGE_CHECK(origin.full == 1 && origin.not_modified == 1);
+
+		// changed content replaces the entry and is revalidated with its new tag
+		origin.Set("/etag", Resource{ "version 2", "no-cache", "\"v2\"", "", 0 });
+		CheckResponse(Fetch(client, server, "/etag"), "version 2", false);
+		CheckResponse(Fetch(client, server, "/etag"), "version 2", true);
+		KGE_CHECK(origin.full == 2 && origin.not_modified == 2);
+
+		origin.Set("/modified", Resource{ "dated", "max-age=0", "", "Wed, 21 Oct 2015 07:28:00 GMT", 0 });
+		CheckResponse(Fetch(client, server, "/modified"), "dated", false);
+		CheckResponse(Fetch(client, server, "/modified"), "dated", true);
+		KGE_CHECK(origin.full == 3 && origin.not_modified == 3);
+
+		// the changed entry was revalidated as well
+		HttpCache::Stats stats = cache->GetStats();
+		KGE_CHECK(stats.revalidations == 4);
+		KGE_CHECK(stats.not_modified == 3);
+		KGE_CHECK(stats.hits == 0);
+	}
+
+	void TestCoalescing(HttpClient& client, test::LoopbackServer const& server, Origin& origin)
+	{
+		client.SetCache(new HttpCache);
+		origin.full = 0;
+
+		// identical GETs in flight share one transfer and one body
+		origin.Set("/slow", Resource{ "shared body", "max-age=60", "", "", 200 });
+
+		Array<HttpResponsePtr> responses;
+		for (int i = 0; i < 5; ++i)
+		{
+			HttpRequestPtr request = new HttpRequest(HttpRequest::Type::Get);
+			request->SetUrl(test::ToUrl(server, "/slow"));
+			request->SetResponseCallback([&responses](HttpRequestPtr, HttpResponsePtr response) { responses.push_back(response); });
+			client.Send(request);
+		}
+
+		KGE_CHECK(test::PumpUntil([&]() { return responses.size() == 5; }));
+		KGE_CHECK(origin.full == 1);
+
+		for (const auto& response : responses)
+		{
+			CheckResponse(response, "shared body", false);
+			KGE_CHECK(response->GetRawData().data() == responses[0]->GetRawData().data());
+		}
+	}
+
+	size_t CountCacheFiles(std::string const& directory)
+	{
+		size_t count = 0;
+		DIR* dir = ::opendir(directory.c_str());
+		KGE_CHECK(dir != nullptr);
+		while (dirent* entry = ::readdir(dir))
+		{
+			if (std::strlen(entry->d_name) == 16)
+				++count;
+		}
+		::closedir(dir);
+		return count;
+	}
+
+	std::string ReadFile(std::string const& path)
+	{
+		std::string data;
+		if (std::FILE* file = std::fopen(path.c_str(), "rb"))
+		{
+			char buffer[256];
+			while (size_t len = std::fread(buffer, 1, sizeof(buffer), file))
+				data.append(buffer, len);
+			std::fclose(file);
+		}
+		return data;
+	}
+
+	void WriteFile(std::string const& path, std::string const& data)
+	{
+		std::FILE* file = std::fopen(path.c_str(), "wb");
+		KGE_CHECK(file != nullptr);
+		KGE_CHECK(std::fwrite(data.data(), 1, data.size(), file) == data.size());
+		std::fclose(file);
+	}
+
+	void TestDisk(HttpClient& client, test::LoopbackServer const& server, Origin& origin)
+	{
+		char temp[] = "/tmp/kiwano-http-cache-XXXXXX";
+		KGE_CHECK(::mkdtemp(temp) != nullptr);
+		const std::string directory = std::string(temp) + "/cache/";
+
+		// entries on disk survive the cache and are found by the next one
+		origin.full = 0;
+		origin.Set("/disk", Resource{ "disk body", "max-age=60", "", "", 0 });
+
+		client.SetCache(new HttpCache(String(directory.c_str())));
+		CheckResponse(Fetch(client, server, "/disk"), "disk body", false);
+
+		client.SetCache(new HttpCache(String(directory.c_str())));
+		CheckResponse(Fetch(client, server, "/disk"), "disk body", true);
+		KGE_CHECK(origin.full == 1);
+		client.SetCache(nullptr);
+
+		// a body written after the last index save, as after a crash, and an unrelated file
+		const std::string index = ReadFile(directory + "index");
+		KGE_CHECK(!index.empty());
+		{
+			HttpCachePtr cache = new HttpCache(String(directory.c_str()));
+			cache->Store("orphan", 200, "HTTP/1.1 200 OK\r\nCache-Control: max-age=60\r\n\r\n",
+				std::make_shared<const std::string>("orphan body"));
+		}
+		KGE_CHECK(CountCacheFiles(directory) == 2);
+		WriteFile(directory + "index", index);
+		WriteFile(directory + "notes.txt", "kept");
+
+		// the next cache removes the unlisted body only
+		Logger::Instance().Disable();	// the removal is logged as a warning
+		{
+			HttpCachePtr cache = new HttpCache(String(directory.c_str()));
+			KGE_CHECK(cache->GetStats().count == 1);
+		}
+		Logger::Instance().Enable();
+
+		KGE_CHECK(CountCacheFiles(directory) == 1);
+		KGE_CHECK(ReadFile(directory + "notes.txt") == "kept");
+
+		std::system(("rm -rf " + std::string(temp)).c_str());
+	}
+}
+
+int main()
+{
+	Origin origin;
+	test::LoopbackServer server([&origin](test::HttpExchange const& exchange) { return origin.Serve(exchange); });
+
+	HttpClient& client = HttpClient::Instance();
+	client.SetupComponent(nullptr);
+
+	TestFreshness(client, server, origin);
+	TestRevalidation(client, server, origin);
+	TestCoalescing(client, server, origin);
+	TestDisk(client, server, origin);
+
+	client.DestroyComponent();
+
+	std::printf("HttpCacheTest passed\n");
+	return 0;
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "network/NetworkTest.h"
+
+// HttpClient concurrency, connection reuse, priorities and cancellation against a loopback server
+
+using namespace kiwano;
+using namespace kiwano::network;
+
+namespace
+{
+	// /delay/<ms> answers after the given time, every reply echoes the path
+	test::HttpReply Echo(test::HttpExchange const& exchange)
+	{
+		test::HttpReply reply;
+		reply.body = exchange.path;
+		if (exchange.path.compare(0, 7, "/delay/") == 0)
+			reply.delay_ms = std::atoi(exchange.path.c_str() + 7);
+		return reply;
+	}
+
+	struct Result
+	{
+		int responses = 0;
+		int failures = 0;
+		Array<std::string> order;
+	};
+
+	HttpRequestPtr MakeGet(test::LoopbackServer const& server, std::string const& path, Result& result)
+	{
+		HttpRequestPtr request = new HttpRequest(HttpRequest::Type::Get);
+		request->SetUrl(test::ToUrl(server, path));
+		request->SetResponseCallback([&result, path](HttpRequestPtr, HttpResponsePtr response)
+		{
+			++result.responses;
+			if (!response->IsSucceed() || response->GetResponseCode() != 200 || response->GetRawData() != path)
+				++result.failures;
+			result.order.push_back(path);
+		});
+		return request;
+	}
+
+	void TestConcurrency(HttpClient& client)
+	{
+		test::LoopbackServer server(Echo);
+		client.SetMaxConcurrentRequests(8);
+		client.SetMaxConnectionsPerHost(4);
+
+		// 8 x 300 ms take 2.4 s one at a time, about 600 ms on 4 connections
+		Result result;
+		const auto start = test::Clock::now();
+		for (int i = 0; i < 8; ++i)
+		{
+			client.Send(MakeGet(server, "/delay/300", result));
+		}
+
+		KGE_CHECK(test::PumpUntil([&]() { return result.responses == 8; }));
+		const double elapsed_ms = test::ElapsedNs(start) / 1e6;
+
+		KGE_CHECK(result.failures == 0);
+		KGE_CHECK(server.MaxActive() >= 2 && server.MaxActive() <= 4);
+		KGE_CHECK(server.Connections() <= 4);
+		KGE_CHECK(elapsed_ms < 1800);
+	}
+
+	void TestConnectionReuse(HttpClient& client)
+	{
+		test::LoopbackServer server(Echo);
+		client.SetMaxConcurrentRequests(8);
+		client.SetMaxConnectionsPerHost(1);
+
+		// requests to one host wait for the single keep-alive connection
+		Result result;
+		for (int i = 0; i < 6; ++i)
+		{
+			client.Send(MakeGet(server, "/delay/20", result));
+		}
+
+		KGE_CHECK(test::PumpUntil([&]() { return result.responses == 6; }));
+		KGE_CHECK(result.failures == 0);
+		KGE_CHECK(server.Requests() == 6);
+		KGE_CHECK(server.Connections() == 1);
+		KGE_CHECK(server.MaxActive() == 1);
+
+		client.SetMaxConnectionsPerHost(4);
+	}
+
+	void TestPriority(HttpClient& client)
+	{
+		test::LoopbackServer server(Echo);
+		client.SetMaxConcurrentRequests(1);
+
+		// the others are queued while the first one runs
+		Result result;
+		client.Send(MakeGet(server, "/delay/200", result));
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		for (int i = 0; i < 3; ++i)
+		{
+			client.Send(MakeGet(server, "/low", result));
+		}
+
+		HttpRequestPtr high = MakeGet(server, "/high", result);
+		high->SetPriority(5);
+		client.Send(high);
+
+		KGE_CHECK(test::PumpUntil([&]() { return result.responses == 5; }));
+		KGE_CHECK(result.failures == 0);
+
+		auto high_pos = std::find(result.order.begin(), result.order.end(), "/high");
+		auto low_pos = std::find(result.order.begin(), result.order.end(), "/low");
+		KGE_CHECK(high_pos < low_pos);
+
+		client.SetMaxConcurrentRequests(8);
+	}
+
+	void TestCancel(HttpClient& client)
+	{
+		test::LoopbackServer server(Echo);
+		client.SetMaxConcurrentRequests(1);
+
+		Result result;
+		HttpRequestPtr running = MakeGet(server, "/delay/3000", result);
+		client.Send(running);
+		KGE_CHECK(test::PumpUntil([&]() { return server.Requests() == 1; }));
+
+		// the queued one never starts, the running one is aborted
+		HttpRequestPtr queued = MakeGet(server, "/queued", result);
+		client.Send(queued);
+		queued->Cancel();
+
+		const auto start = test::Clock::now();
+		running->Cancel();
+
+		Result control;
+		client.Send(MakeGet(server, "/control", control));
+		KGE_CHECK(test::PumpUntil([&]() { return control.responses == 1; }));
+
+		// the control request ran right after the abort, not after the slow reply
+		KGE_CHECK(test::ElapsedNs(start) / 1e6 < 2000);
+		KGE_CHECK(control.failures == 0);
+
+		test::PumpUntil([]() { return false; }, 50);
+		KGE_CHECK(result.responses == 0);
+		KGE_CHECK(server.Requests() == 2);
+
+		client.SetMaxConcurrentRequests(8);
+	}
+}
+
+int main()
+{
+	HttpClient& client = HttpClient::Instance();
+	client.SetupComponent(nullptr);
+
+	TestConcurrency(client);
+	TestConnectionReuse(client);
+	TestPriority(client);
+	TestCancel(client);
+
+	client.DestroyComponent();
+
+	std::printf("HttpClientTest passed\n");
+	return 0;
+}
@@ -0,0 +1,299 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// A keep-alive HTTP/1.1 server on 127.0.0.1 that stands in for real servers in the network tests.
+// Every connection is served on its own thread, so handlers must be thread-safe.
+
+namespace test
+{
+	struct HttpExchange
+	{
+		std::string method;
+		std::string path;
+		std::map<std::string, std::string> headers;	// field names in lower case
+		std::string body;
+
+		std::string Header(std::string const& name) const
+		{
+			auto iter = headers.find(name);
+			return iter != headers.end() ? iter->second : std::string();
+		}
+	};
+
+	struct HttpReply
+	{
+		int status = 200;
+		std::vector<std::pair<std::string, std::string>> headers;
+		std::string body;
+		int delay_ms = 0;	// wait before the reply is sent
+	};
+
+	class LoopbackServer
+	{
+	public:
+		using Handler = std::function<HttpReply(HttpExchange const&)>;
+
+		explicit LoopbackServer(Handler handler)
+			: handler_(std::move(handler))
+			, stop_(false)
+			, port_(0)
+			, connections_(0)
+			, requests_(0)
+			, active_(0)
+			, max_active_(0)
+		{
+			listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+
+			sockaddr_in addr;
+			std::memset(&addr, 0, sizeof(addr));
+			addr.sin_family = AF_INET;
+			addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			addr.sin_port = 0;
+
+			socklen_t len = sizeof(addr);
+			if (listen_fd_ < 0
+				|| 0 != ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))
+				|| 0 != ::listen(listen_fd_, 64)
+				|| 0 != ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len))
+			{
+				std::fprintf(stderr, "LoopbackServer: failed to listen on 127.0.0.1\n");
+				std::exit(1);
+			}
+			port_ = ntohs(addr.sin_port);
+
+			accept_thread_ = std::thread([this]() { AcceptLoop(); });
+		}
+
+		~LoopbackServer()
+		{
+			stop_ = true;
+			::shutdown(listen_fd_, SHUT_RDWR);
+			::close(listen_fd_);
+			accept_thread_.join();
+
+			std::vector<std::thread> threads;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (int fd : client_fds_)
+					::shutdown(fd, SHUT_RDWR);
+				threads.swap(threads_);
+			}
+
+			for (auto& thread : threads)
+				thread.join();
+		}
+
+		std::string Url(std::string const& path) const
+		{
+			return "http://127.0.0.1:" + std::to_string(port_) + path;
+		}
+
+		// accepted connections, requests received and the most requests handled at once
+		size_t Connections() const	{ return connections_; }
+		size_t Requests() const		{ return requests_; }
+		size_t MaxActive() const	{ return max_active_; }
+
+		void ResetCounters()
+		{
+			connections_ = 0;
+			requests_ = 0;
+			max_active_ = 0;
+		}
+
+	private:
+		void AcceptLoop()
+		{
+			while (!stop_)
+			{
+				int fd = ::accept(listen_fd_, nullptr, nullptr);
+				if (fd < 0)
+					continue;
+
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (stop_)
+				{
+					::close(fd);
+					break;
+				}
+
+				++connections_;
+				client_fds_.push_back(fd);
+				threads_.emplace_back([this, fd]() { Serve(fd); });
+			}
+		}
+
+		void Serve(int fd)
+		{
+			std::string buffer;
+			HttpExchange exchange;
+			while (!stop_ && ReadRequest(fd, buffer, exchange))
+			{
+				++requests_;
+
+				size_t active = ++active_;
+				size_t max_active = max_active_;
+				while (active > max_active && !max_active_.compare_exchange_weak(max_active, active)) {}
+
+				HttpReply reply = handler_(exchange);
+				for (int waited = 0; waited < reply.delay_ms && !stop_; waited += 10)
+					std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+				--active_;
+
+				if (!WriteReply(fd, exchange, reply) || exchange.Header("connection") == "close")
+					break;
+			}
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			client_fds_.erase(std::find(client_fds_.begin(), client_fds_.end(), fd));
+			::close(fd);
+		}
+
+		static bool ReadRequest(int fd, std::string& buffer, HttpExchange& exchange)
+		{
+			size_t end = std::string::npos;
+			while ((end = buffer.find("\r\n\r\n")) == std::string::npos)
+			{
+				if (!Receive(fd, buffer))
+					return false;
+			}
+
+			exchange = HttpExchange();
+
+			std::string head = buffer.substr(0, end + 2);
+			buffer.erase(0, end + 4);
+
+			size_t line_end = head.find("\r\n");
+			std::string request_line = head.substr(0, line_end);
+			size_t first = request_line.find(' ');
+			size_t second = request_line.find(' ', first + 1);
+			exchange.method = request_line.substr(0, first);
+			exchange.path = request_line.substr(first + 1, second - first - 1);
+
+			for (size_t pos = line_end + 2; pos < head.size();)
+			{
+				size_t next = head.find("\r\n", pos);
+				std::string line = head.substr(pos, next - pos);
+				pos = next + 2;
+
+				size_t colon = line.find(':');
+				if (colon == std::string::npos)
+					continue;
+
+				std::string name = line.substr(0, colon);
+				for (auto& ch : name)
+					ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+
+				size_t value = line.find_first_not_of(' ', colon + 1);
+				exchange.headers[name] = value == std::string::npos ? std::string() : line.substr(value);
+			}
+
+			const size_t length = static_cast<size_t>(std::atoll(exchange.Header("content-length").c_str()));
+			while (buffer.size() < length)
+			{
+				if (!Receive(fd, buffer))
+					return false;
+			}
+			exchange.body = buffer.substr(0, length);
+			buffer.erase(0, length);
+			return true;
+		}
+
+		static bool WriteReply(int fd, HttpExchange const& exchange, HttpReply const& reply)
+		{
+			std::string data = "HTTP/1.1 " + std::to_string(reply.status) + " " + Reason(reply.status) + "\r\n";
+			for (const auto& pair : reply.headers)
+				data += pair.first + ": " + pair.second + "\r\n";
+
+			// a 304 has no body
+			if (reply.status != 304)
+				data += "Content-Length: " + std::to_string(reply.body.size()) + "\r\n";
+			data += "\r\n";
+
+			if (reply.status != 304 && exchange.method != "HEAD")
+				data += reply.body;
+
+			for (size_t sent = 0; sent < data.size();)
+			{
+				ssize_t len = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+				if (len <= 0)
+					return false;
+				sent += static_cast<size_t>(len);
+			}
+			return true;
+		}
+
+		static bool Receive(int fd, std::string& buffer)
+		{
+			char data[4096];
+			ssize_t len = ::recv(fd, data, sizeof(data), 0);
+			if (len <= 0)
+				return false;
+			buffer.append(data, static_cast<size_t>(len));
+			return true;
+		}
+
+		static const char* Reason(int status)
+		{
+			switch (status)
+			{
+			case 200: return "OK";
+			case 206: return "Partial Content";
+			case 304: return "Not Modified";
+			case 404: return "Not Found";
+			default: return "Status";
+			}
+		}
+
+	private:
+		Handler handler_;
+		std::atomic<bool> stop_;
+		int listen_fd_;
+		unsigned short port_;
+		std::thread accept_thread_;
+
+		std::mutex mutex_;
+		std::vector<int> client_fds_;
+		std::vector<std::thread> threads_;
+
+		std::atomic<size_t> connections_;
+		std::atomic<size_t> requests_;
+		std::atomic<size_t> active_;
+		std::atomic<size_t> max_active_;
+	};
+}
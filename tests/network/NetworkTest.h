@@ -0,0 +1,52 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "test.h"
+#include "network/LoopbackServer.h"
+#include "network/HttpClient.h"
+#include "base/PerformQueue.h"
+#include <thread>
+
+// Helpers shared by the network tests
+
+namespace test
+{
+	// Runs the callbacks posted to the main thread until done() or the timeout
+	template <typename _Pred>
+	bool PumpUntil(_Pred&& done, int timeout_ms = 10000)
+	{
+		const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+		while (!done())
+		{
+			if (Clock::now() > deadline)
+				return false;
+
+			kiwano::PerformQueue::Instance().Perform();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	inline kiwano::String ToUrl(LoopbackServer const& server, std::string const& path)
+	{
+		return kiwano::String(server.Url(path).c_str());
+	}
+}
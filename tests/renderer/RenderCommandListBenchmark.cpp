@@ -0,0 +1,188 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "renderer/RenderCommand.h"
+#include <cstdlib>
+
+// RenderCommandList sorting and sprite batching against the recording backend,
+// with stub textures since nothing is drawn
+
+using namespace kiwano;
+
+namespace
+{
+	using Call = RecordingRenderBackend::Call;
+
+	// Any distinct addresses work as texture identities
+	int textures[4];
+
+	void RecordSprite(RenderCommandList& list, int texture)
+	{
+		RenderCommand& cmd = list.Record(RenderCommandType::Sprite, &textures[texture]);
+		cmd.src_rect = Rect{ 0, 0, 16, 16 };
+		cmd.dest_rect = Rect{ 0, 0, 16, 16 };
+		cmd.opacity = 1.f;
+	}
+
+	void CheckCall(Call const& call, RenderCommandType type, int texture, unsigned int count)
+	{
+		KGE_CHECK(call.type == type);
+		KGE_CHECK(call.count == count);
+		if (type == RenderCommandType::Sprite)
+			KGE_CHECK(call.texture == &textures[texture]);
+	}
+
+	void CheckOrderKept()
+	{
+		RenderCommandList list;
+		RecordingRenderBackend backend;
+
+		// consecutive sprites on one texture merge, anything else keeps its place
+		RecordSprite(list, 0);
+		RecordSprite(list, 0);
+		RecordSprite(list, 1);
+		RecordSprite(list, 0);
+		list.Record(RenderCommandType::FillRectangle);
+		RecordSprite(list, 0);
+		KGE_CHECK(list.GetCommandCount() == 6);
+
+		list.Execute(&backend);
+		KGE_CHECK(list.IsEmpty());
+
+		auto const& calls = backend.GetCalls();
+		KGE_CHECK(calls.size() == 5);
+		CheckCall(calls[0], RenderCommandType::Sprite, 0, 2);
+		CheckCall(calls[1], RenderCommandType::Sprite, 1, 1);
+		CheckCall(calls[2], RenderCommandType::Sprite, 0, 1);
+		CheckCall(calls[3], RenderCommandType::FillRectangle, 0, 1);
+		CheckCall(calls[4], RenderCommandType::Sprite, 0, 1);
+
+		auto const& stats = list.GetStats();
+		KGE_CHECK(stats.commands == 6 && stats.sprites == 5 && stats.batches == 4 && stats.draw_calls == 5);
+
+		list.ResetStats();
+		KGE_CHECK(list.GetStats().commands == 0);
+	}
+
+	void CheckReorder()
+	{
+		RenderCommandList list;
+		RecordingRenderBackend backend;
+
+		list.BeginReorder();
+		RecordSprite(list, 0);
+		RecordSprite(list, 1);
+		RecordSprite(list, 0);
+		RecordSprite(list, 1);
+
+		// a barrier inside the group splits it, sprites never cross it
+		list.Record(RenderCommandType::PushClip);
+		RecordSprite(list, 1);
+		RecordSprite(list, 0);
+		RecordSprite(list, 1);
+
+		// a nested group joins the outer one
+		list.BeginReorder();
+		RecordSprite(list, 0);
+		list.EndReorder();
+		list.Record(RenderCommandType::PopClip);
+		list.EndReorder();
+
+		// sprites after the group keep their order
+		RecordSprite(list, 1);
+		RecordSprite(list, 0);
+		RecordSprite(list, 1);
+		list.Execute(&backend);
+
+		auto const& calls = backend.GetCalls();
+		KGE_CHECK(calls.size() == 9);
+		CheckCall(calls[0], RenderCommandType::Sprite, 0, 2);
+		CheckCall(calls[1], RenderCommandType::Sprite, 1, 2);
+		CheckCall(calls[2], RenderCommandType::PushClip, 0, 1);
+		CheckCall(calls[3], RenderCommandType::Sprite, 0, 2);
+		CheckCall(calls[4], RenderCommandType::Sprite, 1, 2);
+		CheckCall(calls[5], RenderCommandType::PopClip, 0, 1);
+		CheckCall(calls[6], RenderCommandType::Sprite, 1, 1);
+		CheckCall(calls[7], RenderCommandType::Sprite, 0, 1);
+		CheckCall(calls[8], RenderCommandType::Sprite, 1, 1);
+
+		// clips and layers are not draw calls
+		KGE_CHECK(list.GetStats().draw_calls == 7);
+
+		// discarded commands are never submitted
+		backend.Reset();
+		RecordSprite(list, 0);
+		list.Clear();
+		list.Execute(&backend);
+		KGE_CHECK(backend.GetCalls().empty());
+	}
+
+	void Run(const char* name, int count, int texture_count, bool reorder, int runs)
+	{
+		std::srand(7);
+		Array<int> input;
+		for (int i = 0; i < count; ++i)
+			input.push_back(std::rand() % texture_count);
+
+		RenderCommandList list;
+		RecordingRenderBackend backend;
+
+		double ns = test::Measure(runs, [&]()
+		{
+			backend.Reset();
+			list.ResetStats();
+
+			if (reorder)
+				list.BeginReorder();
+
+			for (int texture : input)
+				RecordSprite(list, texture);
+
+			if (reorder)
+				list.EndReorder();
+
+			list.Execute(&backend);
+		});
+
+		auto const& stats = list.GetStats();
+		KGE_CHECK(stats.sprites == static_cast<unsigned int>(count));
+		if (reorder)
+			KGE_CHECK(stats.draw_calls == static_cast<unsigned int>(texture_count));
+
+		std::printf("%-10s %5d sprites, %d textures, %-8s: %5u draw calls %7.1f ns/sprite\n",
+			name, count, texture_count, reorder ? "reorder" : "in order",
+			stats.draw_calls, ns / count);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = test::IsQuick(argc, argv);
+	const int runs = quick ? 1 : 20;
+
+	CheckOrderKept();
+	CheckReorder();
+
+	Run("tiles", 4096, 4, false, runs);
+	Run("tiles", 4096, 4, true, runs);
+	Run("particles", 4096, 1, false, runs);
+	return 0;
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// Minimal helpers shared by the tests and benchmarks.
+// Tests return non-zero from main on failure, benchmarks print one line per case.
+// A failed check exits without running destructors, other threads may still be running.
+
+#define KGE_CHECK(EXPR)																\
+	do {																			\
+		if (!(EXPR)) {																\
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #EXPR);	\
+			std::fflush(stderr);													\
+			std::_Exit(1);															\
+		}																			\
+	} while (0)
+
+namespace test
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Benchmarks take --quick to run a single short pass, which is how ctest runs them
+	inline bool IsQuick(int argc, char** argv)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], "--quick") == 0)
+				return true;
+		}
+		return false;
+	}
+
+	inline double ElapsedNs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	}
+
+	// Best time of several runs in nanoseconds
+	template <typename _Func>
+	double Measure(int runs, _Func&& func)
+	{
+		double best = 0;
+		for (int i = 0; i < runs; ++i)
+		{
+			auto start = Clock::now();
+			func();
+			double elapsed = ElapsedNs(start);
+			best = (i == 0) ? elapsed : std::min(best, elapsed);
+		}
+		return best;
+	}
+
+	// Best times of two alternatives, run alternately after one warm-up pass each
+	// so that neither side pays for cold caches or first-touch page faults alone
+	template <typename _Func1, typename _Func2>
+	void MeasurePair(int runs, double& first, double& second, _Func1&& func1, _Func2&& func2)
+	{
+		func1();
+		func2();
+
+		for (int i = 0; i < runs; ++i)
+		{
+			auto start = Clock::now();
+			func1();
+			double elapsed1 = ElapsedNs(start);
+
+			start = Clock::now();
+			func2();
+			double elapsed2 = ElapsedNs(start);
+
+			first = (i == 0) ? elapsed1 : std::min(first, elapsed1);
+			second = (i == 0) ? elapsed2 : std::min(second, elapsed2);
+		}
+	}
+
+	// Keeps the optimizer from dropping a computed value
+	template <typename _Ty>
+	inline void DoNotOptimize(_Ty const& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r"(&value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+}
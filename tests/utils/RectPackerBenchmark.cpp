@@ -0,0 +1,168 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "utils/RectPacker.h"
+#include <cstdlib>
+#include <vector>
+
+// RectPacker occupancy and speed on typical atlas inputs, compared with a simple shelf packer
+
+using namespace kiwano;
+
+namespace
+{
+	using Box = RectPacker::Box;
+
+	// Rows of rects, left to right, a new page when a row does not fit
+	struct ShelfPacker
+	{
+		int width, height, padding;
+		int pages = 0, x = 0, y = 0, row = 0;
+		long long used = 0;
+
+		void Insert(int w, int h)
+		{
+			if (pages == 0)
+				pages = 1;
+
+			if (x + w > width)
+			{
+				x = 0;
+				y += row + padding;
+				row = 0;
+			}
+
+			if (y + h > height)
+			{
+				++pages;
+				x = y = row = 0;
+			}
+
+			x += w + padding;
+			row = std::max(row, h);
+			used += static_cast<long long>(w) * h;
+		}
+	};
+
+	void CheckPlacement(RectPacker const& packer, Array<Box> const& boxes, int padding)
+	{
+		for (size_t i = 0; i < boxes.size(); ++i)
+		{
+			Box const& a = boxes[i];
+			KGE_CHECK(a.page >= 0 && a.page < packer.GetPageCount());
+			KGE_CHECK(a.x >= 0 && a.y >= 0);
+			KGE_CHECK(a.x + a.width <= packer.GetPageWidth() && a.y + a.height <= packer.GetPageHeight());
+
+			for (size_t j = i + 1; j < boxes.size(); ++j)
+			{
+				Box const& b = boxes[j];
+				if (a.page != b.page)
+					continue;
+
+				bool separated = a.x + a.width + padding <= b.x || b.x + b.width + padding <= a.x
+					|| a.y + a.height + padding <= b.y || b.y + b.height + padding <= a.y;
+				KGE_CHECK(separated);
+			}
+		}
+	}
+
+	void CheckBasics()
+	{
+		RectPacker packer(64, 64, 1);
+		Box box;
+		KGE_CHECK(!packer.Insert(65, 1, box) && box.page == -1);
+		KGE_CHECK(packer.Insert(64, 64, box) && box.page == 0 && box.x == 0 && box.y == 0);
+		KGE_CHECK(packer.Insert(32, 32, box) && box.page == 1);
+		KGE_CHECK(packer.Insert(31, 32, box) && box.page == 1 && box.x == 33);
+		KGE_CHECK(packer.Insert(64, 31, box) && box.page == 1 && box.y == 33);
+		KGE_CHECK(packer.GetPageCount() == 2);
+
+		packer.Reset();
+		KGE_CHECK(packer.GetPageCount() == 0 && packer.GetUsedArea() == 0);
+	}
+
+	void Run(const char* name, int count, int min_size, int max_size, int page_size, bool batch, int runs)
+	{
+		const int padding = 1;
+
+		std::srand(7);
+		Array<Box> input;
+		for (int i = 0; i < count; ++i)
+		{
+			int w = min_size + std::rand() % (max_size - min_size + 1);
+			int h = min_size + std::rand() % (max_size - min_size + 1);
+			input.push_back(Box{ -1, 0, 0, w, h });
+		}
+
+		RectPacker packer(page_size, page_size, padding);
+		Array<Box> boxes;
+		size_t packed = 0;
+
+		double ns = test::Measure(runs, [&]()
+		{
+			packer.Reset();
+			boxes = input;
+			packed = 0;
+
+			if (batch)
+			{
+				packed = packer.Insert(boxes);
+			}
+			else
+			{
+				for (auto& box : boxes)
+					packed += packer.Insert(box.width, box.height, box) ? 1 : 0;
+			}
+		});
+
+		KGE_CHECK(packed == static_cast<size_t>(count));
+		CheckPlacement(packer, boxes, padding);
+
+		ShelfPacker shelf{ page_size, page_size, padding };
+		for (auto const& box : input)
+			shelf.Insert(box.width, box.height);
+
+		const double page_area = static_cast<double>(page_size) * page_size;
+		const double shelf_occupancy = shelf.used / (page_area * shelf.pages);
+
+		std::printf("%-12s %5d rects %3d-%3d px, page %4d, %-6s: %2d pages %5.1f%%   shelf %2d pages %5.1f%%   %8.3f ms\n",
+			name, count, min_size, max_size, page_size, batch ? "batch" : "online",
+			packer.GetPageCount(), packer.GetOccupancy() * 100.0,
+			shelf.pages, shelf_occupancy * 100.0, ns / 1e6);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = test::IsQuick(argc, argv);
+	const int runs = quick ? 1 : 5;
+	const int scale = quick ? 10 : 1;
+
+	CheckBasics();
+
+	Run("ui sprites", 300 / scale, 16, 128, 1024, false, runs);
+	Run("ui sprites", 300 / scale, 16, 128, 1024, true, runs);
+	Run("frames", 256 / scale, 96, 96, 1024, true, runs);
+	Run("glyphs", 2000 / scale, 8, 40, 1024, false, runs);
+	Run("glyphs", 2000 / scale, 8, 40, 1024, true, runs);
+	Run("mixed", 1000 / scale, 4, 256, 2048, true, runs);
+	return 0;
+}
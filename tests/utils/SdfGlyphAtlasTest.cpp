@@ -0,0 +1,208 @@
+// Copyright (c) 2016-2018 Kiwano - Nomango
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "test.h"
+#include "utils/SdfGlyphAtlas.h"
+#include <cmath>
+#include <cstdint>
+
+// Glyph generation, layout and shading of SdfGlyphAtlas with the bundled Source Code Pro font
+
+using namespace kiwano;
+
+namespace
+{
+	Array<std::uint8_t> ReadFont()
+	{
+		Array<std::uint8_t> data;
+
+		std::FILE* file = std::fopen(KIWANO_TEST_DATA_DIR "/SourceCodePro-Regular.ttf", "rb");
+		KGE_CHECK(file != nullptr);
+
+		std::fseek(file, 0, SEEK_END);
+		data.resize(static_cast<size_t>(std::ftell(file)));
+		std::fseek(file, 0, SEEK_SET);
+		KGE_CHECK(std::fread(data.data(), 1, data.size(), file) == data.size());
+		std::fclose(file);
+		return data;
+	}
+
+	bool Near(float a, float b, float tolerance = 0.01f)
+	{
+		return std::fabs(a - b) <= tolerance;
+	}
+
+	// Fraction of opaque pixels inside the shaded region
+	float Coverage(Array<std::uint32_t> const& pixels)
+	{
+		size_t opaque = 0;
+		for (auto pixel : pixels)
+		{
+			if ((pixel >> 24) >= 128)
+				++opaque;
+		}
+		return pixels.empty() ? 0.f : static_cast<float>(opaque) / pixels.size();
+	}
+
+	void TestGlyphs(SdfGlyphAtlas& atlas)
+	{
+		auto a = atlas.GetGlyph(L'A');
+		KGE_CHECK(a != nullptr);
+		KGE_CHECK(a->page == 0);
+		KGE_CHECK(a->width > 0 && a->height > 0);
+		KGE_CHECK(a->advance > 0.f);
+		KGE_CHECK(atlas.GetGlyph(L'A') == a);
+		KGE_CHECK(atlas.GetPageVersion(0) == 1);
+
+		// whitespace advances the pen but takes no space in the page
+		auto space = atlas.GetGlyph(L' ');
+		KGE_CHECK(space != nullptr);
+		KGE_CHECK(space->page == -1);
+		KGE_CHECK(Near(space->advance, a->advance));
+		KGE_CHECK(atlas.GetPageVersion(0) == 1);
+
+		// the glyph is stored as a distance field, inside above the edge value and outside below
+		std::uint8_t const* data = atlas.GetPageData(0);
+		int inside = 0, outside = 0;
+		for (int y = a->y; y < a->y + a->height; ++y)
+		{
+			for (int x = a->x; x < a->x + a->width; ++x)
+			{
+				const int value = data[y * atlas.GetPageSize() + x];
+				inside += value > 128;
+				outside += value < 64;
+			}
+		}
+		KGE_CHECK(inside > 0 && outside > 0);
+	}
+
+	void TestLayout(SdfGlyphAtlas& atlas)
+	{
+		Array<SdfGlyphAtlas::Quad> quads;
+
+		Size size = atlas.Layout(L"AB\nC D", 32.f, 0.f, TextAlign::Left, quads);
+		KGE_CHECK(quads.size() == 4);
+		KGE_CHECK(Near(size.y, atlas.GetLineHeight() * 2));
+
+		// at the base size the page is used as it is
+		auto c = atlas.GetGlyph(L'C');
+		KGE_CHECK(Near(quads[2].src_rect.origin.x, static_cast<float>(c->x)));
+		KGE_CHECK(Near(quads[2].src_rect.size.x, static_cast<float>(c->width)));
+		KGE_CHECK(Near(quads[2].dest_rect.size.x, static_cast<float>(c->width)));
+		KGE_CHECK(quads[3].dest_rect.origin.x > quads[2].dest_rect.origin.x + c->advance);
+
+		// right aligned lines end at the same pen position
+		const Size right = atlas.Layout(L"A\nAAA", 32.f, 0.f, TextAlign::Right, quads);
+		KGE_CHECK(Near(right.x, atlas.GetGlyph(L'A')->advance * 3, 0.5f));
+		KGE_CHECK(Near(quads[0].dest_rect.origin.x, quads[3].dest_rect.origin.x));
+	}
+
+	void TestLargeScale(SdfGlyphAtlas& atlas)
+	{
+		const int max_size = atlas.GetMaxScaledPageSize();
+		const float font_size = atlas.GetBaseSize() * 16.f;
+		const float scale = 16.f;
+		const float page_scale = atlas.GetPageScale(scale);
+
+		// the page stops growing at the limit, quads are stretched instead
+		KGE_CHECK(page_scale < scale);
+		KGE_CHECK(atlas.GetScaledPageSize(scale) <= max_size);
+		KGE_CHECK(Near(atlas.GetPageScale(1.5f), 1.5f));
+
+		Array<SdfGlyphAtlas::Quad> quads;
+		atlas.Layout(L"A", font_size, 0.f, TextAlign::Left, quads);
+		KGE_CHECK(quads.size() == 1);
+
+		auto a = atlas.GetGlyph(L'A');
+		KGE_CHECK(Near(quads[0].src_rect.size.x, a->width * page_scale));
+		KGE_CHECK(Near(quads[0].dest_rect.size.x, a->width * scale, 0.1f));
+		KGE_CHECK(quads[0].src_rect.origin.x + quads[0].src_rect.size.x <= static_cast<float>(atlas.GetScaledPageSize(scale)));
+
+		SdfGlyphAtlas::Style style;
+		style.color = Color::White;
+		style.outline_color = Color::Black;
+		style.outline_width = 0.f;
+		style.shadow_color = Color(Color::Black, 0.f);
+
+		Array<std::uint32_t> pixels;
+		RectPacker::Box region;
+		KGE_CHECK(atlas.ShadePage(0, style, scale, 0, pixels, region));
+		KGE_CHECK(region.x + region.width <= atlas.GetScaledPageSize(scale));
+		KGE_CHECK(region.y + region.height <= atlas.GetScaledPageSize(scale));
+		KGE_CHECK(pixels.size() == static_cast<size_t>(region.width) * region.height);
+
+		// the clamped page has the same shape as an unclamped one
+		Array<std::uint32_t> base_pixels;
+		RectPacker::Box base_region;
+		KGE_CHECK(atlas.ShadePage(0, style, 1.f, 0, base_pixels, base_region));
+		KGE_CHECK(std::fabs(Coverage(pixels) - Coverage(base_pixels)) < 0.05f);
+		KGE_CHECK(Coverage(pixels) > 0.05f);
+
+		// an outline in target pixels covers proportionally less of the clamped page
+		style.outline_width = 4.f;
+		Array<std::uint32_t> outlined;
+		KGE_CHECK(atlas.ShadePage(0, style, scale, 0, outlined, region));
+		KGE_CHECK(Coverage(outlined) > Coverage(pixels));
+
+		// nothing to shade when the page has not changed
+		KGE_CHECK(!atlas.ShadePage(0, style, scale, atlas.GetPageVersion(0), pixels, region));
+	}
+
+	void TestLimit()
+	{
+		SdfGlyphAtlas atlas(32.f, 6, 256);
+		KGE_CHECK(atlas.GetMaxScaledPageSize() >= 256);
+
+		// the limit never drops below the unscaled page
+		atlas.SetMaxScaledPageSize(100);
+		KGE_CHECK(atlas.GetMaxScaledPageSize() == 256);
+		KGE_CHECK(Near(atlas.GetPageScale(2.f), 1.f));
+		KGE_CHECK(Near(atlas.GetPageScale(0.5f), 0.5f));
+
+		atlas.SetMaxScaledPageSize(1024);
+		KGE_CHECK(Near(atlas.GetPageScale(8.f), 4.f));
+		KGE_CHECK(atlas.GetScaledPageSize(8.f) == 1024);
+	}
+}
+
+int main()
+{
+	const auto font = ReadFont();
+
+	SdfGlyphAtlas atlas;
+	KGE_CHECK(!atlas.IsValid());
+	KGE_CHECK(atlas.Load(font.data(), font.size()));
+	KGE_CHECK(atlas.IsValid());
+	KGE_CHECK(atlas.GetLineHeight() > atlas.GetBaseSize() * 0.9f);
+
+	TestGlyphs(atlas);
+	TestLayout(atlas);
+	TestLargeScale(atlas);
+	TestLimit();
+
+	// invalid data leaves the atlas empty
+	const char garbage[16] = {};
+	KGE_CHECK(!atlas.Load(garbage, sizeof(garbage)));
+	KGE_CHECK(!atlas.IsValid());
+	KGE_CHECK(atlas.GetGlyph(L'A') == nullptr);
+
+	std::printf("SdfGlyphAtlasTest passed\n");
+	return 0;
+}